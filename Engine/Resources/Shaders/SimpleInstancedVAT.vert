@@ -0,0 +1,58 @@
+#version 460 core
+#extension GL_ARB_separate_shader_objects : enable
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec3 aNormal;
+layout(location = 2) in vec2 aTexCoords;
+
+/* Vertex animation texture, each frame holds RowsPerFrame rows of Width texels with the skinned position (and normal)
+ * of every vertex of the object, the vertices of a mesh start at VertexOffset */
+struct VertexAnimation {
+  sampler2D Positions;
+  sampler2D Normals;
+  bool HasNormals;
+  int Width;
+  int RowsPerFrame;
+  int FrameCount;
+  int VertexOffset;
+  float SampleRate;
+  float Time;
+};
+
+out vec2 texCoords;
+out vec3 NormalVec;
+out vec3 FragPos;
+uniform mat4 view;
+uniform mat4 projection;
+/* Instances of the current batch, must match YEAGER_VAT_MAX_INSTANCES_PER_DRAW, bigger crowds are drawn in batches */
+uniform mat4 matrices[100];
+uniform float timeOffsets[100];
+uniform VertexAnimation vat;
+
+ivec2 TexelOf(int frame, int vertex)
+{
+  return ivec2(vertex % vat.Width, frame * vat.RowsPerFrame + vertex / vat.Width);
+}
+
+void main()
+{
+  float frameTime = (vat.Time + timeOffsets[gl_InstanceID]) * vat.SampleRate;
+  float frame = mod(frameTime, float(vat.FrameCount));
+  int frame0 = int(floor(frame));
+  int frame1 = (frame0 + 1) % vat.FrameCount;
+  float factor = fract(frame);
+  int vertex = vat.VertexOffset + gl_VertexID;
+
+  vec3 position = mix(texelFetch(vat.Positions, TexelOf(frame0, vertex), 0).xyz,
+                      texelFetch(vat.Positions, TexelOf(frame1, vertex), 0).xyz, factor);
+  vec3 normal = aNormal;
+  if (vat.HasNormals) {
+    normal = normalize(mix(texelFetch(vat.Normals, TexelOf(frame0, vertex), 0).xyz,
+                           texelFetch(vat.Normals, TexelOf(frame1, vertex), 0).xyz, factor));
+  }
+
+  mat4 model = matrices[gl_InstanceID];
+  gl_Position = projection * view * model * vec4(position, 1.0f);
+  texCoords = vec2(aTexCoords.x, aTexCoords.y);
+  NormalVec = mat3(transpose(inverse(model))) * normal;
+  FragPos = vec3(model * vec4(position, 1.0));
+}
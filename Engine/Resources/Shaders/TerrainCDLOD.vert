@@ -0,0 +1,59 @@
+#version 460
+#extension GL_ARB_separate_shader_objects : enable
+layout(location = 0) in vec2 GridPosition;
+uniform mat4 view;
+uniform mat4 projection;
+uniform mat4 model;
+out vec4 Color;
+out vec3 WorldPos;
+out vec2 Tex;
+out vec3 outNormal;
+uniform float MinHeight;
+uniform float MaxHeight;
+
+uniform sampler2D HeightMap;
+uniform vec2 HeightMapSize;
+uniform vec2 NodeOffset;
+uniform float NodeStep;
+uniform float MorphStart;
+uniform float MorphEnd;
+uniform vec3 CameraPosition;
+uniform float WorldScale;
+uniform float TextureScale;
+uniform float TerrainSize;
+
+float SampleHeight(vec2 samplePos)
+{
+  return textureLod(HeightMap, (samplePos + 0.5) / HeightMapSize, 0.0).r;
+}
+
+vec3 GridToPosition(vec2 grid)
+{
+  vec2 samplePos = min(NodeOffset + grid * NodeStep, HeightMapSize - 1.0);
+  return vec3(samplePos.x * WorldScale, SampleHeight(samplePos), samplePos.y * WorldScale);
+}
+
+// Same math of TerrainQuadtree::EvaluateVertex, the odd vertices slide over the even ones of the coarser level
+void main()
+{
+  float distanceToCamera = distance(CameraPosition, GridToPosition(GridPosition));
+  float morph = clamp((distanceToCamera - MorphStart) / max(MorphEnd - MorphStart, 1e-4), 0.0, 1.0);
+  vec2 grid = GridPosition - fract(GridPosition * 0.5) * 2.0 * morph;
+  vec3 Position = GridToPosition(grid);
+
+  vec2 samplePos = Position.xz / WorldScale;
+  float left = SampleHeight(samplePos - vec2(NodeStep, 0.0));
+  float right = SampleHeight(samplePos + vec2(NodeStep, 0.0));
+  float down = SampleHeight(samplePos - vec2(0.0, NodeStep));
+  float up = SampleHeight(samplePos + vec2(0.0, NodeStep));
+
+  gl_Position = projection * view * model * vec4(Position, 1.0);
+
+  float DeltaHeight = MaxHeight - MinHeight;
+  float HeightRatio = (Position.y - MinHeight) / DeltaHeight;
+  float c = HeightRatio * 0.8 + 0.2;
+  Color = vec4(c, c, c, 1.0);
+  WorldPos = Position;
+  Tex = TextureScale * samplePos / TerrainSize;
+  outNormal = normalize(vec3(left - right, 2.0 * NodeStep * WorldScale, down - up));
+}
@@ -0,0 +1,103 @@
+#include "MappedFile.h"
+using namespace Yeager;
+
+#if defined(YEAGER_SYSTEM_LINUX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+  Unmap();
+}
+
+bool MappedFile::Map(const std::filesystem::path& path)
+{
+  Unmap();
+
+#if defined(YEAGER_SYSTEM_LINUX)
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    Yeager::Log(WARNING, "Cannot open file to be mapped! Path {}", path.string());
+    return false;
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size == 0) {
+    Yeager::Log(WARNING, "Cannot map empty or invalid file! Path {}", path.string());
+    close(fd);
+    return false;
+  }
+
+  void* data = mmap(YEAGER_NULLPTR, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  /* The mapping keeps its own reference to the file, the descriptor is not needed anymore */
+  close(fd);
+
+  if (data == MAP_FAILED) {
+    Yeager::Log(WARNING, "mmap failed for file {}", path.string());
+    return false;
+  }
+
+  m_Data = static_cast<const uint8_t*>(data);
+  m_Size = static_cast<size_t>(info.st_size);
+  return true;
+
+#elif defined(YEAGER_SYSTEM_WINDOWS_x64)
+  m_File = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, YEAGER_NULLPTR, OPEN_EXISTING,
+                       FILE_ATTRIBUTE_NORMAL, YEAGER_NULLPTR);
+  if (m_File == INVALID_HANDLE_VALUE) {
+    Yeager::Log(WARNING, "Cannot open file to be mapped! Path {}", path.string());
+    return false;
+  }
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(m_File, &size) || size.QuadPart == 0) {
+    Yeager::Log(WARNING, "Cannot map empty or invalid file! Path {}", path.string());
+    Unmap();
+    return false;
+  }
+
+  m_Mapping = CreateFileMappingW(m_File, YEAGER_NULLPTR, PAGE_READONLY, 0, 0, YEAGER_NULLPTR);
+  if (m_Mapping == YEAGER_NULLPTR) {
+    Yeager::Log(WARNING, "CreateFileMapping failed for file {}", path.string());
+    Unmap();
+    return false;
+  }
+
+  m_Data = static_cast<const uint8_t*>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0));
+  if (m_Data == YEAGER_NULLPTR) {
+    Yeager::Log(WARNING, "MapViewOfFile failed for file {}", path.string());
+    Unmap();
+    return false;
+  }
+  m_Size = static_cast<size_t>(size.QuadPart);
+  return true;
+#else
+  return false;
+#endif
+}
+
+void MappedFile::Unmap()
+{
+#if defined(YEAGER_SYSTEM_LINUX)
+  if (m_Data != YEAGER_NULLPTR) {
+    munmap(const_cast<uint8_t*>(m_Data), m_Size);
+  }
+#elif defined(YEAGER_SYSTEM_WINDOWS_x64)
+  if (m_Data != YEAGER_NULLPTR) {
+    UnmapViewOfFile(m_Data);
+  }
+  if (m_Mapping != YEAGER_NULLPTR) {
+    CloseHandle(m_Mapping);
+    m_Mapping = YEAGER_NULLPTR;
+  }
+  if (m_File != INVALID_HANDLE_VALUE) {
+    CloseHandle(m_File);
+    m_File = INVALID_HANDLE_VALUE;
+  }
+#endif
+  m_Data = YEAGER_NULLPTR;
+  m_Size = 0;
+}
@@ -0,0 +1,70 @@
+//    Yeager Engine, free and open source 3D/2D renderer written in OpenGL
+//    In case of questions and bugs, please, refer to the issue tab on github
+//    Repo : https://github.com/schwq/YeagerEngine
+//    Copyright (C) 2023 - Present
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Common/Utils/Common.h"
+#include "Common/Utils/LogEngine.h"
+
+namespace Yeager {
+
+/**
+    @brief Read only memory mapping of a whole file, the data stays valid until the object is destroyed or Unmap is called.
+    Binary caches are written with 8 bytes aligned sections, so structs can be reinterpreted directly from the mapped data,
+    without copying the file into the heap
+*/
+class MappedFile {
+ public:
+  MappedFile() = default;
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /**
+      @brief Maps the file at the given path, returns false and logs if the file cannot be opened or mapped 
+  */
+  bool Map(const std::filesystem::path& path);
+  void Unmap();
+
+  YEAGER_NODISCARD bool IsMapped() const { return m_Data != YEAGER_NULLPTR; }
+  YEAGER_NODISCARD const uint8_t* GetData() const { return m_Data; }
+  YEAGER_NODISCARD size_t GetSize() const { return m_Size; }
+
+  /**
+      @brief Returns a pointer to a struct at the given offset of the file, or nullptr if it does not fit inside the mapping 
+  */
+  template <typename T>
+  YEAGER_NODISCARD const T* At(uint64_t offset, size_t count = 1) const
+  {
+    /* Written so a corrupted offset or count cannot overflow past the check */
+    if (!IsMapped() || offset > m_Size || count > (m_Size - offset) / sizeof(T))
+      return YEAGER_NULLPTR;
+    return reinterpret_cast<const T*>(m_Data + offset);
+  }
+
+ private:
+  const uint8_t* m_Data = YEAGER_NULLPTR;
+  size_t m_Size = 0;
+#if defined(YEAGER_SYSTEM_WINDOWS_x64)
+  HANDLE m_File = INVALID_HANDLE_VALUE;
+  HANDLE m_Mapping = YEAGER_NULLPTR;
+#endif
+};
+
+}  // namespace Yeager
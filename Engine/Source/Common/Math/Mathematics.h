@@ -145,44 +145,68 @@ Type LeastCommonMultiple(const std::vector<Type>& list)
   return maxValue;
 }
 
+/* Every Array2D starts at this alignment, the pitched layout also aligns each row to it */
+#define YEAGER_ARRAY2D_ALIGNMENT 64
+/* Side of the blocks of the tiled layout is 1 << YEAGER_ARRAY2D_TILE_SHIFT elements */
+#define YEAGER_ARRAY2D_TILE_SHIFT 3
+#define YEAGER_ARRAY2D_TILE_SIZE (1 << YEAGER_ARRAY2D_TILE_SHIFT)
+
+/**
+ * Memory layout of the Array2D.
+ * Linear keeps the rows packed one after another, the whole array is a single contiguous block (the default, and what
+ * code reading the array as a flat pointer expects).
+ * Pitched aligns every row to YEAGER_ARRAY2D_ALIGNMENT, and breaks pitches multiple of 4 KB that make the rows of a
+ * column fight for the same cache sets. Rows are still contiguous, GetPitch gives the distance between them.
+ * Tiled stores blocks of YEAGER_ARRAY2D_TILE_SIZE x YEAGER_ARRAY2D_TILE_SIZE elements, walking a column touches
+ * neighbour memory like walking a row does. Only single elements are contiguous, rows cannot be read as pointers
+ */
+struct Array2DLayout {
+  enum Enum { eLINEAR, eLINEAR_PITCHED, eTILED };
+};
+
+template <typename Type>
+class Array2DView;
+template <typename Type>
+class Array2DLine;
+
 template <typename Type>
 class Array2D {
  public:
   Array2D() {}
-  Array2D(int Cols, int Rows)
-  {
-    m_Rows = Rows;
-    m_Cols = Cols;
-
-    if (m_Pointer) {
-      free(m_Pointer);
-    }
-
-    m_Pointer = (Type*)malloc(Cols * Rows * sizeof(Type));
-  }
+  Array2D(int Cols, int Rows, Array2DLayout::Enum Layout = Array2DLayout::eLINEAR) { Allocate(Cols, Rows, Layout); }
 
   Type DirectAccess(int index) { return m_Pointer[index]; }
 
-  Array2D(int Cols, int Rows, Type InitValue)
+  Array2D(int Cols, int Rows, Type InitValue, Array2DLayout::Enum Layout = Array2DLayout::eLINEAR)
   {
-    m_Rows = Rows;
-    m_Cols = Cols;
-
-    if (m_Pointer) {
-      free(m_Pointer);
-    }
-
-    m_Pointer = (Type*)malloc(Cols * Rows * sizeof(Type));
-    for (int x = 0; x < Cols * Rows; x++) {
+    Allocate(Cols, Rows, Layout);
+    for (size_t x = 0; x < m_Capacity; x++) {
       m_Pointer[x] = InitValue;
     }
   }
 
-  ~Array2D()
+  ~Array2D() { Free(); }
+
+  Array2D(const Array2D&) = delete;
+  Array2D& operator=(const Array2D&) = delete;
+
+  Array2D(Array2D&& other) noexcept { *this = std::move(other); }
+  Array2D& operator=(Array2D&& other) noexcept
   {
-    if (m_Pointer) {
-      free(m_Pointer);
+    if (this != &other) {
+      Free();
+      m_Cols = other.m_Cols;
+      m_Rows = other.m_Rows;
+      m_Pitch = other.m_Pitch;
+      m_TilesPerRow = other.m_TilesPerRow;
+      m_Capacity = other.m_Capacity;
+      m_Layout = other.m_Layout;
+      m_Pointer = other.m_Pointer;
+      other.m_Cols = other.m_Rows = other.m_Pitch = 0;
+      other.m_TilesPerRow = other.m_Capacity = 0;
+      other.m_Pointer = YEAGER_NULLPTR;
     }
+    return *this;
   }
 
   constexpr inline Type& At(int Col, int Row)
@@ -190,6 +214,7 @@ class Array2D {
     size_t Index = CalculateIndex(Col, Row);
     return m_Pointer[Index];
   }
+  constexpr inline const Type& At(int Col, int Row) const { return m_Pointer[CalculateIndex(Col, Row)]; }
 
   constexpr inline void Set(int Col, int Row, const Type& val) { *GetAddr(Col, Row) = val; }
 
@@ -200,7 +225,43 @@ class Array2D {
   }
 
   constexpr inline int GetSize() { return m_Cols * m_Rows; }
+  /** In the linear layouts the address is the start of a contiguous run until the end of the row */
   constexpr inline Type* GetAddress(int Col, int Row) { return &m_Pointer[CalculateIndex(Col, Row)]; }
+  constexpr inline const Type* GetAddress(int Col, int Row) const { return &m_Pointer[CalculateIndex(Col, Row)]; }
+
+  constexpr inline int GetCols() const { return m_Cols; }
+  constexpr inline int GetRows() const { return m_Rows; }
+  /** Elements between the start of two rows, only meaningful in the linear layouts */
+  constexpr inline int GetPitch() const { return m_Pitch; }
+  constexpr inline Array2DLayout::Enum GetLayout() const { return m_Layout; }
+  constexpr inline bool IsLinear() const { return m_Layout != Array2DLayout::eTILED; }
+  /** True when the elements are a single block of cols x rows, the array can be read as a flat pointer */
+  constexpr inline bool IsPacked() const { return IsLinear() && m_Pitch == m_Cols; }
+
+  /** Calls func(Type& value, int col, int row) for every element, in the order the memory stores them */
+  template <typename Func>
+  void ForEach(Func&& func)
+  {
+    if (IsLinear()) {
+      for (int Row = 0; Row < m_Rows; Row++) {
+        Type* Line = &m_Pointer[static_cast<size_t>(Row) * m_Pitch];
+        for (int Col = 0; Col < m_Cols; Col++) {
+          func(Line[Col], Col, Row);
+        }
+      }
+      return;
+    }
+    for (int TileRow = 0; TileRow < m_Rows; TileRow += YEAGER_ARRAY2D_TILE_SIZE) {
+      for (int TileCol = 0; TileCol < m_Cols; TileCol += YEAGER_ARRAY2D_TILE_SIZE) {
+        for (int Row = TileRow; Row < std::min(TileRow + YEAGER_ARRAY2D_TILE_SIZE, m_Rows); Row++) {
+          for (int Col = TileCol; Col < std::min(TileCol + YEAGER_ARRAY2D_TILE_SIZE, m_Cols); Col++) {
+            func(At(Col, Row), Col, Row);
+          }
+        }
+      }
+    }
+  }
+
   void Normalize(Type MinRange, Type MaxRange)
   {
     Type Min, Max;
@@ -212,36 +273,167 @@ class Array2D {
 
     Type MinMaxDelta = Max - Min;
     Type MinMaxRange = MaxRange - MinRange;
-    for (int x = 0; x < m_Rows * m_Cols; x++) {
-      m_Pointer[x] = ((m_Pointer[x] - Min) / MinMaxDelta) * MinMaxRange + MinRange;
-    }
+    ForEach([&](Type& value, int, int) { value = ((value - Min) / MinMaxDelta) * MinMaxRange + MinRange; });
   }
 
   const Type& Get(int Col, int Row) { return *GetAddr(Col, Row); }
 
+  /** Copies the elements of another array of the same size, whatever the layouts of both */
+  void CopyFrom(const Array2D& other)
+  {
+    ForEach([&](Type& value, int Col, int Row) { value = other.At(Col, Row); });
+  }
+
+  Array2DView<Type> GetView(int Col, int Row, int Cols, int Rows)
+  {
+    return Array2DView<Type>(this, Col, Row, Cols, Rows);
+  }
+  Array2DView<Type> GetView() { return Array2DView<Type>(this, 0, 0, m_Cols, m_Rows); }
+  Array2DLine<Type> GetRow(int Row) { return Array2DLine<Type>(this, 0, Row, 1, 0, m_Cols); }
+  Array2DLine<Type> GetColumn(int Col) { return Array2DLine<Type>(this, Col, 0, 0, 1, m_Rows); }
+
  private:
-  size_t CalculateIndex(int Col, int Row)
+  void Allocate(int Cols, int Rows, Array2DLayout::Enum Layout)
   {
-    size_t Index = Row * m_Cols + Col;
-    return Index;
+    m_Rows = Rows;
+    m_Cols = Cols;
+    m_Layout = Layout;
+    m_Pitch = Cols;
+
+    if (Layout == Array2DLayout::eLINEAR_PITCHED && YEAGER_ARRAY2D_ALIGNMENT % sizeof(Type) == 0) {
+      const size_t Bytes = (Cols * sizeof(Type) + YEAGER_ARRAY2D_ALIGNMENT - 1) & ~size_t(YEAGER_ARRAY2D_ALIGNMENT - 1);
+      m_Pitch = (Bytes % 4096 == 0 ? Bytes + YEAGER_ARRAY2D_ALIGNMENT : Bytes) / sizeof(Type);
+    }
+
+    if (Layout == Array2DLayout::eTILED) {
+      m_TilesPerRow = (Cols + YEAGER_ARRAY2D_TILE_SIZE - 1) >> YEAGER_ARRAY2D_TILE_SHIFT;
+      const size_t TileRows = (Rows + YEAGER_ARRAY2D_TILE_SIZE - 1) >> YEAGER_ARRAY2D_TILE_SHIFT;
+      m_Capacity = m_TilesPerRow * TileRows * YEAGER_ARRAY2D_TILE_SIZE * YEAGER_ARRAY2D_TILE_SIZE;
+    } else {
+      m_Capacity = static_cast<size_t>(m_Pitch) * Rows;
+    }
+
+    m_Pointer = static_cast<Type*>(
+        ::operator new(std::max<size_t>(m_Capacity, 1) * sizeof(Type), std::align_val_t(YEAGER_ARRAY2D_ALIGNMENT)));
+  }
+
+  void Free()
+  {
+    if (m_Pointer) {
+      ::operator delete(m_Pointer, std::align_val_t(YEAGER_ARRAY2D_ALIGNMENT));
+      m_Pointer = YEAGER_NULLPTR;
+    }
+  }
+
+  constexpr size_t CalculateIndex(int Col, int Row) const
+  {
+    if (m_Layout != Array2DLayout::eTILED) {
+      return static_cast<size_t>(Row) * m_Pitch + Col;
+    }
+    const size_t Tile = static_cast<size_t>(Row >> YEAGER_ARRAY2D_TILE_SHIFT) * m_TilesPerRow +
+                        (Col >> YEAGER_ARRAY2D_TILE_SHIFT);
+    const int Mask = YEAGER_ARRAY2D_TILE_SIZE - 1;
+    return (Tile << (YEAGER_ARRAY2D_TILE_SHIFT * 2)) + ((Row & Mask) << YEAGER_ARRAY2D_TILE_SHIFT) + (Col & Mask);
   }
 
   void GetMinMax(Type& Min, Type& Max)
   {
-    Max = Min = m_Pointer[0];
-    for (int x = 0; x < m_Rows * m_Cols; x++) {
-      if (m_Pointer[x] < Min) {
-        Min = m_Pointer[x];
+    Max = Min = At(0, 0);
+    ForEach([&](Type& value, int, int) {
+      if (value < Min) {
+        Min = value;
       }
-      if (m_Pointer[x] > Max) {
-        Max = m_Pointer[x];
+      if (value > Max) {
+        Max = value;
       }
-    }
+    });
   }
 
   int m_Cols = 0;
   int m_Rows = 0;
+  int m_Pitch = 0;
+  size_t m_TilesPerRow = 0;
+  size_t m_Capacity = 0;
+  Array2DLayout::Enum m_Layout = Array2DLayout::eLINEAR;
   Type* m_Pointer = YEAGER_NULLPTR;
 };
+
+/**
+ * Walks a row or a column of an Array2D (or of a view), steps of (StepCol, StepRow) from the first element.
+ * Works in every layout, for (float& value : array.GetColumn(x))
+ */
+template <typename Type>
+class Array2DLine {
+ public:
+  class Iterator {
+   public:
+    Iterator(Array2D<Type>* array, int col, int row, int stepCol, int stepRow)
+        : m_Array(array), m_Col(col), m_Row(row), m_StepCol(stepCol), m_StepRow(stepRow)
+    {}
+    Type& operator*() const { return m_Array->At(m_Col, m_Row); }
+    Iterator& operator++()
+    {
+      m_Col += m_StepCol;
+      m_Row += m_StepRow;
+      return *this;
+    }
+    bool operator!=(const Iterator& other) const { return m_Col != other.m_Col || m_Row != other.m_Row; }
+
+   private:
+    Array2D<Type>* m_Array;
+    int m_Col, m_Row, m_StepCol, m_StepRow;
+  };
+
+  Array2DLine(Array2D<Type>* array, int col, int row, int stepCol, int stepRow, int count)
+      : m_Array(array), m_Col(col), m_Row(row), m_StepCol(stepCol), m_StepRow(stepRow), m_Count(count)
+  {}
+
+  Iterator begin() const { return Iterator(m_Array, m_Col, m_Row, m_StepCol, m_StepRow); }
+  Iterator end() const
+  {
+    return Iterator(m_Array, m_Col + m_StepCol * m_Count, m_Row + m_StepRow * m_Count, m_StepCol, m_StepRow);
+  }
+  Type& operator[](int index) const { return m_Array->At(m_Col + m_StepCol * index, m_Row + m_StepRow * index); }
+  int GetCount() const { return m_Count; }
+
+ private:
+  Array2D<Type>* m_Array;
+  int m_Col, m_Row, m_StepCol, m_StepRow, m_Count;
+};
+
+/**
+ * Sub region of an Array2D, positions are relative to the first element of the region. Does not own the array, the
+ * array must outlive the view
+ */
+template <typename Type>
+class Array2DView {
+ public:
+  Array2DView(Array2D<Type>* array, int col, int row, int cols, int rows)
+      : m_Array(array), m_Col(col), m_Row(row), m_Cols(cols), m_Rows(rows)
+  {}
+
+  Type& At(int Col, int Row) const { return m_Array->At(m_Col + Col, m_Row + Row); }
+  void Set(int Col, int Row, const Type& val) const { At(Col, Row) = val; }
+
+  int GetCols() const { return m_Cols; }
+  int GetRows() const { return m_Rows; }
+  int GetCol() const { return m_Col; }
+  int GetRow() const { return m_Row; }
+  Array2D<Type>* GetArray() const { return m_Array; }
+
+  Array2DView SubView(int Col, int Row, int Cols, int Rows) const
+  {
+    return Array2DView(m_Array, m_Col + Col, m_Row + Row, Cols, Rows);
+  }
+  Array2DLine<Type> GetRowLine(int Row) const { return Array2DLine<Type>(m_Array, m_Col, m_Row + Row, 1, 0, m_Cols); }
+  Array2DLine<Type> GetColumnLine(int Col) const
+  {
+    return Array2DLine<Type>(m_Array, m_Col + Col, m_Row, 0, 1, m_Rows);
+  }
+
+ private:
+  Array2D<Type>* m_Array;
+  int m_Col, m_Row, m_Cols, m_Rows;
+};
 }  // namespace Math
 }  // namespace Yeager
\ No newline at end of file
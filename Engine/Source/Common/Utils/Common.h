@@ -104,6 +104,19 @@
 #define YEAGER_NODISCARD
 #endif
 
+/* SSE2 is always available in x86-64, code with SIMD paths falls back to scalar when this is not defined */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define YEAGER_SIMD_SSE2
+#endif
+
+/* Compiles a single function for a newer instruction set (avx2, sse4.1) than the rest of the engine, the caller must
+ * check the hardware support at runtime before calling it. MSVC accepts the intrinsics without it */
+#if defined(YEAGER_SIMD_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define YEAGER_SIMD_TARGET(isa) __attribute__((target(isa)))
+#else
+#define YEAGER_SIMD_TARGET(isa)
+#endif
+
 #define YEAGER_NULL_LITERAL "NULL"
 #define YEAGER_EMPTY_LITERAL ""
 #define YEAGER_NULLPTR nullptr
@@ -23,3 +23,43 @@ Uint Yeager::GetHardwareThreadCount()
 #error "Yeager Engine build cannot find the processors thread count on the hardware!"
 #endif
 #endif
+
+#if defined(YEAGER_SIMD_SSE2) && (defined(__GNUC__) || defined(__clang__))
+bool Yeager::HardwareSupportsSSE41()
+{
+  return __builtin_cpu_supports("sse4.1");
+}
+
+bool Yeager::HardwareSupportsAVX2()
+{
+  return __builtin_cpu_supports("avx2");
+}
+#elif defined(YEAGER_SIMD_SSE2) && defined(YEAGER_SYSTEM_WINDOWS_x64)
+#include <intrin.h>
+bool Yeager::HardwareSupportsSSE41()
+{
+  int info[4];
+  __cpuid(info, 1);
+  return (info[2] & (1 << 19)) != 0;
+}
+
+bool Yeager::HardwareSupportsAVX2()
+{
+  int info[4];
+  __cpuid(info, 1);
+  /* AVX needs the OS to save the YMM registers (OSXSAVE and XCR0) */
+  const bool osSaves = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+  __cpuidex(info, 7, 0);
+  return osSaves && (info[1] & (1 << 5)) != 0;
+}
+#else
+bool Yeager::HardwareSupportsSSE41()
+{
+  return false;
+}
+
+bool Yeager::HardwareSupportsAVX2()
+{
+  return false;
+}
+#endif
@@ -24,4 +24,8 @@ namespace Yeager {
 
 extern Uint GetHardwareThreadCount();
 
+/* Instruction sets checked at runtime, used to pick the SIMD path of the noise and skinning code */
+extern bool HardwareSupportsSSE41();
+extern bool HardwareSupportsAVX2();
+
 }  // namespace Yeager
\ No newline at end of file
@@ -7,4 +7,53 @@ PointerTypeStats BaseAllocator::sWeakPointersCreated;
 
 GeneralMemoryAllocationStats BaseAllocator::sGenMemoryStats;
 
-std::unordered_map<void*, std::size_t> BaseAllocator::mPointersInUse;
\ No newline at end of file
+std::unordered_map<void*, std::size_t> BaseAllocator::mPointersInUse;
+MemoryTagStats BaseAllocator::sTagStats[MemoryTag::eCOUNT];
+
+const char* MemoryTag::ToString(Enum tag)
+{
+  switch (tag) {
+    case eGENERAL:
+      return "General";
+    case ePHYSX:
+      return "PhysX";
+    default:
+      return "Unknown";
+  }
+}
+
+void* BaseAllocator::AllocateAligned(std::size_t bytes, std::size_t alignment, MemoryTag::Enum tag)
+{
+  void* ptr = ::operator new(bytes, std::align_val_t(alignment), std::nothrow);
+  if (!ptr) {
+    Yeager::Log(ERROR, "Cannot allocate {} bytes of {} memory!", bytes, MemoryTag::ToString(tag));
+    return YEAGER_NULLPTR;
+  }
+
+  MemoryTagStats& stats = sTagStats[tag];
+  stats.mAllocations.fetch_add(1, std::memory_order_relaxed);
+  RaisePeak(stats.mPeakBytes, stats.mLiveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+
+#ifdef DEBUG_MEM
+  Yeager::LogDebug(INFO, "Successful allocated aligned size {}, located {}", bytes, fmt::ptr(ptr));
+#endif
+
+  return ptr;
+}
+
+void BaseAllocator::DeallocateAligned(void* ptr, std::size_t bytes, std::size_t alignment,
+                                      MemoryTag::Enum tag) noexcept
+{
+  if (!ptr) {
+    return;
+  }
+  MemoryTagStats& stats = sTagStats[tag];
+  stats.mDeallocations.fetch_add(1, std::memory_order_relaxed);
+  stats.mLiveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+
+#ifdef DEBUG_MEM
+  Yeager::LogDebug(INFO, "Successful deallocated aligned size {}, located {}", bytes, fmt::ptr(ptr));
+#endif
+
+  ::operator delete(ptr, std::align_val_t(alignment));
+}
@@ -22,6 +22,9 @@
 #include "Common/Utils/LogEngine.h"
 #include "Common/Utils/Utilities.h"
 
+#include <atomic>
+#include <new>
+
 namespace Yeager {
 
 struct PointerTypeStats {
@@ -41,6 +44,21 @@ struct GeneralMemoryAllocationStats {
   const std::size_t DiffOfBytes() noexcept { return mBytesAllocated - mBytesDeallocated; }
 };
 
+/// @brief Owner of the memory given by AllocateAligned, the stats are kept apart for each tag
+struct MemoryTag {
+  enum Enum { eGENERAL, ePHYSX, eCOUNT };
+
+  static const char* ToString(Enum tag);
+};
+
+/// @brief Counters of a memory tag, written by any thread
+struct MemoryTagStats {
+  std::atomic<std::size_t> mLiveBytes = 0;
+  std::atomic<std::size_t> mPeakBytes = 0;
+  std::atomic<uint64_t> mAllocations = 0;
+  std::atomic<uint64_t> mDeallocations = 0;
+};
+
 class BaseAllocator {
  public:
   template <typename T>
@@ -104,6 +122,26 @@ class BaseAllocator {
     return ptr;
   }
 
+  /**
+   * @brief Aligned memory of the tag. Unlike Allocate, no map of the pointers is kept, the caller gives the size back
+   * in DeallocateAligned. Safe to call from any thread, the PhysX workers allocate through it
+   */
+  static void* AllocateAligned(std::size_t bytes, std::size_t alignment, MemoryTag::Enum tag);
+  static void DeallocateAligned(void* ptr, std::size_t bytes, std::size_t alignment, MemoryTag::Enum tag) noexcept;
+
+  YEAGER_NODISCARD static const MemoryTagStats& GetTagStats(MemoryTag::Enum tag) { return sTagStats[tag]; }
+
+  /**
+   * @brief Raises the peak to the live bytes when they are higher, safe from any thread. Every peak counter of the
+   * allocators goes through it
+   */
+  static YEAGER_FORCE_INLINE void RaisePeak(std::atomic<std::size_t>& peak, std::size_t live)
+  {
+    /* Almost always below the peak, only the load is paid */
+    std::size_t current = peak.load(std::memory_order_relaxed);
+    while (live > current && !peak.compare_exchange_weak(current, live, std::memory_order_relaxed)) {}
+  }
+
   template <typename T>
   static void Destroy(T* ptr) noexcept
   {
@@ -164,6 +202,7 @@ class BaseAllocator {
 
  private:
   static std::unordered_map<void*, std::size_t> mPointersInUse;
+  static MemoryTagStats sTagStats[MemoryTag::eCOUNT];
 };
 
 }  // namespace Yeager
\ No newline at end of file
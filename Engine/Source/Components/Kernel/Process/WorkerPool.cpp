@@ -0,0 +1,118 @@
+#include "WorkerPool.h"
+using namespace Yeager;
+
+WorkerPool::WorkerPool(Uint workers)
+{
+  for (Uint x = 0; x < workers; x++) {
+    m_Workers.emplace_back([this] { WorkerLoop(); });
+  }
+  Yeager::LogDebug(INFO, "Created worker pool with {} workers", workers);
+}
+
+WorkerPool::~WorkerPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Stopping = true;
+  }
+  m_Condition.notify_all();
+  for (auto& worker : m_Workers) {
+    if (worker.joinable())
+      worker.join();
+  }
+}
+
+WorkerPool* WorkerPool::GetGlobal()
+{
+  static WorkerPool pool(std::max<Uint>(1, std::thread::hardware_concurrency()) - 1);
+  return &pool;
+}
+
+void WorkerPool::Submit(Task task, TaskPriority::Enum priority)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Tasks[priority].push_back(std::move(task));
+  }
+  m_Condition.notify_one();
+}
+
+void WorkerPool::WorkerLoop()
+{
+  while (true) {
+    Task task;
+    {
+      std::unique_lock<std::mutex> lock(m_Mutex);
+      std::deque<Task>* queue = YEAGER_NULLPTR;
+      m_Condition.wait(lock, [this, &queue] {
+        for (std::deque<Task>& tasks : m_Tasks) {
+          if (!tasks.empty()) {
+            queue = &tasks;
+            return true;
+          }
+        }
+        return m_Stopping;
+      });
+      if (!queue)
+        return;
+      task = std::move(queue->front());
+      queue->pop_front();
+    }
+    task();
+  }
+}
+
+/* Shared between the caller and the helper tasks, helpers may still be queued after the caller returned */
+struct ParallelForState {
+  size_t Begin = 0;
+  size_t End = 0;
+  size_t Grain = 1;
+  size_t Chunks = 0;
+  const WorkerPool::RangeFunction* Function = YEAGER_NULLPTR;
+  std::atomic<size_t> NextChunk = 0;
+  std::atomic<size_t> DoneChunks = 0;
+  std::mutex Mutex;
+  std::condition_variable Done;
+
+  void RunChunks()
+  {
+    size_t chunk;
+    while ((chunk = NextChunk.fetch_add(1)) < Chunks) {
+      const size_t begin = Begin + chunk * Grain;
+      (*Function)(begin, std::min(End, begin + Grain));
+      if (DoneChunks.fetch_add(1) + 1 == Chunks) {
+        std::lock_guard<std::mutex> lock(Mutex);
+        Done.notify_all();
+      }
+    }
+  }
+};
+
+void WorkerPool::ParallelFor(size_t begin, size_t end, size_t grain, const RangeFunction& function)
+{
+  if (end <= begin)
+    return;
+
+  grain = std::max<size_t>(1, grain);
+  const size_t chunks = (end - begin + grain - 1) / grain;
+  if (chunks == 1 || m_Workers.empty()) {
+    function(begin, end);
+    return;
+  }
+
+  auto state = std::make_shared<ParallelForState>();
+  state->Begin = begin;
+  state->End = end;
+  state->Grain = grain;
+  state->Chunks = chunks;
+  state->Function = &function;
+
+  const size_t helpers = std::min<size_t>(m_Workers.size(), chunks - 1);
+  for (size_t x = 0; x < helpers; x++) {
+    Submit([state] { state->RunChunks(); });
+  }
+  state->RunChunks();
+
+  std::unique_lock<std::mutex> lock(state->Mutex);
+  state->Done.wait(lock, [&] { return state->DoneChunks.load() == state->Chunks; });
+}
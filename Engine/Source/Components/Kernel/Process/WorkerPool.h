@@ -0,0 +1,83 @@
+//    Yeager Engine, free and open source 3D/2D renderer written in OpenGL
+//    In case of questions and bugs, please, refer to the issue tab on github
+//    Repo : https://github.com/schwq/YeagerEngine
+//    Copyright (C) 2023 - Present
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Common/Utils/Common.h"
+#include "Common/Utils/LogEngine.h"
+#include "Common/Utils/Utilities.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace Yeager {
+
+/// @brief Order the workers take the queued tasks in, the tasks of a higher priority run first
+struct TaskPriority {
+  /* eHIGH is for the work the frame is waiting on (the PhysX step), eLOW for the streaming in the background */
+  enum Enum { eHIGH, eNORMAL, eLOW, eCOUNT };
+};
+
+/**
+ * @brief Fixed group of worker threads running small CPU tasks (mesh builds, noise, skinning). Unlike the threads of
+ * ThreadManagement, the workers live for the whole program and tasks are queued to them.
+ * ParallelFor blocks the calling thread, which also runs chunks of the range, so it is safe to call from inside a task.
+ * The tasks are queued by priority, a worker always takes the oldest task of the highest priority waiting
+ */
+class WorkerPool {
+ public:
+  using Task = std::function<void()>;
+  using RangeFunction = std::function<void(size_t begin, size_t end)>;
+
+  explicit WorkerPool(Uint workers);
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  void Submit(Task task, TaskPriority::Enum priority = TaskPriority::eNORMAL);
+
+  /**
+   * @brief Splits [begin, end) in chunks of grain elements and runs function over each chunk in the workers, returns
+   * once every chunk is done. Which thread runs a chunk changes between calls, the function must only write data of
+   * its own chunk for the result to be deterministic
+   */
+  void ParallelFor(size_t begin, size_t end, size_t grain, const RangeFunction& function);
+
+  YEAGER_NODISCARD Uint GetWorkersCount() const { return m_Workers.size(); }
+  /* Workers plus the thread calling ParallelFor */
+  YEAGER_NODISCARD Uint GetConcurrency() const { return m_Workers.size() + 1; }
+
+  /**
+   * @brief The pool shared by the engine, created on the first use with one worker less than the hardware threads
+   */
+  static WorkerPool* GetGlobal();
+
+ private:
+  void WorkerLoop();
+
+  std::vector<std::thread> m_Workers;
+  std::deque<Task> m_Tasks[TaskPriority::eCOUNT];
+  std::mutex m_Mutex;
+  std::condition_variable m_Condition;
+  bool m_Stopping = false;
+};
+
+}  // namespace Yeager
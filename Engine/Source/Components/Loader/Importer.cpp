@@ -67,9 +67,14 @@ ObjectModelData Importer::Import(Cchar path, const ObjectCreationConfiguration c
   return data;
 }
 
-ObjectModelData Importer::ImportToPhysX(Cchar path, physx::PxRigidActor* actor, bool flip_image, Uint assimp_flags)
+ObjectModelData Importer::ImportToPhysX(Cchar path, physx::PxRigidActor* actor, bool flip_image, Uint assimp_flags,
+                                        const PhysXMeshCollisionSettings& collision)
 {
   m_ImageFlip = flip_image;
+  m_PhysXCollision = collision;
+  if (actor->is<PxRigidDynamic>() && collision.Type == PhysXMeshCollisionType::eTRIANGLE_MESH) {
+    Yeager::Log(WARNING, "Triangle mesh collision of {} on a dynamic actor, it only works for kinematic actors!", path);
+  }
   ObjectModelData data;
   Assimp::Importer imp;
   const aiScene* scene = imp.ReadFile(path, assimp_flags);
@@ -79,6 +84,11 @@ ObjectModelData Importer::ImportToPhysX(Cchar path, physx::PxRigidActor* actor,
   }
   m_FullPath = path;
   ProcessPhysXNode(actor, scene->mRootNode, scene, &data);
+  /* PhysX has no mass for the triangle meshes */
+  PxRigidDynamic* dynamic = actor->is<PxRigidDynamic>();
+  if (dynamic && collision.Type != PhysXMeshCollisionType::eTRIANGLE_MESH) {
+    PxRigidBodyExt::updateMassAndInertia(*dynamic, 1.0f);
+  }
   data.SuccessfulLoaded = true;
   return data;
 }
@@ -154,14 +164,44 @@ ObjectMeshData Importer::ProcessPhysXMesh(physx::PxRigidActor* actor, aiMesh* me
         LoadMaterialTexture(material, aiTextureType_DIFFUSE_ROUGHNESS, "texture_roughness", data);
     textures.insert(textures.end(), roughnessMaps.begin(), roughnessMaps.end());
   }
-  PxMaterial* material = m_Application->GetPhysXHandle()->GetPxPhysics()->createMaterial(1.0f, 1.0f, 1.0f);
-  PxShape* shape = m_Application->GetPhysXHandle()->GetPxPhysics()->createShape(
-      PxTriangleMeshGeometry(m_Application->GetPhysXHandle()->GetGeometryHandle()->CreateTriangleMesh(
+  /* The reference is kept by the mesh for as long as the model is loaded, all the meshes share the material */
+  PhysXHandle* physics = m_Application->GetPhysXHandle();
+  PxMaterial* material = physics->GetMaterialCache()->Acquire(YEAGER_PHYSX_MESH_MATERIAL);
+  std::vector<PxGeometryHolder> geometries;
+  switch (m_PhysXCollision.Type) {
+    case PhysXMeshCollisionType::eTRIANGLE_MESH:
+      geometries.emplace_back(PxTriangleMeshGeometry(physics->GetGeometryHandle()->CreateTriangleMesh(
           mesh->mNumVertices, mesh->mNumFaces, sizeof(PxVec3), sizeof(GLuint) * 3, &PhysxVertices[0],
-          (PxU32*)&indices[0])),
-      *material);
-  actor->attachShape(*shape);
-  shape->release();
+          (PxU32*)&indices[0])));
+      break;
+    case PhysXMeshCollisionType::eCONVEX_HULL:
+      if (PxConvexMesh* convex = physics->GetGeometryHandle()->CreateConvexMesh(
+              PhysxVertices, m_PhysXCollision.VertexLimit, m_PhysXCollision.Inflation)) {
+        geometries.emplace_back(PxConvexMeshGeometry(convex));
+      }
+      break;
+    case PhysXMeshCollisionType::eCONVEX_DECOMPOSITION: {
+      PhysXTriangleMeshInput input;
+      input.Vertices = PhysxVertices;
+      input.Indices.assign(indices.begin(), indices.end());
+      for (PxConvexMesh* convex :
+           physics->GetGeometryHandle()->CreateConvexDecomposition(input, m_PhysXCollision.Decomposition)) {
+        geometries.emplace_back(PxConvexMeshGeometry(convex));
+      }
+    } break;
+  }
+  if (geometries.empty()) {
+    Yeager::Log(ERROR, "Cannot create the PhysX collision of a mesh of {}", m_FullPath);
+  }
+  /* The shapes keep their own reference of the meshes */
+  for (PxGeometryHolder& geometry : geometries) {
+    PxShape* shape = physics->GetPxPhysics()->createShape(geometry.any(), *material);
+    actor->attachShape(*shape);
+    shape->release();
+    if (geometry.getType() == PxGeometryType::eCONVEXMESH) {
+      geometry.convexMesh().convexMesh->release();
+    }
+  }
 
   return ObjectMeshData(indices, vertices, textures);
 }
@@ -21,6 +21,7 @@
 #include "Common/Utils/Common.h"
 #include "Common/Utils/LogEngine.h"
 #include "Common/Utils/Utilities.h"
+#include "Components/Physics/PhysXConvexDecomposition.h"
 #include "Components/Physics/PhysXHandle.h"
 #include "Components/Renderer/Objects/Object.h"
 #include "Components/Renderer/Texture/TextureHandle.h"
@@ -71,8 +72,13 @@ class Importer {
   AnimatedObjectModelData ImportAnimated(
       Cchar path, const ObjectCreationConfiguration configuration = ObjectCreationConfiguration(),
       bool flip_image = false, Uint assimp_flags = YEAGER_ASSIMP_DEFAULT_FLAGS_ANIMATED);
+  /**
+   * Attaches the collision of every mesh of the model to the actor. A dynamic actor needs convex collision, a single
+   * hull or the decomposition of each mesh, its mass and inertia are then computed from the shapes
+   */
   ObjectModelData ImportToPhysX(Cchar path, physx::PxRigidActor* actor, bool flip_image = false,
-                                Uint assimp_flags = YEAGER_ASSIMP_DEFAULT_FLAGS);
+                                Uint assimp_flags = YEAGER_ASSIMP_DEFAULT_FLAGS,
+                                const PhysXMeshCollisionSettings& collision = PhysXMeshCollisionSettings());
 
   static Uint GetModelsCount() { return m_ImportedModelsCount; };
 
@@ -97,6 +103,7 @@ class Importer {
   static Uint m_ImportedModelsCount;
   ApplicationCore* m_Application = YEAGER_NULLPTR;
   ObjectCreationConfiguration m_CreationConfiguration;
+  PhysXMeshCollisionSettings m_PhysXCollision;
   String m_FullPath;
   String m_Source;
   bool m_ImageFlip = false;
@@ -13,6 +13,14 @@ PhysXActor::PhysXActor(Yeager::ApplicationCore* application, Yeager::Object* obj
 
 PhysXActor::~PhysXActor()
 {
+  /* The handle is gone when the scene is terminated after the engine */
+  PhysXHandle* handle = m_Application->GetPhysXHandle();
+  if (m_PoseIndex != YEAGER_PHYSX_NO_POSE && handle != YEAGER_NULLPTR && handle->IsInitialized()) {
+    handle->UnregisterDynamicActor(m_Actor, m_PoseIndex);
+  }
+  if (m_Material && handle != YEAGER_NULLPTR && handle->GetMaterialCache() != YEAGER_NULLPTR) {
+    handle->GetMaterialCache()->Release(m_Material);
+  }
   Yeager::LogDebug(INFO, "Destroryed physx actor for object {} UUID {}", m_Object->GetName(),
                    uuids::to_string(m_Object->GetEntityUUID()));
 }
@@ -29,16 +37,21 @@ void PhysXActor::BuildActor(const ObjectPhysXCreationBase& creation)
   if (creation.Type == ObjectPhysicsType::eUNDEFINED)
     return;  // No physics linked to the object
 
-  m_Material = m_Application->GetPhysXHandle()->GetPxPhysics()->createMaterial(0.1f, 0.1f, 0.1f);
+  PhysXMaterialCache* materials = m_Application->GetPhysXHandle()->GetMaterialCache();
+  if (m_Material) {
+    materials->Release(m_Material);
+  }
+  m_MaterialName = creation.Material;
+  m_Material = materials->Acquire(m_MaterialName);
 
+  /* The body starts with the rotation of the object, the poses written back are the rotation of the body */
+  const physx::PxTransform pose(creation.Position, EulerDegreesToPxQuat(PxVec3ToVector3(creation.Rotation)));
   switch (m_Object->GetGeometry()) {
     case ObjectGeometryType::eCUBE: {
-      m_Actor = physics->CreatePrimitiveBox(rigid, *m_Material, physx::PxTransform(creation.Position),
-                                            physx::PxVec3(creation.Scale));
+      m_Actor = physics->CreatePrimitiveBox(rigid, *m_Material, pose, physx::PxVec3(creation.Scale));
     } break;
     case ObjectGeometryType::eSPHERE: {
-      m_Actor =
-          physics->CreatePrimitiveSphere(rigid, *m_Material, physx::PxTransform(creation.Position), physx::PxU32(1.0f));
+      m_Actor = physics->CreatePrimitiveSphere(rigid, *m_Material, pose, physx::PxU32(1.0f));
     } break;
     default:
       return;
@@ -49,18 +62,27 @@ void PhysXActor::BuildActor(const ObjectPhysXCreationBase& creation)
 
     const ObjectPhysXCreationDynamic& dynamic = static_cast<const ObjectPhysXCreationDynamic&>(creation);
     actor->setMass(dynamic.Mass);
+
+    m_PoseIndex = m_Application->GetPhysXHandle()->RegisterDynamicActor(m_Actor);
   }
 }
 
 void PhysXActor::ProcessTransformation(float delta)
 {
-  const Yeager::ObjectPhysicsType::Enum type = m_Object->GetObjectPhysicsType();
+  if (m_PoseIndex == YEAGER_PHYSX_NO_POSE) {
+    return;
+  }
 
-  if (type == Yeager::ObjectPhysicsType::eDYNAMIC_BODY) {
-    physx::PxRigidBody* actor = static_cast<physx::PxRigidBody*>(m_Actor);
-    const Vector3 pos = PxVec3ToVector3(actor->getGlobalPose().p);
-    const Vector3 rotv = PxVec3ToVector3(actor->getAngularVelocity());
-    m_Object->GetTransformationPtr()->rotation += rotv;
-    m_Object->GetTransformationPtr()->position = pos;
+  /* The poses of the last publish move every frame with the interpolation, the others are written once */
+  PhysXHandle* handle = m_Application->GetPhysXHandle();
+  const PhysXActorPose& pose = handle->GetPublishedPose(m_PoseIndex);
+  const bool interpolated = handle->IsInterpolationEnabled() && pose.Version == handle->GetPoseVersion();
+  if (pose.Version == m_AppliedPoseVersion && !interpolated) {
+    return;
   }
+  const physx::PxTransform transform = handle->GetInterpolatedPose(m_PoseIndex);
+  m_Object->GetTransformationPtr()->position = PxVec3ToVector3(transform.p);
+  m_Object->GetTransformationPtr()->rotation = PxQuatToEulerDegrees(transform.q);
+  /* An interpolated write is not the end of the step, it is written again once the actor rests */
+  m_AppliedPoseVersion = interpolated ? UINT64_MAX : pose.Version;
 }
@@ -52,6 +52,8 @@ struct ObjectPhysXCreationBase {
   physx::PxVec3 Position = physx::PxVec3(0.0f);
   physx::PxVec3 Scale = physx::PxVec3(1.0f);
   physx::PxVec3 Rotation = physx::PxVec3(0.0f);
+  /* Named material of the PhysXMaterialCache */
+  String Material = YEAGER_PHYSX_DEFAULT_MATERIAL;
   ObjectPhysXCreationBase(const ObjectPhysicsType::Enum type = ObjectPhysicsType::eUNDEFINED,
                           const physx::PxVec3& position = physx::PxVec3(0.0f),
                           const physx::PxVec3& rotation = physx::PxVec3(0.0f),
@@ -142,12 +144,22 @@ class PhysXActor {
   ~PhysXActor();
 
   void BuildActor(const ObjectPhysXCreationBase& creation);
+
+  /**
+   * @brief Applies the published pose to the object, it is the pose of the last fetched step even while a step is
+   * running. Nothing is written while the body sleeps
+   */
   void ProcessTransformation(float delta);
 
+  YEAGER_NODISCARD const String& GetMaterialName() const { return m_MaterialName; }
+
  private:
   Yeager::ApplicationCore* m_Application = YEAGER_NULLPTR;
   Yeager::Object* m_Object = YEAGER_NULLPTR;
   physx::PxRigidActor* m_Actor = YEAGER_NULLPTR;
   physx::PxMaterial* m_Material = YEAGER_NULLPTR;
+  String m_MaterialName = YEAGER_PHYSX_DEFAULT_MATERIAL;
+  Uint m_PoseIndex = YEAGER_PHYSX_NO_POSE;
+  uint64_t m_AppliedPoseVersion = UINT64_MAX;
 };
 }  // namespace Yeager
@@ -23,6 +23,7 @@ void PhysXCharacterController::Create()
   /* Slower but more precise overlap testing */
   m_ControllerManager->setPreciseSweeps(true);
   m_ObstacleContext = m_ControllerManager->createObstacleContext();
+  m_Material = m_PhysXHandle->GetMaterialCache()->Acquire(YEAGER_PHYSX_CHARACTER_MATERIAL);
 }
 
 physx::PxController* PhysXCharacterController::CreateController(const physx::PxControllerShapeType::Enum type,
@@ -37,6 +38,7 @@ physx::PxController* PhysXCharacterController::CreateController(const physx::PxC
       desc.nonWalkableMode = PxControllerNonWalkableMode::ePREVENT_CLIMBING_AND_FORCE_SLIDING;
       desc.slopeLimit = cosf(PxDegToRad(45.0f));
       desc.halfHeight = capsuleHeight;
+      desc.material = m_Material;
       desc.reportCallback = this;
       if (desc.isValid()) {
         controller = m_ControllerManager->createController(desc);
@@ -52,7 +54,7 @@ physx::PxController* PhysXCharacterController::CreateController(const physx::PxC
       desc.stepOffset = stepOffSet;
       desc.slopeLimit = cosf(PxDegToRad(45.0f));
       desc.position = physx::PxExtendedVec3(0.0f, 20.0f, 0.0f);
-      desc.material = m_PhysXHandle->GetPxPhysics()->createMaterial(1.0, 1.0f, 1.0f);
+      desc.material = m_Material;
       desc.nonWalkableMode = PxControllerNonWalkableMode::ePREVENT_CLIMBING_AND_FORCE_SLIDING;
       desc.reportCallback = this;
       if (desc.isValid()) {
@@ -77,10 +79,14 @@ void PhysXCharacterController::Delete()
 {
   m_ControllerManager->purgeControllers();
   m_ControllerManager->release();
+  m_PhysXHandle->GetMaterialCache()->Release(m_Material);
+  m_Material = YEAGER_NULLPTR;
 }
 
 void PhysXCharacterController::SetPosition(physx::PxController* controller, const physx::PxExtendedVec3& position)
 {
+  /* The controllers must not touch the scene while a step is running */
+  m_PhysXHandle->EndSimulation();
   controller->setPosition(position);
 }
 
@@ -89,6 +95,7 @@ PhysXCollisionDetection PhysXCharacterController::Move(physx::PxController* cont
                                                        const physx::PxControllerFilters& filters,
                                                        const physx::PxObstacleContext* obstacles)
 {
+  m_PhysXHandle->EndSimulation();
   PhysXCollisionDetection collisionFlags;
   collisionFlags.ExtractPhysXFlagToCollisions(controller->move(disp, minDist, elapsedTime, filters, obstacles));
   return collisionFlags;
@@ -144,6 +144,8 @@ class PhysXCharacterController : physx::PxUserControllerHitReport,
   Yeager::PhysXHandle* m_PhysXHandle = YEAGER_NULLPTR;
   physx::PxControllerManager* m_ControllerManager = YEAGER_NULLPTR;
   physx::PxObstacleContext* m_ObstacleContext = YEAGER_NULLPTR;
+  /* Shared by every controller, acquired from the material cache */
+  physx::PxMaterial* m_Material = YEAGER_NULLPTR;
 };
 
 };  // namespace Yeager
@@ -0,0 +1,597 @@
+#include "PhysXConvexDecomposition.h"
+
+#include <array>
+
+using namespace Yeager;
+using namespace physx;
+
+/* The hull is built in doubles, the corners of the voxels are full of coplanar points */
+struct ConvexHullVector {
+  double x = 0.0, y = 0.0, z = 0.0;
+};
+
+static ConvexHullVector operator-(const ConvexHullVector& a, const ConvexHullVector& b)
+{
+  return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+static double Dot(const ConvexHullVector& a, const ConvexHullVector& b)
+{
+  return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+static ConvexHullVector Cross(const ConvexHullVector& a, const ConvexHullVector& b)
+{
+  return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+struct ConvexHullFace {
+  PxU32 A = 0, B = 0, C = 0;
+  ConvexHullVector Normal;
+  double Offset = 0.0;
+  bool Alive = true;
+  /* Thinner than the tolerance, its normal is rounding noise */
+  bool Sliver = false;
+  /* Points outside the hull that see this face */
+  std::vector<PxU32> Outside;
+};
+
+/* Face counter clockwise seen from outside */
+static ConvexHullFace MakeHullFace(const std::vector<ConvexHullVector>& points, PxU32 a, PxU32 b, PxU32 c,
+                                   double epsilon)
+{
+  ConvexHullFace face;
+  face.A = a;
+  face.B = b;
+  face.C = c;
+  ConvexHullVector normal = Cross(points[b] - points[a], points[c] - points[a]);
+  const double length = std::sqrt(Dot(normal, normal));
+  const double longest = std::sqrt(std::max({Dot(points[b] - points[a], points[b] - points[a]),
+                                             Dot(points[c] - points[a], points[c] - points[a]),
+                                             Dot(points[c] - points[b], points[c] - points[b])}));
+  /* The height of the triangle over its longest edge */
+  face.Sliver = length <= epsilon * longest;
+  if (length > 0.0) {
+    normal = {normal.x / length, normal.y / length, normal.z / length};
+  }
+  face.Normal = normal;
+  face.Offset = Dot(normal, points[a]);
+  return face;
+}
+
+static uint64_t HullEdgeKey(PxU32 a, PxU32 b)
+{
+  return (static_cast<uint64_t>(a) << 32) | b;
+}
+
+bool PhysXConvexHull::Build(const std::vector<PxVec3>& points)
+{
+  Vertices.clear();
+  Indices.clear();
+  Volume = 0.0;
+  if (points.size() < 4) {
+    return false;
+  }
+
+  std::vector<ConvexHullVector> p(points.size());
+  ConvexHullVector min = {DBL_MAX, DBL_MAX, DBL_MAX}, max = {-DBL_MAX, -DBL_MAX, -DBL_MAX};
+  for (size_t x = 0; x < points.size(); x++) {
+    p[x] = {points[x].x, points[x].y, points[x].z};
+    min = {std::min(min.x, p[x].x), std::min(min.y, p[x].y), std::min(min.z, p[x].z)};
+    max = {std::max(max.x, p[x].x), std::max(max.y, p[x].y), std::max(max.z, p[x].z)};
+  }
+  /* The points come in floats, the samples of the same spot on two triangles differ in the last bits. A point closer
+   * than that to the hull is taken as on it, the cone to it would be made of slivers with normals pointing anywhere */
+  const ConvexHullVector extent = max - min;
+  const double scale = std::max({extent.x, extent.y, extent.z, std::abs(min.x), std::abs(min.y), std::abs(min.z),
+                                 std::abs(max.x), std::abs(max.y), std::abs(max.z)});
+  const double epsilon = scale * 1e-5;
+
+  /* Starts from a tetrahedron as large as possible: the extremes of the longest axis, the farthest point from their
+   * line and the farthest from the plane of the three */
+  const int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+  auto coordinate = [&](size_t index) { return axis == 0 ? p[index].x : (axis == 1 ? p[index].y : p[index].z); };
+  PxU32 i0 = 0, i1 = 0;
+  for (PxU32 x = 1; x < p.size(); x++) {
+    i0 = coordinate(x) < coordinate(i0) ? x : i0;
+    i1 = coordinate(x) > coordinate(i1) ? x : i1;
+  }
+  const ConvexHullVector line = p[i1] - p[i0];
+  PxU32 i2 = i0;
+  double farthest = 0.0;
+  for (PxU32 x = 0; x < p.size(); x++) {
+    const ConvexHullVector cross = Cross(p[x] - p[i0], line);
+    const double distance = Dot(cross, cross);
+    if (distance > farthest) {
+      farthest = distance;
+      i2 = x;
+    }
+  }
+  ConvexHullVector normal = Cross(line, p[i2] - p[i0]);
+  const double normalLength = std::sqrt(Dot(normal, normal));
+  if (normalLength <= epsilon * epsilon) {
+    return false;
+  }
+  normal = {normal.x / normalLength, normal.y / normalLength, normal.z / normalLength};
+  PxU32 i3 = i0;
+  farthest = 0.0;
+  for (PxU32 x = 0; x < p.size(); x++) {
+    const double distance = std::abs(Dot(p[x] - p[i0], normal));
+    if (distance > farthest) {
+      farthest = distance;
+      i3 = x;
+    }
+  }
+  if (farthest <= epsilon) {
+    return false;
+  }
+
+  const ConvexHullVector center = {(p[i0].x + p[i1].x + p[i2].x + p[i3].x) * 0.25,
+                                   (p[i0].y + p[i1].y + p[i2].y + p[i3].y) * 0.25,
+                                   (p[i0].z + p[i1].z + p[i2].z + p[i3].z) * 0.25};
+  /* The last point of the tetrahedron is above or below the plane of the first three, that decides the winding */
+  if (Dot(p[i3] - p[i0], normal) > 0.0) {
+    std::swap(i1, i2);
+  }
+  std::vector<ConvexHullFace> faces = {MakeHullFace(p, i0, i1, i2, epsilon), MakeHullFace(p, i0, i3, i1, epsilon),
+                                       MakeHullFace(p, i1, i3, i2, epsilon), MakeHullFace(p, i2, i3, i0, epsilon)};
+  /* Face on the left of each directed edge, the face across an edge is the one of the reversed edge */
+  std::unordered_map<uint64_t, PxU32> edgeFaces;
+  auto link = [&](PxU32 face) {
+    edgeFaces[HullEdgeKey(faces[face].A, faces[face].B)] = face;
+    edgeFaces[HullEdgeKey(faces[face].B, faces[face].C)] = face;
+    edgeFaces[HullEdgeKey(faces[face].C, faces[face].A)] = face;
+  };
+  for (PxU32 x = 0; x < faces.size(); x++) {
+    link(x);
+  }
+
+  /* Quickhull, every point outside the hull waits in the list of one face it sees. The farthest point of a face is
+   * added, the faces it sees are replaced by a cone from the horizon to it and their points go to the new faces. The
+   * faces seen are searched from the face of the point through their neighbours, so they stay in one piece even when
+   * the rounding makes a far face look seen. A sliver reached by the search goes with the faces seen, a normal of
+   * rounding noise must not decide the horizon, and no point waits on it */
+  auto assign = [&](PxU32 point, size_t firstFace) {
+    for (size_t x = firstFace; x < faces.size(); x++) {
+      if (faces[x].Alive && !faces[x].Sliver && Dot(faces[x].Normal, p[point]) - faces[x].Offset > epsilon) {
+        faces[x].Outside.push_back(point);
+        return;
+      }
+    }
+  };
+  for (PxU32 x = 0; x < p.size(); x++) {
+    if (x != i0 && x != i1 && x != i2 && x != i3) {
+      assign(x, 0);
+    }
+  }
+
+  std::vector<PxU32> visible;
+  std::vector<uint8_t> seen(faces.size(), 0);
+  std::vector<std::array<PxU32, 3>> horizon;
+  std::vector<PxU32> orphans;
+  for (PxU32 current = 0; current < faces.size(); current++) {
+    while (faces[current].Alive && !faces[current].Outside.empty()) {
+      const ConvexHullFace& face = faces[current];
+      const PxU32 point = *std::max_element(face.Outside.begin(), face.Outside.end(), [&](PxU32 a, PxU32 b) {
+        return Dot(face.Normal, p[a]) < Dot(face.Normal, p[b]);
+      });
+
+      /* The horizon is made of the edges of the faces seen whose neighbour is not seen. Past the first face, the point
+       * above the plane by any amount sees it, the tolerance only keeps the points too close to the hull out. The faces
+       * kept then meet the cone at a convex edge, a face in the tolerance of the point would leave a fold instead */
+      visible = {current};
+      horizon.clear();
+      seen.resize(faces.size(), 0);
+      seen[current] = 1;
+      for (size_t x = 0; x < visible.size(); x++) {
+        const ConvexHullFace& seenFace = faces[visible[x]];
+        for (const auto& [a, b] : {std::make_pair(seenFace.A, seenFace.B), std::make_pair(seenFace.B, seenFace.C),
+                                   std::make_pair(seenFace.C, seenFace.A)}) {
+          const PxU32 neighbour = edgeFaces[HullEdgeKey(b, a)];
+          if (seen[neighbour] == 1) {
+            continue;
+          }
+          const ConvexHullFace& other = faces[neighbour];
+          if (seen[neighbour] == 0 && (other.Sliver || Dot(other.Normal, p[point]) - other.Offset > 0.0)) {
+            seen[neighbour] = 1;
+            visible.push_back(neighbour);
+          } else {
+            seen[neighbour] = 2;
+            horizon.push_back({a, b, neighbour});
+          }
+        }
+      }
+
+      orphans.clear();
+      for (const PxU32 x : visible) {
+        faces[x].Alive = false;
+        orphans.insert(orphans.end(), faces[x].Outside.begin(), faces[x].Outside.end());
+        faces[x].Outside.clear();
+        for (const uint64_t edge : {HullEdgeKey(faces[x].A, faces[x].B), HullEdgeKey(faces[x].B, faces[x].C),
+                                 HullEdgeKey(faces[x].C, faces[x].A)}) {
+          edgeFaces.erase(edge);
+        }
+      }
+      /* The edges of the horizon keep the winding of the faces seen, so the cone is counter clockwise too */
+      const size_t firstNew = faces.size();
+      for (const auto& [a, b, neighbour] : horizon) {
+        seen[neighbour] = 0;
+        faces.push_back(MakeHullFace(p, a, b, point, epsilon));
+        link(faces.size() - 1);
+      }
+      for (const PxU32 orphan : orphans) {
+        if (orphan != point) {
+          assign(orphan, firstNew);
+        }
+      }
+    }
+  }
+
+  std::vector<PxU32> remap(p.size(), UINT32_MAX);
+  for (const ConvexHullFace& face : faces) {
+    if (!face.Alive) {
+      continue;
+    }
+    for (const PxU32 index : {face.A, face.B, face.C}) {
+      if (remap[index] == UINT32_MAX) {
+        remap[index] = Vertices.size();
+        Vertices.push_back(points[index]);
+      }
+      Indices.push_back(remap[index]);
+    }
+    Volume += Dot(p[face.A] - center, Cross(p[face.B] - center, p[face.C] - center)) / 6.0;
+  }
+  return true;
+}
+
+void PhysXConvexHull::Inflate(float amount)
+{
+  std::vector<PxVec3> normals(Vertices.size(), PxVec3(0.0f));
+  for (size_t x = 0; x + 2 < Indices.size(); x += 3) {
+    const PxVec3& a = Vertices[Indices[x]];
+    /* Not normalized, the large triangles weight more */
+    const PxVec3 normal = (Vertices[Indices[x + 1]] - a).cross(Vertices[Indices[x + 2]] - a);
+    for (size_t y = 0; y < 3; y++) {
+      normals[Indices[x + y]] += normal;
+    }
+  }
+  for (size_t x = 0; x < Vertices.size(); x++) {
+    Vertices[x] += normals[x].getNormalized() * amount;
+  }
+}
+
+struct ConvexDecompositionVoxel {
+  int X = 0, Y = 0, Z = 0;
+};
+
+static int VoxelCoordinate(const ConvexDecompositionVoxel& voxel, int axis)
+{
+  return axis == 0 ? voxel.X : (axis == 1 ? voxel.Y : voxel.Z);
+}
+
+struct ConvexDecompositionPart {
+  std::vector<ConvexDecompositionVoxel> Voxels;
+  PhysXConvexHull Hull;
+  double Concavity = 0.0;
+  bool Splittable = true;
+};
+
+/**
+ * Voxels of the mesh in a grid with an empty border, so the flood fill goes around the whole mesh. The voxels inside
+ * are whole inside the mesh, the ones of the surface keep the points sampled on the triangles that cross them
+ */
+class ConvexDecompositionGrid {
+ public:
+  enum Cell : uint8_t { eEMPTY, eSURFACE, eOUTSIDE };
+
+  bool Voxelize(const PhysXTriangleMeshInput& mesh, Uint resolution)
+  {
+    PxVec3 min(PX_MAX_F32), max(-PX_MAX_F32);
+    for (const PxVec3& vertex : mesh.Vertices) {
+      min = min.minimum(vertex);
+      max = max.maximum(vertex);
+    }
+    const PxVec3 extent = max - min;
+    const float longest = extent.maxElement();
+    if (mesh.Indices.size() < 3 || !(longest > 0.0f)) {
+      return false;
+    }
+
+    Size = longest / std::max<Uint>(resolution, 1);
+    Origin = min - PxVec3(Size);
+    for (int axis = 0; axis < 3; axis++) {
+      Dimensions[axis] = std::max(1, static_cast<int>(std::ceil(extent[axis] / Size))) + 2;
+    }
+    Cells.assign(static_cast<size_t>(Dimensions[0]) * Dimensions[1] * Dimensions[2], eEMPTY);
+
+    /* Samples each triangle at half a voxel, every voxel it crosses gets a sample */
+    std::vector<std::pair<size_t, PxVec3>> samples;
+    for (size_t x = 0; x + 2 < mesh.Indices.size(); x += 3) {
+      const PxVec3& a = mesh.Vertices[mesh.Indices[x]];
+      const PxVec3& b = mesh.Vertices[mesh.Indices[x + 1]];
+      const PxVec3& c = mesh.Vertices[mesh.Indices[x + 2]];
+      const float edge = std::max({(b - a).magnitude(), (c - a).magnitude(), (c - b).magnitude()});
+      const int count = static_cast<int>(std::ceil(edge / (Size * 0.5f))) + 1;
+      for (int u = 0; u <= count; u++) {
+        for (int v = 0; v <= count - u; v++) {
+          const PxVec3 point =
+              a + (b - a) * (static_cast<float>(u) / count) + (c - a) * (static_cast<float>(v) / count);
+          const size_t cell = Index(Coordinate(point.x, 0), Coordinate(point.y, 1), Coordinate(point.z, 2));
+          Cells[cell] = eSURFACE;
+          samples.emplace_back(cell, point);
+        }
+      }
+    }
+
+    /* The samples of a voxel are SurfacePoints[SurfaceOffsets[cell]] until SurfaceOffsets[cell + 1] */
+    std::stable_sort(samples.begin(), samples.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    SurfaceOffsets.assign(Cells.size() + 1, 0);
+    SurfacePoints.resize(samples.size());
+    for (size_t x = 0; x < samples.size(); x++) {
+      SurfaceOffsets[samples[x].first + 1]++;
+      SurfacePoints[x] = samples[x].second;
+    }
+    for (size_t x = 1; x < SurfaceOffsets.size(); x++) {
+      SurfaceOffsets[x] += SurfaceOffsets[x - 1];
+    }
+
+    /* Everything the outside does not reach through the empty cells is inside the mesh */
+    std::vector<ConvexDecompositionVoxel> stack = {{0, 0, 0}};
+    At(0, 0, 0) = eOUTSIDE;
+    while (!stack.empty()) {
+      const ConvexDecompositionVoxel voxel = stack.back();
+      stack.pop_back();
+      static const int neighbours[6][3] = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+      for (const auto& offset : neighbours) {
+        const ConvexDecompositionVoxel next = {voxel.X + offset[0], voxel.Y + offset[1], voxel.Z + offset[2]};
+        if (next.X < 0 || next.Y < 0 || next.Z < 0 || next.X >= Dimensions[0] || next.Y >= Dimensions[1] ||
+            next.Z >= Dimensions[2] || At(next.X, next.Y, next.Z) != eEMPTY) {
+          continue;
+        }
+        At(next.X, next.Y, next.Z) = eOUTSIDE;
+        stack.push_back(next);
+      }
+    }
+    return true;
+  }
+
+  std::vector<ConvexDecompositionVoxel> GetSolidVoxels() const
+  {
+    std::vector<ConvexDecompositionVoxel> voxels;
+    for (int z = 0; z < Dimensions[2]; z++) {
+      for (int y = 0; y < Dimensions[1]; y++) {
+        for (int x = 0; x < Dimensions[0]; x++) {
+          if (Cells[Index(x, y, z)] != eOUTSIDE) {
+            voxels.push_back({x, y, z});
+          }
+        }
+      }
+    }
+    return voxels;
+  }
+
+  PxVec3 GetCorner(int x, int y, int z) const { return Origin + PxVec3(x, y, z) * Size; }
+  size_t Index(int x, int y, int z) const { return (static_cast<size_t>(z) * Dimensions[1] + y) * Dimensions[0] + x; }
+  bool IsSurface(const ConvexDecompositionVoxel& voxel) const
+  {
+    return Cells[Index(voxel.X, voxel.Y, voxel.Z)] == eSURFACE;
+  }
+
+  int Dimensions[3] = {0, 0, 0};
+  PxVec3 Origin = PxVec3(0.0f);
+  float Size = 0.0f;
+  std::vector<PxVec3> SurfacePoints;
+  std::vector<PxU32> SurfaceOffsets;
+
+ private:
+  uint8_t& At(int x, int y, int z) { return Cells[Index(x, y, z)]; }
+  int Coordinate(float value, int axis) const
+  {
+    return std::clamp(static_cast<int>((value - Origin[axis]) / Size), 1, Dimensions[axis] - 2);
+  }
+
+  std::vector<uint8_t> Cells;
+};
+
+/**
+ * The hull of the voxels only needs the first and the last voxel of each row along X, any voxel between them is inside
+ * their hull. It is larger than the hull of the mesh in the voxels but cheap, good enough to compare the cuts
+ */
+static void GatherRowExtremes(const ConvexDecompositionGrid& grid, const std::vector<ConvexDecompositionVoxel>& voxels,
+                              std::vector<PxVec3>* points)
+{
+  const int rows = grid.Dimensions[1] * grid.Dimensions[2];
+  std::vector<std::pair<int, int>> extremes(rows, {INT_MAX, INT_MIN});
+  for (const ConvexDecompositionVoxel& voxel : voxels) {
+    auto& row = extremes[voxel.Z * grid.Dimensions[1] + voxel.Y];
+    row.first = std::min(row.first, voxel.X);
+    row.second = std::max(row.second, voxel.X);
+  }
+
+  points->clear();
+  for (int row = 0; row < rows; row++) {
+    if (extremes[row].first == INT_MAX) {
+      continue;
+    }
+    const int y = row % grid.Dimensions[1];
+    const int z = row / grid.Dimensions[1];
+    for (const int x : {extremes[row].first, extremes[row].second + 1}) {
+      points->push_back(grid.GetCorner(x, y, z));
+      points->push_back(grid.GetCorner(x, y + 1, z));
+      points->push_back(grid.GetCorner(x, y, z + 1));
+      points->push_back(grid.GetCorner(x, y + 1, z + 1));
+    }
+  }
+}
+
+static double HullVolumeOfVoxels(const ConvexDecompositionGrid& grid,
+                                 const std::vector<ConvexDecompositionVoxel>& voxels, std::vector<PxVec3>* points)
+{
+  GatherRowExtremes(grid, voxels, points);
+  PhysXConvexHull hull;
+  hull.Build(*points);
+  return hull.Volume;
+}
+
+/**
+ * The hull of a part is made of the corners of its voxels inside the mesh and of the points sampled on the surface in
+ * its voxels of the surface, so it fits the mesh instead of the voxels. Only the voxels at an end of a row along some
+ * axis can hold a point of the hull, the others have part voxels on every side. The concavity compares the voxels
+ * with the hull of their corners instead, both have the whole surface voxels so a convex mesh is a single part
+ */
+static void BuildPart(const ConvexDecompositionGrid& grid, ConvexDecompositionPart* part)
+{
+  const int* dimensions = grid.Dimensions;
+  std::vector<std::pair<int, int>> rows[3];
+  for (int axis = 0; axis < 3; axis++) {
+    rows[axis].assign(static_cast<size_t>(dimensions[(axis + 1) % 3]) * dimensions[(axis + 2) % 3], {INT_MAX, INT_MIN});
+  }
+  auto row = [&](const ConvexDecompositionVoxel& voxel, int axis) -> std::pair<int, int>& {
+    const int coordinates[3] = {voxel.X, voxel.Y, voxel.Z};
+    return rows[axis][coordinates[(axis + 2) % 3] * dimensions[(axis + 1) % 3] + coordinates[(axis + 1) % 3]];
+  };
+  for (const ConvexDecompositionVoxel& voxel : part->Voxels) {
+    for (int axis = 0; axis < 3; axis++) {
+      const int coordinate = VoxelCoordinate(voxel, axis);
+      row(voxel, axis).first = std::min(row(voxel, axis).first, coordinate);
+      row(voxel, axis).second = std::max(row(voxel, axis).second, coordinate);
+    }
+  }
+
+  std::vector<PxVec3> points;
+  for (const ConvexDecompositionVoxel& voxel : part->Voxels) {
+    const bool surface = grid.IsSurface(voxel);
+    bool extreme = false;
+    for (int axis = 0; axis < 3 && !extreme; axis++) {
+      const int coordinate = VoxelCoordinate(voxel, axis);
+      extreme = coordinate == row(voxel, axis).first || coordinate == row(voxel, axis).second;
+    }
+    if (!extreme) {
+      continue;
+    }
+    if (surface) {
+      const size_t cell = grid.Index(voxel.X, voxel.Y, voxel.Z);
+      points.insert(points.end(), grid.SurfacePoints.begin() + grid.SurfaceOffsets[cell],
+                    grid.SurfacePoints.begin() + grid.SurfaceOffsets[cell + 1]);
+    } else {
+      for (int corner = 0; corner < 8; corner++) {
+        points.push_back(
+            grid.GetCorner(voxel.X + (corner & 1), voxel.Y + ((corner >> 1) & 1), voxel.Z + (corner >> 2)));
+      }
+    }
+  }
+  part->Hull.Build(points);
+
+  const double voxelVolume = static_cast<double>(grid.Size) * grid.Size * grid.Size;
+  part->Concavity = std::max(0.0, HullVolumeOfVoxels(grid, part->Voxels, &points) - part->Voxels.size() * voxelVolume);
+}
+
+/**
+ * @brief Cuts the part by the plane that leaves the smallest hulls on both sides, the voxel volume of both sides is
+ * the same for every cut so it is the one that leaves the least concavity
+ * @return False if the part has a single voxel along every axis
+ */
+static bool SplitPart(const ConvexDecompositionGrid& grid, const PhysXConvexDecompositionSettings& settings,
+                      const ConvexDecompositionPart& part, ConvexDecompositionPart* left,
+                      ConvexDecompositionPart* right)
+{
+  const double voxelVolume = static_cast<double>(grid.Size) * grid.Size * grid.Size;
+  std::vector<ConvexDecompositionVoxel> below, above;
+  std::vector<PxVec3> points;
+  double bestCost = DBL_MAX;
+  int bestAxis = -1, bestCut = 0;
+
+  for (int axis = 0; axis < 3; axis++) {
+    int min = INT_MAX, max = INT_MIN;
+    for (const ConvexDecompositionVoxel& voxel : part.Voxels) {
+      min = std::min(min, VoxelCoordinate(voxel, axis));
+      max = std::max(max, VoxelCoordinate(voxel, axis));
+    }
+
+    int lastCut = min;
+    for (Uint plane = 1; plane <= settings.PlanesPerAxis; plane++) {
+      /* The voxels before the cut go below, the cut is between min + 1 and max so both sides have voxels */
+      const int cut = min + std::max(1, static_cast<int>(std::lround((max - min + 1.0) * plane /
+                                                                      (settings.PlanesPerAxis + 1))));
+      if (cut <= lastCut || cut > max) {
+        continue;
+      }
+      lastCut = cut;
+
+      below.clear();
+      above.clear();
+      for (const ConvexDecompositionVoxel& voxel : part.Voxels) {
+        (VoxelCoordinate(voxel, axis) < cut ? below : above).push_back(voxel);
+      }
+      if (below.empty() || above.empty()) {
+        continue;
+      }
+      const double balance = std::abs(static_cast<double>(below.size()) - above.size()) * voxelVolume;
+      const double cost = HullVolumeOfVoxels(grid, below, &points) + HullVolumeOfVoxels(grid, above, &points) +
+                          settings.BalanceWeight * balance;
+      if (cost < bestCost) {
+        bestCost = cost;
+        bestAxis = axis;
+        bestCut = cut;
+      }
+    }
+  }
+  if (bestAxis < 0) {
+    return false;
+  }
+
+  left->Voxels.clear();
+  right->Voxels.clear();
+  for (const ConvexDecompositionVoxel& voxel : part.Voxels) {
+    (VoxelCoordinate(voxel, bestAxis) < bestCut ? left : right)->Voxels.push_back(voxel);
+  }
+  BuildPart(grid, left);
+  BuildPart(grid, right);
+  return true;
+}
+
+bool PhysXConvexDecomposition::Decompose(const PhysXTriangleMeshInput& mesh,
+                                         const PhysXConvexDecompositionSettings& settings,
+                                         std::vector<std::vector<PxVec3>>* hulls)
+{
+  hulls->clear();
+  ConvexDecompositionGrid grid;
+  if (!grid.Voxelize(mesh, settings.Resolution)) {
+    Yeager::Log(ERROR, "Convex decomposition needs a mesh with triangles and volume!");
+    return false;
+  }
+
+  std::vector<ConvexDecompositionPart> parts(1);
+  parts[0].Voxels = grid.GetSolidVoxels();
+  BuildPart(grid, &parts[0]);
+  const double maxConcavity = settings.MaxConcavity * parts[0].Hull.Volume;
+
+  /* The most concave part is split first, so a low count of hulls still goes to where the mesh needs them */
+  while (parts.size() < std::max<Uint>(settings.MaxHulls, 1)) {
+    size_t worst = parts.size();
+    for (size_t x = 0; x < parts.size(); x++) {
+      if (parts[x].Splittable && parts[x].Concavity > maxConcavity &&
+          (worst == parts.size() || parts[x].Concavity > parts[worst].Concavity)) {
+        worst = x;
+      }
+    }
+    if (worst == parts.size()) {
+      break;
+    }
+
+    ConvexDecompositionPart left, right;
+    if (!SplitPart(grid, settings, parts[worst], &left, &right)) {
+      parts[worst].Splittable = false;
+      continue;
+    }
+    parts[worst] = std::move(left);
+    parts.push_back(std::move(right));
+  }
+
+  for (const ConvexDecompositionPart& part : parts) {
+    if (!part.Hull.Vertices.empty()) {
+      hulls->push_back(part.Hull.Vertices);
+    }
+  }
+  return !hulls->empty();
+}
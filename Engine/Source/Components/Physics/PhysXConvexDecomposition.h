@@ -0,0 +1,101 @@
+//    Yeager Engine, free and open source 3D/2D renderer written in OpenGL
+//    In case of questions and bugs, please, refer to the issue tab on github
+//    Repo : https://github.com/schwq/YeagerEngine
+//    Copyright (C) 2023 - Present
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Common/Utils/Common.h"
+#include "Common/Utils/LogEngine.h"
+#include "Common/Utils/Utilities.h"
+
+#include "PhysXGeometryHandle.h"
+#include "PhysxAllocator.h"
+
+namespace Yeager {
+
+/**
+ * @brief Convex hull of a set of points, built by quickhull in double precision. Only used where PhysX cooking does
+ * not fit: the volumes of the parts tried by the decomposition, and the normals of the vertices for the inflation
+ */
+struct PhysXConvexHull {
+  std::vector<physx::PxVec3> Vertices;
+  /* Triangles of the hull, counter clockwise seen from outside */
+  std::vector<physx::PxU32> Indices;
+  double Volume = 0.0;
+
+  /**
+   * @brief Replaces the hull with the hull of the points
+   * @return False if the points are flat (less than 4 points not in the same plane), the hull is left empty
+   */
+  bool Build(const std::vector<physx::PxVec3>& points);
+
+  /** Moves every vertex outwards along the average normal of its triangles, the hull grows about amount on each side */
+  void Inflate(float amount);
+};
+
+/// @brief Parameters of the decomposition, the defaults split a prop in a few hulls in a fraction of a second
+struct PhysXConvexDecompositionSettings {
+  /* Voxels along the longest side of the mesh */
+  Uint Resolution = 32;
+  Uint MaxHulls = 16;
+  /* A part stops splitting when its hull has less empty volume than this, relative to the hull of the whole mesh */
+  float MaxConcavity = 0.01f;
+  /* Cutting planes tried along each axis when a part is split */
+  Uint PlanesPerAxis = 8;
+  /* Weight of the difference between the volumes of the two sides of a cut, the cuts in the middle win the ties */
+  float BalanceWeight = 0.05f;
+  /* Vertices of each hull cooked, up to 255 */
+  physx::PxU16 VertexLimit = 64;
+};
+
+/**
+ * @brief Approximate convex decomposition of a triangle mesh in the manner of V-HACD. The mesh is voxelized (the
+ * surface, then the inside by a flood fill from the outside) and the voxels are split in parts by axis aligned planes.
+ * The part with the most empty volume in its hull (its concavity) is split first, by the plane that leaves the least
+ * concavity on both sides, until every part is convex enough or the count of hulls is reached. A mesh that is not
+ * closed has no inside, its parts are shells of voxels. The hulls are made of the points of the mesh surface in their
+ * voxels, they meet the neighbour hulls at the cuts and do not overlap the mesh
+ */
+class PhysXConvexDecomposition {
+ public:
+  /**
+   * @brief Decomposes the mesh, each hull is the list of vertices of its convex hull
+   * @return False if the mesh has no triangles or its bounds are flat
+   */
+  static bool Decompose(const PhysXTriangleMeshInput& mesh, const PhysXConvexDecompositionSettings& settings,
+                        std::vector<std::vector<physx::PxVec3>>* hulls);
+};
+
+/// @brief Collision built for the meshes of an imported model
+struct PhysXMeshCollisionType {
+  enum Enum { eTRIANGLE_MESH, eCONVEX_HULL, eCONVEX_DECOMPOSITION };
+};
+
+/**
+ * @brief Collision of the imported meshes. Triangle meshes are only for static actors, a dynamic body needs convex
+ * shapes, a single hull of each mesh or its decomposition in several hulls
+ */
+struct PhysXMeshCollisionSettings {
+  PhysXMeshCollisionType::Enum Type = PhysXMeshCollisionType::eTRIANGLE_MESH;
+  /* Vertices of the single hull, up to 255 */
+  physx::PxU16 VertexLimit = 64;
+  /* Distance the single hull is grown by */
+  float Inflation = 0.0f;
+  PhysXConvexDecompositionSettings Decomposition;
+};
+
+}  // namespace Yeager
@@ -0,0 +1,318 @@
+#include "PhysXCookingCache.h"
+#include "Common/FS/MappedFile.h"
+#include "Components/Kernel/Caching/Cache.h"
+#include "PhysXConvexDecomposition.h"
+
+using namespace Yeager;
+using namespace physx;
+
+/* FNV-1a 64, the cache files must keep their names between runs so std::hash is not an option */
+static uint64_t HashBytes(uint64_t hash, const void* data, size_t size)
+{
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  for (size_t x = 0; x < size; x++) {
+    hash = (hash ^ bytes[x]) * 0x100000001b3ull;
+  }
+  return hash;
+}
+
+template <typename T>
+static uint64_t HashValue(uint64_t hash, const T& value)
+{
+  return HashBytes(hash, &value, sizeof(T));
+}
+
+static uint64_t HashCookingParams(uint64_t hash, const PxCookingParams& params)
+{
+  hash = HashValue(hash, static_cast<uint32_t>(PX_PHYSICS_VERSION));
+  hash = HashValue(hash, params.areaTestEpsilon);
+  hash = HashValue(hash, params.planeTolerance);
+  hash = HashValue(hash, static_cast<uint32_t>(params.convexMeshCookingType));
+  hash = HashValue(hash, static_cast<uint8_t>(params.suppressTriangleMeshRemapTable));
+  hash = HashValue(hash, static_cast<uint8_t>(params.buildTriangleAdjacencies));
+  hash = HashValue(hash, static_cast<uint8_t>(params.buildGPUData));
+  hash = HashValue(hash, params.scale.length);
+  hash = HashValue(hash, params.scale.speed);
+  hash = HashValue(hash, static_cast<uint32_t>(params.meshPreprocessParams));
+  hash = HashValue(hash, params.meshWeldTolerance);
+  hash = HashValue(hash, static_cast<uint32_t>(params.midphaseDesc.getType()));
+  hash = HashValue(hash, params.gaussMapLimit);
+  return hash;
+}
+
+static uint64_t HashPoints(uint64_t hash, const PxBoundedData& points)
+{
+  const uint8_t* data = static_cast<const uint8_t*>(points.data);
+  for (PxU32 x = 0; x < points.count; x++) {
+    hash = HashBytes(hash, data + static_cast<size_t>(x) * points.stride, sizeof(PxVec3));
+  }
+  return HashValue(hash, points.count);
+}
+
+uint64_t PhysXCookingCache::HashTriangleMesh(const PxTriangleMeshDesc& desc, const PxCookingParams& params)
+{
+  uint64_t hash = HashValue(0xcbf29ce484222325ull, static_cast<uint32_t>(PhysXCookedMeshType::eTRIANGLE_MESH));
+  hash = HashPoints(hash, desc.points);
+
+  const size_t indexSize = desc.flags.isSet(PxMeshFlag::e16_BIT_INDICES) ? sizeof(PxU16) : sizeof(PxU32);
+  const uint8_t* triangles = static_cast<const uint8_t*>(desc.triangles.data);
+  for (PxU32 x = 0; x < desc.triangles.count; x++) {
+    hash = HashBytes(hash, triangles + static_cast<size_t>(x) * desc.triangles.stride, indexSize * 3);
+  }
+  hash = HashValue(hash, desc.triangles.count);
+  hash = HashValue(hash, static_cast<uint32_t>(desc.flags));
+  return HashCookingParams(hash, params);
+}
+
+uint64_t PhysXCookingCache::HashConvexMesh(const PxConvexMeshDesc& desc, const PxCookingParams& params)
+{
+  uint64_t hash = HashValue(0xcbf29ce484222325ull, static_cast<uint32_t>(PhysXCookedMeshType::eCONVEX_MESH));
+  hash = HashPoints(hash, desc.points);
+  hash = HashValue(hash, static_cast<uint32_t>(desc.flags));
+  hash = HashValue(hash, desc.vertexLimit);
+  hash = HashValue(hash, desc.quantizedCount);
+  return HashCookingParams(hash, params);
+}
+
+uint64_t PhysXCookingCache::HashConvexDecomposition(const PhysXTriangleMeshInput& mesh,
+                                                    const PhysXConvexDecompositionSettings& settings)
+{
+  uint64_t hash =
+      HashValue(0xcbf29ce484222325ull, static_cast<uint32_t>(PhysXCookedMeshType::eCONVEX_DECOMPOSITION));
+  hash = HashValue(hash, static_cast<uint32_t>(YEAGER_PHYSX_CONVEX_DECOMPOSITION_VERSION));
+  hash = HashBytes(hash, mesh.Vertices.data(), mesh.Vertices.size() * sizeof(PxVec3));
+  hash = HashValue(hash, mesh.Vertices.size());
+  hash = HashBytes(hash, mesh.Indices.data(), mesh.Indices.size() * sizeof(PxU32));
+  hash = HashValue(hash, mesh.Indices.size());
+  hash = HashValue(hash, settings.Resolution);
+  hash = HashValue(hash, settings.MaxHulls);
+  hash = HashValue(hash, settings.MaxConcavity);
+  hash = HashValue(hash, settings.PlanesPerAxis);
+  return HashValue(hash, settings.BalanceWeight);
+}
+
+void PhysXCookingCache::SetFolder(const String& folder)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  if (folder == m_Folder) {
+    return;
+  }
+  if (!folder.empty() && !Yeager::ValidatesPath(folder, false)) {
+    Yeager::CreateDirectoryAndValidate(folder);
+  }
+  m_Folder = folder;
+}
+
+String PhysXCookingCache::GetFolder() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Folder;
+}
+
+String PhysXCookingCache::GetCachePath(uint64_t key) const
+{
+  return GetFolder() + YG_PS + std::to_string(key) + String(YEAGER_PHYSX_COOKING_CACHE_EXT_STR);
+}
+
+PhysXCookingCacheStats PhysXCookingCache::GetStats() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Stats;
+}
+
+void PhysXCookingCache::ResetStats()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Stats = PhysXCookingCacheStats();
+}
+
+bool PhysXCookingCache::Map(uint64_t key, PhysXCookedMeshType::Enum type, MappedFile* file) const
+{
+  const String path = GetCachePath(key);
+  if (!Yeager::ValidatesPath(path, false) || !file->Map(path)) {
+    return false;
+  }
+
+  const PhysXCookingCacheHeader* header = file->At<PhysXCookingCacheHeader>(0);
+  if (!header || std::memcmp(header->MagicConst, YEAGER_CACHE_MAGIC_CONST, sizeof(char) * 4) != 0 ||
+      header->Version != YEAGER_PHYSX_COOKING_CACHE_VERSION || header->PhysXVersion != PX_PHYSICS_VERSION ||
+      header->MeshType != type || header->Key != key ||
+      header->DataSize + sizeof(PhysXCookingCacheHeader) != file->GetSize()) {
+    Yeager::Log(WARNING, "PhysX cooking cache {} is invalid or from another version, it will be cooked again", path);
+    file->Unmap();
+    return false;
+  }
+  return true;
+}
+
+void PhysXCookingCache::Write(uint64_t key, PhysXCookedMeshType::Enum type, const PxDefaultMemoryOutputStream& stream)
+{
+  PhysXCookingCacheHeader header;
+  std::memcpy(header.MagicConst, YEAGER_CACHE_MAGIC_CONST, sizeof(char) * 4);
+  header.Version = YEAGER_PHYSX_COOKING_CACHE_VERSION;
+  header.PhysXVersion = PX_PHYSICS_VERSION;
+  header.MeshType = type;
+  header.Key = key;
+  header.DataSize = stream.getSize();
+
+  /* Writes to a temporary file first, a crash while writing must not leave a corrupted cache behind. Two threads
+   * cooking the same mesh write their own temporary file and the last rename wins, both files are the same */
+  const String outputPath = GetCachePath(key);
+  const String temporaryPath =
+      outputPath + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+  {
+    std::ofstream output(temporaryPath, std::ios_base::binary | std::ios_base::trunc);
+    if (!output.is_open()) {
+      Yeager::Log(ERROR, "Cannot write PhysX cooking cache {}", outputPath);
+      return;
+    }
+    output.write(reinterpret_cast<const char*>(&header), sizeof(PhysXCookingCacheHeader));
+    output.write(reinterpret_cast<const char*>(stream.getData()), stream.getSize());
+    /* Closed here so a short write is seen before the file is published as a cache entry */
+    output.close();
+    if (output.fail()) {
+      Yeager::Log(ERROR, "Cannot write PhysX cooking cache {}, the disk may be full", outputPath);
+      std::error_code error;
+      std::filesystem::remove(temporaryPath, error);
+      return;
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temporaryPath, outputPath, error);
+  if (error) {
+    Yeager::Log(ERROR, "Cannot move PhysX cooking cache to {}, {}", outputPath, error.message());
+    std::filesystem::remove(temporaryPath, error);
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Stats.BytesWritten += sizeof(PhysXCookingCacheHeader) + stream.getSize();
+}
+
+PxTriangleMesh* PhysXCookingCache::CreateTriangleMesh(const PxTriangleMeshDesc& desc, const PxCookingParams& params)
+{
+  const bool enabled = !GetFolder().empty();
+  const uint64_t key = enabled ? HashTriangleMesh(desc, params) : 0;
+
+  MappedFile file;
+  if (enabled && Map(key, PhysXCookedMeshType::eTRIANGLE_MESH, &file)) {
+    PxDefaultMemoryInputData input(const_cast<PxU8*>(file.GetData()) + sizeof(PhysXCookingCacheHeader),
+                                   file.GetSize() - sizeof(PhysXCookingCacheHeader));
+    PxTriangleMesh* mesh = m_PxPhysics->createTriangleMesh(input);
+    if (mesh) {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_Stats.Hits++;
+      m_Stats.BytesRead += file.GetSize();
+      return mesh;
+    }
+    Yeager::Log(WARNING, "PhysX cannot read the cooked triangle mesh {}, it will be cooked again", GetCachePath(key));
+  }
+
+  PxDefaultMemoryOutputStream buffer;
+  PxTriangleMeshCookingResult::Enum result;
+  if (!PxCookTriangleMesh(params, desc, buffer, &result)) {
+    Yeager::Log(ERROR, "PhysX cannot cook the triangle mesh! Result {}", static_cast<int>(result));
+    return YEAGER_NULLPTR;
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Stats.Cooked++;
+  }
+  if (enabled) {
+    Write(key, PhysXCookedMeshType::eTRIANGLE_MESH, buffer);
+  }
+  PxDefaultMemoryInputData input(buffer.getData(), buffer.getSize());
+  return m_PxPhysics->createTriangleMesh(input);
+}
+
+PxConvexMesh* PhysXCookingCache::CreateConvexMesh(const PxConvexMeshDesc& desc, const PxCookingParams& params)
+{
+  const bool enabled = !GetFolder().empty();
+  const uint64_t key = enabled ? HashConvexMesh(desc, params) : 0;
+
+  MappedFile file;
+  if (enabled && Map(key, PhysXCookedMeshType::eCONVEX_MESH, &file)) {
+    PxDefaultMemoryInputData input(const_cast<PxU8*>(file.GetData()) + sizeof(PhysXCookingCacheHeader),
+                                   file.GetSize() - sizeof(PhysXCookingCacheHeader));
+    PxConvexMesh* mesh = m_PxPhysics->createConvexMesh(input);
+    if (mesh) {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_Stats.Hits++;
+      m_Stats.BytesRead += file.GetSize();
+      return mesh;
+    }
+    Yeager::Log(WARNING, "PhysX cannot read the cooked convex mesh {}, it will be cooked again", GetCachePath(key));
+  }
+
+  PxDefaultMemoryOutputStream buffer;
+  PxConvexMeshCookingResult::Enum result;
+  if (!PxCookConvexMesh(params, desc, buffer, &result)) {
+    Yeager::Log(ERROR, "PhysX cannot cook the convex mesh! Result {}", static_cast<int>(result));
+    return YEAGER_NULLPTR;
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Stats.Cooked++;
+  }
+  if (enabled) {
+    Write(key, PhysXCookedMeshType::eCONVEX_MESH, buffer);
+  }
+  PxDefaultMemoryInputData input(buffer.getData(), buffer.getSize());
+  return m_PxPhysics->createConvexMesh(input);
+}
+
+bool PhysXCookingCache::LoadConvexDecomposition(uint64_t key, std::vector<std::vector<PxVec3>>* hulls)
+{
+  MappedFile file;
+  if (GetFolder().empty() || !Map(key, PhysXCookedMeshType::eCONVEX_DECOMPOSITION, &file)) {
+    return false;
+  }
+
+  hulls->clear();
+  size_t offset = sizeof(PhysXCookingCacheHeader);
+  const uint32_t* hullCount = file.At<uint32_t>(offset);
+  offset += sizeof(uint32_t);
+  for (uint32_t x = 0; hullCount && x < *hullCount; x++) {
+    const uint32_t* pointCount = file.At<uint32_t>(offset);
+    offset += sizeof(uint32_t);
+    const PxVec3* points = pointCount ? file.At<PxVec3>(offset, *pointCount) : YEAGER_NULLPTR;
+    if (!points) {
+      hullCount = YEAGER_NULLPTR;
+      break;
+    }
+    hulls->emplace_back(points, points + *pointCount);
+    offset += static_cast<size_t>(*pointCount) * sizeof(PxVec3);
+  }
+  if (!hullCount || offset != file.GetSize()) {
+    Yeager::Log(WARNING, "PhysX convex decomposition {} is truncated, it will be decomposed again", GetCachePath(key));
+    hulls->clear();
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Stats.Hits++;
+  m_Stats.BytesRead += file.GetSize();
+  return true;
+}
+
+void PhysXCookingCache::StoreConvexDecomposition(uint64_t key, const std::vector<std::vector<PxVec3>>& hulls)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Stats.Cooked++;
+  }
+  if (GetFolder().empty()) {
+    return;
+  }
+
+  PxDefaultMemoryOutputStream buffer;
+  const uint32_t hullCount = hulls.size();
+  buffer.write(&hullCount, sizeof(uint32_t));
+  for (const std::vector<PxVec3>& hull : hulls) {
+    const uint32_t pointCount = hull.size();
+    buffer.write(&pointCount, sizeof(uint32_t));
+    buffer.write(hull.data(), pointCount * sizeof(PxVec3));
+  }
+  Write(key, PhysXCookedMeshType::eCONVEX_DECOMPOSITION, buffer);
+}
@@ -0,0 +1,119 @@
+//    Yeager Engine, free and open source 3D/2D renderer written in OpenGL
+//    In case of questions and bugs, please, refer to the issue tab on github
+//    Repo : https://github.com/schwq/YeagerEngine
+//    Copyright (C) 2023 - Present
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Common/Utils/Common.h"
+#include "Common/Utils/LogEngine.h"
+#include "Common/Utils/Utilities.h"
+
+#include "PhysxAllocator.h"
+
+#include <mutex>
+
+namespace Yeager {
+class MappedFile;
+struct PhysXTriangleMeshInput;
+struct PhysXConvexDecompositionSettings;
+
+#define YEAGER_PHYSX_COOKING_CACHE_EXT_STR ".ygen_px_cache"
+#define YEAGER_PHYSX_COOKING_CACHE_VERSION 1
+/* Part of the key of the decompositions, a change in PhysXConvexDecomposition that moves the hulls must bump it */
+#define YEAGER_PHYSX_CONVEX_DECOMPOSITION_VERSION 1
+
+struct PhysXCookedMeshType {
+  enum Enum { eTRIANGLE_MESH, eCONVEX_MESH, eCONVEX_DECOMPOSITION };
+};
+
+/**
+ * PhysX cooking cache file (key).ygen_px_cache, the key hashes the geometry, the cooking params and the version of
+ * PhysX. The cooked data is what PxCookTriangleMesh and PxCookConvexMesh write to the stream
+ * Header - PhysXCookingCacheHeader (32 bytes)
+ * Data - DataSize bytes of cooked mesh
+ * A convex decomposition keeps the points of its hulls instead, each hull is then cooked through the cache
+ * Data - uint32_t count of hulls, for each hull an uint32_t count of points and the PxVec3 points
+ */
+struct PhysXCookingCacheHeader {
+  char MagicConst[4] = {0};
+  uint32_t Version = 0;
+  uint32_t PhysXVersion = 0;
+  uint32_t MeshType = 0;
+  uint64_t Key = 0;
+  uint64_t DataSize = 0;
+};
+
+/// @brief Counters of the cache, cooked are the meshes that missed the cache
+struct PhysXCookingCacheStats {
+  Uint Hits = 0;
+  Uint Cooked = 0;
+  uint64_t BytesRead = 0;
+  uint64_t BytesWritten = 0;
+};
+
+/**
+ * @brief Cooked triangle and convex meshes on disk, cooking dominates the load of the scenes with a lot of collision.
+ * A mesh seen before is created straight from the cooked stream, the others are cooked and written for the next load.
+ * Without a folder the meshes are always cooked, the folder is the Physics cache of the project
+ */
+class PhysXCookingCache {
+ public:
+  PhysXCookingCache(physx::PxPhysics* physics) : m_PxPhysics(physics) {}
+
+  /** Empty disables the cache, the folder is created if it does not exist */
+  void SetFolder(const String& folder);
+  YEAGER_NODISCARD String GetFolder() const;
+
+  /** Cooks or loads the mesh, returns null if the description cannot be cooked */
+  YEAGER_NODISCARD physx::PxTriangleMesh* CreateTriangleMesh(const physx::PxTriangleMeshDesc& desc,
+                                                             const physx::PxCookingParams& params);
+  YEAGER_NODISCARD physx::PxConvexMesh* CreateConvexMesh(const physx::PxConvexMeshDesc& desc,
+                                                         const physx::PxCookingParams& params);
+
+  /** Hashes the points and triangles through their strides, so descriptions of the same geometry match */
+  static uint64_t HashTriangleMesh(const physx::PxTriangleMeshDesc& desc, const physx::PxCookingParams& params);
+  static uint64_t HashConvexMesh(const physx::PxConvexMeshDesc& desc, const physx::PxCookingParams& params);
+  static uint64_t HashConvexDecomposition(const PhysXTriangleMeshInput& mesh,
+                                          const PhysXConvexDecompositionSettings& settings);
+
+  /**
+   * @brief Points of the hulls of the decomposition of the key, the decomposition takes far longer than the cooking
+   * @return False if the cache is disabled or has no valid file for the key
+   */
+  bool LoadConvexDecomposition(uint64_t key, std::vector<std::vector<physx::PxVec3>>* hulls);
+  void StoreConvexDecomposition(uint64_t key, const std::vector<std::vector<physx::PxVec3>>& hulls);
+
+  YEAGER_NODISCARD String GetCachePath(uint64_t key) const;
+  YEAGER_NODISCARD PhysXCookingCacheStats GetStats() const;
+  void ResetStats();
+
+ private:
+  /**
+   * @brief Maps the file of the key, the cooked data follows the header
+   * @return False if the file is missing, invalid or from another version
+   */
+  bool Map(uint64_t key, PhysXCookedMeshType::Enum type, MappedFile* file) const;
+  void Write(uint64_t key, PhysXCookedMeshType::Enum type, const physx::PxDefaultMemoryOutputStream& stream);
+
+  physx::PxPhysics* m_PxPhysics = YEAGER_NULLPTR;
+  /* The models are imported in other threads */
+  mutable std::mutex m_Mutex;
+  String m_Folder;
+  PhysXCookingCacheStats m_Stats;
+};
+
+}  // namespace Yeager
@@ -0,0 +1,88 @@
+#include "PhysXCpuDispatcher.h"
+using namespace Yeager;
+using namespace physx;
+
+PhysXCpuDispatcher::PhysXCpuDispatcher(WorkerPool* pool, Uint maxThreads) : m_Pool(pool), m_MaxThreads(maxThreads)
+{
+  Yeager::Log(INFO, "PhysX tasks run in the worker pool, {} of {} workers", getWorkerCount(),
+              m_Pool->GetWorkersCount());
+}
+
+PhysXCpuDispatcher::~PhysXCpuDispatcher()
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  m_Idle.wait(lock, [this] { return m_Running == 0; });
+}
+
+void PhysXCpuDispatcher::submitTask(PxBaseTask& task)
+{
+  if (m_Pool->GetWorkersCount() == 0) {
+    task.run();
+    task.release();
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Stats.Tasks++;
+    m_Stats.InlineTasks++;
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_Running >= getWorkerCount()) {
+      m_Pending.push_back(&task);
+      return;
+    }
+    m_Running++;
+    m_Stats.PeakRunning = std::max(m_Stats.PeakRunning, m_Running);
+  }
+  m_Pool->Submit([this, &task]() { RunTasks(&task); }, TaskPriority::eHIGH);
+}
+
+void PhysXCpuDispatcher::RunTasks(PxBaseTask* task)
+{
+  while (task) {
+    task->run();
+    task->release();
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Stats.Tasks++;
+    /* Above the limit when it was lowered, the last task running always goes on so none is left waiting */
+    if (!m_Pending.empty() && m_Running <= getWorkerCount()) {
+      task = m_Pending.front();
+      m_Pending.pop_front();
+    } else {
+      task = YEAGER_NULLPTR;
+      m_Running--;
+      /* Under the lock, the destructor may run as soon as it sees no task running */
+      m_Idle.notify_all();
+    }
+  }
+}
+
+PxU32 PhysXCpuDispatcher::getWorkerCount() const
+{
+  const Uint workers = std::max<Uint>(1, m_Pool->GetWorkersCount());
+  const Uint maxThreads = m_MaxThreads;
+  return maxThreads == 0 ? workers : std::min(maxThreads, workers);
+}
+
+void PhysXCpuDispatcher::SetMaxThreads(Uint maxThreads)
+{
+  m_MaxThreads = maxThreads;
+}
+
+Uint PhysXCpuDispatcher::GetMaxThreads() const
+{
+  return m_MaxThreads;
+}
+
+PhysXCpuDispatcherStats PhysXCpuDispatcher::GetStats() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Stats;
+}
+
+void PhysXCpuDispatcher::ResetStats()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Stats = PhysXCpuDispatcherStats();
+}
@@ -0,0 +1,85 @@
+//    Yeager Engine, free and open source 3D/2D renderer written in OpenGL
+//    In case of questions and bugs, please, refer to the issue tab on github
+//    Repo : https://github.com/schwq/YeagerEngine
+//    Copyright (C) 2023 - Present
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Common/Utils/Common.h"
+#include "Common/Utils/LogEngine.h"
+#include "Common/Utils/Utilities.h"
+#include "Components/Kernel/Process/WorkerPool.h"
+
+#include "PhysxAllocator.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+namespace Yeager {
+
+/// @brief Counters of the dispatcher shown in the debug window
+struct PhysXCpuDispatcherStats {
+  uint64_t Tasks = 0;
+  /* Tasks run in submitTask, the pool had no workers */
+  uint64_t InlineTasks = 0;
+  /* Most tasks running at once since the last reset */
+  Uint PeakRunning = 0;
+};
+
+/**
+ * @brief Runs the tasks of the PhysX steps in the engine WorkerPool, with the high priority, instead of the threads of
+ * PxDefaultCpuDispatcher. Physics shares the cores with the terrain, skinning and the other work of the pool instead of
+ * competing with it, and uses every worker when nothing else is queued. The tasks running at once can be limited,
+ * the tasks past the limit wait in the dispatcher and are run by the pool tasks already running, one after the other.
+ * A pool without workers (one hardware thread) runs the tasks in submitTask, as the default dispatcher does without
+ * threads
+ */
+class PhysXCpuDispatcher : public physx::PxCpuDispatcher {
+ public:
+  /** @param maxThreads Tasks running at once, 0 is every worker of the pool */
+  PhysXCpuDispatcher(WorkerPool* pool, Uint maxThreads = 0);
+  /** Waits for the pool tasks still finishing, the last PhysX task of a step is released before they return */
+  ~PhysXCpuDispatcher();
+
+  PhysXCpuDispatcher(const PhysXCpuDispatcher&) = delete;
+  PhysXCpuDispatcher& operator=(const PhysXCpuDispatcher&) = delete;
+
+  virtual void submitTask(physx::PxBaseTask& task);
+  virtual physx::PxU32 getWorkerCount() const;
+
+  /** Only the tasks submitted after this see the new limit, 0 is every worker of the pool */
+  void SetMaxThreads(Uint maxThreads);
+  YEAGER_NODISCARD Uint GetMaxThreads() const;
+  YEAGER_NODISCARD WorkerPool* GetWorkerPool() { return m_Pool; }
+
+  YEAGER_NODISCARD PhysXCpuDispatcherStats GetStats() const;
+  void ResetStats();
+
+ private:
+  /* Runs the task and then the ones waiting for a free thread */
+  void RunTasks(physx::PxBaseTask* task);
+
+  WorkerPool* m_Pool = YEAGER_NULLPTR;
+  mutable std::mutex m_Mutex;
+  std::condition_variable m_Idle;
+  std::deque<physx::PxBaseTask*> m_Pending;
+  std::atomic<Uint> m_MaxThreads = 0;
+  Uint m_Running = 0;
+  PhysXCpuDispatcherStats m_Stats;
+};
+
+}  // namespace Yeager
@@ -0,0 +1,53 @@
+#include "PhysXFixedStep.h"
+
+using namespace Yeager;
+
+PhysXFixedStep::PhysXFixedStep(float stepRate, Uint maxSubsteps)
+{
+  SetStepRate(stepRate);
+  SetMaxSubsteps(maxSubsteps);
+}
+
+void PhysXFixedStep::SetStepRate(float stepRate)
+{
+  if (!(stepRate >= YEAGER_PHYSX_MIN_STEP_RATE && stepRate <= YEAGER_PHYSX_MAX_STEP_RATE)) {
+    Yeager::Log(WARNING, "PhysX step rate {} out of range, clamped between {} and {}", stepRate,
+                YEAGER_PHYSX_MIN_STEP_RATE, YEAGER_PHYSX_MAX_STEP_RATE);
+    stepRate = std::isnan(stepRate) ? YEAGER_PHYSX_DEFAULT_STEP_RATE
+                                    : std::clamp(stepRate, YEAGER_PHYSX_MIN_STEP_RATE, YEAGER_PHYSX_MAX_STEP_RATE);
+  }
+  m_StepNanoseconds = std::llround(1e9 / stepRate);
+  /* A shorter step must not see a whole step waiting in the accumulator */
+  m_Accumulator = std::min(m_Accumulator, m_StepNanoseconds - 1);
+}
+
+void PhysXFixedStep::SetMaxSubsteps(Uint maxSubsteps)
+{
+  m_MaxSubsteps = std::max<Uint>(maxSubsteps, 1);
+}
+
+Uint PhysXFixedStep::Advance(float deltaTime)
+{
+  /* Negative and NaN times (a clock going back) add nothing */
+  if (deltaTime > 0.0f) {
+    m_Accumulator += std::llround(static_cast<double>(deltaTime) * 1e9);
+  }
+
+  const Uint steps = std::min<uint64_t>(m_Accumulator / m_StepNanoseconds, m_MaxSubsteps);
+  m_Accumulator -= steps * m_StepNanoseconds;
+  if (m_Accumulator >= m_StepNanoseconds) {
+    /* Keeps the fraction of a step, so the interpolation does not jump after a hitch */
+    const uint64_t kept = m_Accumulator % m_StepNanoseconds;
+    m_DroppedNanoseconds += m_Accumulator - kept;
+    m_Accumulator = kept;
+  }
+  m_StepCount += steps;
+  return steps;
+}
+
+void PhysXFixedStep::Reset()
+{
+  m_Accumulator = 0;
+  m_StepCount = 0;
+  m_DroppedNanoseconds = 0;
+}
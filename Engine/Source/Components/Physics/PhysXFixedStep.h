@@ -0,0 +1,73 @@
+//    Yeager Engine, free and open source 3D/2D renderer written in OpenGL
+//    In case of questions and bugs, please, refer to the issue tab on github
+//    Repo : https://github.com/schwq/YeagerEngine
+//    Copyright (C) 2023 - Present
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Common/Utils/Common.h"
+#include "Common/Utils/LogEngine.h"
+#include "Common/Utils/Utilities.h"
+
+namespace Yeager {
+
+#define YEAGER_PHYSX_DEFAULT_STEP_RATE 60.0f
+#define YEAGER_PHYSX_DEFAULT_MAX_SUBSTEPS 4
+#define YEAGER_PHYSX_MIN_STEP_RATE 10.0f
+#define YEAGER_PHYSX_MAX_STEP_RATE 1000.0f
+
+/**
+ * @brief Accumulator of the frame time that hands out physics steps of a fixed length. The time is kept in integer
+ * nanoseconds, the same sequence of frame times always gives the same sequence of steps. A frame never runs more than
+ * the max substeps, the time beyond it is dropped, otherwise a slow step makes the next frame slower (spiral of death)
+ */
+class PhysXFixedStep {
+ public:
+  PhysXFixedStep(float stepRate = YEAGER_PHYSX_DEFAULT_STEP_RATE, Uint maxSubsteps = YEAGER_PHYSX_DEFAULT_MAX_SUBSTEPS);
+
+  /** Steps per second, clamped between YEAGER_PHYSX_MIN_STEP_RATE and YEAGER_PHYSX_MAX_STEP_RATE */
+  void SetStepRate(float stepRate);
+  YEAGER_NODISCARD float GetStepRate() const { return 1e9 / m_StepNanoseconds; }
+  YEAGER_NODISCARD float GetStepSeconds() const { return m_StepNanoseconds * 1e-9; }
+
+  /** At least one */
+  void SetMaxSubsteps(Uint maxSubsteps);
+  YEAGER_NODISCARD Uint GetMaxSubsteps() const { return m_MaxSubsteps; }
+
+  /**
+   * @brief Adds the time of the frame to the accumulator
+   * @return Count of steps the frame must run, between 0 and the max substeps
+   */
+  Uint Advance(float deltaTime);
+
+  /** Fraction of a step left in the accumulator, from 0 to 1. Where the rendering is between the last two steps */
+  YEAGER_NODISCARD float GetAlpha() const { return static_cast<double>(m_Accumulator) / m_StepNanoseconds; }
+  YEAGER_NODISCARD uint64_t GetStepCount() const { return m_StepCount; }
+  /** Frame time thrown away by the max substeps */
+  YEAGER_NODISCARD double GetDroppedSeconds() const { return m_DroppedNanoseconds * 1e-9; }
+
+  /** Empties the accumulator and the counters, the rate and the max substeps stay */
+  void Reset();
+
+ private:
+  uint64_t m_StepNanoseconds = 0;
+  uint64_t m_Accumulator = 0;
+  Uint m_MaxSubsteps = YEAGER_PHYSX_DEFAULT_MAX_SUBSTEPS;
+  uint64_t m_StepCount = 0;
+  uint64_t m_DroppedNanoseconds = 0;
+};
+
+}  // namespace Yeager
@@ -1,6 +1,8 @@
 #include "PhysXGeometryHandle.h"
 #include "Components/Loader/Importer.h"
+#include "Components/TerrainGen/TerrainChunkManager.h"
 #include "Main/Core/Application.h"
+#include "PhysXConvexDecomposition.h"
 
 using namespace Yeager;
 using namespace physx;
@@ -134,13 +136,7 @@ PxTriangleMesh* PhysXGeometryHandle::CreateTriangleMesh(physx::PxU32 pointCount,
 #endif
 
   if (yeagerPhysxFlags == YEAGER_PHYSX_COOKING_STREAM_SERIALIZATION_ENABLED) {
-    PxDefaultMemoryOutputStream buffer;
-    PxTriangleMeshCookingResult::Enum result;
-    if (!PxCookTriangleMesh(params, meshDesc, buffer, &result)) {
-      Yeager::Log(ERROR, "Cannot PxCookConvexMesh failed!");
-    }
-    PxDefaultMemoryInputData input(buffer.getData(), buffer.getSize());
-    return m_PhysXHandle->GetPxPhysics()->createTriangleMesh(input);
+    return GetCookingCache()->CreateTriangleMesh(meshDesc, params);
   } else {
     return PxCreateTriangleMesh(params, meshDesc, m_PhysXHandle->GetPxPhysics()->getPhysicsInsertionCallback());
   }
@@ -154,7 +150,7 @@ PxTriangleMesh* PhysXGeometryHandle::CreateTriangleMesh(const Yeager::PhysXTrian
   meshDesc.points.stride = sizeof(PxVec3);
   meshDesc.points.data = &mesh.Vertices[0];
 
-  meshDesc.triangles.count = mesh.Vertices.size() / 3;
+  meshDesc.triangles.count = mesh.Indices.size() / 3;
   meshDesc.triangles.stride = 3 * sizeof(PxU32);
   meshDesc.triangles.data = &mesh.Indices[0];
 
@@ -171,18 +167,249 @@ PxTriangleMesh* PhysXGeometryHandle::CreateTriangleMesh(const Yeager::PhysXTrian
   }
 
   if (yeagerPhysxFlags == YEAGER_PHYSX_COOKING_STREAM_SERIALIZATION_ENABLED) {
-    PxDefaultMemoryOutputStream buffer;
-    PxTriangleMeshCookingResult::Enum result;
-    if (!PxCookTriangleMesh(params, meshDesc, buffer, &result)) {
-      Yeager::Log(ERROR, "Cannot PxCookConvexMesh failed!");
-    }
-    PxDefaultMemoryInputData input(buffer.getData(), buffer.getSize());
-    return m_PhysXHandle->GetPxPhysics()->createTriangleMesh(input);
+    return GetCookingCache()->CreateTriangleMesh(meshDesc, params);
   } else {
     return PxCreateTriangleMesh(params, meshDesc, m_PhysXHandle->GetPxPhysics()->getPhysicsInsertionCallback());
   }
 }
 
+PxConvexMesh* PhysXGeometryHandle::CreateConvexMesh(const std::vector<physx::PxVec3>& points, physx::PxU16 vertexLimit,
+                                                    float inflation)
+{
+  PhysXConvexHull hull;
+  if (inflation > 0.0f) {
+    if (!hull.Build(points)) {
+      Yeager::Log(ERROR, "PhysX cannot inflate the convex hull, the {} points are flat!", points.size());
+      return YEAGER_NULLPTR;
+    }
+    hull.Inflate(inflation);
+  }
+  const std::vector<PxVec3>& hullPoints = inflation > 0.0f ? hull.Vertices : points;
+
+  PxConvexMeshDesc convexDesc;
+  convexDesc.points.count = hullPoints.size();
+  convexDesc.points.stride = sizeof(PxVec3);
+  convexDesc.points.data = hullPoints.data();
+  convexDesc.flags = PxConvexFlag::eCOMPUTE_CONVEX;
+  convexDesc.vertexLimit = std::clamp<PxU16>(vertexLimit, 4, 255);
+
+  PxTolerancesScale scale;
+  PxCookingParams params(scale);
+  return GetCookingCache()->CreateConvexMesh(convexDesc, params);
+}
+
+std::vector<PxConvexMesh*> PhysXGeometryHandle::CreateConvexDecomposition(
+    const Yeager::PhysXTriangleMeshInput& mesh, const Yeager::PhysXConvexDecompositionSettings& settings)
+{
+  std::vector<PxConvexMesh*> meshes;
+  PhysXCookingCache* cache = GetCookingCache();
+  const uint64_t key = PhysXCookingCache::HashConvexDecomposition(mesh, settings);
+  std::vector<std::vector<PxVec3>> hulls;
+  if (!cache->LoadConvexDecomposition(key, &hulls)) {
+    if (!PhysXConvexDecomposition::Decompose(mesh, settings, &hulls)) {
+      return meshes;
+    }
+    cache->StoreConvexDecomposition(key, hulls);
+  }
+
+  for (const std::vector<PxVec3>& hull : hulls) {
+    PxConvexMesh* convex = CreateConvexMesh(hull, settings.VertexLimit);
+    if (convex != YEAGER_NULLPTR) {
+      meshes.push_back(convex);
+    }
+  }
+  return meshes;
+}
+
+bool PhysXGeometryHandle::ValidateConvexMesh(const physx::PxConvexMesh& mesh, float tolerance)
+{
+  if (mesh.getNbVertices() < 4 || mesh.getNbPolygons() < 4) {
+    return false;
+  }
+  PxReal mass = 0.0f;
+  PxMat33 inertia;
+  PxVec3 centerOfMass;
+  mesh.getMassInformation(mass, inertia, centerOfMass);
+  if (!(mass > 0.0f)) {
+    return false;
+  }
+
+  const PxVec3* vertices = mesh.getVertices();
+  for (PxU32 x = 0; x < mesh.getNbPolygons(); x++) {
+    PxHullPolygon polygon;
+    if (!mesh.getPolygonData(x, polygon)) {
+      return false;
+    }
+    /* The plane is normal and distance, the normal points out of the hull */
+    const PxVec3 normal(polygon.mPlane[0], polygon.mPlane[1], polygon.mPlane[2]);
+    for (PxU32 y = 0; y < mesh.getNbVertices(); y++) {
+      if (normal.dot(vertices[y]) + polygon.mPlane[3] > tolerance) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+PhysXCookingCache* PhysXGeometryHandle::GetCookingCache()
+{
+  PhysXCookingCache* cache = m_PhysXHandle->GetCookingCache();
+  /* The headless benchmarks have no application, they set the folder of the cache themselves */
+  if (m_Application != YEAGER_NULLPTR && m_Application->GetScene() != YEAGER_NULLPTR) {
+    cache->SetFolder(m_Application->GetScene()->GetPhysicsCacheFolderPath());
+  }
+  return cache;
+}
+
+bool PhysXGeometryHandle::BuildHeightFieldSamples(const PhysXHeightFieldInput& input,
+                                                  std::vector<physx::PxHeightFieldSample>* samples, float* heightScale,
+                                                  float* heightOffset)
+{
+  if (input.Heights == YEAGER_NULLPTR || input.Width < 2 || input.Depth < 2) {
+    Yeager::Log(ERROR, "PhysX heightfield needs at least 2 x 2 samples, got {} x {}!", input.Width, input.Depth);
+    return false;
+  }
+
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(input.Heights);
+  auto height = [&](int x, int z) {
+    return *reinterpret_cast<const float*>(bytes + z * input.RowStride + x * input.SampleStride);
+  };
+
+  float min = std::numeric_limits<float>::max(), max = std::numeric_limits<float>::lowest();
+  for (int z = 0; z < input.Depth; z++) {
+    for (int x = 0; x < input.Width; x++) {
+      min = std::min(min, height(x, z));
+      max = std::max(max, height(x, z));
+    }
+  }
+
+  /* The samples go from -32767 to 32767 around the middle of the range, a flat grid still needs a valid scale */
+  *heightOffset = (min + max) * 0.5f;
+  *heightScale = std::max((max - min) / 65534.0f, PX_MIN_HEIGHTFIELD_Y_SCALE);
+  const float inverseScale = 1.0f / *heightScale;
+
+  samples->resize(static_cast<size_t>(input.Width) * input.Depth);
+  for (int z = 0; z < input.Depth; z++) {
+    for (int x = 0; x < input.Width; x++) {
+      const float quantized = std::round((height(x, z) - *heightOffset) * inverseScale);
+      PxHeightFieldSample& sample = (*samples)[static_cast<size_t>(x) * input.Depth + z];
+      sample.height = static_cast<PxI16>(std::clamp(quantized, -32767.0f, 32767.0f));
+      sample.materialIndex0 = 0;
+      sample.materialIndex1 = 0;
+      /* Splits the cell from the sample (row, column) to (row + 1, column + 1) */
+      sample.setTessFlag();
+    }
+  }
+  return true;
+}
+
+PhysXHeightField PhysXGeometryHandle::CreateHeightField(physx::PxPhysics* physics, const PhysXHeightFieldInput& input)
+{
+  PhysXHeightField heightField;
+  std::vector<PxHeightFieldSample> samples;
+  float heightScale = 1.0f;
+  if (!BuildHeightFieldSamples(input, &samples, &heightScale, &heightField.aHeightOffset)) {
+    return heightField;
+  }
+
+  PxHeightFieldDesc desc;
+  desc.format = PxHeightFieldFormat::eS16_TM;
+  desc.nbRows = input.Width;
+  desc.nbColumns = input.Depth;
+  desc.samples.data = samples.data();
+  desc.samples.stride = sizeof(PxHeightFieldSample);
+  if (input.NoBoundaryEdges) {
+    desc.flags |= PxHeightFieldFlag::eNO_BOUNDARY_EDGES;
+  }
+
+  if (!desc.isValid()) {
+    Yeager::Log(ERROR, "PhysX cannot create a heightfield, the PxHeightFieldDesc is not valid!");
+    return heightField;
+  }
+
+  heightField.aHeightField = PxCreateHeightField(desc, physics->getPhysicsInsertionCallback());
+  if (heightField.aHeightField == YEAGER_NULLPTR) {
+    Yeager::Log(ERROR, "PxCreateHeightField failed! {} x {} samples", input.Width, input.Depth);
+    return heightField;
+  }
+
+  heightField.aGeometry = PxHeightFieldGeometry(heightField.aHeightField, PxMeshGeometryFlags(), heightScale,
+                                                input.WorldScale, input.WorldScale);
+  heightField.aPose = PxTransform(PxVec3(0.0f, heightField.aHeightOffset, 0.0f));
+  return heightField;
+}
+
+PhysXHeightField PhysXGeometryHandle::CreateHeightFieldActor(const PhysXHeightFieldInput& input, const Vector3& origin,
+                                                            physx::PxMaterial& material)
+{
+  PhysXHeightField heightField = CreateHeightField(m_PhysXHandle->GetPxPhysics(), input);
+  if (heightField.aHeightField == YEAGER_NULLPTR) {
+    return heightField;
+  }
+
+  heightField.aPose.p += Vector3ToPxVec3(origin);
+  heightField.aHeightFieldActor = CreateStatic(m_PhysXHandle, heightField.aPose, heightField.aGeometry, material);
+  return heightField;
+}
+
+PhysXHeightField PhysXGeometryHandle::CreateTerrainHeightField(const TerrainMetricData& metric, const Vector3& origin,
+                                                              physx::PxMaterial& material)
+{
+  const Math::Array2D<float>* heightMap = metric.m_HeightMap.get();
+  if (heightMap == YEAGER_NULLPTR || !heightMap->IsLinear()) {
+    Yeager::Log(ERROR, "PhysX terrain heightfield needs a heightmap with linear rows!");
+    return PhysXHeightField();
+  }
+
+  PhysXHeightFieldInput input;
+  input.Heights = heightMap->GetAddress(0, 0);
+  input.Width = metric.m_Width;
+  input.Depth = metric.m_Height;
+  input.RowStride = heightMap->GetPitch() * sizeof(float);
+  input.WorldScale = metric.WorldScale;
+  return CreateHeightFieldActor(input, origin, material);
+}
+
+PhysXHeightField PhysXGeometryHandle::CreateTerrainHeightField(const ProceduralTerrain& terrain,
+                                                              physx::PxMaterial& material)
+{
+  return CreateTerrainHeightField(terrain.GetMetricData(), terrain.GetWorldOrigin(), material);
+}
+
+PhysXHeightField PhysXGeometryHandle::CreateTerrainChunkHeightField(const TerrainChunkMesh& chunk,
+                                                                   const TerrainStreamingSettings& settings,
+                                                                   physx::PxMaterial& material)
+{
+  const int side = settings.ChunkQuads + 1;
+  if (chunk.Vertices.size() != static_cast<size_t>(side) * side) {
+    Yeager::Log(ERROR, "PhysX chunk heightfield, the chunk does not have the vertices of the settings!");
+    return PhysXHeightField();
+  }
+
+  PhysXHeightFieldInput input;
+  input.Heights = &chunk.Vertices[0].Position.y;
+  input.Width = side;
+  input.Depth = side;
+  input.SampleStride = sizeof(TerrainVertex);
+  input.RowStride = side * sizeof(TerrainVertex);
+  input.WorldScale = settings.WorldScale;
+  input.NoBoundaryEdges = true;
+
+  /* Same origin of the chunk when drawn by the chunk manager */
+  const float size = settings.GetChunkWorldSize();
+  return CreateHeightFieldActor(input, Vector3(chunk.Coord.X * size, -settings.MaxHeight, chunk.Coord.Z * size),
+                                material);
+}
+
+void PhysXGeometryHandle::ReleaseHeightField(PhysXHeightField* heightField)
+{
+  if (heightField->aHeightFieldActor != YEAGER_NULLPTR) {
+    m_PhysXHandle->RemoveFromScene(heightField->aHeightFieldActor);
+  }
+  PX_RELEASE(heightField->aHeightFieldActor);
+  PX_RELEASE(heightField->aHeightField);
+}
+
 void PhysXGeometryHandle::RenderShapeInformation(physx::PxRigidActor* actor)
 {
   std::vector<PxShape*> shapes = ExtractShapesFromActor(actor);
@@ -212,6 +439,17 @@ void PhysXGeometryHandle::RenderGeometryInformation(physx::PxRigidActor* actor,
     case PxGeometryType::ePLANE:
       ImGui::Text("Plane Geometry");
       break;
+    case PxGeometryType::eCONVEXMESH:
+      ImGui::Text("Convex Mesh Geometry");
+      ImGui::Text("Vertices %u Polygons %u", geom.convexMesh().convexMesh->getNbVertices(),
+                  geom.convexMesh().convexMesh->getNbPolygons());
+      break;
+    case PxGeometryType::eHEIGHTFIELD:
+      ImGui::Text("Height Field Geometry");
+      ImGui::Text("Samples %u x %u", geom.heightField().heightField->getNbRows(),
+                  geom.heightField().heightField->getNbColumns());
+      ImGui::Text("Height Scale %f", geom.heightField().heightScale);
+      break;
     case PxGeometryType::eINVALID:
       ImGui::Text("INVALID_GEOMETRY_TYPE");
       break;
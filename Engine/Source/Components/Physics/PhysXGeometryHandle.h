@@ -23,6 +23,12 @@
 namespace Yeager {
 class ApplicationCore;
 class PhysXHandle;
+class PhysXCookingCache;
+class ProceduralTerrain;
+struct TerrainMetricData;
+struct TerrainChunkMesh;
+struct TerrainStreamingSettings;
+struct PhysXConvexDecompositionSettings;
 
 #define YEAGER_PHYSX_COOKING_STREAM_SERIALIZATION_ENABLED 0x01
 #define YEAGER_PHYSX_COOKING_STREAM_SERIALIZATION_DISABLED 0x02
@@ -51,6 +57,32 @@ struct PhysXTriangleMesh {
   physx::PxTriangleMeshGeometry* aGeometry = YEAGER_NULLPTR;
 };
 
+/**
+ * @brief Heights of a grid for a PhysX heightfield, Width samples along X and Depth along Z. The strides are in bytes,
+ * so the heights are read in place from the rows of a Array2D or from the vertices of a mesh
+ */
+struct PhysXHeightFieldInput {
+  const float* Heights = YEAGER_NULLPTR;
+  int Width = 0;
+  int Depth = 0;
+  size_t SampleStride = sizeof(float);
+  size_t RowStride = 0;
+  float WorldScale = 1.0f;
+  /* The chunks of a streamed terrain ignore the edges of their border, so bodies sliding from a chunk to the next do
+   * not catch on them */
+  bool NoBoundaryEdges = false;
+};
+
+/// @brief A heightfield in the scene, the quantized heights are centered on zero and the pose moves them back up
+struct PhysXHeightField {
+  physx::PxRigidStatic* aHeightFieldActor = YEAGER_NULLPTR;
+  physx::PxHeightField* aHeightField = YEAGER_NULLPTR;
+  physx::PxHeightFieldGeometry aGeometry;
+  physx::PxTransform aPose = physx::PxTransform(physx::PxIdentity);
+  /* Height of the zero of the samples, in the space of the input heights */
+  float aHeightOffset = 0.0f;
+};
+
 static physx::PxRigidDynamic* CreateDynamic(Yeager::PhysXHandle* handle, const physx::PxTransform& trans,
                                             const physx::PxGeometry& geometry, physx::PxMaterial& material,
                                             const physx::PxVec3& velocity = physx::PxVec3(0.0f),
@@ -65,6 +97,11 @@ class PhysXGeometryHandle {
   PhysXGeometryHandle(Yeager::PhysXHandle* handle, Yeager::ApplicationCore* app);
   ~PhysXGeometryHandle() {}
 
+  /**
+   * The meshes cooked with the stream serialization go through the cooking cache of the handle, a mesh already cooked
+   * for the project is loaded from the cooked stream. Without it the mesh is inserted straight into PhysX, skipping the
+   * cleaning and the active edges
+   */
   YEAGER_NODISCARD physx::PxTriangleMesh* CreateTriangleMesh(
       physx::PxU32 pointCount, physx::PxU32 trianglesCount, physx::PxU32 pointStride, physx::PxU32 triangleStride,
       physx::PxVec3* vertices, physx::PxU32* indices,
@@ -74,6 +111,64 @@ class PhysXGeometryHandle {
       const Yeager::PhysXTriangleMeshInput& mesh,
       physx::PxU32 yeagerPhysxFlags = YEAGER_PHYSX_COOKING_STREAM_SERIALIZATION_ENABLED);
 
+  /**
+   * Convex hull of the points, at most vertexLimit vertices (255 is the limit of PhysX). The hull is grown by inflation
+   * before the cooking, so the vertices dropped by the limit do not cut into the mesh
+   */
+  YEAGER_NODISCARD physx::PxConvexMesh* CreateConvexMesh(const std::vector<physx::PxVec3>& points,
+                                                         physx::PxU16 vertexLimit = 255, float inflation = 0.0f);
+
+  /**
+   * Convex hulls of the decomposition of a concave mesh, the shapes of a dynamic body that follow the mesh where a
+   * single hull would fill the holes. The decomposition is kept in the cooking cache with the cooked hulls
+   */
+  YEAGER_NODISCARD std::vector<physx::PxConvexMesh*> CreateConvexDecomposition(
+      const Yeager::PhysXTriangleMeshInput& mesh, const Yeager::PhysXConvexDecompositionSettings& settings);
+
+  /**
+   * @brief Checks a cooked convex mesh: a closed hull with volume and every vertex behind the planes of every polygon,
+   * up to the tolerance
+   */
+  static bool ValidateConvexMesh(const physx::PxConvexMesh& mesh, float tolerance = 1e-3f);
+
+  /**
+   * Terrain collision as PhysX heightfields, built straight from the heights with nothing to cook. A sample takes 4
+   * bytes against the cooked vertices, triangles and BVH of the same grid as a triangle mesh. The heights are quantized
+   * to 16 bits over the range of the grid, so a sample differs at most by half the heightScale of the geometry. Every
+   * cell is split by the diagonal from (x, z) to (x + 1, z + 1), the same triangles of the terrain meshes
+   */
+
+  /**
+   * @brief Quantizes the heights in the order of PhysX, the rows of a heightfield go along X and the columns along Z
+   * @return False if the input has less than 2 x 2 samples
+   */
+  static bool BuildHeightFieldSamples(const PhysXHeightFieldInput& input,
+                                      std::vector<physx::PxHeightFieldSample>* samples, float* heightScale,
+                                      float* heightOffset);
+
+  /** Creates the heightfield and its geometry without any actor, the pose only holds the height offset */
+  YEAGER_NODISCARD static PhysXHeightField CreateHeightField(physx::PxPhysics* physics,
+                                                             const PhysXHeightFieldInput& input);
+
+  /**
+   * @brief Static actor of the heightfield added to the scene, origin is the position of the sample (0, 0) in the world
+   */
+  PhysXHeightField CreateHeightFieldActor(const PhysXHeightFieldInput& input, const Vector3& origin,
+                                          physx::PxMaterial& material);
+
+  /** Collision of a whole terrain, read from the heightmap of the metric data (linear and pitched layouts) */
+  PhysXHeightField CreateTerrainHeightField(const TerrainMetricData& metric, const Vector3& origin,
+                                            physx::PxMaterial& material);
+  PhysXHeightField CreateTerrainHeightField(const ProceduralTerrain& terrain, physx::PxMaterial& material);
+
+  /** Collision of a chunk of a streamed terrain, read from the heights of its vertices */
+  PhysXHeightField CreateTerrainChunkHeightField(const TerrainChunkMesh& chunk,
+                                                 const TerrainStreamingSettings& settings,
+                                                 physx::PxMaterial& material);
+
+  /** Removes the actor from the scene and releases it with the heightfield, for evicted chunks */
+  void ReleaseHeightField(PhysXHeightField* heightField);
+
   /**
    * Primitives PhysX geometries types
    * Functions below create spheres, boxes, capsules and planes automatically and adds them to the scene
@@ -108,6 +203,9 @@ class PhysXGeometryHandle {
   void RenderGeometryInformation(physx::PxRigidActor* actor, physx::PxShape* shape);
 
  private:
+  /** The cooking cache pointing to the Physics cache folder of the project loaded */
+  Yeager::PhysXCookingCache* GetCookingCache();
+
   Yeager::PhysXHandle* m_PhysXHandle = YEAGER_NULLPTR;
   Yeager::ApplicationCore* m_Application = YEAGER_NULLPTR;
 };
@@ -1,5 +1,6 @@
 #include "PhysXHandle.h"
 #include "Main/Core/Application.h"
+#include "PhysXActor.h"
 #include "PhysXGeometryHandle.h"
 using namespace Yeager;
 using namespace physx;
@@ -54,12 +55,52 @@ Vector3 Yeager::PxVec3ToVector3(const PxVec3& vec)
   return rt;
 }
 
+PxQuat Yeager::EulerDegreesToPxQuat(const Vector3& rotation)
+{
+  const PxQuat x(PxDegToRad(rotation.x), PxVec3(1.0f, 0.0f, 0.0f));
+  const PxQuat y(PxDegToRad(rotation.y), PxVec3(0.0f, 1.0f, 0.0f));
+  const PxQuat z(PxDegToRad(rotation.z), PxVec3(0.0f, 0.0f, 1.0f));
+  return x * y * z;
+}
+
+Vector3 Yeager::PxQuatToEulerDegrees(const PxQuat& quat)
+{
+  /* Row 0 of X * Y * Z is (cy cz, -cy sz, sy), column 2 is (sy, -sx cy, cx cy) */
+  const PxMat33 m(quat);
+  const float sinY = PxClamp(m(0, 2), -1.0f, 1.0f);
+  Vector3 rotation(0.0f);
+  rotation.y = PxAsin(sinY);
+  if (PxAbs(sinY) < 0.9999f) {
+    rotation.x = PxAtan2(-m(1, 2), m(2, 2));
+    rotation.z = PxAtan2(-m(0, 1), m(0, 0));
+  } else {
+    /* Gimbal lock, X and Z turn around the same axis */
+    rotation.x = PxAtan2(m(2, 1), m(1, 1));
+  }
+  return Vector3(PxRadToDeg(rotation.x), PxRadToDeg(rotation.y), PxRadToDeg(rotation.z));
+}
+
+PxTransform Yeager::InterpolatePxTransform(const PxTransform& from, const PxTransform& to, float alpha)
+{
+  /* The rotation of a step is small, nlerp is close enough to slerp there. q and -q are the same rotation, the shorter
+   * way is taken */
+  const PxQuat target = from.q.dot(to.q) < 0.0f ? -to.q : to.q;
+  const PxQuat rotation = from.q * (1.0f - alpha) + target * alpha;
+  return PxTransform(from.p + (to.p - from.p) * alpha, rotation.getNormalized());
+}
+
 void PhysXHandle::PushToScene(physx::PxRigidActor* actor)
 {
   m_PxScene->addActor(*actor);
   m_PxActors.push_back(actor);
 }
 
+void PhysXHandle::RemoveFromScene(physx::PxRigidActor* actor)
+{
+  m_PxScene->removeActor(*actor);
+  m_PxActors.erase(std::remove(m_PxActors.begin(), m_PxActors.end(), actor), m_PxActors.end());
+}
+
 PhysXHandle::PhysXHandle(Yeager::ApplicationCore* app) : m_Application(app) {}
 
 bool PhysXHandle::InitPxEngine()
@@ -73,19 +114,23 @@ bool PhysXHandle::InitPxEngine()
     Yeager::Log(ERROR, "PhysX cannot create the PxFoundation!");
     return false;
   }
-
-  m_PxPvd = PxCreatePvd(*m_PxFoundation);
-
-  if (!m_PxPvd) {
-    Yeager::Log(ERROR, "PxCreatePvd failed! PhysX Visual Debugger cannot be created!");
-    return false;
-  }
-
-  m_PxPvdTransport = PxDefaultPvdSocketTransportCreate(PVD_HOST, 5425, 10);
-  if (!m_PxPvd->connect(*m_PxPvdTransport, PxPvdInstrumentationFlag::eALL)) {
-    Yeager::Log(ERROR, "m_PxPvd cannot connect to PVD!");
-  } else {
-    Yeager::Log(INFO, "PhysX connect to PVD success! Host {} Port {}", PVD_HOST, 5425);
+  /* The allocator counts the bytes of each name, without this every allocation has the same name */
+  m_PxFoundation->setReportAllocationNames(true);
+
+  if (m_PxPvdEnabled) {
+    m_PxPvd = PxCreatePvd(*m_PxFoundation);
+
+    if (!m_PxPvd) {
+      Yeager::Log(ERROR, "PxCreatePvd failed! PhysX Visual Debugger cannot be created!");
+      return false;
+    }
+
+    m_PxPvdTransport = PxDefaultPvdSocketTransportCreate(PVD_HOST, 5425, 10);
+    if (!m_PxPvd->connect(*m_PxPvdTransport, PxPvdInstrumentationFlag::eALL)) {
+      Yeager::Log(ERROR, "m_PxPvd cannot connect to PVD!");
+    } else {
+      Yeager::Log(INFO, "PhysX connect to PVD success! Host {} Port {}", PVD_HOST, 5425);
+    }
   }
   m_PxPhysics = PxCreatePhysics(PX_PHYSICS_VERSION, *m_PxFoundation, PxTolerancesScale(), true, m_PxPvd);
 
@@ -103,16 +148,14 @@ bool PhysXHandle::InitPxEngine()
     Yeager::Log(WARNING, "PxPhysx tolerance scale is not valid!");
   }
 
-  m_PxCpuDispatcher = PxDefaultCpuDispatcherCreate(Yeager::GetHardwareThreadCount() / 2);
-  if (!m_PxCpuDispatcher) {
-    Yeager::Log(ERROR, "PxDefaultCpuDispacterCreate failed!");
-    return false;
-  }
+  /* No threads of its own, the steps run in the workers of the engine */
+  m_PxCpuDispatcher = BaseAllocator::Construct<PhysXCpuDispatcher>(WorkerPool::GetGlobal());
 
   m_PxSceneDesc = BaseAllocator::Construct<PxSceneDesc>(m_PxPhysics->getTolerancesScale());
   m_PxSceneDesc->gravity = PxVec3(0.0f, -90.81f, 0.0f);
   m_PxSceneDesc->cpuDispatcher = m_PxCpuDispatcher;
   m_PxSceneDesc->filterShader = PxDefaultSimulationFilterShader;
+  m_PxSceneDesc->flags |= PxSceneFlag::eENABLE_ACTIVE_ACTORS;
 
   if (!m_PxSceneDesc->isValid()) {
     Yeager::Log(WARNING, "PxSceneDesc is not valid!");
@@ -127,8 +170,10 @@ bool PhysXHandle::InitPxEngine()
     m_PxPvdClient->setScenePvdFlag(PxPvdSceneFlag::eTRANSMIT_SCENEQUERIES, true);
   }
 
-  PxMaterial* gMaterial = m_PxPhysics->createMaterial(0.5f, 0.5f, 0.6f);
-  PxRigidStatic* groundPlane = PxCreatePlane(*m_PxPhysics, PxPlane(0, 1, 0, 0), *gMaterial);
+  m_MaterialCache = BaseAllocator::Construct<PhysXMaterialCache>(m_PxPhysics);
+  m_CookingCache = BaseAllocator::Construct<PhysXCookingCache>(m_PxPhysics);
+  m_GroundMaterial = m_MaterialCache->Acquire(YEAGER_PHYSX_GROUND_MATERIAL);
+  PxRigidStatic* groundPlane = PxCreatePlane(*m_PxPhysics, PxPlane(0, 1, 0, 0), *m_GroundMaterial);
   m_PxActors.push_back(groundPlane);
   m_PxScene->addActor(*groundPlane);
 
@@ -141,6 +186,8 @@ bool PhysXHandle::InitPxEngine()
 
 void PhysXHandle::TerminateEngine()
 {
+  EndSimulation();
+
   for (auto& capsule : m_Capsules) {
     delete capsule;
   }
@@ -149,6 +196,24 @@ void PhysXHandle::TerminateEngine()
   m_CharacterController->PhysXCharacterController::~PhysXCharacterController();
 
   PX_RELEASE(m_PxScene);
+  if (m_MaterialCache) {
+    m_MaterialCache->Release(m_GroundMaterial);
+    m_GroundMaterial = YEAGER_NULLPTR;
+    BaseAllocator::Destroy(m_MaterialCache);
+    BaseAllocator::Deallocate(m_MaterialCache);
+    m_MaterialCache = YEAGER_NULLPTR;
+  }
+  if (m_CookingCache) {
+    BaseAllocator::Destroy(m_CookingCache);
+    BaseAllocator::Deallocate(m_CookingCache);
+    m_CookingCache = YEAGER_NULLPTR;
+  }
+  /* After the scene, the tasks of its last step may still be returning to the pool */
+  if (m_PxCpuDispatcher) {
+    BaseAllocator::Destroy(m_PxCpuDispatcher);
+    BaseAllocator::Deallocate(m_PxCpuDispatcher);
+    m_PxCpuDispatcher = YEAGER_NULLPTR;
+  }
   PX_RELEASE(m_PxPhysics);
   if (m_PxExtensionsEnabled) {
     PxCloseExtensions();
@@ -161,21 +226,173 @@ void PhysXHandle::TerminateEngine()
   if (m_PxPvd) {
     m_PxPvd->release();
   }
+  PX_RELEASE(m_PxPvdTransport);
 
   PX_RELEASE(m_PxFoundation);
+  /* Every block of the foundation is back, the chunks of the pools go back to the engine */
+  m_PxAllocatorCallback.ReleasePools();
 
   BaseAllocator::Deallocate(m_PhysXGeometryHandle);
   // TODO: Check this
   //YEAGER_DELETE(m_CharacterController);
+  m_Initialized = false;
   Yeager::Log(INFO, "PhysX Engine terminated!");
 }
 
 void PhysXHandle::StartSimulation(float deltaTime)
 {
-  m_PxScene->simulate(deltaTime);
+  EndSimulation();
+
+  /* The poses drawn this frame were started with the accumulator as it is now */
+  m_InterpolationAlpha = m_FixedStep.GetAlpha();
+  m_LastFrameSteps = m_FixedStep.Advance(deltaTime);
+  if (m_LastFrameSteps == 0) {
+    return;
+  }
+
+  const float step = m_FixedStep.GetStepSeconds();
+  for (Uint x = 1; x < m_LastFrameSteps; x++) {
+    m_PxScene->simulate(step);
+    m_PxScene->fetchResults(true);
+    CollectActivePoses();
+  }
+  KeepStepStartPoses();
+  m_PxScene->simulate(step);
+  m_SimulationRunning = true;
+}
+
+bool PhysXHandle::EndSimulation(bool block)
+{
+  if (!m_SimulationRunning) {
+    return true;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  if (!m_PxScene->fetchResults(block)) {
+    return false;
+  }
+  m_LastFetchWaitSeconds = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+  m_SimulationRunning = false;
+  PublishPoses();
+  return true;
+}
+
+void PhysXHandle::ExecuteQueries(PhysXQueryBatch* batch, WorkerPool* pool)
+{
+  if (!m_Initialized) {
+    Yeager::Log(WARNING, "PhysX scene queries executed before the engine is initialized!");
+    return;
+  }
+  /* Actors added or moved by hand since the last fetch are pending in the query structures, the workers must not find
+   * them half updated. A running step flushes them itself on fetch, the queries see the scene before it */
+  if (!m_SimulationRunning) {
+    PxSceneWriteLock lock(*m_PxScene);
+    m_PxScene->flushQueryUpdates();
+  }
+  batch->Execute(m_PxScene, pool);
+}
+
+Uint PhysXHandle::RegisterDynamicActor(physx::PxRigidActor* actor)
+{
+  Uint index = m_Poses[0].size();
+  if (!m_FreePoses.empty()) {
+    index = m_FreePoses.back();
+    m_FreePoses.pop_back();
+  } else {
+    m_Poses[0].emplace_back();
+    m_Poses[1].emplace_back();
+    m_PoseActors.emplace_back();
+    m_PoseCollected.emplace_back(0);
+    m_StepStartPoses.emplace_back(PxIdentity);
+  }
+
+  /* Both slots start at the initial pose, the object stays there until the actor moves */
+  PhysXActorPose& pose = m_Poses[0][index];
+  pose.Transform = actor->getGlobalPose();
+  pose.Previous = pose.Transform;
+  pose.Version = m_PoseVersion;
+  m_Poses[1][index] = pose;
+  actor->userData = reinterpret_cast<void*>(static_cast<uintptr_t>(index) + 1);
+  m_PoseActors[index] = actor;
+  return index;
+}
+
+void PhysXHandle::UnregisterDynamicActor(physx::PxRigidActor* actor, Uint index)
+{
+  actor->userData = YEAGER_NULLPTR;
+  m_PoseActors[index] = YEAGER_NULLPTR;
+  m_FreePoses.push_back(index);
+  /* Removed while the steps of the frame run, the index may be given to another actor before the publish */
+  if (m_PoseCollected[index]) {
+    m_PoseCollected[index] = 0;
+    m_CollectedPoses.erase(std::find(m_CollectedPoses.begin(), m_CollectedPoses.end(), index));
+  }
+}
+
+PxTransform PhysXHandle::GetInterpolatedPose(Uint index) const
+{
+  const PhysXActorPose& pose = GetPublishedPose(index);
+  if (!m_InterpolationEnabled || pose.Version != m_PoseVersion) {
+    return pose.Transform;
+  }
+  return InterpolatePxTransform(pose.Previous, pose.Transform, m_InterpolationAlpha);
+}
+
+Uint PhysXHandle::GetActivePoseIndex(PxActor* actor) const
+{
+  /* Actors not registered (the character controllers) may use the userData for something else */
+  const uintptr_t index = reinterpret_cast<uintptr_t>(actor->userData) - 1;
+  if (index >= m_PoseActors.size() || m_PoseActors[index] != actor) {
+    return YEAGER_PHYSX_NO_POSE;
+  }
+  return index;
+}
+
+void PhysXHandle::CollectActivePoses()
+{
+  PxU32 count = 0;
+  PxActor** actors = m_PxScene->getActiveActors(count);
+  for (PxU32 x = 0; x < count; x++) {
+    const Uint index = GetActivePoseIndex(actors[x]);
+    if (index != YEAGER_PHYSX_NO_POSE && !m_PoseCollected[index]) {
+      m_PoseCollected[index] = 1;
+      m_CollectedPoses.push_back(index);
+    }
+  }
 }
 
-void PhysXHandle::EndSimulation()
+void PhysXHandle::KeepStepStartPoses()
 {
-  m_PxScene->fetchResults(true);
+  for (const Uint index : m_CollectedPoses) {
+    m_StepStartPoses[index] = m_PoseActors[index]->getGlobalPose();
+  }
+}
+
+void PhysXHandle::PublishPoses()
+{
+  const Uint published = GetPublishedPoseSlot();
+  const Uint slot = published ^ 1;
+  std::vector<PhysXActorPose>& poses = m_Poses[slot];
+
+  /* The slot only misses the poses written by the last publish, the others are the same in both slots */
+  for (const Uint index : m_ActivePoses) {
+    poses[index] = m_Poses[published][index];
+  }
+  m_ActivePoses.clear();
+  m_PoseVersion++;
+
+  /* The actors moved by the steps before the last started it at the kept transform, the others where they were drawn */
+  const Uint collected = m_CollectedPoses.size();
+  CollectActivePoses();
+  for (Uint x = 0; x < m_CollectedPoses.size(); x++) {
+    const Uint index = m_CollectedPoses[x];
+    PhysXActorPose& pose = poses[index];
+    pose.Previous = x < collected ? m_StepStartPoses[index] : m_Poses[published][index].Transform;
+    pose.Transform = m_PoseActors[index]->getGlobalPose();
+    pose.Version = m_PoseVersion;
+    m_PoseCollected[index] = 0;
+  }
+  m_ActivePoses.swap(m_CollectedPoses);
+  m_CollectedPoses.clear();
+  m_PublishedPoseSlot.store(slot, std::memory_order_release);
 }
@@ -25,13 +25,21 @@
 #include "Components/Kernel/Hardware/HardwareInfo.h"
 
 #include "PhysXCharacterController.h"
+#include "PhysXCookingCache.h"
+#include "PhysXCpuDispatcher.h"
+#include "PhysXFixedStep.h"
 #include "PhysXGeometryHandle.h"
+#include "PhysXMaterialCache.h"
+#include "PhysXSceneQuery.h"
 #include "PhysxAllocator.h"
 
+#include <atomic>
+
 #define PVD_HOST "127.0.0.1"
 
 namespace Yeager {
 class ApplicationCore;
+class PhysXActor;
 
 extern physx::PxVec3 Vector3ToPxVec3(const Vector3& vec);
 extern Vector3 PxVec3ToVector3(const physx::PxVec3& vec);
@@ -39,6 +47,25 @@ extern Vector3 PxVec3ToVector3(const physx::PxVec3& vec);
 extern physx::PxMat44 Matrix4ToPxMat44(const Matrix4& mat);
 extern Matrix4 PxMat4ToMatrix4(const physx::PxMat44& mat);
 
+/** Euler angles in degrees in the order of Transformation3D, the rotation is X * Y * Z */
+extern physx::PxQuat EulerDegreesToPxQuat(const Vector3& rotation);
+extern Vector3 PxQuatToEulerDegrees(const physx::PxQuat& quat);
+
+/** Position lerp and rotation nlerp, alpha 0 is from and 1 is to */
+extern physx::PxTransform InterpolatePxTransform(const physx::PxTransform& from, const physx::PxTransform& to,
+                                                 float alpha);
+
+/** Index of a dynamic actor without a pose in the PhysXHandle */
+#define YEAGER_PHYSX_NO_POSE UINT32_MAX
+
+/// @brief State of a dynamic actor at the end of the last step and one step before it, the object is drawn between them
+struct PhysXActorPose {
+  physx::PxTransform Transform = physx::PxTransform(physx::PxIdentity);
+  physx::PxTransform Previous = physx::PxTransform(physx::PxIdentity);
+  /* Fetch of the last change, the objects skip the poses they have already applied */
+  uint64_t Version = 0;
+};
+
 class YgPxErrorCallback : public physx::PxErrorCallback {
  public:
   virtual void reportError(physx::PxErrorCode::Enum code, const char* message, const char* file, int line)
@@ -57,11 +84,14 @@ class PhysXHandle {
   bool IsInitialized() const { return m_Initialized; }
   bool IsPxExtensionsEnabled() const { return m_PxExtensionsEnabled; }
   bool IsPxPvdEnabled() const { return m_PxPvdEnabled; }
+  /** Must be set before InitPxEngine, the headless benchmarks run without the visual debugger */
+  void SetPxPvdEnabled(bool enabled) { m_PxPvdEnabled = enabled; }
 
   /**
    @brief Push the actor the PxScene and to the application
    */
   void PushToScene(physx::PxRigidActor* actor);
+  void RemoveFromScene(physx::PxRigidActor* actor);
 
   YEAGER_NODISCARD physx::PxScene* GetPxScene()
   {
@@ -79,13 +109,76 @@ class PhysXHandle {
     return m_PxPhysics;
   }
 
+  /**
+   * @brief Adds the frame time to the fixed step accumulator and runs the steps it gives. All but the last run here,
+   * the last runs in the PhysX workers while the frame is drawn. A step still running is fetched first
+   */
   void StartSimulation(float deltaTime);
-  void EndSimulation();
+
+  /**
+   * @brief Fetches the results of the running step and publishes the poses of the dynamic actors, nothing happens if no
+   * step is running. Called at the start of the next frame, and before anything that must not touch the scene during
+   * a step (the character controllers)
+   * @param block False returns at once if the step has not finished
+   * @return False if the step is still running
+   */
+  bool EndSimulation(bool block = true);
+
+  YEAGER_NODISCARD bool IsSimulationRunning() const { return m_SimulationRunning; }
+  YEAGER_NODISCARD PhysXFixedStep* GetFixedStep() { return &m_FixedStep; }
+  /** Steps run by the last StartSimulation */
+  YEAGER_NODISCARD Uint GetLastFrameSteps() const { return m_LastFrameSteps; }
+
+  /**
+   * The published poses are a frame behind the accumulator, the frame is drawn at the time the accumulator had when
+   * they were started: between the Previous and the Transform of the poses by the alpha of that time. Without the
+   * interpolation the objects jump from step to step
+   */
+  void SetInterpolationEnabled(bool enabled) { m_InterpolationEnabled = enabled; }
+  YEAGER_NODISCARD bool IsInterpolationEnabled() const { return m_InterpolationEnabled; }
+  YEAGER_NODISCARD float GetInterpolationAlpha() const { return m_InterpolationAlpha; }
+  /** Transform to draw the actor of the pose with this frame */
+  YEAGER_NODISCARD physx::PxTransform GetInterpolatedPose(Uint index) const;
+  /** Version of the last publish, only the poses written by it are still moving */
+  YEAGER_NODISCARD uint64_t GetPoseVersion() const { return m_PoseVersion; }
+  /** Time the last EndSimulation blocked waiting for the workers, the part of the step not hidden by the frame */
+  YEAGER_NODISCARD float GetLastFetchWaitSeconds() const { return m_LastFetchWaitSeconds; }
+
+  /**
+   * @brief Runs the raycasts, sweeps and overlaps of the batch in the workers and waits for them. Queries may run while
+   * a step is running, they see the scene of the last fetch
+   */
+  void ExecuteQueries(PhysXQueryBatch* batch, WorkerPool* pool = WorkerPool::GetGlobal());
+
+  /**
+   * The poses of the dynamic actors are kept in a contiguous array, double buffered. Each fetch copies the poses of the
+   * active actors of the steps of the frame (the ones that moved, PxScene::getActiveActors) to the slot not being read
+   * and then publishes it, the userData of the actor holds its index. Sleeping and static bodies cost nothing,
+   * rendering reads the published slot so it sees every actor from the same step
+   * @return Index of the pose of the actor
+   */
+  Uint RegisterDynamicActor(physx::PxRigidActor* actor);
+  void UnregisterDynamicActor(physx::PxRigidActor* actor, Uint index);
+  YEAGER_NODISCARD Uint GetPublishedPoseSlot() const { return m_PublishedPoseSlot.load(std::memory_order_acquire); }
+  YEAGER_NODISCARD const PhysXActorPose& GetPublishedPose(Uint index) const
+  {
+    return m_Poses[GetPublishedPoseSlot()][index];
+  }
+  /** Actors that moved in the last step fetched */
+  YEAGER_NODISCARD Uint GetActivePoseCount() const { return m_ActivePoses.size(); }
+  YEAGER_NODISCARD Uint GetDynamicPoseCount() const { return m_Poses[0].size() - m_FreePoses.size(); }
 
   std::vector<Yeager::PhysXCapsule*>* GetCapsules() { return &m_Capsules; }
   std::vector<PhysXTriangleMesh*>* GetTrianglesMeshes() { return &m_TriangleMeshes; }
 
   Yeager::PhysXGeometryHandle* GetGeometryHandle() { return m_PhysXGeometryHandle; }
+  /** Null after TerminateEngine, the actors of the scene are destroyed after the engine */
+  Yeager::PhysXMaterialCache* GetMaterialCache() { return m_MaterialCache; }
+  Yeager::PhysXCookingCache* GetCookingCache() { return m_CookingCache; }
+  /** The PhysX tasks run in the global worker pool, the threads they use at once can be limited here */
+  Yeager::PhysXCpuDispatcher* GetCpuDispatcher() { return m_PxCpuDispatcher; }
+  /** Memory of the SDK, by allocation name */
+  const Yeager::YgPxAllocatorCallback* GetPxAllocator() const { return &m_PxAllocatorCallback; }
 
   /**
    * The engine physics engine must keep track about pointer from physX, or otherwise it can be overrided by the system
@@ -100,12 +193,15 @@ class PhysXHandle {
   physx::PxPhysics* m_PxPhysics = YEAGER_NULLPTR;
   physx::PxScene* m_PxScene = YEAGER_NULLPTR;
   physx::PxSceneDesc* m_PxSceneDesc = YEAGER_NULLPTR;
-  physx::PxCpuDispatcher* m_PxCpuDispatcher = YEAGER_NULLPTR;
+  Yeager::PhysXCpuDispatcher* m_PxCpuDispatcher = YEAGER_NULLPTR;
   physx::PxPvd* m_PxPvd = YEAGER_NULLPTR;
   physx::PxPvdTransport* m_PxPvdTransport = YEAGER_NULLPTR;
   physx::PxPvdSceneClient* m_PxPvdClient = YEAGER_NULLPTR;
   Yeager::PhysXGeometryHandle* m_PhysXGeometryHandle = YEAGER_NULLPTR;
   Yeager::PhysXCharacterController* m_CharacterController = YEAGER_NULLPTR;
+  Yeager::PhysXMaterialCache* m_MaterialCache = YEAGER_NULLPTR;
+  physx::PxMaterial* m_GroundMaterial = YEAGER_NULLPTR;
+  Yeager::PhysXCookingCache* m_CookingCache = YEAGER_NULLPTR;
   YgPxErrorCallback m_PxErrorCallback;
   YgPxAllocatorCallback m_PxAllocatorCallback;
   std::vector<physx::PxActor*> m_PxActors;
@@ -117,5 +213,30 @@ class PhysXHandle {
   std::vector<PhysXTriangleMesh*> m_TriangleMeshes;
 
   std::vector<physx::PxRigidActor*> m_ActorHandle;
+
+  void PublishPoses();
+  /** Keeps the active actors of a step run before the last one of the frame, the publish writes them too */
+  void CollectActivePoses();
+  /** The transform of the moved actors before the last step of the frame, the Previous of their poses */
+  void KeepStepStartPoses();
+  YEAGER_NODISCARD Uint GetActivePoseIndex(physx::PxActor* actor) const;
+
+  std::vector<PhysXActorPose> m_Poses[2];
+  std::vector<physx::PxRigidActor*> m_PoseActors;
+  std::vector<Uint> m_FreePoses;
+  /* Poses written by the last publish, the other slot has not seen them yet */
+  std::vector<Uint> m_ActivePoses;
+  /* Actors moved by the steps of the frame, with their transform when the last step started */
+  std::vector<Uint> m_CollectedPoses;
+  std::vector<uint8_t> m_PoseCollected;
+  std::vector<physx::PxTransform> m_StepStartPoses;
+  uint64_t m_PoseVersion = 0;
+  PhysXFixedStep m_FixedStep;
+  Uint m_LastFrameSteps = 0;
+  float m_InterpolationAlpha = 0.0f;
+  bool m_InterpolationEnabled = true;
+  std::atomic<Uint> m_PublishedPoseSlot = 0;
+  bool m_SimulationRunning = false;
+  float m_LastFetchWaitSeconds = 0.0f;
 };
 }  // namespace Yeager
\ No newline at end of file
@@ -0,0 +1,161 @@
+#include "PhysXMaterialCache.h"
+
+using namespace Yeager;
+using namespace physx;
+
+String PhysXMaterialDesc::CombineModeToString(PxCombineMode::Enum mode)
+{
+  switch (mode) {
+    case PxCombineMode::eMIN:
+      return "Min";
+    case PxCombineMode::eMULTIPLY:
+      return "Multiply";
+    case PxCombineMode::eMAX:
+      return "Max";
+    default:
+      return "Average";
+  }
+}
+
+PxCombineMode::Enum PhysXMaterialDesc::StringToCombineMode(const String& mode)
+{
+  if (mode == "Min") {
+    return PxCombineMode::eMIN;
+  } else if (mode == "Multiply") {
+    return PxCombineMode::eMULTIPLY;
+  } else if (mode == "Max") {
+    return PxCombineMode::eMAX;
+  }
+  return PxCombineMode::eAVERAGE;
+}
+
+PhysXMaterialCache::PhysXMaterialCache(PxPhysics* physics) : m_PxPhysics(physics)
+{
+  ResetNamedMaterials();
+}
+
+PhysXMaterialCache::~PhysXMaterialCache()
+{
+  /* The objects of the scene are destroyed after the engine and may still hold references, they check for the cache */
+  for (auto& [key, entry] : m_Materials) {
+    PX_RELEASE(entry.aMaterial);
+  }
+  m_Materials.clear();
+  m_MaterialKeys.clear();
+}
+
+PhysXMaterialCache::Key PhysXMaterialCache::MakeKey(const PhysXMaterialDesc& desc)
+{
+  Key key;
+  key.StaticFriction = static_cast<int32_t>(std::lround(desc.StaticFriction * YEAGER_PHYSX_MATERIAL_QUANTIZATION));
+  key.DynamicFriction = static_cast<int32_t>(std::lround(desc.DynamicFriction * YEAGER_PHYSX_MATERIAL_QUANTIZATION));
+  key.Restitution = static_cast<int32_t>(std::lround(desc.Restitution * YEAGER_PHYSX_MATERIAL_QUANTIZATION));
+  key.FrictionCombine = desc.FrictionCombine;
+  key.RestitutionCombine = desc.RestitutionCombine;
+  return key;
+}
+
+PxMaterial* PhysXMaterialCache::Acquire(const PhysXMaterialDesc& desc)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  const Key key = MakeKey(desc);
+  auto it = m_Materials.find(key);
+  if (it == m_Materials.end()) {
+    /* Created from the quantized values, the material is the same whichever description came first */
+    PxMaterial* material = m_PxPhysics->createMaterial(key.StaticFriction / YEAGER_PHYSX_MATERIAL_QUANTIZATION,
+                                                       key.DynamicFriction / YEAGER_PHYSX_MATERIAL_QUANTIZATION,
+                                                       key.Restitution / YEAGER_PHYSX_MATERIAL_QUANTIZATION);
+    if (material == YEAGER_NULLPTR) {
+      Yeager::Log(ERROR, "PhysX cannot create a material!");
+      return YEAGER_NULLPTR;
+    }
+    material->setFrictionCombineMode(desc.FrictionCombine);
+    material->setRestitutionCombineMode(desc.RestitutionCombine);
+    it = m_Materials.emplace(key, Entry{material, 0}).first;
+    m_MaterialKeys[material] = key;
+  }
+  it->second.RefCount++;
+  return it->second.aMaterial;
+}
+
+PxMaterial* PhysXMaterialCache::Acquire(const String& name)
+{
+  PhysXMaterialDesc desc;
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto it = m_NamedMaterials.find(name);
+    if (it == m_NamedMaterials.end()) {
+      Yeager::Log(WARNING, "PhysX material {} does not exist, using the default material!", name);
+      it = m_NamedMaterials.find(YEAGER_PHYSX_DEFAULT_MATERIAL);
+    }
+    desc = it->second;
+  }
+  return Acquire(desc);
+}
+
+void PhysXMaterialCache::Release(PxMaterial* material)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  auto key = m_MaterialKeys.find(material);
+  if (key == m_MaterialKeys.end()) {
+    Yeager::Log(WARNING, "PhysX material released was not acquired from the cache!");
+    return;
+  }
+
+  auto it = m_Materials.find(key->second);
+  if (--it->second.RefCount == 0) {
+    PX_RELEASE(it->second.aMaterial);
+    m_Materials.erase(it);
+    m_MaterialKeys.erase(key);
+  }
+}
+
+void PhysXMaterialCache::SetNamedMaterial(const String& name, const PhysXMaterialDesc& desc)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_NamedMaterials[name] = desc;
+}
+
+std::map<String, PhysXMaterialDesc> PhysXMaterialCache::GetNamedMaterials() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_NamedMaterials;
+}
+
+void PhysXMaterialCache::ResetNamedMaterials()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_NamedMaterials.clear();
+
+  PhysXMaterialDesc object;
+  object.StaticFriction = 0.1f;
+  object.DynamicFriction = 0.1f;
+  object.Restitution = 0.1f;
+  m_NamedMaterials[YEAGER_PHYSX_DEFAULT_MATERIAL] = object;
+
+  PhysXMaterialDesc ground;
+  ground.StaticFriction = 0.5f;
+  ground.DynamicFriction = 0.5f;
+  ground.Restitution = 0.6f;
+  m_NamedMaterials[YEAGER_PHYSX_GROUND_MATERIAL] = ground;
+
+  /* Same values, the character and the imported meshes share the material */
+  PhysXMaterialDesc rough;
+  rough.StaticFriction = 1.0f;
+  rough.DynamicFriction = 1.0f;
+  rough.Restitution = 1.0f;
+  m_NamedMaterials[YEAGER_PHYSX_CHARACTER_MATERIAL] = rough;
+  m_NamedMaterials[YEAGER_PHYSX_MESH_MATERIAL] = rough;
+}
+
+PhysXMaterialCacheStats PhysXMaterialCache::GetStats() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  PhysXMaterialCacheStats stats;
+  stats.Materials = m_Materials.size();
+  stats.NamedMaterials = m_NamedMaterials.size();
+  for (const auto& [key, entry] : m_Materials) {
+    stats.References += entry.RefCount;
+  }
+  return stats;
+}
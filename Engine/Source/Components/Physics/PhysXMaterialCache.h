@@ -0,0 +1,117 @@
+//    Yeager Engine, free and open source 3D/2D renderer written in OpenGL
+//    In case of questions and bugs, please, refer to the issue tab on github
+//    Repo : https://github.com/schwq/YeagerEngine
+//    Copyright (C) 2023 - Present
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Common/Utils/Common.h"
+#include "Common/Utils/LogEngine.h"
+#include "Common/Utils/Utilities.h"
+
+#include "PhysxAllocator.h"
+
+#include <mutex>
+
+namespace Yeager {
+
+/** Steps per unit the friction and restitution are rounded to before looking for a material with the same values */
+#define YEAGER_PHYSX_MATERIAL_QUANTIZATION 1024.0f
+
+#define YEAGER_PHYSX_DEFAULT_MATERIAL "Default"
+#define YEAGER_PHYSX_GROUND_MATERIAL "Ground"
+#define YEAGER_PHYSX_CHARACTER_MATERIAL "Character"
+#define YEAGER_PHYSX_MESH_MATERIAL "Mesh"
+
+/// @brief Values of a PhysX material, two descriptions that quantize the same share the PxMaterial
+struct PhysXMaterialDesc {
+  float StaticFriction = 0.5f;
+  float DynamicFriction = 0.5f;
+  float Restitution = 0.0f;
+  physx::PxCombineMode::Enum FrictionCombine = physx::PxCombineMode::eAVERAGE;
+  physx::PxCombineMode::Enum RestitutionCombine = physx::PxCombineMode::eAVERAGE;
+
+  static String CombineModeToString(physx::PxCombineMode::Enum mode);
+  /** Unknown names are the average, the default of PhysX */
+  static physx::PxCombineMode::Enum StringToCombineMode(const String& mode);
+};
+
+/// @brief Counters of the cache shown in the debug window
+struct PhysXMaterialCacheStats {
+  /* Materials created by the cache and alive */
+  Uint Materials = 0;
+  /* References to them held by actors, controllers and meshes */
+  Uint References = 0;
+  Uint NamedMaterials = 0;
+};
+
+/**
+ * @brief Shares the PxMaterial between everything with the same friction and restitution, creating one material per
+ * actor fills the material table of the SDK and slows the contact generation. The materials are reference counted,
+ * every Acquire must be paired with a Release and the material is released with the last reference (the shapes using
+ * it keep their own reference in PhysX). Named materials are the values the editor and the scene file refer to, they
+ * are saved with the scene. The models are imported in other threads, the cache is locked by a mutex
+ */
+class PhysXMaterialCache {
+ public:
+  PhysXMaterialCache(physx::PxPhysics* physics);
+  ~PhysXMaterialCache();
+
+  PhysXMaterialCache(const PhysXMaterialCache&) = delete;
+  PhysXMaterialCache& operator=(const PhysXMaterialCache&) = delete;
+
+  YEAGER_NODISCARD physx::PxMaterial* Acquire(const PhysXMaterialDesc& desc);
+  /** Unknown names acquire the default material */
+  YEAGER_NODISCARD physx::PxMaterial* Acquire(const String& name);
+  void Release(physx::PxMaterial* material);
+
+  /**
+   * @brief Adds or changes a named material, only the materials acquired after this have the new values
+   */
+  void SetNamedMaterial(const String& name, const PhysXMaterialDesc& desc);
+  /** Copy of the named materials, sorted by name */
+  YEAGER_NODISCARD std::map<String, PhysXMaterialDesc> GetNamedMaterials() const;
+  /** Back to the materials of the engine, called before the materials of a scene are loaded */
+  void ResetNamedMaterials();
+
+  YEAGER_NODISCARD PhysXMaterialCacheStats GetStats() const;
+
+ private:
+  struct Key {
+    int32_t StaticFriction = 0;
+    int32_t DynamicFriction = 0;
+    int32_t Restitution = 0;
+    int32_t FrictionCombine = 0;
+    int32_t RestitutionCombine = 0;
+
+    auto operator<=>(const Key&) const = default;
+  };
+
+  struct Entry {
+    physx::PxMaterial* aMaterial = YEAGER_NULLPTR;
+    Uint RefCount = 0;
+  };
+
+  static Key MakeKey(const PhysXMaterialDesc& desc);
+
+  physx::PxPhysics* m_PxPhysics = YEAGER_NULLPTR;
+  mutable std::mutex m_Mutex;
+  std::map<Key, Entry> m_Materials;
+  std::unordered_map<physx::PxMaterial*, Key> m_MaterialKeys;
+  std::map<String, PhysXMaterialDesc> m_NamedMaterials;
+};
+
+}  // namespace Yeager
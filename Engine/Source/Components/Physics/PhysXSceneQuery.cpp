@@ -0,0 +1,88 @@
+#include "PhysXSceneQuery.h"
+
+using namespace Yeager;
+using namespace physx;
+
+void PhysXQueryHits::Resize(size_t count)
+{
+  Hit.resize(count);
+  Position.resize(count);
+  Normal.resize(count);
+  Distance.resize(count);
+  Actor.resize(count);
+  Shape.resize(count);
+}
+
+void PhysXOverlapHits::Resize(size_t count)
+{
+  Count.resize(count);
+  Actor.resize(count * MaxTouches);
+  Shape.resize(count * MaxTouches);
+}
+
+template <typename Hit>
+static void WriteHit(PhysXQueryHits* hits, size_t index, bool found, const Hit& hit)
+{
+  hits->Hit[index] = found;
+  hits->Position[index] = found ? hit.position : PxVec3(0.0f);
+  hits->Normal[index] = found ? hit.normal : PxVec3(0.0f);
+  hits->Distance[index] = found ? hit.distance : PX_MAX_F32;
+  hits->Actor[index] = found ? hit.actor : YEAGER_NULLPTR;
+  hits->Shape[index] = found ? hit.shape : YEAGER_NULLPTR;
+}
+
+void PhysXQueryBatch::Execute(PxScene* scene, WorkerPool* pool)
+{
+  RaycastHits.Resize(Raycasts.size());
+  SweepHits.Resize(Sweeps.size());
+  OverlapHits.Resize(Overlaps.size());
+
+  /* One range over the three kinds of requests, so a batch of few raycasts and many overlaps still spreads */
+  const size_t sweepsBegin = Raycasts.size();
+  const size_t overlapsBegin = sweepsBegin + Sweeps.size();
+  pool->ParallelFor(0, GetRequestCount(), YEAGER_PHYSX_QUERY_GRAIN, [&](size_t begin, size_t end) {
+    PxSceneReadLock lock(*scene);
+    std::vector<PxOverlapHit> touches(OverlapHits.MaxTouches);
+
+    for (size_t request = begin; request < end; request++) {
+      if (request < sweepsBegin) {
+        const PhysXRaycastRequest& raycast = Raycasts[request];
+        PxRaycastBuffer buffer;
+        const bool found = scene->raycast(raycast.Origin, raycast.Direction, raycast.MaxDistance, buffer,
+                                          PxHitFlag::eDEFAULT, raycast.Filter) &&
+                           buffer.hasBlock;
+        WriteHit(&RaycastHits, request, found, buffer.block);
+      } else if (request < overlapsBegin) {
+        const size_t index = request - sweepsBegin;
+        const PhysXSweepRequest& sweep = Sweeps[index];
+        PxSweepBuffer buffer;
+        const bool found = scene->sweep(sweep.Geometry.any(), sweep.Pose, sweep.Direction, sweep.MaxDistance, buffer,
+                                        PxHitFlag::eDEFAULT, sweep.Filter) &&
+                           buffer.hasBlock;
+        WriteHit(&SweepHits, index, found, buffer.block);
+      } else {
+        const size_t index = request - overlapsBegin;
+        const PhysXOverlapRequest& overlap = Overlaps[index];
+        /* Every shape is a touch, a blocking hit would end the overlap at the first shape */
+        PxQueryFilterData filter = overlap.Filter;
+        filter.flags |= PxQueryFlag::eNO_BLOCK;
+        PxOverlapBuffer buffer(touches.data(), touches.size());
+        scene->overlap(overlap.Geometry.any(), overlap.Pose, buffer, filter);
+
+        const size_t first = index * OverlapHits.MaxTouches;
+        OverlapHits.Count[index] = buffer.getNbTouches();
+        for (PxU32 touch = 0; touch < buffer.getNbTouches(); touch++) {
+          OverlapHits.Actor[first + touch] = buffer.getTouch(touch).actor;
+          OverlapHits.Shape[first + touch] = buffer.getTouch(touch).shape;
+        }
+      }
+    }
+  });
+}
+
+void PhysXQueryBatch::Clear()
+{
+  Raycasts.clear();
+  Sweeps.clear();
+  Overlaps.clear();
+}
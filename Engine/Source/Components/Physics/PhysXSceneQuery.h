@@ -0,0 +1,102 @@
+//    Yeager Engine, free and open source 3D/2D renderer written in OpenGL
+//    In case of questions and bugs, please, refer to the issue tab on github
+//    Repo : https://github.com/schwq/YeagerEngine
+//    Copyright (C) 2023 - Present
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Common/Utils/Common.h"
+#include "Common/Utils/LogEngine.h"
+#include "Common/Utils/Utilities.h"
+#include "Components/Kernel/Process/WorkerPool.h"
+
+#include "PhysxAllocator.h"
+
+namespace Yeager {
+
+/** Touches kept for each overlap request, the ones after it are dropped */
+#define YEAGER_PHYSX_QUERY_MAX_OVERLAP_TOUCHES 16
+/** Requests run by a worker at a time, a query takes a few microseconds */
+#define YEAGER_PHYSX_QUERY_GRAIN 64
+
+struct PhysXRaycastRequest {
+  physx::PxVec3 Origin = physx::PxVec3(0.0f);
+  /* Normalized */
+  physx::PxVec3 Direction = physx::PxVec3(0.0f, -1.0f, 0.0f);
+  float MaxDistance = PX_MAX_F32;
+  physx::PxQueryFilterData Filter;
+};
+
+struct PhysXSweepRequest {
+  physx::PxGeometryHolder Geometry;
+  physx::PxTransform Pose = physx::PxTransform(physx::PxIdentity);
+  /* Normalized */
+  physx::PxVec3 Direction = physx::PxVec3(0.0f, -1.0f, 0.0f);
+  float MaxDistance = PX_MAX_F32;
+  physx::PxQueryFilterData Filter;
+};
+
+struct PhysXOverlapRequest {
+  physx::PxGeometryHolder Geometry;
+  physx::PxTransform Pose = physx::PxTransform(physx::PxIdentity);
+  physx::PxQueryFilterData Filter;
+};
+
+/// @brief Closest hit of each raycast or sweep, element i of every array answers the request i
+struct PhysXQueryHits {
+  std::vector<uint8_t> Hit;
+  std::vector<physx::PxVec3> Position;
+  std::vector<physx::PxVec3> Normal;
+  std::vector<float> Distance;
+  std::vector<physx::PxRigidActor*> Actor;
+  std::vector<physx::PxShape*> Shape;
+
+  void Resize(size_t count);
+};
+
+/// @brief Touches of each overlap, the touch k of the request i is at i * MaxTouches + k for k < Count[i]
+struct PhysXOverlapHits {
+  std::vector<Uint> Count;
+  std::vector<physx::PxRigidActor*> Actor;
+  std::vector<physx::PxShape*> Shape;
+  Uint MaxTouches = YEAGER_PHYSX_QUERY_MAX_OVERLAP_TOUCHES;
+
+  void Resize(size_t count);
+};
+
+/**
+ * @brief Raycasts, sweeps and overlaps gathered from anywhere in the frame (editor picking, character grounding,
+ * gameplay probes) and run together in the worker pool. Each worker holds a read lock of the scene, the query
+ * structures are only read, so the queries run side by side. The results are written to arrays in the order of the
+ * requests, the same for any count of workers. Clear keeps the memory of the arrays for the next frame
+ */
+struct PhysXQueryBatch {
+  std::vector<PhysXRaycastRequest> Raycasts;
+  std::vector<PhysXSweepRequest> Sweeps;
+  std::vector<PhysXOverlapRequest> Overlaps;
+
+  PhysXQueryHits RaycastHits;
+  PhysXQueryHits SweepHits;
+  PhysXOverlapHits OverlapHits;
+
+  /** Blocks until every request has its result, the scene must not be written meanwhile */
+  void Execute(physx::PxScene* scene, WorkerPool* pool = WorkerPool::GetGlobal());
+  void Clear();
+
+  YEAGER_NODISCARD size_t GetRequestCount() const { return Raycasts.size() + Sweeps.size() + Overlaps.size(); }
+};
+
+}  // namespace Yeager
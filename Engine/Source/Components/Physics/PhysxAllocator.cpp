@@ -0,0 +1,239 @@
+#include "PhysxAllocator.h"
+using namespace Yeager;
+using namespace physx;
+
+/* The names PhysX gives for its types are the signature of PxReflectionAllocator<T>::getName, only T is kept */
+static String ShortAllocationName(const char* name)
+{
+  const String full(name);
+  const std::size_t type = full.find("T = ");
+  if (type == String::npos) {
+    return full;
+  }
+  const std::size_t end = full.find_first_of(";]", type);
+  return full.substr(type + 4, end == String::npos ? String::npos : end - type - 4);
+}
+
+YgPxAllocatorCallback::YgPxAllocatorCallback()
+{
+  std::size_t pool = 0;
+  for (std::size_t x = 0; x <= YEAGER_PHYSX_POOL_MAX_BLOCK / 16; x++) {
+    while (sBlockSizes[pool] < x * 16) {
+      pool++;
+    }
+    m_PoolBySize[x] = pool;
+  }
+  for (std::size_t x = 0; x < sPoolCount; x++) {
+    m_Pools[x].BlockSize = sBlockSizes[x];
+  }
+  m_Names[0].Name = "Other";
+}
+
+YgPxAllocatorCallback::~YgPxAllocatorCallback()
+{
+  ReleasePools();
+}
+
+void* YgPxAllocatorCallback::allocate(size_t size, const char* typeName, const char*, int)
+{
+  const std::size_t total = size + sizeof(BlockHeader);
+  BlockHeader* header = YEAGER_NULLPTR;
+  uint16_t sizeClass = sLargeBlock;
+  if (total <= YEAGER_PHYSX_POOL_MAX_BLOCK) {
+    sizeClass = m_PoolBySize[(total + 15) / 16];
+    header = static_cast<BlockHeader*>(AllocatePooled(m_Pools[sizeClass]));
+  } else {
+    header = static_cast<BlockHeader*>(BaseAllocator::AllocateAligned(total, 16, MemoryTag::ePHYSX));
+    if (header) {
+      m_LargeBytes.fetch_add(total, std::memory_order_relaxed);
+    }
+  }
+  if (!header) {
+    Yeager::Log(ERROR, "PhysX allocation of {} bytes failed!", size);
+    return YEAGER_NULLPTR;
+  }
+
+  header->SizeClass = sizeClass;
+  header->Name = GetNameSlot(typeName);
+  header->Size = size;
+
+  const uint64_t live = size + (UINT64_C(1) << sLiveCountShift);
+  NameSlot& slot = m_Names[header->Name];
+  BaseAllocator::RaisePeak(slot.PeakBytes,
+                           (slot.Live.fetch_add(live, std::memory_order_relaxed) + live) & sLiveBytesMask);
+  BaseAllocator::RaisePeak(m_PeakBytes, (m_Live.fetch_add(live, std::memory_order_relaxed) + live) & sLiveBytesMask);
+
+  void* ptr = header + 1;
+  PX_ASSERT((size_t(ptr) % 16) == 0);
+#if PX_STOMP_ALLOCATED_MEMORY
+  physx::PxMemSet(ptr, physx::PxI32(0xcd), physx::PxU32(size));
+#endif
+  return ptr;
+}
+
+void YgPxAllocatorCallback::deallocate(void* ptr)
+{
+  if (!ptr) {
+    return;
+  }
+  BlockHeader* header = static_cast<BlockHeader*>(ptr) - 1;
+  const std::size_t size = header->Size;
+
+  const uint64_t live = size + (UINT64_C(1) << sLiveCountShift);
+  m_Names[header->Name].Live.fetch_sub(live, std::memory_order_relaxed);
+  m_Live.fetch_sub(live, std::memory_order_relaxed);
+
+  if (header->SizeClass == sLargeBlock) {
+    const std::size_t total = size + sizeof(BlockHeader);
+    m_LargeBytes.fetch_sub(total, std::memory_order_relaxed);
+    BaseAllocator::DeallocateAligned(header, total, 16, MemoryTag::ePHYSX);
+  } else {
+    DeallocatePooled(m_Pools[header->SizeClass], header);
+  }
+}
+
+void* YgPxAllocatorCallback::AllocatePooled(Pool& pool)
+{
+  std::lock_guard<std::mutex> lock(pool.Mutex);
+  if (!pool.FreeList) {
+    char* chunk =
+        static_cast<char*>(BaseAllocator::AllocateAligned(YEAGER_PHYSX_POOL_CHUNK_SIZE, 16, MemoryTag::ePHYSX));
+    if (!chunk) {
+      return YEAGER_NULLPTR;
+    }
+    pool.Chunks.push_back(chunk);
+    /* Threads the blocks of the chunk in the free list, the first block is given first */
+    const std::size_t blocks = YEAGER_PHYSX_POOL_CHUNK_SIZE / pool.BlockSize;
+    for (std::size_t x = blocks; x-- > 0;) {
+      void* block = chunk + x * pool.BlockSize;
+      *static_cast<void**>(block) = pool.FreeList;
+      pool.FreeList = block;
+    }
+  }
+  void* block = pool.FreeList;
+  pool.FreeList = *static_cast<void**>(block);
+  pool.UsedBlocks++;
+  return block;
+}
+
+void YgPxAllocatorCallback::DeallocatePooled(Pool& pool, void* block)
+{
+  std::lock_guard<std::mutex> lock(pool.Mutex);
+  *static_cast<void**>(block) = pool.FreeList;
+  pool.FreeList = block;
+  pool.UsedBlocks--;
+}
+
+void YgPxAllocatorCallback::ReleasePools()
+{
+  for (Pool& pool : m_Pools) {
+    std::lock_guard<std::mutex> lock(pool.Mutex);
+    if (pool.Chunks.empty()) {
+      continue;
+    }
+    if (pool.UsedBlocks > 0) {
+      Yeager::Log(WARNING, "PhysX pool of {} bytes blocks has {} blocks still in use, the chunks are kept!",
+                  pool.BlockSize, pool.UsedBlocks);
+      continue;
+    }
+    for (void* chunk : pool.Chunks) {
+      BaseAllocator::DeallocateAligned(chunk, YEAGER_PHYSX_POOL_CHUNK_SIZE, 16, MemoryTag::ePHYSX);
+    }
+    pool.Chunks.clear();
+    pool.FreeList = YEAGER_NULLPTR;
+  }
+}
+
+static Uint NameTableIndex(const char* name)
+{
+  return (reinterpret_cast<uintptr_t>(name) * UINT64_C(0x9E3779B97F4A7C15)) >> 32 & (YEAGER_PHYSX_NAME_TABLE_SIZE - 1);
+}
+
+uint16_t YgPxAllocatorCallback::GetNameSlot(const char* name)
+{
+  if (!name) {
+    return 0;
+  }
+  for (Uint index = NameTableIndex(name);; index = (index + 1) & (YEAGER_PHYSX_NAME_TABLE_SIZE - 1)) {
+    const NameEntry& entry = m_NameTable[index];
+    const char* pointer = entry.Pointer.load(std::memory_order_acquire);
+    if (pointer == name) {
+      return entry.Slot;
+    }
+    if (!pointer) {
+      return AddNameSlot(name);
+    }
+  }
+}
+
+uint16_t YgPxAllocatorCallback::AddNameSlot(const char* name)
+{
+  std::lock_guard<std::mutex> lock(m_NamesMutex);
+  Uint index = NameTableIndex(name);
+  for (const char* pointer = m_NameTable[index].Pointer.load(std::memory_order_relaxed); pointer;
+       pointer = m_NameTable[index].Pointer.load(std::memory_order_relaxed)) {
+    /* Added by another thread since the lookup */
+    if (pointer == name) {
+      return m_NameTable[index].Slot;
+    }
+    index = (index + 1) & (YEAGER_PHYSX_NAME_TABLE_SIZE - 1);
+  }
+
+  String shortName = ShortAllocationName(name);
+  uint16_t slot = 0;
+  const auto same = m_NameByString.find(shortName);
+  if (same != m_NameByString.end()) {
+    slot = same->second;
+  } else if (m_NameCount.load(std::memory_order_relaxed) < YEAGER_PHYSX_ALLOCATION_NAMES) {
+    slot = m_NameCount.load(std::memory_order_relaxed);
+    m_Names[slot].Name = shortName;
+    m_NameByString[shortName] = slot;
+    /* GetNameStats reads the name of the slots below the count without the lock */
+    m_NameCount.store(slot + 1, std::memory_order_release);
+  }
+  /* The table is kept at most half full so the probes stay short, the pointers past that are looked up here */
+  if (m_NameTableCount < YEAGER_PHYSX_NAME_TABLE_SIZE / 2) {
+    m_NameTable[index].Slot = slot;
+    m_NameTable[index].Pointer.store(name, std::memory_order_release);
+    m_NameTableCount++;
+  }
+  return slot;
+}
+
+PhysXAllocatorStats YgPxAllocatorCallback::GetStats() const
+{
+  PhysXAllocatorStats stats;
+  const uint64_t live = m_Live.load(std::memory_order_relaxed);
+  stats.LiveBytes = live & sLiveBytesMask;
+  stats.LiveAllocations = live >> sLiveCountShift;
+  stats.PeakBytes = m_PeakBytes.load(std::memory_order_relaxed);
+  stats.LargeBytes = m_LargeBytes.load(std::memory_order_relaxed);
+  for (const Pool& pool : m_Pools) {
+    std::lock_guard<std::mutex> lock(pool.Mutex);
+    stats.PooledBytes += pool.Chunks.size() * YEAGER_PHYSX_POOL_CHUNK_SIZE;
+    stats.PooledBytesUsed += pool.UsedBlocks * pool.BlockSize;
+  }
+  return stats;
+}
+
+std::vector<PhysXAllocationNameStats> YgPxAllocatorCallback::GetNameStats() const
+{
+  std::vector<PhysXAllocationNameStats> names;
+  const Uint count = m_NameCount.load(std::memory_order_acquire);
+  for (Uint x = 0; x < count; x++) {
+    const NameSlot& slot = m_Names[x];
+    PhysXAllocationNameStats stats;
+    stats.Name = slot.Name;
+    const uint64_t live = slot.Live.load(std::memory_order_relaxed);
+    stats.LiveBytes = live & sLiveBytesMask;
+    stats.LiveAllocations = live >> sLiveCountShift;
+    stats.PeakBytes = slot.PeakBytes.load(std::memory_order_relaxed);
+    if (stats.PeakBytes > 0) {
+      names.push_back(stats);
+    }
+  }
+  std::sort(names.begin(), names.end(), [](const PhysXAllocationNameStats& a, const PhysXAllocationNameStats& b) {
+    return a.LiveBytes != b.LiveBytes ? a.LiveBytes > b.LiveBytes : a.PeakBytes > b.PeakBytes;
+  });
+  return names;
+}
@@ -21,11 +21,15 @@
 #include "Common/Utils/Common.h"
 #include "Common/Utils/LogEngine.h"
 #include "Common/Utils/Utilities.h"
+#include "Components/Kernel/Memory/Allocator.h"
 
 #include <malloc.h>
 #include "PxPhysics.h"
 #include "PxPhysicsAPI.h"
 
+#include <atomic>
+#include <mutex>
+
 namespace Yeager {
 
 #ifdef YEAGER_SYSTEM_LINUX
@@ -57,23 +61,123 @@ YEAGER_FORCE_INLINE void platformAlignedFree(void* ptr)
 }
 #endif
 
+/** Blocks up to this size, with their header, come from the pools, the rest from the engine allocator directly */
+#define YEAGER_PHYSX_POOL_MAX_BLOCK 2048
+#define YEAGER_PHYSX_POOL_CHUNK_SIZE (64 * 1024)
+/** Allocation names tracked one by one, the rest are counted as "Other" */
+#define YEAGER_PHYSX_ALLOCATION_NAMES 256
+/** Entries of the table from the name pointers to their slot, a power of two */
+#define YEAGER_PHYSX_NAME_TABLE_SIZE 4096
+
+/// @brief Memory PhysX asked for under one allocation name (the type or the subsystem allocating)
+struct PhysXAllocationNameStats {
+  String Name = YEAGER_EMPTY_LITERAL;
+  std::size_t LiveBytes = 0;
+  std::size_t PeakBytes = 0;
+  uint64_t LiveAllocations = 0;
+};
+
+/// @brief Counters of the allocator shown in the debug window
+struct PhysXAllocatorStats {
+  /* Bytes PhysX asked for and has not given back */
+  std::size_t LiveBytes = 0;
+  std::size_t PeakBytes = 0;
+  uint64_t LiveAllocations = 0;
+  /* Chunks of the pools taken from the engine allocator, and the part of them given to PhysX */
+  std::size_t PooledBytes = 0;
+  std::size_t PooledBytesUsed = 0;
+  /* Blocks too large for the pools */
+  std::size_t LargeBytes = 0;
+};
+
+/**
+ * @brief Allocator of the PhysX foundation. The memory comes from the BaseAllocator with the PhysX tag, so it is part
+ * of the engine memory stats. Small blocks come from pools of size classes, carved from chunks of 64 KB and kept in a
+ * free list, PhysX allocates and frees small blocks all through the step and the pools avoid the system heap. Each
+ * block has a header of 16 bytes with its size class, size and allocation name, the alignment of 16 PhysX needs is
+ * kept. The bytes are counted for each allocation name PhysX gives (PxFoundation::setReportAllocationNames). Called by
+ * the PhysX workers, each pool has its own mutex and the counters are atomic
+ */
 class YgPxAllocatorCallback : public physx::PxAllocatorCallback {
  public:
-  virtual void* allocate(size_t size, const char*, const char*, int)
-  {
-    void* ptr = platformAlignedAlloc(size);
-    PX_ASSERT((size_t(ptr) % 15) == 0);
-#if PX_STOMP_ALLOCATED_MEMORY
-    if (ptr != NULL) {
-      physx::PxMemSet(ptr, physx::PxI32(0xcd), physx::PxU32(size));
-    }
-#endif
-    return ptr;
-  }
+  YgPxAllocatorCallback();
+  ~YgPxAllocatorCallback();
+
+  YgPxAllocatorCallback(const YgPxAllocatorCallback&) = delete;
+  YgPxAllocatorCallback& operator=(const YgPxAllocatorCallback&) = delete;
+
+  virtual void* allocate(size_t size, const char* typeName, const char* filename, int line);
+  virtual void deallocate(void* ptr);
+
+  /**
+   * @brief Gives the chunks of the pools back to the engine allocator, called after the foundation is released. Chunks
+   * with blocks still in use are kept, and the leak is logged
+   */
+  void ReleasePools();
+
+  YEAGER_NODISCARD PhysXAllocatorStats GetStats() const;
+  /** Stats of every allocation name seen, the most live bytes first */
+  YEAGER_NODISCARD std::vector<PhysXAllocationNameStats> GetNameStats() const;
+
+ private:
+  struct alignas(16) BlockHeader {
+    uint16_t SizeClass = 0;
+    uint16_t Name = 0;
+    uint32_t Reserved = 0;
+    uint64_t Size = 0;
+  };
+
+  struct Pool {
+    mutable std::mutex Mutex;
+    std::size_t BlockSize = 0;
+    void* FreeList = YEAGER_NULLPTR;
+    std::vector<void*> Chunks;
+    std::size_t UsedBlocks = 0;
+  };
+
+  /* The counters are touched by every allocation, each atomic add costs as much as the pool itself. The live bytes
+   * and the count of live blocks share a counter, the bytes in the low 40 bits and the count above */
+  static constexpr uint64_t sLiveCountShift = 40;
+  static constexpr uint64_t sLiveBytesMask = (UINT64_C(1) << sLiveCountShift) - 1;
+
+  struct NameSlot {
+    String Name = YEAGER_EMPTY_LITERAL;
+    std::atomic<uint64_t> Live = 0;
+    std::atomic<std::size_t> PeakBytes = 0;
+  };
+
+  struct NameEntry {
+    std::atomic<const char*> Pointer = YEAGER_NULLPTR;
+    uint16_t Slot = 0;
+  };
+
+  /* Block sizes of the pools, header included */
+  static constexpr std::size_t sBlockSizes[] = {32,  48,  64,  80,  96,   128,  160,  192,  256,
+                                                320, 384, 512, 640, 768, 1024, 1280, 1536, 2048};
+  static constexpr std::size_t sPoolCount = sizeof(sBlockSizes) / sizeof(sBlockSizes[0]);
+  static constexpr uint16_t sLargeBlock = UINT16_MAX;
+
+  void* AllocatePooled(Pool& pool);
+  void DeallocatePooled(Pool& pool, void* block);
+  uint16_t GetNameSlot(const char* name);
+  uint16_t AddNameSlot(const char* name);
+
+  Pool m_Pools[sPoolCount];
+  /* Pool of each size in steps of 16 bytes */
+  uint8_t m_PoolBySize[YEAGER_PHYSX_POOL_MAX_BLOCK / 16 + 1];
+
+  std::atomic<uint64_t> m_Live = 0;
+  std::atomic<std::size_t> m_PeakBytes = 0;
+  std::atomic<std::size_t> m_LargeBytes = 0;
 
-  virtual void deallocate(void* ptr)
-  {
-    platformAlignedFree(ptr);
-  }
+  /* The names are looked up by the pointer PhysX gives, almost always a literal, in an open addressing table read
+   * without a lock. The entries are only added, under the mutex, the pointer is stored last. The same name from
+   * another pointer shares the slot */
+  std::mutex m_NamesMutex;
+  NameEntry m_NameTable[YEAGER_PHYSX_NAME_TABLE_SIZE];
+  Uint m_NameTableCount = 0;
+  std::unordered_map<String, uint16_t> m_NameByString;
+  NameSlot m_Names[YEAGER_PHYSX_ALLOCATION_NAMES];
+  std::atomic<Uint> m_NameCount = 1;
 };
-}  // namespace Yeager
\ No newline at end of file
+}  // namespace Yeager
@@ -1,20 +1,113 @@
 #include "Animation.h"
 using namespace Yeager;
 
-Animation::Animation(const String& name, const aiScene* scene, Uint index, AnimatedObject* model) : m_Name(name)
+std::shared_ptr<AnimationSkeleton> AnimationSkeleton::Build(const aiNode* root)
+{
+  auto skeleton = BaseAllocator::MakeSharedPtr<AnimationSkeleton>();
+  ReadHeirarchyData(skeleton->RootNode, root);
+  skeleton->Flatten(skeleton->RootNode, -1);
+  return skeleton;
+}
+
+std::shared_ptr<AnimationSkeleton> AnimationSkeleton::Build(const AnimationClipFile& file)
+{
+  auto skeleton = BaseAllocator::MakeSharedPtr<AnimationSkeleton>();
+  ReadHeirarchyData(skeleton->RootNode, file, 0);
+  skeleton->Flatten(skeleton->RootNode, -1);
+  return skeleton;
+}
+
+void AnimationSkeleton::Flatten(const AssimpNodeData& node, int parent)
+{
+  AnimationSkeletonNode data;
+  data.Transformation = node.Transformation;
+  data.Name = node.Name;
+  data.Parent = parent;
+
+  const int index = Nodes.size();
+  Nodes.push_back(data);
+  for (const auto& child : node.Children) {
+    Flatten(child, index);
+  }
+}
+
+AnimationSkeletonBinding AnimationSkeleton::Bind(const std::map<String, BoneInfo>& boneInfoMap) const
+{
+  AnimationSkeletonBinding binding;
+  binding.BoneIDs.assign(Nodes.size(), -1);
+  binding.OffSets.assign(Nodes.size(), Matrix4(1.0f));
+  for (Uint x = 0; x < Nodes.size(); x++) {
+    const auto info = boneInfoMap.find(Nodes[x].Name);
+    if (info != boneInfoMap.end()) {
+      binding.BoneIDs[x] = info->second.ID;
+      binding.OffSets[x] = info->second.OffSet;
+    }
+  }
+  return binding;
+}
+
+size_t AnimationSkeleton::GetMemorySize() const
+{
+  /* The nested root node holds roughly the same data as the flattened nodes */
+  return Nodes.capacity() * sizeof(AnimationSkeletonNode) * 2;
+}
+
+void AnimationSkeleton::ReadHeirarchyData(AssimpNodeData& dest, const aiNode* src)
+{
+  assert(src);
+
+  dest.Name = src->mName.data;
+  dest.Transformation = ConvertAssimpMatrixToGLMFormat(src->mTransformation);
+  dest.ChildrenCount = src->mNumChildren;
+
+  for (int x = 0; x < src->mNumChildren; x++) {
+    AssimpNodeData newData;
+    ReadHeirarchyData(newData, src->mChildren[x]);
+    dest.Children.push_back(newData);
+  }
+}
+
+Uint AnimationSkeleton::ReadHeirarchyData(AssimpNodeData& dest, const AnimationClipFile& file, Uint index)
+{
+  assert(index < file.GetNodeCount());
+
+  /* Nodes are stored in depth first order, the children of a node follow it and the return is the next sibling */
+  const AnimationClipNode* node = file.GetNodes() + index;
+  dest.Name = file.GetString(node->NameOffset);
+  dest.Transformation = glm::make_mat4(node->Transformation);
+  dest.ChildrenCount = node->ChildrenCount;
+
+  Uint next = index + 1;
+  for (Uint x = 0; x < node->ChildrenCount; x++) {
+    AssimpNodeData newData;
+    next = ReadHeirarchyData(newData, file, next);
+    dest.Children.push_back(newData);
+  }
+  return next;
+}
+
+Animation::Animation(const String& name, const aiScene* scene, Uint index) : m_Name(name)
 {
   auto animation = scene->mAnimations[index];
   m_Duration = animation->mDuration;
   m_TicksPerSecond = animation->mTicksPerSecond;
-  aiMatrix4x4 globalTransformation = scene->mRootNode->mTransformation;
-  globalTransformation = globalTransformation.Inverse();
-  ReadHeirarchyData(m_RootNode, scene->mRootNode);
-  ReadMissingBones(animation, *model);
+  ReadBones(animation);
+}
+
+Animation::Animation(std::shared_ptr<AnimationClipFile> file, Uint index) : m_ClipFile(file)
+{
+  const AnimationClipDesc* clip = file->GetClip(index);
+  m_Name = String(file->GetString(clip->NameOffset));
+  m_Duration = clip->Duration;
+  m_TicksPerSecond = clip->TicksPerSecond;
+  m_Index = index;
+  ReadBones(*file, clip);
 }
 
-Bone* Animation::FindBone(const String& name)
+const Bone* Animation::FindBone(const String& name) const
 {
-  auto iter = std::find_if(m_Bones.begin(), m_Bones.end(), [&](Bone& Bone) { return Bone.GetBoneName() == name; });
+  auto iter =
+      std::find_if(m_Bones.begin(), m_Bones.end(), [&](const Bone& Bone) { return Bone.GetBoneName() == name; });
   if (iter == m_Bones.end()) {
     return YEAGER_NULLPTR;
   } else {
@@ -22,38 +115,63 @@ Bone* Animation::FindBone(const String& name)
   }
 }
 
-void Animation::ReadMissingBones(const aiAnimation* animation, AnimatedObject& model)
+void Animation::BindSkeleton(std::shared_ptr<const AnimationSkeleton> skeleton)
 {
-  int size = animation->mNumChannels;
-  auto& BoneInfoMap = model.GetModelData()->GetBoneInfoMap();
-  int& BoneCount = model.GetModelData()->GetBoneCount();
+  m_Skeleton = skeleton;
+  m_NodeBones.assign(skeleton->Nodes.size(), -1);
+  for (Uint x = 0; x < skeleton->Nodes.size(); x++) {
+    const Bone* bone = FindBone(skeleton->Nodes[x].Name);
+    if (bone) {
+      m_NodeBones[x] = static_cast<int>(bone - m_Bones.data());
+    }
+  }
+}
 
-  for (int x = 0; x < size; x++) {
-    auto channel = animation->mChannels[x];
-    String boneName = channel->mNodeName.data;
+void Animation::RegisterBones(AnimatedObject* model) const
+{
+  auto& BoneInfoMap = model->GetModelData()->GetBoneInfoMap();
+  int& BoneCount = model->GetModelData()->GetBoneCount();
 
-    if (BoneInfoMap.find(boneName) == BoneInfoMap.end()) {
-      BoneInfoMap[boneName].ID = BoneCount;
+  for (const auto& bone : m_Bones) {
+    if (BoneInfoMap.find(bone.GetBoneName()) == BoneInfoMap.end()) {
+      BoneInfoMap[bone.GetBoneName()].ID = BoneCount;
       BoneCount++;
     }
-
-    m_Bones.push_back(Bone(channel->mNodeName.data, BoneInfoMap[channel->mNodeName.data].ID, channel));
   }
+}
 
-  m_BoneInfoMap = BoneInfoMap;
+size_t Animation::GetMemorySize() const
+{
+  size_t size = sizeof(Animation) + m_Bones.capacity() * sizeof(Bone) + m_NodeBones.capacity() * sizeof(int);
+  for (const auto& bone : m_Bones) {
+    size += bone.GetKeysMemorySize();
+  }
+  return size;
 }
 
-void Animation::ReadHeirarchyData(AssimpNodeData& dest, const aiNode* src)
+void Animation::FlagLowImportanceBones(const std::vector<String>& patterns)
 {
-  assert(src);
+  for (auto& bone : m_Bones) {
+    const String name = ToLower(bone.GetBoneName());
+    const bool match = std::any_of(patterns.begin(), patterns.end(), [&](const String& pattern) {
+      return name.find(ToLower(pattern)) != String::npos;
+    });
+    bone.SetLowImportance(match);
+  }
+}
 
-  dest.Name = src->mName.data;
-  dest.Transformation = ConvertAssimpMatrixToGLMFormat(src->mTransformation);
-  dest.ChildrenCount = src->mNumChildren;
+void Animation::ReadBones(const aiAnimation* animation)
+{
+  for (Uint x = 0; x < animation->mNumChannels; x++) {
+    auto channel = animation->mChannels[x];
+    m_Bones.push_back(Bone(channel->mNodeName.data, channel));
+  }
+}
 
-  for (int x = 0; x < src->mNumChildren; x++) {
-    AssimpNodeData newData;
-    ReadHeirarchyData(newData, src->mChildren[x]);
-    dest.Children.push_back(newData);
+void Animation::ReadBones(const AnimationClipFile& file, const AnimationClipDesc* clip)
+{
+  const AnimationClipTrack* tracks = file.GetTracks(clip);
+  for (Uint x = 0; x < clip->TrackCount; x++) {
+    m_Bones.push_back(Bone(file.GetString(tracks[x].NameOffset), &file, &tracks[x], clip->Duration));
   }
-}
\ No newline at end of file
+}
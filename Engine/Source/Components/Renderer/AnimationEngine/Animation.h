@@ -22,6 +22,7 @@
 #include "Common/Utils/LogEngine.h"
 #include "Common/Utils/Utilities.h"
 
+#include "AnimationClip.h"
 #include "Bone.h"
 #include "Components/Renderer/Objects/Object.h"
 
@@ -37,6 +38,9 @@
 
 namespace Yeager {
 
+/* Rate used by the clips whose source file has no ticks per second */
+#define YEAGER_ANIMATION_DEFAULT_TICKS_PER_SECOND 25.0f
+
 struct AssimpNodeData {
   Matrix4 Transformation;
   String Name;
@@ -44,33 +48,111 @@ struct AssimpNodeData {
   std::vector<AssimpNodeData> Children;
 };
 
+/**
+ * @brief Node of the flattened hierarchy, parents always come before their children so the pose can be computed in a
+ * single loop
+ */
+struct AnimationSkeletonNode {
+  Matrix4 Transformation = Matrix4(1.0f);
+  String Name = YEAGER_NULL_LITERAL;
+  int Parent = -1;
+};
+
+/**
+ * @brief Bones of a mesh bound to the nodes of a shared skeleton. Meshes using the same clips can order their bones
+ * differently and have other offsets, so every animator keeps its own binding. BoneIDs is the index in the final bone
+ * matrices for each node, -1 if the node doesnt deform the mesh
+ */
+struct AnimationSkeletonBinding {
+  std::vector<int> BoneIDs;
+  std::vector<Matrix4> OffSets;
+};
+
+/**
+ * @brief Node hierarchy of a animated model, shared by every clip loaded from the same file and immutable once built
+ */
+struct AnimationSkeleton {
+  AssimpNodeData RootNode;
+  std::vector<AnimationSkeletonNode> Nodes;
+
+  static std::shared_ptr<AnimationSkeleton> Build(const aiNode* root);
+  static std::shared_ptr<AnimationSkeleton> Build(const AnimationClipFile& file);
+
+  /**
+   * @brief Returns the bone id and offset of every node found in the bone info map of the model
+   */
+  AnimationSkeletonBinding Bind(const std::map<String, BoneInfo>& boneInfoMap) const;
+  size_t GetMemorySize() const;
+
+ private:
+  static void ReadHeirarchyData(AssimpNodeData& dest, const aiNode* src);
+  static Uint ReadHeirarchyData(AssimpNodeData& dest, const AnimationClipFile& file, Uint index);
+  void Flatten(const AssimpNodeData& node, int parent);
+};
+
+/**
+ * @brief Immutable keyframes of a clip, shared between every animator playing it. The playback state (time, key
+ * cursors and poses) lives in the AnimationEngine of each instance
+ */
 class Animation {
  public:
   Animation() = default;
-  Animation(const String& name, const aiScene* scene, Uint index, AnimatedObject* model);
+  Animation(const String& name, const aiScene* scene, Uint index);
+  /**
+   * @brief Builds the animation from a clip of a compiled cache file, the bones sample the mapped keys directly, the
+   * animation keeps a reference to the file so the mapping stays alive while any copy of it exists
+   */
+  Animation(std::shared_ptr<AnimationClipFile> file, Uint index);
   ~Animation() {}
 
-  Bone* FindBone(const String& name);
+  const Bone* FindBone(const String& name) const;
+
+  /**
+   * @brief Marks the bones whose names contain one of the given patterns (case insensitive) as low importance, those
+   * bones can be skipped by the animation level of detail when the animator is far from the viewer
+   */
+  void FlagLowImportanceBones(const std::vector<String>& patterns);
+
+  /**
+   * @brief Links the clip to the skeleton of its file, every node gets the index of the bone animating it
+   */
+  void BindSkeleton(std::shared_ptr<const AnimationSkeleton> skeleton);
+
+  /**
+   * @brief Adds the bones animated by this clip and missing from the mesh to the bone info map of the model, must be
+   * called for every model using the clip before its skeleton binding is built
+   */
+  void RegisterBones(AnimatedObject* model) const;
+
+  Uint GetBoneCount() const { return m_Bones.size(); }
+  const std::vector<Bone>& GetBones() const { return m_Bones; }
+  /* Index of the bone in GetBones() for each node of the skeleton, -1 if the node is not animated by this clip */
+  const std::vector<int>& GetNodeBones() const { return m_NodeBones; }
+  const AnimationSkeleton* GetSkeleton() const { return m_Skeleton.get(); }
+  size_t GetMemorySize() const;
 
-  inline int GetTicksPerSecond() { return m_TicksPerSecond; }
-  inline float GetDuration() { return m_Duration; }
-  inline const AssimpNodeData& GetRootNode() { return m_RootNode; }
-  inline const std::map<String, BoneInfo>& GetBoneIDMap() { return m_BoneInfoMap; }
+  inline float GetTicksPerSecond() const
+  {
+    return m_TicksPerSecond > 0.0f ? m_TicksPerSecond : YEAGER_ANIMATION_DEFAULT_TICKS_PER_SECOND;
+  }
+  inline float GetDuration() const { return m_Duration; }
+  inline const AssimpNodeData& GetRootNode() const { return m_Skeleton->RootNode; }
 
   String GetName() const { return m_Name; }
-  Uint GetIndex() { return m_Index; }
+  Uint GetIndex() const { return m_Index; }
   void SetIndex(Uint index) { m_Index = index; }
 
  private:
-  void ReadMissingBones(const aiAnimation* animation, AnimatedObject& model);
-  void ReadHeirarchyData(AssimpNodeData& dest, const aiNode* src);
+  void ReadBones(const aiAnimation* animation);
+  void ReadBones(const AnimationClipFile& file, const AnimationClipDesc* clip);
   float m_Duration;
-  int m_TicksPerSecond;
+  float m_TicksPerSecond;
   std::vector<Bone> m_Bones;
-  AssimpNodeData m_RootNode;
+  std::vector<int> m_NodeBones;
+  std::shared_ptr<const AnimationSkeleton> m_Skeleton = YEAGER_NULLPTR;
   String m_Name = YEAGER_NULL_LITERAL;
-  std::map<String, BoneInfo> m_BoneInfoMap;
   Uint m_Index = 0;
+  std::shared_ptr<AnimationClipFile> m_ClipFile = YEAGER_NULLPTR;
 };
 
 }  // namespace Yeager
\ No newline at end of file
@@ -0,0 +1,545 @@
+#include "AnimationClip.h"
+#include "Bone.h"
+#include "Components/Kernel/Caching/Cache.h"
+using namespace Yeager;
+
+static constexpr float kSqrt2 = 1.41421356237f;
+static constexpr float kQuantizedRange16 = 65535.0f;
+static constexpr float kQuantizedRange15 = 32767.0f;
+
+static uint64_t AlignOffset(uint64_t offset)
+{
+  return (offset + 7) & ~static_cast<uint64_t>(7);
+}
+
+static uint16_t QuantizeRange(float value, float min, float extent)
+{
+  if (extent <= 0.0f)
+    return 0;
+  const float normalized = std::clamp((value - min) / extent, 0.0f, 1.0f);
+  return static_cast<uint16_t>(std::lround(normalized * kQuantizedRange16));
+}
+
+static float DequantizeRange(uint16_t value, float min, float extent)
+{
+  return min + (static_cast<float>(value) / kQuantizedRange16) * extent;
+}
+
+static Vector3 DequantizeVector(const uint16_t* value, const float* min, const float* extent)
+{
+  return Vector3(DequantizeRange(value[0], min[0], extent[0]), DequantizeRange(value[1], min[1], extent[1]),
+                 DequantizeRange(value[2], min[2], extent[2]));
+}
+
+static float DecodeTime(uint16_t time, float duration)
+{
+  return (static_cast<float>(time) / kQuantizedRange16) * duration;
+}
+
+static float RotationAngleError(const glm::quat& a, const glm::quat& b)
+{
+  const float dot = std::min(std::abs(glm::dot(glm::normalize(a), glm::normalize(b))), 1.0f);
+  return 2.0f * std::acos(dot);
+}
+
+void AnimationClipCompiler::EncodeQuaternion(const glm::quat& quat, uint16_t* out)
+{
+  const glm::quat q = glm::normalize(quat);
+  const float components[4] = {q.x, q.y, q.z, q.w};
+
+  Uint largest = 0;
+  for (Uint x = 1; x < 4; x++) {
+    if (std::abs(components[x]) > std::abs(components[largest]))
+      largest = x;
+  }
+
+  /* q and -q are the same rotation, the dropped component is always positive so it can be rebuilt from the others */
+  const float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+  uint16_t values[3];
+  Uint index = 0;
+  for (Uint x = 0; x < 4; x++) {
+    if (x == largest)
+      continue;
+    /* The three smallest components are inside [-1/sqrt(2), 1/sqrt(2)] */
+    const float normalized = std::clamp((components[x] * sign * kSqrt2 + 1.0f) * 0.5f, 0.0f, 1.0f);
+    values[index++] = static_cast<uint16_t>(std::lround(normalized * kQuantizedRange15));
+  }
+
+  out[0] = static_cast<uint16_t>((values[0] << 1) | ((largest >> 1) & 1));
+  out[1] = static_cast<uint16_t>((values[1] << 1) | (largest & 1));
+  out[2] = static_cast<uint16_t>(values[2] << 1);
+}
+
+glm::quat AnimationClipCompiler::DecodeQuaternion(const uint16_t* in)
+{
+  const Uint largest = ((in[0] & 1) << 1) | (in[1] & 1);
+  float values[3];
+  for (Uint x = 0; x < 3; x++) {
+    values[x] = ((static_cast<float>(in[x] >> 1) / kQuantizedRange15) * 2.0f - 1.0f) / kSqrt2;
+  }
+
+  float components[4];
+  Uint index = 0;
+  float sum = 0.0f;
+  for (Uint x = 0; x < 4; x++) {
+    if (x == largest)
+      continue;
+    components[x] = values[index++];
+    sum += components[x] * components[x];
+  }
+  components[largest] = std::sqrt(std::max(1.0f - sum, 0.0f));
+  return glm::normalize(glm::quat(components[3], components[0], components[1], components[2]));
+}
+
+/**
+ * @brief Greedy key reduction, walks the keys from a anchor and extends the segment while the linear interpolation between
+ * the anchor and the candidate reproduces every key in between within the tolerance. Returns the indices of the kept keys
+ */
+template <typename T, typename Interpolate, typename Error>
+static std::vector<Uint> ReduceKeys(const std::vector<float>& times, const std::vector<T>& values, float tolerance,
+                                    Interpolate interpolate, Error error)
+{
+  std::vector<Uint> kept;
+  const Uint count = values.size();
+  if (count == 0)
+    return kept;
+
+  /* Constant tracks only need one key */
+  bool constant = true;
+  for (Uint x = 1; x < count && constant; x++) {
+    constant = error(values[0], values[x]) <= tolerance;
+  }
+  if (constant || count == 1) {
+    kept.push_back(0);
+    return kept;
+  }
+
+  kept.push_back(0);
+  Uint anchor = 0;
+  for (Uint candidate = 2; candidate < count; candidate++) {
+    bool fits = true;
+    const float span = times[candidate] - times[anchor];
+    for (Uint key = anchor + 1; key < candidate && fits; key++) {
+      const float factor = span > 0.0f ? (times[key] - times[anchor]) / span : 0.0f;
+      fits = error(interpolate(values[anchor], values[candidate], factor), values[key]) <= tolerance;
+    }
+    if (!fits) {
+      kept.push_back(candidate - 1);
+      anchor = candidate - 1;
+    }
+  }
+  kept.push_back(count - 1);
+  return kept;
+}
+
+static uint16_t EncodeTime(float time, float duration)
+{
+  if (duration <= 0.0f)
+    return 0;
+  return static_cast<uint16_t>(std::lround(std::clamp(time / duration, 0.0f, 1.0f) * kQuantizedRange16));
+}
+
+static void ComputeRange(const std::vector<Vector3>& values, const std::vector<Uint>& kept, float* min, float* extent)
+{
+  Vector3 low(std::numeric_limits<float>::max());
+  Vector3 high(std::numeric_limits<float>::lowest());
+  for (const auto& index : kept) {
+    low = glm::min(low, values[index]);
+    high = glm::max(high, values[index]);
+  }
+  for (Uint x = 0; x < 3; x++) {
+    min[x] = low[x];
+    extent[x] = high[x] - low[x];
+  }
+}
+
+static uint32_t AppendString(std::vector<char>* strings, const String& str)
+{
+  const uint32_t offset = strings->size();
+  strings->insert(strings->end(), str.begin(), str.end());
+  strings->push_back('\0');
+  return offset;
+}
+
+static void AppendNodes(const aiNode* node, int32_t parent, std::vector<AnimationClipNode>* nodes,
+                        std::vector<char>* strings)
+{
+  AnimationClipNode data;
+  const Matrix4 transformation = ConvertAssimpMatrixToGLMFormat(node->mTransformation);
+  std::memcpy(data.Transformation, glm::value_ptr(transformation), sizeof(data.Transformation));
+  data.NameOffset = AppendString(strings, String(node->mName.data));
+  data.Parent = parent;
+  data.ChildrenCount = node->mNumChildren;
+
+  const int32_t index = nodes->size();
+  nodes->push_back(data);
+  for (Uint x = 0; x < node->mNumChildren; x++) {
+    AppendNodes(node->mChildren[x], index, nodes, strings);
+  }
+}
+
+bool AnimationClipCompiler::Compile(const aiScene* scene, const String& sourcePath, const String& outputPath,
+                                    const AnimationClipCompileSettings& settings, AnimationClipCompileReport* report)
+{
+  if (!scene || !scene->mRootNode) {
+    Yeager::Log(ERROR, "Cannot compile animation clips from invalid scene! Source {}", sourcePath);
+    return false;
+  }
+
+  std::vector<AnimationClipNode> nodes;
+  std::vector<AnimationClipDesc> clips;
+  std::vector<AnimationClipTrack> tracks;
+  std::vector<AnimationClipKey> keys;
+  std::vector<char> strings;
+  AnimationClipCompileReport summary;
+
+  AppendNodes(scene->mRootNode, -1, &nodes, &strings);
+
+  /* Key offsets are indices into the keys vector until the final layout of the file is known */
+  for (Uint animation = 0; animation < scene->mNumAnimations; animation++) {
+    const aiAnimation* source = scene->mAnimations[animation];
+    const float duration = source->mDuration;
+
+    AnimationClipDesc clip;
+    clip.NameOffset = AppendString(&strings, String(source->mName.C_Str()));
+    clip.TrackCount = source->mNumChannels;
+    clip.Duration = duration;
+    clip.TicksPerSecond = source->mTicksPerSecond;
+    clip.TracksOffset = tracks.size();
+    clips.push_back(clip);
+
+    for (Uint channel = 0; channel < source->mNumChannels; channel++) {
+      const aiNodeAnim* node = source->mChannels[channel];
+      AnimationClipTrack track;
+      track.NameOffset = AppendString(&strings, String(node->mNodeName.data));
+
+      std::vector<float> times;
+      std::vector<Vector3> positions;
+      for (Uint x = 0; x < node->mNumPositionKeys; x++) {
+        times.push_back(node->mPositionKeys[x].mTime);
+        positions.push_back(GetGLMVec(node->mPositionKeys[x].mValue));
+      }
+      const auto keptPositions = ReduceKeys(
+          times, positions, settings.PositionTolerance,
+          [](const Vector3& a, const Vector3& b, float f) { return glm::mix(a, b, f); },
+          [](const Vector3& a, const Vector3& b) { return glm::distance(a, b); });
+      ComputeRange(positions, keptPositions, track.PositionMin, track.PositionExtent);
+      track.PositionCount = keptPositions.size();
+      track.PositionKeysOffset = keys.size();
+      for (const auto& index : keptPositions) {
+        AnimationClipKey key;
+        key.Time = EncodeTime(times[index], duration);
+        for (Uint c = 0; c < 3; c++) {
+          key.Value[c] = QuantizeRange(positions[index][c], track.PositionMin[c], track.PositionExtent[c]);
+        }
+        keys.push_back(key);
+      }
+
+      times.clear();
+      std::vector<glm::quat> rotations;
+      for (Uint x = 0; x < node->mNumRotationKeys; x++) {
+        times.push_back(node->mRotationKeys[x].mTime);
+        rotations.push_back(GetGLMQuat(node->mRotationKeys[x].mValue));
+      }
+      const auto keptRotations = ReduceKeys(
+          times, rotations, settings.RotationTolerance,
+          [](const glm::quat& a, const glm::quat& b, float f) { return glm::normalize(glm::slerp(a, b, f)); },
+          [](const glm::quat& a, const glm::quat& b) { return RotationAngleError(a, b); });
+      track.RotationCount = keptRotations.size();
+      track.RotationKeysOffset = keys.size();
+      for (const auto& index : keptRotations) {
+        AnimationClipKey key;
+        key.Time = EncodeTime(times[index], duration);
+        EncodeQuaternion(rotations[index], key.Value);
+        keys.push_back(key);
+      }
+
+      times.clear();
+      std::vector<Vector3> scales;
+      for (Uint x = 0; x < node->mNumScalingKeys; x++) {
+        times.push_back(node->mScalingKeys[x].mTime);
+        scales.push_back(GetGLMVec(node->mScalingKeys[x].mValue));
+      }
+      const auto keptScales = ReduceKeys(
+          times, scales, settings.ScaleTolerance,
+          [](const Vector3& a, const Vector3& b, float f) { return glm::mix(a, b, f); },
+          [](const Vector3& a, const Vector3& b) { return glm::distance(a, b); });
+      ComputeRange(scales, keptScales, track.ScaleMin, track.ScaleExtent);
+      track.ScaleCount = keptScales.size();
+      track.ScaleKeysOffset = keys.size();
+      for (const auto& index : keptScales) {
+        AnimationClipKey key;
+        key.Time = EncodeTime(times[index], duration);
+        for (Uint c = 0; c < 3; c++) {
+          key.Value[c] = QuantizeRange(scales[index][c], track.ScaleMin[c], track.ScaleExtent[c]);
+        }
+        keys.push_back(key);
+      }
+
+      summary.SourceKeys += node->mNumPositionKeys + node->mNumRotationKeys + node->mNumScalingKeys;
+      summary.SourceBytes += sizeof(KeyPosition) * node->mNumPositionKeys +
+                             sizeof(KeyRotation) * node->mNumRotationKeys + sizeof(KeyScale) * node->mNumScalingKeys;
+      tracks.push_back(track);
+    }
+  }
+
+  AnimationClipFileHeader header;
+  std::memcpy(header.MagicConst, YEAGER_CACHE_MAGIC_CONST, sizeof(char) * 4);
+  header.Version = YEAGER_ANIMATION_CLIP_CACHE_VERSION;
+  header.SourceHash = CreateFileHash(sourcePath);
+  header.SourceTimestamp = AnimationClipFile::GetSourceTimestamp(sourcePath);
+  header.NodeCount = nodes.size();
+  header.ClipCount = clips.size();
+  header.NodesOffset = AlignOffset(sizeof(AnimationClipFileHeader));
+  header.ClipsOffset = AlignOffset(header.NodesOffset + nodes.size() * sizeof(AnimationClipNode));
+  const uint64_t tracksOffset = AlignOffset(header.ClipsOffset + clips.size() * sizeof(AnimationClipDesc));
+  const uint64_t keysOffset = AlignOffset(tracksOffset + tracks.size() * sizeof(AnimationClipTrack));
+  header.StringsOffset = AlignOffset(keysOffset + keys.size() * sizeof(AnimationClipKey));
+  header.FileSize = AlignOffset(header.StringsOffset + strings.size());
+
+  for (auto& clip : clips) {
+    clip.TracksOffset = tracksOffset + clip.TracksOffset * sizeof(AnimationClipTrack);
+  }
+  for (auto& track : tracks) {
+    track.PositionKeysOffset = keysOffset + track.PositionKeysOffset * sizeof(AnimationClipKey);
+    track.RotationKeysOffset = keysOffset + track.RotationKeysOffset * sizeof(AnimationClipKey);
+    track.ScaleKeysOffset = keysOffset + track.ScaleKeysOffset * sizeof(AnimationClipKey);
+  }
+
+  std::vector<uint8_t> buffer(header.FileSize, 0);
+  std::memcpy(buffer.data(), &header, sizeof(AnimationClipFileHeader));
+  std::memcpy(buffer.data() + header.NodesOffset, nodes.data(), nodes.size() * sizeof(AnimationClipNode));
+  std::memcpy(buffer.data() + header.ClipsOffset, clips.data(), clips.size() * sizeof(AnimationClipDesc));
+  std::memcpy(buffer.data() + tracksOffset, tracks.data(), tracks.size() * sizeof(AnimationClipTrack));
+  std::memcpy(buffer.data() + keysOffset, keys.data(), keys.size() * sizeof(AnimationClipKey));
+  std::memcpy(buffer.data() + header.StringsOffset, strings.data(), strings.size());
+
+  /* Writes to a temporary file first, a crash while writing must not leave a corrupted cache behind */
+  const String temporaryPath = outputPath + ".tmp";
+  {
+    std::ofstream output(temporaryPath, std::ios_base::binary | std::ios_base::trunc);
+    if (!output.is_open()) {
+      Yeager::Log(ERROR, "Cannot write animation clip cache {}", outputPath);
+      return false;
+    }
+    output.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    if (!output) {
+      Yeager::Log(ERROR, "Cannot write animation clip cache {}", outputPath);
+      return false;
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temporaryPath, outputPath, error);
+  if (error) {
+    Yeager::Log(ERROR, "Cannot move animation clip cache to {}, {}", outputPath, error.message());
+    return false;
+  }
+
+  summary.CompiledBytes = header.FileSize;
+  summary.CompiledKeys = keys.size();
+
+  AnimationClipFile compiled;
+  if (!compiled.Load(outputPath, header.SourceHash, header.SourceTimestamp)) {
+    Yeager::Log(ERROR, "Animation clip cache {} cannot be loaded back after compiled!", outputPath);
+    return false;
+  }
+  for (Uint animation = 0; animation < scene->mNumAnimations; animation++) {
+    MeasureRoundTripError(scene->mAnimations[animation], compiled, animation, &summary);
+  }
+
+  Yeager::Log(INFO,
+              "Compiled animation clips of {}, {} bytes -> {} bytes, keys {} -> {}, max error position {} rotation {} "
+              "scale {}",
+              sourcePath, summary.SourceBytes, summary.CompiledBytes, summary.SourceKeys, summary.CompiledKeys,
+              summary.MaxPositionError, summary.MaxRotationError, summary.MaxScaleError);
+
+  if (report)
+    *report = summary;
+  return true;
+}
+
+void AnimationClipCompiler::MeasureRoundTripError(const aiAnimation* source, const AnimationClipFile& file, Uint clip,
+                                                  AnimationClipCompileReport* report)
+{
+  const AnimationClipDesc* desc = file.GetClip(clip);
+  const AnimationClipTrack* tracks = file.GetTracks(desc);
+
+  for (Uint channel = 0; channel < source->mNumChannels && channel < desc->TrackCount; channel++) {
+    const aiNodeAnim* node = source->mChannels[channel];
+    const AnimationClipTrack* track = &tracks[channel];
+    Vector3 position, scale;
+    glm::quat rotation;
+
+    for (Uint x = 0; x < node->mNumPositionKeys; x++) {
+      file.SampleTrack(track, desc->Duration, node->mPositionKeys[x].mTime, &position, &rotation, &scale);
+      report->MaxPositionError =
+          std::max(report->MaxPositionError, glm::distance(position, GetGLMVec(node->mPositionKeys[x].mValue)));
+    }
+    for (Uint x = 0; x < node->mNumRotationKeys; x++) {
+      file.SampleTrack(track, desc->Duration, node->mRotationKeys[x].mTime, &position, &rotation, &scale);
+      report->MaxRotationError =
+          std::max(report->MaxRotationError, RotationAngleError(rotation, GetGLMQuat(node->mRotationKeys[x].mValue)));
+    }
+    for (Uint x = 0; x < node->mNumScalingKeys; x++) {
+      file.SampleTrack(track, desc->Duration, node->mScalingKeys[x].mTime, &position, &rotation, &scale);
+      report->MaxScaleError =
+          std::max(report->MaxScaleError, glm::distance(scale, GetGLMVec(node->mScalingKeys[x].mValue)));
+    }
+  }
+}
+
+bool AnimationClipFile::Load(const String& path, uint64_t sourceHash, uint64_t sourceTimestamp)
+{
+  m_Header = YEAGER_NULLPTR;
+  if (!Yeager::ValidatesPath(path, false) || !m_File.Map(path)) {
+    return false;
+  }
+
+  const AnimationClipFileHeader* header = m_File.At<AnimationClipFileHeader>(0);
+  if (!header || std::memcmp(header->MagicConst, YEAGER_CACHE_MAGIC_CONST, sizeof(char) * 4) != 0 ||
+      header->Version != YEAGER_ANIMATION_CLIP_CACHE_VERSION || header->FileSize != m_File.GetSize()) {
+    Yeager::Log(WARNING, "Animation clip cache {} is invalid or from another version, it will be rebuild", path);
+    m_File.Unmap();
+    return false;
+  }
+
+  if (header->SourceHash != sourceHash || header->SourceTimestamp != sourceTimestamp) {
+    Yeager::LogDebug(INFO, "Animation clip cache {} is outdated, it will be rebuild", path);
+    m_File.Unmap();
+    return false;
+  }
+
+  m_Nodes = m_File.At<AnimationClipNode>(header->NodesOffset, header->NodeCount);
+  m_Clips = m_File.At<AnimationClipDesc>(header->ClipsOffset, header->ClipCount);
+  if (!m_Nodes || !m_Clips || !ValidateRanges(header)) {
+    Yeager::Log(WARNING, "Animation clip cache {} is truncated, it will be rebuild", path);
+    m_File.Unmap();
+    return false;
+  }
+
+  m_Header = header;
+  return true;
+}
+
+bool AnimationClipFile::ValidateRanges(const AnimationClipFileHeader* header) const
+{
+  /* The last string ends at the end of the file, so every name read from the strings section is terminated */
+  if (header->StringsOffset >= m_File.GetSize() || m_File.GetData()[m_File.GetSize() - 1] != '\0') {
+    return false;
+  }
+  const uint64_t stringsSize = m_File.GetSize() - header->StringsOffset;
+
+  for (Uint node = 0; node < header->NodeCount; node++) {
+    if (m_Nodes[node].NameOffset >= stringsSize)
+      return false;
+  }
+
+  /* Every track and key range is checked once here, so sampling the clips does not need to */
+  for (Uint clip = 0; clip < header->ClipCount; clip++) {
+    const AnimationClipDesc* desc = &m_Clips[clip];
+    const AnimationClipTrack* tracks = GetTracks(desc);
+    if (!tracks || desc->NameOffset >= stringsSize)
+      return false;
+    for (Uint x = 0; x < desc->TrackCount; x++) {
+      const AnimationClipTrack* track = &tracks[x];
+      if (track->NameOffset >= stringsSize || !GetKeys(track->PositionKeysOffset, track->PositionCount) ||
+          !GetKeys(track->RotationKeysOffset, track->RotationCount) ||
+          !GetKeys(track->ScaleKeysOffset, track->ScaleCount)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+const AnimationClipTrack* AnimationClipFile::GetTracks(const AnimationClipDesc* clip) const
+{
+  return m_File.At<AnimationClipTrack>(clip->TracksOffset, clip->TrackCount);
+}
+
+Cchar AnimationClipFile::GetString(uint32_t offset) const
+{
+  return reinterpret_cast<Cchar>(m_File.GetData() + m_Header->StringsOffset + offset);
+}
+
+/**
+ * @brief Finds the key pair surrounding the time and the interpolation factor between them, like the index search of
+ * the bones, times past the last key are clamped to it
+ */
+static Uint FindKeyIndex(const AnimationClipKey* keys, Uint count, float time, float duration, float* factor)
+{
+  const AnimationClipKey* end = keys + count;
+  const float normalized = duration > 0.0f ? std::clamp(time / duration, 0.0f, 1.0f) * kQuantizedRange16 : 0.0f;
+  const AnimationClipKey* next = std::upper_bound(
+      keys, end, normalized, [](float value, const AnimationClipKey& key) { return value < static_cast<float>(key.Time); });
+
+  if (next == keys) {
+    *factor = 0.0f;
+    return 0;
+  }
+  if (next == end) {
+    *factor = 1.0f;
+    return count - 2;
+  }
+
+  const Uint index = (next - keys) - 1;
+  const float last = DecodeTime(keys[index].Time, duration);
+  const float span = DecodeTime(keys[index + 1].Time, duration) - last;
+  *factor = span > 0.0f ? std::clamp((time - last) / span, 0.0f, 1.0f) : 0.0f;
+  return index;
+}
+
+void AnimationClipFile::SampleTrack(const AnimationClipTrack* track, float duration, float time, Vector3* position,
+                                    glm::quat* rotation, Vector3* scale) const
+{
+  float factor = 0.0f;
+
+  /* A channel without keys keeps the identity, like a node without a channel */
+  const AnimationClipKey* positions = GetKeys(track->PositionKeysOffset, track->PositionCount);
+  if (track->PositionCount == 0) {
+    *position = Vector3(0.0f);
+  } else if (track->PositionCount == 1) {
+    *position = DequantizeVector(positions[0].Value, track->PositionMin, track->PositionExtent);
+  } else {
+    const Uint index = FindKeyIndex(positions, track->PositionCount, time, duration, &factor);
+    *position = glm::mix(DequantizeVector(positions[index].Value, track->PositionMin, track->PositionExtent),
+                         DequantizeVector(positions[index + 1].Value, track->PositionMin, track->PositionExtent), factor);
+  }
+
+  const AnimationClipKey* rotations = GetKeys(track->RotationKeysOffset, track->RotationCount);
+  if (track->RotationCount == 0) {
+    *rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+  } else if (track->RotationCount == 1) {
+    *rotation = AnimationClipCompiler::DecodeQuaternion(rotations[0].Value);
+  } else {
+    const Uint index = FindKeyIndex(rotations, track->RotationCount, time, duration, &factor);
+    *rotation = glm::normalize(glm::slerp(AnimationClipCompiler::DecodeQuaternion(rotations[index].Value),
+                                          AnimationClipCompiler::DecodeQuaternion(rotations[index + 1].Value), factor));
+  }
+
+  const AnimationClipKey* scales = GetKeys(track->ScaleKeysOffset, track->ScaleCount);
+  if (track->ScaleCount == 0) {
+    *scale = Vector3(1.0f);
+  } else if (track->ScaleCount == 1) {
+    *scale = DequantizeVector(scales[0].Value, track->ScaleMin, track->ScaleExtent);
+  } else {
+    const Uint index = FindKeyIndex(scales, track->ScaleCount, time, duration, &factor);
+    *scale = glm::mix(DequantizeVector(scales[index].Value, track->ScaleMin, track->ScaleExtent),
+                      DequantizeVector(scales[index + 1].Value, track->ScaleMin, track->ScaleExtent), factor);
+  }
+}
+
+String AnimationClipFile::GetCachePath(const String& cacheFolder, const String& sourcePath)
+{
+  return cacheFolder + YG_PS + std::to_string(CreateFileHash(sourcePath)) + String(YEAGER_ANIMATION_CLIP_CACHE_EXT_STR);
+}
+
+uint64_t AnimationClipFile::GetSourceTimestamp(const String& sourcePath)
+{
+  std::error_code error;
+  const auto time = std::filesystem::last_write_time(sourcePath, error);
+  if (error)
+    return 0;
+  return static_cast<uint64_t>(time.time_since_epoch().count());
+}
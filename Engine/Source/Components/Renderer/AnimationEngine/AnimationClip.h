@@ -0,0 +1,193 @@
+//    Yeager Engine, free and open source 3D/2D renderer written in OpenGL
+//    In case of questions and bugs, please, refer to the issue tab on github
+//    Repo : https://github.com/schwq/YeagerEngine
+//    Copyright (C) 2023 - Present
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Common/FS/MappedFile.h"
+#include "Common/Utils/Common.h"
+#include "Common/Utils/LogEngine.h"
+#include "Common/Utils/Utilities.h"
+
+#include <assimp/anim.h>
+#include <assimp/scene.h>
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/glm.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+namespace Yeager {
+
+#define YEAGER_ANIMATION_CLIP_CACHE_EXT_STR ".ygen_anim_cache"
+#define YEAGER_ANIMATION_CLIP_CACHE_VERSION 1
+
+/**
+ * Animation clip cache file (path_hash).ygen_anim_cache, every section starts 8 bytes aligned so the file can be mapped
+ * and read in place. Offsets are from the start of the file, except names that are offsets into the strings section
+ * Header - AnimationClipFileHeader (64 bytes)
+ * Nodes - NodeCount * AnimationClipNode, the node hierarchy in depth first order
+ * Clips - ClipCount * AnimationClipDesc
+ * Tracks - AnimationClipTrack of every clip, one for each animated bone
+ * Keys - AnimationClipKey of every track (8 bytes each)
+ * Strings - Null terminated node, clip and bone names
+ */
+struct AnimationClipFileHeader {
+  char MagicConst[4] = {0};
+  uint32_t Version = 0;
+  uint64_t SourceHash = 0;
+  uint64_t SourceTimestamp = 0;
+  uint32_t NodeCount = 0;
+  uint32_t ClipCount = 0;
+  uint64_t NodesOffset = 0;
+  uint64_t ClipsOffset = 0;
+  uint64_t StringsOffset = 0;
+  uint64_t FileSize = 0;
+};
+
+struct AnimationClipNode {
+  float Transformation[16];
+  uint32_t NameOffset = 0;
+  int32_t Parent = -1;
+  uint32_t ChildrenCount = 0;
+  uint32_t Padding = 0;
+};
+
+struct AnimationClipDesc {
+  uint32_t NameOffset = 0;
+  uint32_t TrackCount = 0;
+  float Duration = 0.0f;
+  float TicksPerSecond = 0.0f;
+  uint64_t TracksOffset = 0;
+};
+
+/**
+ * Translations and scales are quantized to 16 bits inside the range [Min, Min + Extent] of the track, rotations are
+ * stored with the smallest three encoding, three 15 bits components and the index of the dropped one in the low bits
+ */
+struct AnimationClipTrack {
+  uint32_t NameOffset = 0;
+  uint32_t PositionCount = 0;
+  uint32_t RotationCount = 0;
+  uint32_t ScaleCount = 0;
+  float PositionMin[3] = {0};
+  float PositionExtent[3] = {0};
+  float ScaleMin[3] = {0};
+  float ScaleExtent[3] = {0};
+  uint64_t PositionKeysOffset = 0;
+  uint64_t RotationKeysOffset = 0;
+  uint64_t ScaleKeysOffset = 0;
+};
+
+/* Time is normalized to the duration of the clip and quantized to 16 bits */
+struct AnimationClipKey {
+  uint16_t Time = 0;
+  uint16_t Value[3] = {0};
+};
+
+/**
+ * @brief Error bounds used by the key reduction, a key is dropped when the linear interpolation of its neighbours
+ * reproduces it within the tolerance. Rotation tolerance is a angle in radians
+ */
+struct AnimationClipCompileSettings {
+  float PositionTolerance = 0.001f;
+  float RotationTolerance = 0.001f;
+  float ScaleTolerance = 0.001f;
+};
+
+/**
+ * @brief Memory and precision of a compiled clip against the source keys, the errors are measured by sampling the
+ * compiled tracks at every source key
+ */
+struct AnimationClipCompileReport {
+  size_t SourceBytes = 0;
+  size_t CompiledBytes = 0;
+  Uint SourceKeys = 0;
+  Uint CompiledKeys = 0;
+  float MaxPositionError = 0.0f;
+  float MaxRotationError = 0.0f;
+  float MaxScaleError = 0.0f;
+};
+
+/**
+ * @brief Read only view of a compiled animation clip file, the file is mapped in memory and the tracks are decoded only
+ * when sampled, so the memory cost of a loaded clip is the size of the file
+ */
+class AnimationClipFile {
+ public:
+  AnimationClipFile() = default;
+
+  /**
+   * @brief Maps the cache file and validates its header, returns false if the file is missing, corrupted or was compiled
+   * from another version of the source file
+   */
+  bool Load(const String& path, uint64_t sourceHash, uint64_t sourceTimestamp);
+  bool IsLoaded() const { return m_Header != YEAGER_NULLPTR; }
+
+  Uint GetNodeCount() const { return m_Header->NodeCount; }
+  Uint GetClipCount() const { return m_Header->ClipCount; }
+  const AnimationClipNode* GetNodes() const { return m_Nodes; }
+  const AnimationClipDesc* GetClip(Uint index) const { return &m_Clips[index]; }
+  const AnimationClipTrack* GetTracks(const AnimationClipDesc* clip) const;
+  Cchar GetString(uint32_t offset) const;
+  size_t GetMemorySize() const { return m_File.GetSize(); }
+
+  /**
+   * @brief Decodes the pose of a track at the given time (in ticks), interpolating between the surrounding keys
+   */
+  void SampleTrack(const AnimationClipTrack* track, float duration, float time, Vector3* position,
+                   glm::quat* rotation, Vector3* scale) const;
+
+  /**
+   * @brief Path of the cache file for the given source in the cache folder and the values used to invalidate it
+   */
+  static String GetCachePath(const String& cacheFolder, const String& sourcePath);
+  static uint64_t GetSourceTimestamp(const String& sourcePath);
+
+ private:
+  /* Checks the tracks, keys and names of every clip fit inside the file, after the node and clip tables are mapped */
+  bool ValidateRanges(const AnimationClipFileHeader* header) const;
+  const AnimationClipKey* GetKeys(uint64_t offset, uint32_t count) const
+  {
+    return m_File.At<AnimationClipKey>(offset, count);
+  }
+
+  MappedFile m_File;
+  const AnimationClipFileHeader* m_Header = YEAGER_NULLPTR;
+  const AnimationClipNode* m_Nodes = YEAGER_NULLPTR;
+  const AnimationClipDesc* m_Clips = YEAGER_NULLPTR;
+};
+
+/**
+ * @brief Offline compiler of the animation clips of a assimp scene into the compact cache format
+ */
+class AnimationClipCompiler {
+ public:
+  static bool Compile(const aiScene* scene, const String& sourcePath, const String& outputPath,
+                      const AnimationClipCompileSettings& settings = AnimationClipCompileSettings(),
+                      AnimationClipCompileReport* report = YEAGER_NULLPTR);
+
+  /**
+   * @brief Samples every track of the compiled clip at the times of the source keys and writes the largest errors found
+   * into the report, used to validate the quantization and key reduction
+   */
+  static void MeasureRoundTripError(const aiAnimation* source, const AnimationClipFile& file, Uint clip,
+                                    AnimationClipCompileReport* report);
+
+  static void EncodeQuaternion(const glm::quat& quat, uint16_t* out);
+  static glm::quat DecodeQuaternion(const uint16_t* in);
+};
+
+}  // namespace Yeager
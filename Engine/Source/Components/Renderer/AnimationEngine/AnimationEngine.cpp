@@ -1,45 +1,104 @@
 #include "AnimationEngine.h"
 using namespace Yeager;
 
+AnimationLODSettings AnimationEngine::sLODSettings;
+AnimationLODFrameStats AnimationEngine::sLODFrameStats;
+Uint AnimationEngine::sAnimatorsCount = 0;
+
+String AnimationLODLevel::ToString(AnimationLODLevel::Enum type)
+{
+  switch (type) {
+    case eLOD_NEAR:
+      return "Near";
+    case eLOD_MEDIUM:
+      return "Medium";
+    case eLOD_FAR:
+      return "Far";
+    case eLOD_DISTANT:
+      return "Distant";
+    case eLOD_OFF_SCREEN:
+      return "Off Screen";
+    default:
+      return "Undefined";
+  }
+}
+
 AnimationEngine::AnimationEngine()
 {
+  /* Each animator gets a different offset, so animators sharing a reduced rate dont evaluate on the same frame */
+  m_StaggerOffset = sAnimatorsCount++;
   Initialize();
 }
 
 void AnimationEngine::Initialize()
 {
   m_CurrentTime = 0.0f;
+  m_FinalBoneMatrices.clear();
   m_FinalBoneMatrices.reserve(MAX_BONES);
   for (int x = 0; x < MAX_BONES; x++) {
     m_FinalBoneMatrices.push_back(Matrix4(1.0f));
   }
+  m_PreviousBoneMatrices = m_FinalBoneMatrices;
+  m_TargetBoneMatrices = m_FinalBoneMatrices;
+  m_FramesSinceEvaluation = 0;
+  m_CurrentUpdateInterval = 1;
+  m_ForceEvaluation = true;
 }
 
 void AnimationEngine::LoadAnimationsFromFile(const String& path, AnimatedObject* model)
 {
-  Assimp::Importer imp;
-  const aiScene* scene = imp.ReadFile(path, aiProcess_Triangulate);
+  LoadClipSet(AnimationLibrary::Acquire(path, model), model->GetModelData()->GetBoneInfoMap());
+}
+
+void AnimationEngine::LoadClipSet(std::shared_ptr<const AnimationClipSet> set,
+                                  const std::map<String, BoneInfo>& boneInfoMap)
+{
+  m_ClipSet = set;
+  m_AnimationsLoaded = m_ClipSet != YEAGER_NULLPTR;
+  m_Binding = m_AnimationsLoaded ? m_ClipSet->Skeleton->Bind(boneInfoMap) : AnimationSkeletonBinding();
+}
 
-  if (!scene || !scene->mRootNode) {
-    Yeager::Log(ERROR, "Assimp cannot load animation file! Path {}", path);
-  }
+const std::vector<Animation>* AnimationEngine::GetAnimations() const
+{
+  static const std::vector<Animation> empty;
+  return m_ClipSet ? &m_ClipSet->Animations : &empty;
+}
 
-  for (Uint animations = 0; animations < scene->mNumAnimations; animations++) {
-    aiString name = scene->mAnimations[animations]->mName;
-    Animation anim(String(name.C_Str()), scene, animations, model);
-    anim.SetIndex(animations);
-    m_Animations.push_back(anim);
+bool AnimationEngine::SamplePose(Uint index, float seconds, std::vector<Matrix4>* output)
+{
+  if (!m_AnimationsLoaded || index >= m_ClipSet->Animations.size())
+    return false;
+
+  const Animation* animation = &m_ClipSet->Animations.at(index);
+  if (m_CurrentAnimation != animation) {
+    PlayAnimation(animation);
   }
 
-  m_AnimationsLoaded = true;
+  const float ticks = fmod(animation->GetTicksPerSecond() * seconds, animation->GetDuration());
+  m_SkipLowImportanceBones = false;
+  output->assign(MAX_BONES, Matrix4(1.0f));
+  EvaluatePose(ticks, output);
+  return true;
+}
+
+void AnimationPlaybackState::Reset(const Animation* animation)
+{
+  const Uint bones = animation->GetBoneCount();
+  Cursors.assign(bones, BoneKeyCursor());
+  LocalTransforms.assign(bones, Matrix4(1.0f));
+  Evaluated.assign(bones, 0);
+  GlobalTransforms.assign(animation->GetSkeleton()->Nodes.size(), Matrix4(1.0f));
 }
 
 void AnimationEngine::PlayAnimation(Uint index)
 {
   if (m_AnimationsLoaded) {
-    m_CurrentAnimation = &m_Animations.at(index);
+    m_CurrentAnimation = &m_ClipSet->Animations.at(index);
+    m_Playback.Reset(m_CurrentAnimation);
     m_CurrentTime = 0.0f;
     m_PlayingAnimation = true;
+    /* Forces the next update to evaluate the new animation */
+    m_ForceEvaluation = true;
   }
 }
 
@@ -49,48 +108,148 @@ void AnimationEngine::UpdateAnimation(float dt)
     return;
 
   m_DeltaTime = dt;
+  m_LODLevel = AnimationLODLevel::eLOD_NEAR;
+  m_SkipLowImportanceBones = false;
+  m_CurrentUpdateInterval = 1;
   if (m_CurrentAnimation) {
     m_CurrentTime += m_CurrentAnimation->GetTicksPerSecond() * dt;
     m_CurrentTime = fmod(m_CurrentTime, m_CurrentAnimation->GetDuration());
-    CalculateBoneTransform(&m_CurrentAnimation->GetRootNode(), Matrix4(1.0f));
+    EvaluatePose(m_CurrentTime, &m_FinalBoneMatrices);
+    sLODFrameStats.AnimatorsEvaluated++;
   }
 }
-void AnimationEngine::PlayAnimation(Animation* animation)
-{
-  m_CurrentAnimation = animation;
-  m_CurrentTime = 0.0f;
-  m_PlayingAnimation = true;
-}
 
-void AnimationEngine::CalculateBoneTransform(const AssimpNodeData* node, Matrix4 parentTrans)
+void AnimationEngine::UpdateAnimation(float dt, float viewerDistance, bool onScreen)
 {
+  if (!sLODSettings.Enabled) {
+    UpdateAnimation(dt);
+    return;
+  }
+
   if (!m_AnimationsLoaded)
     return;
 
-  assert(node);
+  m_DeltaTime = dt;
+  m_FrameCounter++;
+  if (!m_CurrentAnimation)
+    return;
 
-  String nodeName = node->Name;
+  const float ticks = m_CurrentAnimation->GetTicksPerSecond() * dt;
+  m_CurrentTime = fmod(m_CurrentTime + ticks, m_CurrentAnimation->GetDuration());
+
+  m_LODLevel = SelectLODLevel(viewerDistance, onScreen);
+  m_SkipLowImportanceBones = viewerDistance > sLODSettings.SkipLowImportanceBonesDistance;
+  const Uint interval = std::max(GetLODUpdateInterval(m_LODLevel), 1u);
+  const bool interpolate =
+      sLODSettings.InterpolateBetweenUpdates && interval > 1 && m_LODLevel != AnimationLODLevel::eLOD_OFF_SCREEN;
+
+  /* Evaluates when the staggered slot of this animator comes, or when a new animation started playing */
+  const bool slot = ((m_FrameCounter + m_StaggerOffset) % interval) == 0;
+  if (slot || m_ForceEvaluation) {
+    m_CurrentUpdateInterval = interval;
+    m_FramesSinceEvaluation = 0;
+    sLODFrameStats.AnimatorsEvaluated++;
+
+    if (interpolate && !m_ForceEvaluation) {
+      /* The target pose is sampled ahead, at the time the animator will be when the interval finishes, so the blended
+       * pose follows the real animation time instead of lagging behind it */
+      m_PreviousBoneMatrices = m_FinalBoneMatrices;
+      const float lookAhead = fmod(m_CurrentTime + ticks * (interval - 1), m_CurrentAnimation->GetDuration());
+      EvaluatePose(lookAhead, &m_TargetBoneMatrices);
+    } else {
+      m_ForceEvaluation = false;
+      EvaluatePose(m_CurrentTime, &m_FinalBoneMatrices);
+      m_TargetBoneMatrices = m_FinalBoneMatrices;
+      m_CurrentUpdateInterval = 1;
+      return;
+    }
+  } else {
+    m_FramesSinceEvaluation++;
+    sLODFrameStats.BonesSavedByRate += m_CurrentAnimation->GetBoneCount();
+    if (!interpolate)
+      return;
+    sLODFrameStats.AnimatorsInterpolated++;
+  }
 
-  Matrix4 nodeTransform = node->Transformation;
+  const float alpha = std::min(static_cast<float>(m_FramesSinceEvaluation + 1) / m_CurrentUpdateInterval, 1.0f);
+  for (Uint x = 0; x < m_FinalBoneMatrices.size(); x++) {
+    m_FinalBoneMatrices[x] = m_PreviousBoneMatrices[x] + (m_TargetBoneMatrices[x] - m_PreviousBoneMatrices[x]) * alpha;
+  }
+}
 
-  Bone* Bone = m_CurrentAnimation->FindBone(nodeName);
+AnimationLODLevel::Enum AnimationEngine::SelectLODLevel(float viewerDistance, bool onScreen) const
+{
+  if (!onScreen)
+    return AnimationLODLevel::eLOD_OFF_SCREEN;
+  if (viewerDistance <= sLODSettings.NearDistance)
+    return AnimationLODLevel::eLOD_NEAR;
+  if (viewerDistance <= sLODSettings.MediumDistance)
+    return AnimationLODLevel::eLOD_MEDIUM;
+  if (viewerDistance <= sLODSettings.FarDistance)
+    return AnimationLODLevel::eLOD_FAR;
+  return AnimationLODLevel::eLOD_DISTANT;
+}
 
-  if (Bone) {
-    Bone->Update(m_CurrentTime);
-    nodeTransform = Bone->GetLocalTransform();
+Uint AnimationEngine::GetLODUpdateInterval(AnimationLODLevel::Enum level) const
+{
+  switch (level) {
+    case AnimationLODLevel::eLOD_NEAR:
+      return sLODSettings.NearUpdateInterval;
+    case AnimationLODLevel::eLOD_MEDIUM:
+      return sLODSettings.MediumUpdateInterval;
+    case AnimationLODLevel::eLOD_FAR:
+      return sLODSettings.FarUpdateInterval;
+    case AnimationLODLevel::eLOD_DISTANT:
+      return sLODSettings.DistantUpdateInterval;
+    case AnimationLODLevel::eLOD_OFF_SCREEN:
+    default:
+      return sLODSettings.OffScreenUpdateInterval;
   }
+}
 
-  Matrix4 globalTransformation = parentTrans * nodeTransform;
-
-  auto boneInfoMap = m_CurrentAnimation->GetBoneIDMap();
+void AnimationEngine::PlayAnimation(const Animation* animation)
+{
+  m_CurrentAnimation = animation;
+  m_Playback.Reset(m_CurrentAnimation);
+  m_CurrentTime = 0.0f;
+  m_PlayingAnimation = true;
+  m_ForceEvaluation = true;
+}
 
-  if (boneInfoMap.find(nodeName) != boneInfoMap.end()) {
-    int index = boneInfoMap[nodeName].ID;
-    Matrix4 offset = boneInfoMap[nodeName].OffSet;
-    m_FinalBoneMatrices[index] = globalTransformation * offset;
-  }
+void AnimationEngine::EvaluatePose(float time, std::vector<Matrix4>* output)
+{
+  if (!m_AnimationsLoaded)
+    return;
 
-  for (int x = 0; x < node->ChildrenCount; x++) {
-    CalculateBoneTransform(&node->Children[x], globalTransformation);
+  const AnimationSkeleton* skeleton = m_CurrentAnimation->GetSkeleton();
+  const std::vector<int>& nodeBones = m_CurrentAnimation->GetNodeBones();
+  const std::vector<Bone>& bones = m_CurrentAnimation->GetBones();
+
+  /* Parents are always before their children in the skeleton, so their global transform is already computed */
+  for (Uint x = 0; x < skeleton->Nodes.size(); x++) {
+    const AnimationSkeletonNode& node = skeleton->Nodes[x];
+    const int bone = nodeBones[x];
+    Matrix4 nodeTransform = node.Transformation;
+
+    if (bone >= 0) {
+      /* Low importance bones keep their last pose when far away, they still need a first evaluation, otherwise the
+       * bone would collapse to the identity transform */
+      if (m_SkipLowImportanceBones && bones[bone].IsLowImportance() && m_Playback.Evaluated[bone]) {
+        sLODFrameStats.BonesSavedByImportance++;
+      } else {
+        m_Playback.LocalTransforms[bone] = bones[bone].Evaluate(time, &m_Playback.Cursors[bone]);
+        m_Playback.Evaluated[bone] = 1;
+        sLODFrameStats.BonesEvaluated++;
+      }
+      nodeTransform = m_Playback.LocalTransforms[bone];
+    }
+
+    m_Playback.GlobalTransforms[x] =
+        node.Parent >= 0 ? m_Playback.GlobalTransforms[node.Parent] * nodeTransform : nodeTransform;
+
+    const int boneID = m_Binding.BoneIDs[x];
+    if (boneID >= 0 && boneID < MAX_BONES) {
+      (*output)[boneID] = m_Playback.GlobalTransforms[x] * m_Binding.OffSets[x];
+    }
   }
-}
\ No newline at end of file
+}
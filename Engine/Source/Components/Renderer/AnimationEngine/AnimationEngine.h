@@ -23,34 +23,141 @@
 #include "Common/Utils/Utilities.h"
 
 #include "Animation.h"
+#include "AnimationLibrary.h"
 
 #define MAX_BONES 100
 
 namespace Yeager {
+
+struct AnimationLODLevel {
+  enum Enum { eLOD_NEAR, eLOD_MEDIUM, eLOD_FAR, eLOD_DISTANT, eLOD_OFF_SCREEN };
+  YEAGER_ENUM_TO_STRING(AnimationLODLevel)
+};
+
+/**
+ * @brief Thresholds used to select the animation level of detail of a animator. Distances are in world units measured
+ * from the viewer, the update intervals are the number of frames between each pose evaluation at that level. Animators
+ * further than the far distance are still visible, they are updated at the distant rate but keep the interpolation,
+ * only the off screen ones snap between their poses
+ */
+struct AnimationLODSettings {
+  bool Enabled = true;
+  float NearDistance = 15.0f;
+  float MediumDistance = 40.0f;
+  float FarDistance = 80.0f;
+  Uint NearUpdateInterval = 1;
+  Uint MediumUpdateInterval = 2;
+  Uint FarUpdateInterval = 4;
+  Uint DistantUpdateInterval = 8;
+  Uint OffScreenUpdateInterval = 8;
+  /* Bones matching one of the patterns keep their last local transform when the animator is further than this */
+  float SkipLowImportanceBonesDistance = 40.0f;
+  /* Blends the bone matrices between two evaluations, so reduced update rates dont look choppy */
+  bool InterpolateBetweenUpdates = true;
+  /* Case insensitive substrings of bone names considered low importance, like fingers and face bones */
+  std::vector<String> LowImportanceBonePatterns = {"finger", "thumb", "index", "middle", "ring", "pinky", "eye",
+                                                   "jaw",    "brow",  "lip",   "cheek",  "tongue", "toe"};
+};
+
+/**
+ * @brief Counters of the animation level of detail, reseted every frame by ResetLODFrameStats. Bones saved is the sum
+ * of bones that would have been evaluated at full rate but were not
+ */
+struct AnimationLODFrameStats {
+  Uint BonesEvaluated = 0;
+  Uint BonesSavedByRate = 0;
+  Uint BonesSavedByImportance = 0;
+  Uint AnimatorsEvaluated = 0;
+  Uint AnimatorsInterpolated = 0;
+
+  Uint BonesSaved() const { return BonesSavedByRate + BonesSavedByImportance; }
+};
+
+/**
+ * @brief Per instance playback state of the current clip, the clip itself is shared through the AnimationLibrary.
+ * Local transforms and cursors are indexed by the bones of the clip, global transforms by the nodes of the skeleton
+ */
+struct AnimationPlaybackState {
+  std::vector<BoneKeyCursor> Cursors;
+  std::vector<Matrix4> LocalTransforms;
+  std::vector<uint8_t> Evaluated;
+  std::vector<Matrix4> GlobalTransforms;
+
+  void Reset(const Animation* animation);
+};
+
 class AnimationEngine {
  public:
   AnimationEngine();
 
   void Initialize();
   void LoadAnimationsFromFile(const String& path, AnimatedObject* model);
+  /**
+   * @brief Plays the clips of a shared set on the mesh described by the bone info map, the bones missing from the map
+   * are not written to the final bone matrices
+   */
+  void LoadClipSet(std::shared_ptr<const AnimationClipSet> set, const std::map<String, BoneInfo>& boneInfoMap);
 
+  /**
+   * @brief Updates the animation at full rate, every bone is evaluated
+   */
   void UpdateAnimation(float dt);
-  void PlayAnimation(Animation* animation);
+  /**
+   * @brief Updates the animation using the level of detail selected from the distance to the viewer and the visibility
+   * of the animated object. Animators at reduced rates are staggered between frames, so they dont all update at once
+   */
+  void UpdateAnimation(float dt, float viewerDistance, bool onScreen);
+  void PlayAnimation(const Animation* animation);
   void PlayAnimation(Uint index);
-  void CalculateBoneTransform(const AssimpNodeData* node, Matrix4 parentTrans);
-  std::vector<Matrix4> GetFinalBoneMatrices() const { return m_FinalBoneMatrices; }
-  std::vector<Animation>* GetAnimations() { return &m_Animations; }
+  const std::vector<Matrix4>& GetFinalBoneMatrices() const { return m_FinalBoneMatrices; }
+  const std::vector<Animation>* GetAnimations() const;
+
+  /**
+   * @brief Evaluates the pose of the clip at the given time in seconds into output (MAX_BONES matrices), every bone is
+   * evaluated. Changes the current animation of the animator, used by offline tools like the vertex animation baker
+   */
+  bool SamplePose(Uint index, float seconds, std::vector<Matrix4>* output);
 
   bool IsAnimationsLoaded() const { return m_AnimationsLoaded; }
   bool IsPlayingAnimation() const { return m_PlayingAnimation; }
 
+  AnimationLODLevel::Enum GetLODLevel() const { return m_LODLevel; }
+
+  static AnimationLODSettings* GetLODSettings() { return &sLODSettings; }
+  static const AnimationLODFrameStats& GetLODFrameStats() { return sLODFrameStats; }
+  /**
+   * @brief Must be called once per frame before the animators are updated
+   */
+  static void ResetLODFrameStats() { sLODFrameStats = AnimationLODFrameStats(); }
+
  protected:
-  std::vector<Animation> m_Animations;
+  AnimationLODLevel::Enum SelectLODLevel(float viewerDistance, bool onScreen) const;
+  Uint GetLODUpdateInterval(AnimationLODLevel::Enum level) const;
+  void EvaluatePose(float time, std::vector<Matrix4>* output);
+
+  static AnimationLODSettings sLODSettings;
+  static AnimationLODFrameStats sLODFrameStats;
+  static Uint sAnimatorsCount;
+
+  std::shared_ptr<const AnimationClipSet> m_ClipSet = YEAGER_NULLPTR;
+  AnimationSkeletonBinding m_Binding;
+  AnimationPlaybackState m_Playback;
   std::vector<Matrix4> m_FinalBoneMatrices;
-  Animation* m_CurrentAnimation = YEAGER_NULLPTR;
+  const Animation* m_CurrentAnimation = YEAGER_NULLPTR;
   float m_CurrentTime;
   float m_DeltaTime;
   bool m_PlayingAnimation = false;
   bool m_AnimationsLoaded = false;
+
+  /* Level of detail state, the previous and target poses are only used when interpolating between updates */
+  std::vector<Matrix4> m_PreviousBoneMatrices;
+  std::vector<Matrix4> m_TargetBoneMatrices;
+  AnimationLODLevel::Enum m_LODLevel = AnimationLODLevel::eLOD_NEAR;
+  Uint m_StaggerOffset = 0;
+  Uint m_FrameCounter = 0;
+  Uint m_FramesSinceEvaluation = 0;
+  Uint m_CurrentUpdateInterval = 1;
+  bool m_SkipLowImportanceBones = false;
+  bool m_ForceEvaluation = true;
 };
 }  // namespace Yeager
\ No newline at end of file
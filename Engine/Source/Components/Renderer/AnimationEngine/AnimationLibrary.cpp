@@ -0,0 +1,144 @@
+#include "AnimationLibrary.h"
+#include "AnimationEngine.h"
+#include "Components/Kernel/Caching/Cache.h"
+#include "Main/Core/Application.h"
+#include "Main/Scene/Scene.h"
+using namespace Yeager;
+
+std::map<String, std::weak_ptr<const AnimationClipSet>> AnimationLibrary::sClipSets;
+std::mutex AnimationLibrary::sMutex;
+
+size_t AnimationClipSet::GetMemorySize() const
+{
+  size_t size = sizeof(AnimationClipSet) + MappedBytes;
+  if (Skeleton)
+    size += Skeleton->GetMemorySize();
+  for (const auto& animation : Animations) {
+    size += animation.GetMemorySize();
+  }
+  return size;
+}
+
+std::shared_ptr<const AnimationClipSet> AnimationLibrary::Acquire(const String& path, AnimatedObject* model)
+{
+  const uint64_t hash = CreateFileHash(path + std::to_string(AnimationClipFile::GetSourceTimestamp(path)));
+  const String key = path + "#" + std::to_string(hash);
+
+  std::lock_guard<std::mutex> lock(sMutex);
+
+  /* Drops the entries of clip sets that are not used anymore */
+  for (auto it = sClipSets.begin(); it != sClipSets.end();) {
+    it = it->second.expired() ? sClipSets.erase(it) : std::next(it);
+  }
+
+  std::shared_ptr<const AnimationClipSet> set = YEAGER_NULLPTR;
+  const auto found = sClipSets.find(key);
+  if (found != sClipSets.end()) {
+    set = found->second.lock();
+  }
+
+  if (set) {
+    Yeager::LogDebug(INFO, "Animation clips of {} shared from the library", path);
+  } else {
+    std::shared_ptr<AnimationClipSet> loaded = LoadClipSet(path, model);
+    if (!loaded) {
+      return YEAGER_NULLPTR;
+    }
+    loaded->Hash = hash;
+    sClipSets[key] = loaded;
+    set = loaded;
+  }
+
+  /* The set holds no bone of any model, each model gets the missing bones in its own bone info map */
+  for (const auto& animation : set->Animations) {
+    animation.RegisterBones(model);
+  }
+  return set;
+}
+
+std::shared_ptr<AnimationClipSet> AnimationLibrary::LoadClipSet(const String& path, AnimatedObject* model)
+{
+  auto set = BaseAllocator::MakeSharedPtr<AnimationClipSet>();
+  set->Path = path;
+
+  /* The clips are loaded from the compiled cache of the project when possible, assimp is only used to build it */
+  bool loaded = false;
+  ApplicationCore* application = model->GetApplication();
+  if (application && application->GetScene()) {
+    const String cachePath = AnimationClipFile::GetCachePath(application->GetScene()->GetAnimationCacheFolderPath(), path);
+    loaded = LoadFromCache(set.get(), cachePath);
+  }
+
+  if (!loaded && !LoadFromSource(set.get())) {
+    return YEAGER_NULLPTR;
+  }
+
+  for (auto& animation : set->Animations) {
+    animation.FlagLowImportanceBones(AnimationEngine::GetLODSettings()->LowImportanceBonePatterns);
+    animation.BindSkeleton(set->Skeleton);
+  }
+  return set;
+}
+
+bool AnimationLibrary::LoadFromCache(AnimationClipSet* set, const String& cachePath)
+{
+  const uint64_t hash = CreateFileHash(set->Path);
+  const uint64_t timestamp = AnimationClipFile::GetSourceTimestamp(set->Path);
+
+  auto file = BaseAllocator::MakeSharedPtr<AnimationClipFile>();
+  if (!file->Load(cachePath, hash, timestamp)) {
+    Assimp::Importer imp;
+    const aiScene* scene = imp.ReadFile(set->Path, aiProcess_Triangulate);
+    if (!scene || !scene->mRootNode || !AnimationClipCompiler::Compile(scene, set->Path, cachePath)) {
+      return false;
+    }
+    if (!file->Load(cachePath, hash, timestamp)) {
+      return false;
+    }
+  }
+
+  set->Skeleton = AnimationSkeleton::Build(*file);
+  set->MappedBytes = file->GetMemorySize();
+  for (Uint clip = 0; clip < file->GetClipCount(); clip++) {
+    set->Animations.push_back(Animation(file, clip));
+  }
+  return true;
+}
+
+bool AnimationLibrary::LoadFromSource(AnimationClipSet* set)
+{
+  Assimp::Importer imp;
+  const aiScene* scene = imp.ReadFile(set->Path, aiProcess_Triangulate);
+
+  if (!scene || !scene->mRootNode) {
+    Yeager::Log(ERROR, "Assimp cannot load animation file! Path {}", set->Path);
+    return false;
+  }
+
+  set->Skeleton = AnimationSkeleton::Build(scene->mRootNode);
+  for (Uint animations = 0; animations < scene->mNumAnimations; animations++) {
+    aiString name = scene->mAnimations[animations]->mName;
+    Animation anim(String(name.C_Str()), scene, animations);
+    anim.SetIndex(animations);
+    set->Animations.push_back(anim);
+  }
+  return true;
+}
+
+Uint AnimationLibrary::GetLoadedClipSetsCount()
+{
+  std::lock_guard<std::mutex> lock(sMutex);
+  return std::count_if(sClipSets.begin(), sClipSets.end(), [](const auto& entry) { return !entry.second.expired(); });
+}
+
+size_t AnimationLibrary::GetLoadedClipSetsMemory()
+{
+  std::lock_guard<std::mutex> lock(sMutex);
+  size_t size = 0;
+  for (const auto& entry : sClipSets) {
+    if (auto set = entry.second.lock()) {
+      size += set->GetMemorySize();
+    }
+  }
+  return size;
+}
@@ -0,0 +1,72 @@
+//    Yeager Engine, free and open source 3D/2D renderer written in OpenGL
+//    In case of questions and bugs, please, refer to the issue tab on github
+//    Repo : https://github.com/schwq/YeagerEngine
+//    Copyright (C) 2023 - Present
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Common/Utils/Common.h"
+#include "Common/Utils/LogEngine.h"
+#include "Common/Utils/Utilities.h"
+
+#include <mutex>
+
+#include "Animation.h"
+
+namespace Yeager {
+
+/**
+ * @brief Every clip and the skeleton loaded from a single source file, shared by all the animated objects using it.
+ * Nothing in the set depends on the mesh, the bones of each mesh are bound to the skeleton by its animator
+ */
+struct AnimationClipSet {
+  String Path = YEAGER_NULL_LITERAL;
+  uint64_t Hash = 0;
+  std::shared_ptr<AnimationSkeleton> Skeleton = YEAGER_NULLPTR;
+  std::vector<Animation> Animations;
+  /* Size of the mapped cache file, zero when the clips were read from the source file */
+  size_t MappedBytes = 0;
+
+  size_t GetMemorySize() const;
+};
+
+/**
+ * @brief Asset level library of animation clips. Clip sets are looked up by the source path plus a hash of the path and
+ * the last write time of the file, so a modified file is loaded again. The library only keeps weak references, a clip
+ * set is freed when the last animator using it is destroyed
+ */
+class AnimationLibrary {
+ public:
+  /**
+   * @brief Returns the clip set of the file, loading it if no other animator is using it. The bones of the clips
+   * missing from the mesh are registered in the bone info map of the model, the caller binds the skeleton to that map
+   * afterwards. Returns nullptr if the file cannot be loaded
+   */
+  static std::shared_ptr<const AnimationClipSet> Acquire(const String& path, AnimatedObject* model);
+
+  static Uint GetLoadedClipSetsCount();
+  static size_t GetLoadedClipSetsMemory();
+
+ private:
+  static std::shared_ptr<AnimationClipSet> LoadClipSet(const String& path, AnimatedObject* model);
+  static bool LoadFromCache(AnimationClipSet* set, const String& cachePath);
+  static bool LoadFromSource(AnimationClipSet* set);
+
+  static std::map<String, std::weak_ptr<const AnimationClipSet>> sClipSets;
+  static std::mutex sMutex;
+};
+
+}  // namespace Yeager
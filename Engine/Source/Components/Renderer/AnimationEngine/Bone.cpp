@@ -1,7 +1,8 @@
 #include "Bone.h"
+#include "AnimationClip.h"
 using namespace Yeager;
 
-Bone::Bone(const String& Name, int ID, const aiNodeAnim* Channel) : m_Name(Name), m_ID(ID), m_LocalTransform(1.0f)
+Bone::Bone(const String& Name, const aiNodeAnim* Channel) : m_Name(Name)
 {
   m_NumPositions = Channel->mNumPositionKeys;
   for (int positionIndex = 0; positionIndex < m_NumPositions; ++positionIndex) {
@@ -34,48 +35,75 @@ Bone::Bone(const String& Name, int ID, const aiNodeAnim* Channel) : m_Name(Name)
   }
 }
 
-void Bone::Update(float AnimationTime)
+Bone::Bone(const String& Name, const AnimationClipFile* File, const AnimationClipTrack* Track, float Duration)
+    : m_ClipFile(File), m_ClipTrack(Track), m_ClipDuration(Duration), m_Name(Name)
+{}
+
+Matrix4 Bone::Evaluate(float AnimationTime, BoneKeyCursor* Cursor) const
 {
-  Matrix4 trans = InterpolatePosition(AnimationTime);
-  Matrix4 rotation = InterpolateRotation(AnimationTime);
-  Matrix4 scale = InterpolateScaling(AnimationTime);
-  m_LocalTransform = trans * rotation * scale;
+  if (m_ClipTrack) {
+    Vector3 position, scale;
+    glm::quat rotation;
+    m_ClipFile->SampleTrack(m_ClipTrack, m_ClipDuration, AnimationTime, &position, &rotation, &scale);
+    return glm::translate(Matrix4(1.0f), position) * glm::toMat4(rotation) * glm::scale(Matrix4(1.0f), scale);
+  }
+
+  Matrix4 trans = InterpolatePosition(AnimationTime, &Cursor->Position);
+  Matrix4 rotation = InterpolateRotation(AnimationTime, &Cursor->Rotation);
+  Matrix4 scale = InterpolateScaling(AnimationTime, &Cursor->Scale);
+  return trans * rotation * scale;
 }
 
-int Bone::GetPositionIndex(float AnimationTime)
+size_t Bone::GetKeysMemorySize() const
 {
-  for (int index = 0; index < m_NumPositions - 1; ++index) {
-    if (AnimationTime < m_Positions[index + 1].TimeStamp) {
+  return m_Positions.capacity() * sizeof(KeyPosition) + m_Rotations.capacity() * sizeof(KeyRotation) +
+         m_Scales.capacity() * sizeof(KeyScale);
+}
+
+/* The search starts at the hint when the time did not go backwards, like when the animation loops */
+template <typename Key>
+static int FindKeyIndex(const std::vector<Key>& keys, int count, float AnimationTime, int Hint)
+{
+  int index = (Hint > 0 && Hint < count - 1 && keys[Hint].TimeStamp <= AnimationTime) ? Hint : 0;
+  for (; index < count - 1; ++index) {
+    if (AnimationTime < keys[index + 1].TimeStamp) {
       return index;
     }
   }
-  Yeager::Log(WARNING, "Warning! Bone cannot find positions index associated!");
-  assert(0);
+  return -1;
 }
 
-int Bone::GetRotationIndex(float AnimationTime)
+int Bone::GetPositionIndex(float AnimationTime, int Hint) const
 {
-  for (int index = 0; index < m_NumRotations - 1; ++index) {
-    if (AnimationTime < m_Rotations[index + 1].TimeStamp) {
-      return index;
-    }
+  const int index = FindKeyIndex(m_Positions, m_NumPositions, AnimationTime, Hint);
+  if (index < 0) {
+    Yeager::Log(WARNING, "Warning! Bone cannot find positions index associated!");
+    return m_NumPositions - 2;
   }
-  Yeager::Log(WARNING, "Warning! Bone cannot find rotation index associated!");
-  assert(0);
+  return index;
 }
 
-int Bone::GetScaleIndex(float AnimationTime)
+int Bone::GetRotationIndex(float AnimationTime, int Hint) const
 {
-  for (int index = 0; index < m_NumScalings - 1; ++index) {
-    if (AnimationTime < m_Scales[index + 1].TimeStamp) {
-      return index;
-    }
+  const int index = FindKeyIndex(m_Rotations, m_NumRotations, AnimationTime, Hint);
+  if (index < 0) {
+    Yeager::Log(WARNING, "Warning! Bone cannot find rotation index associated!");
+    return m_NumRotations - 2;
+  }
+  return index;
+}
+
+int Bone::GetScaleIndex(float AnimationTime, int Hint) const
+{
+  const int index = FindKeyIndex(m_Scales, m_NumScalings, AnimationTime, Hint);
+  if (index < 0) {
+    Yeager::Log(WARNING, "Warning! Bone cannot find scaling index associated!");
+    return m_NumScalings - 2;
   }
-  Yeager::Log(WARNING, "Warning! Bone cannot find scaling index associated!");
-  assert(0);
+  return index;
 }
 
-float Bone::GetScaleFactor(float LastTimeStamp, float NextTimeStamp, float AnimationTime)
+float Bone::GetScaleFactor(float LastTimeStamp, float NextTimeStamp, float AnimationTime) const
 {
   float scaleFator = 0.0f;
   float midWay = AnimationTime - LastTimeStamp;
@@ -84,41 +112,44 @@ float Bone::GetScaleFactor(float LastTimeStamp, float NextTimeStamp, float Anima
   return scaleFator;
 }
 
-Matrix4 Bone::InterpolatePosition(float AnimationTime)
+Matrix4 Bone::InterpolatePosition(float AnimationTime, int* Cursor) const
 {
   if (m_NumPositions == 1) {
     return glm::translate(Matrix4(1.0f), m_Positions[0].Position);
   }
 
-  int p0Index = GetPositionIndex(AnimationTime);
+  int p0Index = GetPositionIndex(AnimationTime, *Cursor);
   int p1Index = p0Index + 1;
+  *Cursor = p0Index;
   float scaleFactor = GetScaleFactor(m_Positions[p0Index].TimeStamp, m_Positions[p1Index].TimeStamp, AnimationTime);
   Vector3 finalPos = glm::mix(m_Positions[p0Index].Position, m_Positions[p1Index].Position, scaleFactor);
   return glm::translate(Matrix4(1.0f), finalPos);
 }
 
-Matrix4 Bone::InterpolateRotation(float AnimationTime)
+Matrix4 Bone::InterpolateRotation(float AnimationTime, int* Cursor) const
 {
   if (m_NumRotations == 1) {
     auto rotation = glm::normalize(m_Rotations[0].Orientation);
     return glm::toMat4(rotation);
   }
 
-  int p0Index = GetRotationIndex(AnimationTime);
+  int p0Index = GetRotationIndex(AnimationTime, *Cursor);
   int p1Index = p0Index + 1;
+  *Cursor = p0Index;
   float scaleFactor = GetScaleFactor(m_Rotations[p0Index].TimeStamp, m_Rotations[p1Index].TimeStamp, AnimationTime);
   glm::quat finalRot = glm::slerp(m_Rotations[p0Index].Orientation, m_Rotations[p1Index].Orientation, scaleFactor);
   finalRot = glm::normalize(finalRot);
   return glm::toMat4(finalRot);
 }
 
-Matrix4 Bone::InterpolateScaling(float AnimationTime)
+Matrix4 Bone::InterpolateScaling(float AnimationTime, int* Cursor) const
 {
   if (m_NumScalings == 1) {
     return glm::scale(Matrix4(1.0f), m_Scales[0].Scale);
   }
-  int p0Index = GetScaleIndex(AnimationTime);
+  int p0Index = GetScaleIndex(AnimationTime, *Cursor);
   int p1Index = p0Index + 1;
+  *Cursor = p0Index;
   float scaleFactor = GetScaleFactor(m_Scales[p0Index].TimeStamp, m_Scales[p1Index].TimeStamp, AnimationTime);
   Vector3 finalScale = glm::mix(m_Scales[p0Index].Scale, m_Scales[p1Index].Scale, scaleFactor);
   return glm::scale(Matrix4(1.0f), finalScale);
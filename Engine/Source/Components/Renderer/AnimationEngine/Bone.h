@@ -33,6 +33,10 @@
 #include <glm/gtx/quaternion.hpp>
 
 namespace Yeager {
+
+class AnimationClipFile;
+struct AnimationClipTrack;
+
 struct KeyPosition {
   Vector3 Position;
   float TimeStamp;
@@ -48,35 +52,64 @@ struct KeyScale {
   float TimeStamp;
 };
 
+/**
+ * @brief Last key index found for each channel of a bone, kept by every instance playing the animation. Playback moves
+ * forward most of the time, so the key search starts from the cursor instead of the first key
+ */
+struct BoneKeyCursor {
+  int Position = 0;
+  int Rotation = 0;
+  int Scale = 0;
+};
+
+/**
+ * @brief Keyframes of a bone in a animation clip. The bone is immutable after loading and can be shared between every
+ * instance of the animation, the pose is returned to the caller instead of being stored in the bone
+ */
 class Bone {
  public:
-  Bone(const String& Name, int ID, const aiNodeAnim* Channel);
+  Bone(const String& Name, const aiNodeAnim* Channel);
+  /**
+   * @brief Bone sampled from a compiled clip track, the keys are decoded from the mapped file when evaluated and no key
+   * is copied into the bone
+   */
+  Bone(const String& Name, const AnimationClipFile* File, const AnimationClipTrack* Track, float Duration);
 
-  void Update(float AnimationTime);
+  /**
+   * @brief Returns the local transformation of the bone at the given time, the cursor is updated with the keys found
+   */
+  Matrix4 Evaluate(float AnimationTime, BoneKeyCursor* Cursor) const;
 
-  constexpr Matrix4 GetLocalTransform() { return m_LocalTransform; }
-  String GetBoneName() { return m_Name; }
-  constexpr int GetBoneID() { return m_ID; }
+  const String& GetBoneName() const { return m_Name; }
 
-  int GetPositionIndex(float AnimationTime);
-  int GetRotationIndex(float AnimationTime);
-  int GetScaleIndex(float AnimationTime);
+  constexpr bool IsLowImportance() const { return m_LowImportance; }
+  constexpr void SetLowImportance(bool low) { m_LowImportance = low; }
+
+  int GetPositionIndex(float AnimationTime, int Hint = 0) const;
+  int GetRotationIndex(float AnimationTime, int Hint = 0) const;
+  int GetScaleIndex(float AnimationTime, int Hint = 0) const;
+
+  /* Heap memory used by the keys of this bone, mapped clips dont own their keys */
+  size_t GetKeysMemorySize() const;
 
  private:
-  float GetScaleFactor(float LastTimeStamp, float NextTimeStamp, float AnimationTime);
-  Matrix4 InterpolatePosition(float AnimationTime);
-  Matrix4 InterpolateRotation(float AnimationTime);
-  Matrix4 InterpolateScaling(float AnimationTime);
+  float GetScaleFactor(float LastTimeStamp, float NextTimeStamp, float AnimationTime) const;
+  Matrix4 InterpolatePosition(float AnimationTime, int* Cursor) const;
+  Matrix4 InterpolateRotation(float AnimationTime, int* Cursor) const;
+  Matrix4 InterpolateScaling(float AnimationTime, int* Cursor) const;
 
   std::vector<KeyPosition> m_Positions;
   std::vector<KeyRotation> m_Rotations;
   std::vector<KeyScale> m_Scales;
-  int m_NumPositions;
-  int m_NumRotations;
-  int m_NumScalings;
+  int m_NumPositions = 0;
+  int m_NumRotations = 0;
+  int m_NumScalings = 0;
+
+  const AnimationClipFile* m_ClipFile = YEAGER_NULLPTR;
+  const AnimationClipTrack* m_ClipTrack = YEAGER_NULLPTR;
+  float m_ClipDuration = 0.0f;
 
-  Matrix4 m_LocalTransform;
   String m_Name;
-  int m_ID;
+  bool m_LowImportance = false;
 };
 }  // namespace Yeager
\ No newline at end of file
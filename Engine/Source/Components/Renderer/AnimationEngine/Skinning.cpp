@@ -0,0 +1,335 @@
+#include "Skinning.h"
+using namespace Yeager;
+
+#ifdef YEAGER_SIMD_SSE2
+#include <immintrin.h>
+#endif
+
+String SkinningMethod::ToString(SkinningMethod::Enum type)
+{
+  switch (type) {
+    case eLINEAR_BLEND:
+      return "Linear Blend";
+    case eDUAL_QUATERNION:
+      return "Dual Quaternion";
+    default:
+      return "Undefined";
+  }
+}
+
+DualQuaternion DualQuaternion::FromMatrix(const Matrix4& matrix)
+{
+  DualQuaternion dq;
+  const Vector3 x(matrix[0]), y(matrix[1]), z(matrix[2]);
+  if (glm::length(x) > 0.0f && glm::length(y) > 0.0f && glm::length(z) > 0.0f) {
+    /* Strips the scale of the columns, only the rotation goes to the dual quaternion */
+    dq.Real = glm::normalize(glm::quat_cast(glm::mat3(glm::normalize(x), glm::normalize(y), glm::normalize(z))));
+  }
+  const Vector3 translation(matrix[3]);
+  dq.Dual = glm::quat(0.0f, translation.x, translation.y, translation.z) * dq.Real * 0.5f;
+  return dq;
+}
+
+/* False when the vertex stays in bind pose, the shader does it for any id bigger than the bone array */
+static YEAGER_FORCE_INLINE bool HasValidInfluences(const AnimatedVertexData& vertex, Uint boneCount)
+{
+  for (Uint x = 0; x < MAX_BONE_INFLUENCE; x++) {
+    const int id = vertex.BonesIDs[x];
+    if (id != -1 && (id < 0 || id >= static_cast<int>(boneCount))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static YEAGER_FORCE_INLINE Vector3 FinishNormal(const Vector3& skinned, const Vector3& bind)
+{
+  const float length = glm::length(skinned);
+  return length > 0.0f ? skinned / length : bind;
+}
+
+static YEAGER_FORCE_INLINE void WriteBindPose(const AnimatedVertexData& vertex, Vector3* position, Vector3* normal)
+{
+  *position = vertex.Position;
+  if (normal) {
+    *normal = vertex.Normals;
+  }
+}
+
+void CpuSkinning::LinearBlendScalar(const AnimatedVertexData* vertices, size_t count, const Matrix4* bones,
+                                    Uint boneCount, Vector3* positions, Vector3* normals)
+{
+  for (size_t index = 0; index < count; index++) {
+    const AnimatedVertexData& vertex = vertices[index];
+    if (!HasValidInfluences(vertex, boneCount)) {
+      WriteBindPose(vertex, &positions[index], normals ? &normals[index] : YEAGER_NULLPTR);
+      continue;
+    }
+
+    Matrix4 blended(0.0f);
+    for (Uint x = 0; x < MAX_BONE_INFLUENCE; x++) {
+      if (vertex.BonesIDs[x] != -1) {
+        blended += bones[vertex.BonesIDs[x]] * vertex.Weights[x];
+      }
+    }
+
+    positions[index] = Vector3(blended * glm::vec4(vertex.Position, 1.0f));
+    if (normals) {
+      normals[index] = FinishNormal(glm::mat3(blended) * vertex.Normals, vertex.Normals);
+    }
+  }
+}
+
+void CpuSkinning::DualQuaternionScalar(const AnimatedVertexData* vertices, size_t count, const DualQuaternion* bones,
+                                       Uint boneCount, Vector3* positions, Vector3* normals)
+{
+  for (size_t index = 0; index < count; index++) {
+    const AnimatedVertexData& vertex = vertices[index];
+    if (!HasValidInfluences(vertex, boneCount)) {
+      WriteBindPose(vertex, &positions[index], normals ? &normals[index] : YEAGER_NULLPTR);
+      continue;
+    }
+
+    glm::quat real(0.0f, 0.0f, 0.0f, 0.0f), dual(0.0f, 0.0f, 0.0f, 0.0f);
+    const glm::quat* pivot = YEAGER_NULLPTR;
+    for (Uint x = 0; x < MAX_BONE_INFLUENCE; x++) {
+      if (vertex.BonesIDs[x] == -1) {
+        continue;
+      }
+      const DualQuaternion& bone = bones[vertex.BonesIDs[x]];
+      float weight = vertex.Weights[x];
+      /* Keeps every rotation in the same hemisphere of the first one, otherwise the blend takes the long path */
+      if (!pivot) {
+        pivot = &bone.Real;
+      } else if (glm::dot(*pivot, bone.Real) < 0.0f) {
+        weight = -weight;
+      }
+      real = real + bone.Real * weight;
+      dual = dual + bone.Dual * weight;
+    }
+
+    const float length = glm::length(real);
+    if (length <= 0.0f) {
+      positions[index] = Vector3(0.0f);
+      if (normals) {
+        normals[index] = vertex.Normals;
+      }
+      continue;
+    }
+    real = real / length;
+    dual = dual / length;
+
+    const Vector3 r(real.x, real.y, real.z), d(dual.x, dual.y, dual.z);
+    const Vector3& p = vertex.Position;
+    const Vector3 rotated = p + 2.0f * glm::cross(r, glm::cross(r, p) + real.w * p);
+    const Vector3 translation = 2.0f * (real.w * d - dual.w * r + glm::cross(r, d));
+    positions[index] = rotated + translation;
+    if (normals) {
+      const Vector3& n = vertex.Normals;
+      normals[index] = FinishNormal(n + 2.0f * glm::cross(r, glm::cross(r, n) + real.w * n), n);
+    }
+  }
+}
+
+#ifdef YEAGER_SIMD_SSE2
+
+static_assert(offsetof(glm::quat, x) == 0 && offsetof(glm::quat, w) == sizeof(float) * 3,
+              "The SIMD skinning expects the quaternion components in the xyzw order!");
+
+static YEAGER_FORCE_INLINE __m128 LoadVector3(const Vector3& vector)
+{
+  return _mm_set_ps(0.0f, vector.z, vector.y, vector.x);
+}
+
+static YEAGER_FORCE_INLINE Vector3 StoreVector3(__m128 vector)
+{
+  alignas(16) float out[4];
+  _mm_store_ps(out, vector);
+  return Vector3(out[0], out[1], out[2]);
+}
+
+/* Cross product of the xyz lanes, the w lane of the result is zero */
+static YEAGER_FORCE_INLINE __m128 Cross3(__m128 a, __m128 b)
+{
+  const __m128 aYZX = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+  const __m128 bYZX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+  const __m128 c = _mm_sub_ps(_mm_mul_ps(a, bYZX), _mm_mul_ps(aYZX, b));
+  return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+}
+
+/* Dot product of the four lanes, broadcasted to every lane */
+static YEAGER_FORCE_INLINE __m128 Dot4(__m128 a, __m128 b)
+{
+  const __m128 m = _mm_mul_ps(a, b);
+  const __m128 s = _mm_add_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_add_ps(s, _mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 0, 3, 2)));
+}
+
+static YEAGER_FORCE_INLINE Vector3 FinishNormal(__m128 skinned, const Vector3& bind)
+{
+  const float length = _mm_cvtss_f32(_mm_sqrt_ss(Dot4(skinned, skinned)));
+  return length > 0.0f ? StoreVector3(_mm_div_ps(skinned, _mm_set1_ps(length))) : bind;
+}
+
+#endif
+
+void CpuSkinning::LinearBlendSIMD(const AnimatedVertexData* vertices, size_t count, const Matrix4* bones,
+                                  Uint boneCount, Vector3* positions, Vector3* normals)
+{
+#ifdef YEAGER_SIMD_SSE2
+  for (size_t index = 0; index < count; index++) {
+    const AnimatedVertexData& vertex = vertices[index];
+    if (!HasValidInfluences(vertex, boneCount)) {
+      WriteBindPose(vertex, &positions[index], normals ? &normals[index] : YEAGER_NULLPTR);
+      continue;
+    }
+
+    /* Blends the columns of the bone matrices, glm matrices are column major */
+    __m128 c0 = _mm_setzero_ps(), c1 = _mm_setzero_ps(), c2 = _mm_setzero_ps(), c3 = _mm_setzero_ps();
+    for (Uint x = 0; x < MAX_BONE_INFLUENCE; x++) {
+      if (vertex.BonesIDs[x] == -1) {
+        continue;
+      }
+      const float* matrix = glm::value_ptr(bones[vertex.BonesIDs[x]]);
+      const __m128 weight = _mm_set1_ps(vertex.Weights[x]);
+      c0 = _mm_add_ps(c0, _mm_mul_ps(_mm_loadu_ps(matrix), weight));
+      c1 = _mm_add_ps(c1, _mm_mul_ps(_mm_loadu_ps(matrix + 4), weight));
+      c2 = _mm_add_ps(c2, _mm_mul_ps(_mm_loadu_ps(matrix + 8), weight));
+      c3 = _mm_add_ps(c3, _mm_mul_ps(_mm_loadu_ps(matrix + 12), weight));
+    }
+
+    const Vector3& p = vertex.Position;
+    __m128 position = _mm_add_ps(c3, _mm_mul_ps(c0, _mm_set1_ps(p.x)));
+    position = _mm_add_ps(position, _mm_mul_ps(c1, _mm_set1_ps(p.y)));
+    position = _mm_add_ps(position, _mm_mul_ps(c2, _mm_set1_ps(p.z)));
+    positions[index] = StoreVector3(position);
+
+    if (normals) {
+      const Vector3& n = vertex.Normals;
+      __m128 normal = _mm_mul_ps(c0, _mm_set1_ps(n.x));
+      normal = _mm_add_ps(normal, _mm_mul_ps(c1, _mm_set1_ps(n.y)));
+      normal = _mm_add_ps(normal, _mm_mul_ps(c2, _mm_set1_ps(n.z)));
+      /* The w lane holds the blended w row of the matrix, it is not part of the normal */
+      normal = _mm_and_ps(normal, _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1)));
+      normals[index] = FinishNormal(normal, n);
+    }
+  }
+#else
+  LinearBlendScalar(vertices, count, bones, boneCount, positions, normals);
+#endif
+}
+
+void CpuSkinning::DualQuaternionSIMD(const AnimatedVertexData* vertices, size_t count, const DualQuaternion* bones,
+                                     Uint boneCount, Vector3* positions, Vector3* normals)
+{
+#ifdef YEAGER_SIMD_SSE2
+  const __m128 two = _mm_set1_ps(2.0f);
+  for (size_t index = 0; index < count; index++) {
+    const AnimatedVertexData& vertex = vertices[index];
+    if (!HasValidInfluences(vertex, boneCount)) {
+      WriteBindPose(vertex, &positions[index], normals ? &normals[index] : YEAGER_NULLPTR);
+      continue;
+    }
+
+    __m128 real = _mm_setzero_ps(), dual = _mm_setzero_ps();
+    __m128 pivot = _mm_setzero_ps();
+    bool hasPivot = false;
+    for (Uint x = 0; x < MAX_BONE_INFLUENCE; x++) {
+      if (vertex.BonesIDs[x] == -1) {
+        continue;
+      }
+      const DualQuaternion& bone = bones[vertex.BonesIDs[x]];
+      const __m128 boneReal = _mm_loadu_ps(&bone.Real.x);
+      float weight = vertex.Weights[x];
+      if (!hasPivot) {
+        pivot = boneReal;
+        hasPivot = true;
+      } else if (_mm_cvtss_f32(Dot4(pivot, boneReal)) < 0.0f) {
+        weight = -weight;
+      }
+      const __m128 w = _mm_set1_ps(weight);
+      real = _mm_add_ps(real, _mm_mul_ps(boneReal, w));
+      dual = _mm_add_ps(dual, _mm_mul_ps(_mm_loadu_ps(&bone.Dual.x), w));
+    }
+
+    const __m128 lengthSquared = Dot4(real, real);
+    if (_mm_cvtss_f32(lengthSquared) <= 0.0f) {
+      positions[index] = Vector3(0.0f);
+      if (normals) {
+        normals[index] = vertex.Normals;
+      }
+      continue;
+    }
+    const __m128 length = _mm_sqrt_ps(lengthSquared);
+    real = _mm_div_ps(real, length);
+    dual = _mm_div_ps(dual, length);
+
+    const __m128 realW = _mm_shuffle_ps(real, real, _MM_SHUFFLE(3, 3, 3, 3));
+    const __m128 dualW = _mm_shuffle_ps(dual, dual, _MM_SHUFFLE(3, 3, 3, 3));
+
+    const __m128 p = LoadVector3(vertex.Position);
+    const __m128 inner = _mm_add_ps(Cross3(real, p), _mm_mul_ps(realW, p));
+    const __m128 rotated = _mm_add_ps(p, _mm_mul_ps(two, Cross3(real, inner)));
+    __m128 translation = _mm_sub_ps(_mm_mul_ps(realW, dual), _mm_mul_ps(dualW, real));
+    translation = _mm_mul_ps(two, _mm_add_ps(translation, Cross3(real, dual)));
+    positions[index] = StoreVector3(_mm_add_ps(rotated, translation));
+
+    if (normals) {
+      const __m128 n = LoadVector3(vertex.Normals);
+      const __m128 innerNormal = _mm_add_ps(Cross3(real, n), _mm_mul_ps(realW, n));
+      normals[index] = FinishNormal(_mm_add_ps(n, _mm_mul_ps(two, Cross3(real, innerNormal))), vertex.Normals);
+    }
+  }
+#else
+  DualQuaternionScalar(vertices, count, bones, boneCount, positions, normals);
+#endif
+}
+
+void CpuSkinning::LinearBlend(const AnimatedVertexData* vertices, size_t count, const Matrix4* bones, Uint boneCount,
+                              Vector3* positions, Vector3* normals)
+{
+  LinearBlendSIMD(vertices, count, bones, boneCount, positions, normals);
+}
+
+void CpuSkinning::DualQuaternionBlend(const AnimatedVertexData* vertices, size_t count, const DualQuaternion* bones,
+                                      Uint boneCount, Vector3* positions, Vector3* normals)
+{
+  DualQuaternionSIMD(vertices, count, bones, boneCount, positions, normals);
+}
+
+void CpuSkinning::BuildDualQuaternions(const Matrix4* bones, Uint boneCount, std::vector<DualQuaternion>* output)
+{
+  output->resize(boneCount);
+  for (Uint x = 0; x < boneCount; x++) {
+    (*output)[x] = DualQuaternion::FromMatrix(bones[x]);
+  }
+}
+
+void CpuSkinning::Skin(SkinningMethod::Enum method, const std::vector<AnimatedVertexData>& vertices,
+                       const std::vector<Matrix4>& bones, std::vector<Vector3>* positions,
+                       std::vector<Vector3>* normals)
+{
+  positions->resize(vertices.size());
+  if (normals) {
+    normals->resize(vertices.size());
+  }
+  Vector3* normalsData = normals ? normals->data() : YEAGER_NULLPTR;
+
+  if (method == SkinningMethod::eDUAL_QUATERNION) {
+    std::vector<DualQuaternion> dualQuaternions;
+    BuildDualQuaternions(bones.data(), bones.size(), &dualQuaternions);
+    DualQuaternionBlend(vertices.data(), vertices.size(), dualQuaternions.data(), dualQuaternions.size(),
+                        positions->data(), normalsData);
+  } else {
+    LinearBlend(vertices.data(), vertices.size(), bones.data(), bones.size(), positions->data(), normalsData);
+  }
+}
+
+bool CpuSkinning::IsSIMDAvailable()
+{
+#ifdef YEAGER_SIMD_SSE2
+  return true;
+#else
+  return false;
+#endif
+}
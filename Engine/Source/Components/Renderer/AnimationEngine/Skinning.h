@@ -0,0 +1,85 @@
+//    Yeager Engine, free and open source 3D/2D renderer written in OpenGL
+//    In case of questions and bugs, please, refer to the issue tab on github
+//    Repo : https://github.com/schwq/YeagerEngine
+//    Copyright (C) 2023 - Present
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Common/Utils/Common.h"
+#include "Common/Utils/LogEngine.h"
+#include "Common/Utils/Utilities.h"
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/quaternion.hpp>
+
+#include "Components/Renderer/Objects/Object.h"
+
+namespace Yeager {
+
+struct SkinningMethod {
+  enum Enum { eLINEAR_BLEND, eDUAL_QUATERNION };
+  YEAGER_ENUM_TO_STRING(SkinningMethod)
+};
+
+/**
+ * @brief Unit dual quaternion of a rigid bone transform, Real is the rotation and Dual holds the translation. Scale and
+ * shear of the bone matrix are lost in the conversion
+ */
+struct DualQuaternion {
+  glm::quat Real = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+  glm::quat Dual = glm::quat(0.0f, 0.0f, 0.0f, 0.0f);
+
+  static DualQuaternion FromMatrix(const Matrix4& matrix);
+};
+
+/**
+ * @brief Reference skinning in the CPU over the vertex layout of the animated meshes. Used where the skinned mesh is
+ * needed outside of the shaders (baking, picking, physics proxies) and to validate the shader output.
+ * The rules of SimpleAnimated.vert are followed: a bone id equal to -1 is skipped, a id out of the bone range leaves the
+ * vertex in bind pose and a vertex without any influence ends at the origin. Normals are skinned by the blended rotation
+ * and normalized. The SIMD versions give the same results as the scalar ones within float rounding
+ */
+class CpuSkinning {
+ public:
+  /**
+   * @brief Skins count vertices with the best implementation available, normals can be null
+   */
+  static void LinearBlend(const AnimatedVertexData* vertices, size_t count, const Matrix4* bones, Uint boneCount,
+                          Vector3* positions, Vector3* normals);
+  static void DualQuaternionBlend(const AnimatedVertexData* vertices, size_t count, const DualQuaternion* bones,
+                                  Uint boneCount, Vector3* positions, Vector3* normals);
+
+  static void LinearBlendScalar(const AnimatedVertexData* vertices, size_t count, const Matrix4* bones, Uint boneCount,
+                                Vector3* positions, Vector3* normals);
+  static void LinearBlendSIMD(const AnimatedVertexData* vertices, size_t count, const Matrix4* bones, Uint boneCount,
+                              Vector3* positions, Vector3* normals);
+  static void DualQuaternionScalar(const AnimatedVertexData* vertices, size_t count, const DualQuaternion* bones,
+                                   Uint boneCount, Vector3* positions, Vector3* normals);
+  static void DualQuaternionSIMD(const AnimatedVertexData* vertices, size_t count, const DualQuaternion* bones,
+                                 Uint boneCount, Vector3* positions, Vector3* normals);
+
+  static void BuildDualQuaternions(const Matrix4* bones, Uint boneCount, std::vector<DualQuaternion>* output);
+
+  /**
+   * @brief Skins a whole mesh with the chosen method, the outputs are resized to the vertex count
+   */
+  static void Skin(SkinningMethod::Enum method, const std::vector<AnimatedVertexData>& vertices,
+                   const std::vector<Matrix4>& bones, std::vector<Vector3>* positions, std::vector<Vector3>* normals);
+
+  YEAGER_NODISCARD static bool IsSIMDAvailable();
+};
+
+}  // namespace Yeager
@@ -0,0 +1,188 @@
+#include "VertexAnimationTexture.h"
+#include "AnimationEngine.h"
+#include "Skinning.h"
+#include "Components/Renderer/Shader/ShaderHandle.h"
+using namespace Yeager;
+
+std::optional<VertexAnimationTextureData> VertexAnimationTextureBaker::Bake(
+    AnimatedObject* object, Uint clip, const VertexAnimationTextureBakeSettings& settings)
+{
+  if (!object->IsLoaded()) {
+    Yeager::Log(WARNING, "Cannot bake vertex animation texture of object not loaded! {}", object->GetName());
+    return std::nullopt;
+  }
+
+  /* A separated animator is used so the playback of the object is not changed, the clips come from the library */
+  AnimationEngine engine;
+  engine.LoadAnimationsFromFile(object->GetPath(), object);
+  if (!engine.IsAnimationsLoaded() || clip >= engine.GetAnimations()->size()) {
+    Yeager::Log(WARNING, "Cannot bake vertex animation texture, clip {} not found in object {}", clip,
+                object->GetName());
+    return std::nullopt;
+  }
+
+  std::vector<const std::vector<AnimatedVertexData>*> meshes;
+  for (const auto& mesh : object->GetModelData()->Meshes) {
+    meshes.push_back(&mesh.Vertices);
+  }
+
+  auto data = BakeClip(meshes, &engine, clip, settings);
+  if (!data.has_value()) {
+    Yeager::Log(WARNING, "Cannot bake vertex animation texture of object {}", object->GetName());
+    return std::nullopt;
+  }
+
+  Yeager::Log(INFO, "Baked vertex animation texture of {} clip {}, {} vertices, {} frames, {}x{} texels, {} KB",
+              object->GetName(), engine.GetAnimations()->at(clip).GetName(), data->VertexCount, data->FrameCount,
+              data->Width, data->GetHeight(), data->GetMemorySize() / 1024);
+  return data;
+}
+
+std::optional<VertexAnimationTextureData> VertexAnimationTextureBaker::BakeClip(
+    const std::vector<const std::vector<AnimatedVertexData>*>& meshes, AnimationEngine* engine, Uint clip,
+    const VertexAnimationTextureBakeSettings& settings)
+{
+  if (!engine->IsAnimationsLoaded() || clip >= engine->GetAnimations()->size())
+    return std::nullopt;
+
+  const Animation& animation = engine->GetAnimations()->at(clip);
+  return BakeMeshes(
+      meshes, animation.GetDuration() / animation.GetTicksPerSecond(),
+      [&](float seconds, std::vector<Matrix4>* bones) { return engine->SamplePose(clip, seconds, bones); }, settings);
+}
+
+std::optional<VertexAnimationTextureData> VertexAnimationTextureBaker::BakeMeshes(
+    const std::vector<const std::vector<AnimatedVertexData>*>& meshes, float duration,
+    const VertexAnimationPoseSampler& sampler, const VertexAnimationTextureBakeSettings& settings)
+{
+  VertexAnimationTextureData data;
+  data.SampleRate = settings.SampleRate;
+  data.Duration = duration;
+  data.FrameCount = std::max<Uint>(1, static_cast<Uint>(std::ceil(data.Duration * data.SampleRate)));
+
+  for (const auto* mesh : meshes) {
+    data.MeshVertexOffsets.push_back(data.VertexCount);
+    data.VertexCount += mesh->size();
+  }
+
+  if (data.VertexCount == 0 || settings.MaxWidth == 0) {
+    Yeager::Log(WARNING, "Cannot bake vertex animation texture without vertices!");
+    return std::nullopt;
+  }
+
+  data.Width = std::min<Uint>(data.VertexCount, settings.MaxWidth);
+  data.RowsPerFrame = (data.VertexCount + data.Width - 1) / data.Width;
+
+  const size_t floats = static_cast<size_t>(data.Width) * data.GetHeight() * 3;
+  data.Positions.assign(floats, 0.0f);
+  if (settings.BakeNormals) {
+    data.Normals.assign(floats, 0.0f);
+  }
+
+  std::vector<Matrix4> bones;
+  std::vector<Vector3> positions, normals;
+  for (Uint frame = 0; frame < data.FrameCount; frame++) {
+    if (!sampler(frame / data.SampleRate, &bones)) {
+      return std::nullopt;
+    }
+
+    for (Uint mesh = 0; mesh < meshes.size(); mesh++) {
+      CpuSkinning::Skin(SkinningMethod::eLINEAR_BLEND, *meshes[mesh], bones, &positions,
+                        settings.BakeNormals ? &normals : YEAGER_NULLPTR);
+
+      for (Uint vertex = 0; vertex < positions.size(); vertex++) {
+        const size_t texel = data.GetTexelIndex(frame, data.MeshVertexOffsets[mesh] + vertex);
+        std::memcpy(&data.Positions[texel], glm::value_ptr(positions[vertex]), sizeof(float) * 3);
+        if (settings.BakeNormals) {
+          std::memcpy(&data.Normals[texel], glm::value_ptr(normals[vertex]), sizeof(float) * 3);
+        }
+      }
+    }
+  }
+  return data;
+}
+
+VertexAnimationTexture::~VertexAnimationTexture()
+{
+  Delete();
+}
+
+static GLuint GenerateFloatTexture(const std::vector<float>& data, Uint width, Uint height)
+{
+  GLuint texture = 0;
+  glGenTextures(1, &texture);
+  glBindTexture(GL_TEXTURE_2D, texture);
+  /* Texels are read with texelFetch, filtering between frames is done by the shader */
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB32F, width, height, 0, GL_RGB, GL_FLOAT, data.data());
+  glBindTexture(GL_TEXTURE_2D, 0);
+  return texture;
+}
+
+bool VertexAnimationTexture::Generate(const VertexAnimationTextureData& data)
+{
+  Delete();
+
+  GLint maxSize = 0;
+  glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+  if (data.Width > static_cast<Uint>(maxSize) || data.GetHeight() > static_cast<Uint>(maxSize)) {
+    Yeager::Log(ERROR, "Vertex animation texture {}x{} is bigger than the max texture size {}", data.Width,
+                data.GetHeight(), maxSize);
+    return false;
+  }
+
+  m_PositionTexture = GenerateFloatTexture(data.Positions, data.Width, data.GetHeight());
+  m_HasNormals = !data.Normals.empty();
+  if (m_HasNormals) {
+    m_NormalTexture = GenerateFloatTexture(data.Normals, data.Width, data.GetHeight());
+  }
+
+  m_Width = data.Width;
+  m_RowsPerFrame = data.RowsPerFrame;
+  m_FrameCount = data.FrameCount;
+  m_SampleRate = data.SampleRate;
+  m_Duration = data.Duration;
+  m_MeshVertexOffsets = data.MeshVertexOffsets;
+  m_Generated = true;
+  return true;
+}
+
+void VertexAnimationTexture::Delete()
+{
+  if (m_Generated) {
+    glDeleteTextures(1, &m_PositionTexture);
+    if (m_HasNormals) {
+      glDeleteTextures(1, &m_NormalTexture);
+    }
+    m_Generated = false;
+  }
+}
+
+void VertexAnimationTexture::Bind(Shader* shader, float time, GLuint positionUnit, GLuint normalUnit)
+{
+  shader->UseShader();
+  glActiveTexture(GL_TEXTURE0 + positionUnit);
+  glBindTexture(GL_TEXTURE_2D, m_PositionTexture);
+  shader->SetInt("vat.Positions", positionUnit);
+  if (m_HasNormals) {
+    glActiveTexture(GL_TEXTURE0 + normalUnit);
+    glBindTexture(GL_TEXTURE_2D, m_NormalTexture);
+    shader->SetInt("vat.Normals", normalUnit);
+  }
+  shader->SetBool("vat.HasNormals", m_HasNormals);
+  shader->SetInt("vat.Width", m_Width);
+  shader->SetInt("vat.RowsPerFrame", m_RowsPerFrame);
+  shader->SetInt("vat.FrameCount", m_FrameCount);
+  shader->SetFloat("vat.SampleRate", m_SampleRate);
+  shader->SetFloat("vat.Time", time);
+  glActiveTexture(GL_TEXTURE0);
+}
+
+void VertexAnimationTexture::SetMeshVertexOffset(Shader* shader, Uint mesh)
+{
+  shader->SetInt("vat.VertexOffset", mesh < m_MeshVertexOffsets.size() ? m_MeshVertexOffsets[mesh] : 0);
+}
@@ -0,0 +1,132 @@
+//    Yeager Engine, free and open source 3D/2D renderer written in OpenGL
+//    In case of questions and bugs, please, refer to the issue tab on github
+//    Repo : https://github.com/schwq/YeagerEngine
+//    Copyright (C) 2023 - Present
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Common/Utils/Common.h"
+#include "Common/Utils/LogEngine.h"
+#include "Common/Utils/Utilities.h"
+
+#include "Components/Renderer/Objects/Object.h"
+
+namespace Yeager {
+
+class Shader;
+class AnimationEngine;
+
+/* Largest width used by the baked textures, meshes with more vertices wrap to the next rows of the same frame */
+#define YEAGER_VAT_MAX_TEXTURE_WIDTH 4096
+/* Size of the uniform arrays of the SimpleInstancedVAT shader, bigger crowds are drawn in batches of this size */
+#define YEAGER_VAT_MAX_INSTANCES_PER_DRAW 100
+
+struct VertexAnimationTextureBakeSettings {
+  /* Frames sampled per second of animation */
+  float SampleRate = 30.0f;
+  bool BakeNormals = true;
+  Uint MaxWidth = YEAGER_VAT_MAX_TEXTURE_WIDTH;
+};
+
+/* Writes the bone matrices of the pose at the given time in seconds, returns false if the pose cannot be sampled */
+using VertexAnimationPoseSampler = std::function<bool(float seconds, std::vector<Matrix4>* bones)>;
+
+/**
+ * @brief Skinned vertex positions and normals of a clip sampled at a fixed rate. Every frame is RowsPerFrame rows of
+ * Width texels, the vertex n of a frame is at texel (n % Width, frame * RowsPerFrame + n / Width). Vertices of every mesh
+ * of the object are stored one after another, MeshVertexOffsets has the first vertex of each mesh
+ */
+struct VertexAnimationTextureData {
+  Uint VertexCount = 0;
+  Uint FrameCount = 0;
+  Uint Width = 0;
+  Uint RowsPerFrame = 0;
+  float SampleRate = 0.0f;
+  float Duration = 0.0f;
+  std::vector<Uint> MeshVertexOffsets;
+  std::vector<float> Positions;
+  std::vector<float> Normals;
+
+  YEAGER_NODISCARD Uint GetHeight() const { return FrameCount * RowsPerFrame; }
+  YEAGER_NODISCARD size_t GetMemorySize() const { return (Positions.size() + Normals.size()) * sizeof(float); }
+  /* Index of the first float (RGB) of the vertex in the frame */
+  YEAGER_NODISCARD size_t GetTexelIndex(Uint frame, Uint vertex) const
+  {
+    return (static_cast<size_t>(frame) * RowsPerFrame * Width + vertex) * 3;
+  }
+};
+
+/**
+ * @brief Offline baker of vertex animation textures, runs entirely on the CPU. The clip is sampled through the animation
+ * engine and every vertex is skinned by the reference CpuSkinning, which follows the rules of SimpleAnimated.vert
+ */
+class VertexAnimationTextureBaker {
+ public:
+  static std::optional<VertexAnimationTextureData> Bake(
+      AnimatedObject* object, Uint clip,
+      const VertexAnimationTextureBakeSettings& settings = VertexAnimationTextureBakeSettings());
+
+  /**
+   * @brief Bakes the vertices of the meshes skinned by the poses of the sampler, the duration is in seconds. Does not
+   * need a loaded object, so the baked texels can be checked against a pose computed without the skinning
+   */
+  static std::optional<VertexAnimationTextureData> BakeMeshes(
+      const std::vector<const std::vector<AnimatedVertexData>*>& meshes, float duration,
+      const VertexAnimationPoseSampler& sampler,
+      const VertexAnimationTextureBakeSettings& settings = VertexAnimationTextureBakeSettings());
+  /**
+   * @brief Bakes the whole clip of a animator with its clip set loaded, the poses are sampled by the animator
+   */
+  static std::optional<VertexAnimationTextureData> BakeClip(
+      const std::vector<const std::vector<AnimatedVertexData>*>& meshes, AnimationEngine* engine, Uint clip,
+      const VertexAnimationTextureBakeSettings& settings = VertexAnimationTextureBakeSettings());
+};
+
+/**
+ * @brief Float textures of a baked clip, played by the SimpleInstancedVAT shader. A crowd using it is drawn with a
+ * single instanced draw per mesh and no animation work in the CPU, each instance has its own time offset
+ */
+class VertexAnimationTexture {
+ public:
+  VertexAnimationTexture() = default;
+  ~VertexAnimationTexture();
+
+  bool Generate(const VertexAnimationTextureData& data);
+  void Delete();
+
+  /**
+   * @brief Binds the textures to the given units and sets the uniforms of the playback, time is in seconds
+   */
+  void Bind(Shader* shader, float time, GLuint positionUnit = 14, GLuint normalUnit = 15);
+  void SetMeshVertexOffset(Shader* shader, Uint mesh);
+
+  YEAGER_NODISCARD bool IsGenerated() const { return m_Generated; }
+  YEAGER_NODISCARD float GetDuration() const { return m_Duration; }
+
+ private:
+  GLuint m_PositionTexture = 0;
+  GLuint m_NormalTexture = 0;
+  Uint m_Width = 0;
+  Uint m_RowsPerFrame = 0;
+  Uint m_FrameCount = 0;
+  float m_SampleRate = 0.0f;
+  float m_Duration = 0.0f;
+  bool m_HasNormals = false;
+  bool m_Generated = false;
+  std::vector<Uint> m_MeshVertexOffsets;
+};
+
+}  // namespace Yeager
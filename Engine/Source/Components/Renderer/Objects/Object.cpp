@@ -2,6 +2,7 @@
 #include "Components/Loader/Importer.h"
 #include "Components/Physics/PhysXActor.h"
 #include "Components/Renderer/AnimationEngine/AnimationEngine.h"
+#include "Components/Renderer/AnimationEngine/VertexAnimationTexture.h"
 #include "Main/Core/Application.h"
 
 using namespace Yeager;
@@ -161,6 +162,7 @@ Object::~Object()
 
 AnimatedObject::~AnimatedObject()
 {
+  m_VertexAnimation.reset();
   m_AnimationEngine.reset();
   m_ThreadImporter.reset();
 }
@@ -208,11 +210,29 @@ void AnimatedObject::UpdateAnimation(float delta)
   }
 }
 
+void AnimatedObject::UpdateAnimation(float delta, const Vector3& viewerPos, const Matrix4& viewProjection)
+{
+  if (m_ObjectDataLoaded && bRender) {
+    const Vector3 position = mEntityTransformation.position;
+    const float distance = glm::distance(viewerPos, position);
+
+    /* Conservative visibility test against the clip space of the object origin, the margin accounts for the size of the
+     * model, since we dont have the bounding volume of the animated meshes */
+    const Vector3 scale = mEntityTransformation.scale;
+    const float margin = std::max(std::max(scale.x, scale.y), scale.z) * 2.0f;
+    const glm::vec4 clip = viewProjection * glm::vec4(position, 1.0f);
+    const bool onScreen = clip.w > -margin && std::abs(clip.x) <= clip.w + margin &&
+                          std::abs(clip.y) <= clip.w + margin && clip.z <= clip.w + margin;
+
+    m_AnimationEngine->UpdateAnimation(delta, distance, onScreen);
+  }
+}
+
 void AnimatedObject::BuildAnimationMatrices(Shader* shader)
 {
   if (m_ObjectDataLoaded && bRender) {
     shader->UseShader();
-    auto transform = m_AnimationEngine->GetFinalBoneMatrices();
+    const auto& transform = m_AnimationEngine->GetFinalBoneMatrices();
     for (int x = 0; x < transform.size(); x++) {
       shader->SetMat4("finalBonesMatrices[" + std::to_string(x) + "]", transform.at(x));
     }
@@ -690,9 +710,78 @@ void AnimatedObject::Draw(Shader* shader)
   IntervalElapsedTimeManager::EndTimeInterval(this->mName);
 }
 
+bool AnimatedObject::BuildVertexAnimationTexture(Uint clip, const VertexAnimationTextureBakeSettings& settings)
+{
+  if (!IsInstanced()) {
+    Yeager::Log(WARNING, "Vertex animation textures are only used by instanced objects! {}", mName);
+    return false;
+  }
+
+  auto data = VertexAnimationTextureBaker::Bake(this, clip, settings);
+  if (!data.has_value()) {
+    return false;
+  }
+
+  m_VertexAnimation = BaseAllocator::MakeSharedPtr<VertexAnimationTexture>();
+  if (!m_VertexAnimation->Generate(data.value())) {
+    m_VertexAnimation.reset();
+    return false;
+  }
+
+  /* Spreads the instances over the clip with the golden ratio, so the crowd doesnt move in sync */
+  m_InstanceTimeOffsets.resize(m_InstancedObjs);
+  for (Uint x = 0; x < m_InstancedObjs; x++) {
+    m_InstanceTimeOffsets[x] = std::fmod(x * 0.618034f, 1.0f) * data->Duration;
+  }
+  return true;
+}
+
+bool AnimatedObject::HasVertexAnimationTexture() const
+{
+  return m_VertexAnimation && m_VertexAnimation->IsGenerated();
+}
+
+void AnimatedObject::DrawVertexAnimated(Shader* shader, float delta)
+{
+  if (!m_ObjectDataLoaded || !bRender || !HasVertexAnimationTexture())
+    return;
+
+  IntervalElapsedTimeManager::StartTimeInterval(this->mName);
+  ProcessOnScreenProprieties();
+
+  m_VertexAnimationTime += delta;
+  m_VertexAnimation->Bind(shader, m_VertexAnimationTime);
+  /* The shader holds the instances of a single draw in uniform arrays, bigger crowds are drawn in batches and the
+   * instance id starts from zero again in each of them */
+  const Uint instances = std::min<Uint>(m_Props.size(), m_InstancedObjs);
+  for (Uint first = 0; first < instances; first += YEAGER_VAT_MAX_INSTANCES_PER_DRAW) {
+    const Uint count = std::min<Uint>(instances - first, YEAGER_VAT_MAX_INSTANCES_PER_DRAW);
+    for (Uint x = 0; x < count; x++) {
+      const Uint instance = first + x;
+      shader->SetMat4("matrices[" + std::to_string(x) + "]", Transformation3D::Apply(*m_Props.at(instance)));
+      shader->SetFloat("timeOffsets[" + std::to_string(x) + "]",
+                       instance < m_InstanceTimeOffsets.size() ? m_InstanceTimeOffsets[instance] : 0.0f);
+    }
+    DrawMeshes(shader, count);
+  }
+
+  PosProcessOnScreenProprieties();
+  IntervalElapsedTimeManager::EndTimeInterval(this->mName);
+}
+
 void AnimatedObject::DrawMeshes(Shader* shader)
 {
-  for (auto& mesh : m_ModelData.Meshes) {
+  DrawMeshes(shader, m_InstancedObjs);
+}
+
+void AnimatedObject::DrawMeshes(Shader* shader, Uint instances)
+{
+  const bool vertexAnimated = HasVertexAnimationTexture();
+  for (Uint index = 0; index < m_ModelData.Meshes.size(); index++) {
+    auto& mesh = m_ModelData.Meshes[index];
+    if (vertexAnimated) {
+      m_VertexAnimation->SetMeshVertexOffset(shader, index);
+    }
     Uint diffuseNum = 1;
     Uint specularNum = 1;
     Uint normalNum = 1;
@@ -720,7 +809,7 @@ void AnimatedObject::DrawMeshes(Shader* shader)
       mesh.Renderer.Draw(GL_TRIANGLES, static_cast<GLsizei>(mesh.Indices.size()), GL_UNSIGNED_INT, YEAGER_NULLPTR);
     } else {
       mesh.Renderer.DrawInstanced(GL_TRIANGLES, static_cast<GLsizei>(mesh.Indices.size()), GL_UNSIGNED_INT,
-                                  YEAGER_NULLPTR, m_InstancedObjs);
+                                  YEAGER_NULLPTR, instances);
     }
 
     mesh.Renderer.UnbindVertexArray();
@@ -33,6 +33,8 @@ namespace Yeager {
 class ApplicationCore;
 class Animation;
 class AnimationEngine;
+class VertexAnimationTexture;
+struct VertexAnimationTextureBakeSettings;
 class Importer;
 class ImporterThreaded;
 class ImporterThreadedAnimated;
@@ -271,16 +273,34 @@ class AnimatedObject : public Object {
   std::shared_ptr<AnimationEngine> GetAnimationEngine() { return m_AnimationEngine; }
 
   void UpdateAnimation(float delta);
+  /**
+   * @brief Updates the animation with the level of detail chosen by the distance to the viewer and if the object is
+   * inside the view frustum, see AnimationLODSettings
+   */
+  void UpdateAnimation(float delta, const Vector3& viewerPos, const Matrix4& viewProjection);
   void BuildAnimationMatrices(Shader* shader);
   void BuildAnimation(String path);
   void ThreadLoadIncompleteTextures();
 
+  /**
+   * @brief Bakes the clip into a vertex animation texture, after that the instanced object is drawn by the
+   * SimpleInstancedVAT shader without any animation work in the CPU. Each instance gets a different time offset
+   */
+  bool BuildVertexAnimationTexture(Uint clip, const VertexAnimationTextureBakeSettings& settings);
+  bool HasVertexAnimationTexture() const;
+  void SetInstanceTimeOffsets(const std::vector<float>& offsets) { m_InstanceTimeOffsets = offsets; }
+  void DrawVertexAnimated(Shader* shader, float delta);
+
  protected:
   void Setup();
   void DrawMeshes(Shader* shader);
+  void DrawMeshes(Shader* shader, Uint instances);
   AnimatedObjectModelData m_ModelData;
   std::shared_ptr<AnimationEngine> m_AnimationEngine = YEAGER_NULLPTR;
   std::shared_ptr<ImporterThreadedAnimated> m_ThreadImporter = YEAGER_NULLPTR;
+  std::shared_ptr<VertexAnimationTexture> m_VertexAnimation = YEAGER_NULLPTR;
+  std::vector<float> m_InstanceTimeOffsets;
+  float m_VertexAnimationTime = 0.0f;
 };
 
 }  // namespace Yeager
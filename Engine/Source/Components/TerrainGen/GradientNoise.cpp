@@ -0,0 +1,471 @@
+#include "GradientNoise.h"
+#include "Components/Kernel/Hardware/HardwareInfo.h"
+using namespace Yeager;
+
+#ifdef YEAGER_SIMD_SSE2
+#include <immintrin.h>
+#endif
+
+/* Skew and unskew factors of the 2D simplex grid */
+static const float sF2 = 0.366025403784f;
+static const float sG2 = 0.211324865405f;
+static const float sG2TimesTwoMinusOne = 2.0f * 0.211324865405f - 1.0f;
+/* Scales the sum of the three corners to [-1, 1] */
+static const float sNoiseScale = 70.0f;
+
+/* The 8 gradients of the corners, indexed by the permutation & 7 */
+alignas(32) static const float sGradientX[8] = {1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 0.0f, 0.0f};
+alignas(32) static const float sGradientY[8] = {1.0f, 1.0f, -1.0f, -1.0f, 0.0f, 0.0f, 1.0f, -1.0f};
+
+String NoiseFractalType::ToString(NoiseFractalType::Enum type)
+{
+  switch (type) {
+    case eFRACTAL_FBM:
+      return "fBm";
+    case eFRACTAL_RIDGED:
+      return "Ridged";
+    case eFRACTAL_BILLOW:
+      return "Billow";
+    default:
+      return "Undefined";
+  }
+}
+
+String NoiseSIMDPath::ToString(NoiseSIMDPath::Enum type)
+{
+  switch (type) {
+    case eSIMD_SCALAR:
+      return "Scalar";
+    case eSIMD_SSE41:
+      return "SSE4.1";
+    case eSIMD_AVX2:
+      return "AVX2";
+    default:
+      return "Undefined";
+  }
+}
+
+GradientNoise::GradientNoise(uint64_t seed)
+{
+  SetSeed(seed);
+  m_Path = GetBestSIMDPath();
+}
+
+void GradientNoise::SetSeed(uint64_t seed)
+{
+  m_Seed = seed;
+
+  /* SplitMix64, the standard distributions are implementation defined and would change the table between compilers */
+  uint64_t state = seed;
+  auto next = [&state]() {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  };
+
+  int32_t permutation[256];
+  for (int x = 0; x < 256; x++) {
+    permutation[x] = x;
+  }
+  for (int x = 255; x > 0; x--) {
+    std::swap(permutation[x], permutation[next() % (x + 1)]);
+  }
+  for (int x = 0; x < 512; x++) {
+    m_Permutation[x] = permutation[x & 255];
+  }
+}
+
+NoiseSIMDPath::Enum GradientNoise::GetBestSIMDPath()
+{
+  static const NoiseSIMDPath::Enum path = HardwareSupportsAVX2()    ? NoiseSIMDPath::eSIMD_AVX2
+                                          : HardwareSupportsSSE41() ? NoiseSIMDPath::eSIMD_SSE41
+                                                                    : NoiseSIMDPath::eSIMD_SCALAR;
+  return path;
+}
+
+void GradientNoise::SetSIMDPath(NoiseSIMDPath::Enum path)
+{
+  if ((path == NoiseSIMDPath::eSIMD_AVX2 && !HardwareSupportsAVX2()) ||
+      (path == NoiseSIMDPath::eSIMD_SSE41 && !HardwareSupportsSSE41())) {
+    Yeager::Log(WARNING, "Noise SIMD path {} not supported by the hardware!", NoiseSIMDPath::ToString(path));
+    return;
+  }
+  m_Path = path;
+}
+
+static YEAGER_FORCE_INLINE float SimplexCorner(float x, float y, int32_t gradient)
+{
+  float t = 0.5f - x * x - y * y;
+  if (t < 0.0f) {
+    return 0.0f;
+  }
+  t = t * t;
+  return t * t * (sGradientX[gradient] * x + sGradientY[gradient] * y);
+}
+
+float GradientNoise::Sample(float x, float y) const
+{
+  const float s = (x + y) * sF2;
+  const float fi = std::floor(x + s);
+  const float fj = std::floor(y + s);
+  const float t = (fi + fj) * sG2;
+  const float x0 = x - (fi - t);
+  const float y0 = y - (fj - t);
+
+  /* Which of the two triangles of the skewed cell holds the point */
+  const float i1 = x0 > y0 ? 1.0f : 0.0f;
+  const float j1 = 1.0f - i1;
+  const float x1 = x0 - i1 + sG2;
+  const float y1 = y0 - j1 + sG2;
+  const float x2 = x0 + sG2TimesTwoMinusOne;
+  const float y2 = y0 + sG2TimesTwoMinusOne;
+
+  const int32_t ii = static_cast<int32_t>(fi) & 255;
+  const int32_t jj = static_cast<int32_t>(fj) & 255;
+  const int32_t offsetI = static_cast<int32_t>(i1);
+  const int32_t offsetJ = static_cast<int32_t>(j1);
+  const int32_t g0 = m_Permutation[ii + m_Permutation[jj]] & 7;
+  const int32_t g1 = m_Permutation[ii + offsetI + m_Permutation[jj + offsetJ]] & 7;
+  const int32_t g2 = m_Permutation[ii + 1 + m_Permutation[jj + 1]] & 7;
+
+  const float n0 = SimplexCorner(x0, y0, g0);
+  const float n1 = SimplexCorner(x1, y1, g1);
+  const float n2 = SimplexCorner(x2, y2, g2);
+  return sNoiseScale * (n0 + n1 + n2);
+}
+
+static YEAGER_FORCE_INLINE float ShapeOctave(float noise, NoiseFractalType::Enum type)
+{
+  switch (type) {
+    case NoiseFractalType::eFRACTAL_RIDGED:
+      noise = 1.0f - std::fabs(noise);
+      return noise * noise;
+    case NoiseFractalType::eFRACTAL_BILLOW:
+      return std::fabs(noise) * 2.0f - 1.0f;
+    case NoiseFractalType::eFRACTAL_FBM:
+    default:
+      return noise;
+  }
+}
+
+float GradientNoise::Fractal(float x, float y, const NoiseFractalSettings& settings) const
+{
+  float sum = 0.0f;
+  float amplitude = 1.0f;
+  float amplitudeSum = 0.0f;
+  float frequency = settings.Frequency;
+  for (int octave = 0; octave < settings.Octaves; octave++) {
+    sum += ShapeOctave(Sample(x * frequency, y * frequency), settings.Type) * amplitude;
+    amplitudeSum += amplitude;
+    amplitude *= settings.Gain;
+    frequency *= settings.Lacunarity;
+  }
+  return amplitudeSum > 0.0f ? sum / amplitudeSum : 0.0f;
+}
+
+void GradientNoise::FractalBatchScalar(const float* x, const float* y, const NoiseFractalSettings& settings,
+                                       float* output) const
+{
+  for (int lane = 0; lane < YEAGER_NOISE_BATCH; lane++) {
+    output[lane] = Fractal(x[lane], y[lane], settings);
+  }
+}
+
+#ifdef YEAGER_SIMD_SSE2
+
+/* SSE4.1 path, two groups of 4 lanes. There is no gather before AVX2, the table lookups are done per lane */
+YEAGER_SIMD_TARGET("sse4.1")
+static __m128 SimplexCornersSSE41(__m128 x, __m128 y, __m128i gradient)
+{
+  alignas(16) int32_t index[4];
+  alignas(16) float gradientX[4], gradientY[4];
+  _mm_store_si128(reinterpret_cast<__m128i*>(index), gradient);
+  for (int lane = 0; lane < 4; lane++) {
+    gradientX[lane] = sGradientX[index[lane]];
+    gradientY[lane] = sGradientY[index[lane]];
+  }
+
+  __m128 t = _mm_sub_ps(_mm_sub_ps(_mm_set1_ps(0.5f), _mm_mul_ps(x, x)), _mm_mul_ps(y, y));
+  const __m128 inside = _mm_cmpge_ps(t, _mm_setzero_ps());
+  t = _mm_mul_ps(t, t);
+  const __m128 dot = _mm_add_ps(_mm_mul_ps(_mm_load_ps(gradientX), x), _mm_mul_ps(_mm_load_ps(gradientY), y));
+  return _mm_and_ps(inside, _mm_mul_ps(_mm_mul_ps(t, t), dot));
+}
+
+YEAGER_SIMD_TARGET("sse4.1")
+static __m128i LookupSSE41(const int32_t* table, __m128i index)
+{
+  alignas(16) int32_t lanes[4];
+  _mm_store_si128(reinterpret_cast<__m128i*>(lanes), index);
+  return _mm_setr_epi32(table[lanes[0]], table[lanes[1]], table[lanes[2]], table[lanes[3]]);
+}
+
+YEAGER_SIMD_TARGET("sse4.1")
+static __m128 SampleSSE41(const int32_t* permutation, __m128 x, __m128 y)
+{
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 s = _mm_mul_ps(_mm_add_ps(x, y), _mm_set1_ps(sF2));
+  const __m128 fi = _mm_floor_ps(_mm_add_ps(x, s));
+  const __m128 fj = _mm_floor_ps(_mm_add_ps(y, s));
+  const __m128 t = _mm_mul_ps(_mm_add_ps(fi, fj), _mm_set1_ps(sG2));
+  const __m128 x0 = _mm_sub_ps(x, _mm_sub_ps(fi, t));
+  const __m128 y0 = _mm_sub_ps(y, _mm_sub_ps(fj, t));
+
+  const __m128 i1 = _mm_and_ps(_mm_cmpgt_ps(x0, y0), one);
+  const __m128 j1 = _mm_sub_ps(one, i1);
+  const __m128 x1 = _mm_add_ps(_mm_sub_ps(x0, i1), _mm_set1_ps(sG2));
+  const __m128 y1 = _mm_add_ps(_mm_sub_ps(y0, j1), _mm_set1_ps(sG2));
+  const __m128 x2 = _mm_add_ps(x0, _mm_set1_ps(sG2TimesTwoMinusOne));
+  const __m128 y2 = _mm_add_ps(y0, _mm_set1_ps(sG2TimesTwoMinusOne));
+
+  const __m128i mask = _mm_set1_epi32(255);
+  const __m128i ii = _mm_and_si128(_mm_cvttps_epi32(fi), mask);
+  const __m128i jj = _mm_and_si128(_mm_cvttps_epi32(fj), mask);
+  const __m128i oneInt = _mm_set1_epi32(1);
+  const __m128i seven = _mm_set1_epi32(7);
+  const __m128i offsetI = _mm_cvttps_epi32(i1);
+  const __m128i offsetJ = _mm_cvttps_epi32(j1);
+
+  const __m128i g0 = _mm_and_si128(
+      LookupSSE41(permutation, _mm_add_epi32(ii, LookupSSE41(permutation, jj))), seven);
+  const __m128i g1 = _mm_and_si128(
+      LookupSSE41(permutation, _mm_add_epi32(_mm_add_epi32(ii, offsetI),
+                                             LookupSSE41(permutation, _mm_add_epi32(jj, offsetJ)))),
+      seven);
+  const __m128i g2 = _mm_and_si128(
+      LookupSSE41(permutation, _mm_add_epi32(_mm_add_epi32(ii, oneInt),
+                                             LookupSSE41(permutation, _mm_add_epi32(jj, oneInt)))),
+      seven);
+
+  const __m128 n0 = SimplexCornersSSE41(x0, y0, g0);
+  const __m128 n1 = SimplexCornersSSE41(x1, y1, g1);
+  const __m128 n2 = SimplexCornersSSE41(x2, y2, g2);
+  return _mm_mul_ps(_mm_set1_ps(sNoiseScale), _mm_add_ps(_mm_add_ps(n0, n1), n2));
+}
+
+YEAGER_SIMD_TARGET("sse4.1")
+static __m128 ShapeOctaveSSE41(__m128 noise, NoiseFractalType::Enum type)
+{
+  const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+  switch (type) {
+    case NoiseFractalType::eFRACTAL_RIDGED:
+      noise = _mm_sub_ps(_mm_set1_ps(1.0f), _mm_and_ps(noise, absMask));
+      return _mm_mul_ps(noise, noise);
+    case NoiseFractalType::eFRACTAL_BILLOW:
+      return _mm_sub_ps(_mm_mul_ps(_mm_and_ps(noise, absMask), _mm_set1_ps(2.0f)), _mm_set1_ps(1.0f));
+    case NoiseFractalType::eFRACTAL_FBM:
+    default:
+      return noise;
+  }
+}
+
+YEAGER_SIMD_TARGET("sse4.1")
+void GradientNoise::FractalBatchSSE41(const float* x, const float* y, const NoiseFractalSettings& settings,
+                                      float* output) const
+{
+  for (int group = 0; group < YEAGER_NOISE_BATCH; group += 4) {
+    const __m128 px = _mm_loadu_ps(x + group);
+    const __m128 py = _mm_loadu_ps(y + group);
+    __m128 sum = _mm_setzero_ps();
+    float amplitude = 1.0f;
+    float amplitudeSum = 0.0f;
+    float frequency = settings.Frequency;
+    for (int octave = 0; octave < settings.Octaves; octave++) {
+      const __m128 f = _mm_set1_ps(frequency);
+      const __m128 noise = ShapeOctaveSSE41(SampleSSE41(m_Permutation, _mm_mul_ps(px, f), _mm_mul_ps(py, f)),
+                                            settings.Type);
+      sum = _mm_add_ps(sum, _mm_mul_ps(noise, _mm_set1_ps(amplitude)));
+      amplitudeSum += amplitude;
+      amplitude *= settings.Gain;
+      frequency *= settings.Lacunarity;
+    }
+    const __m128 result = amplitudeSum > 0.0f ? _mm_div_ps(sum, _mm_set1_ps(amplitudeSum)) : _mm_setzero_ps();
+    _mm_storeu_ps(output + group, result);
+  }
+}
+
+/* AVX2 path, the 8 lanes at once with the table lookups done by gathers */
+YEAGER_SIMD_TARGET("avx2")
+static __m256 SimplexCornersAVX2(__m256 x, __m256 y, __m256i gradient)
+{
+  const __m256 gradientX = _mm256_permutevar8x32_ps(_mm256_load_ps(sGradientX), gradient);
+  const __m256 gradientY = _mm256_permutevar8x32_ps(_mm256_load_ps(sGradientY), gradient);
+
+  __m256 t = _mm256_sub_ps(_mm256_sub_ps(_mm256_set1_ps(0.5f), _mm256_mul_ps(x, x)), _mm256_mul_ps(y, y));
+  const __m256 inside = _mm256_cmp_ps(t, _mm256_setzero_ps(), _CMP_GE_OQ);
+  t = _mm256_mul_ps(t, t);
+  const __m256 dot = _mm256_add_ps(_mm256_mul_ps(gradientX, x), _mm256_mul_ps(gradientY, y));
+  return _mm256_and_ps(inside, _mm256_mul_ps(_mm256_mul_ps(t, t), dot));
+}
+
+YEAGER_SIMD_TARGET("avx2")
+static __m256i LookupAVX2(const int32_t* table, __m256i index)
+{
+  return _mm256_i32gather_epi32(table, index, 4);
+}
+
+YEAGER_SIMD_TARGET("avx2")
+static __m256 SampleAVX2(const int32_t* permutation, __m256 x, __m256 y)
+{
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const __m256 s = _mm256_mul_ps(_mm256_add_ps(x, y), _mm256_set1_ps(sF2));
+  const __m256 fi = _mm256_floor_ps(_mm256_add_ps(x, s));
+  const __m256 fj = _mm256_floor_ps(_mm256_add_ps(y, s));
+  const __m256 t = _mm256_mul_ps(_mm256_add_ps(fi, fj), _mm256_set1_ps(sG2));
+  const __m256 x0 = _mm256_sub_ps(x, _mm256_sub_ps(fi, t));
+  const __m256 y0 = _mm256_sub_ps(y, _mm256_sub_ps(fj, t));
+
+  const __m256 i1 = _mm256_and_ps(_mm256_cmp_ps(x0, y0, _CMP_GT_OQ), one);
+  const __m256 j1 = _mm256_sub_ps(one, i1);
+  const __m256 x1 = _mm256_add_ps(_mm256_sub_ps(x0, i1), _mm256_set1_ps(sG2));
+  const __m256 y1 = _mm256_add_ps(_mm256_sub_ps(y0, j1), _mm256_set1_ps(sG2));
+  const __m256 x2 = _mm256_add_ps(x0, _mm256_set1_ps(sG2TimesTwoMinusOne));
+  const __m256 y2 = _mm256_add_ps(y0, _mm256_set1_ps(sG2TimesTwoMinusOne));
+
+  const __m256i mask = _mm256_set1_epi32(255);
+  const __m256i ii = _mm256_and_si256(_mm256_cvttps_epi32(fi), mask);
+  const __m256i jj = _mm256_and_si256(_mm256_cvttps_epi32(fj), mask);
+  const __m256i oneInt = _mm256_set1_epi32(1);
+  const __m256i seven = _mm256_set1_epi32(7);
+  const __m256i offsetI = _mm256_cvttps_epi32(i1);
+  const __m256i offsetJ = _mm256_cvttps_epi32(j1);
+
+  const __m256i g0 =
+      _mm256_and_si256(LookupAVX2(permutation, _mm256_add_epi32(ii, LookupAVX2(permutation, jj))), seven);
+  const __m256i g1 = _mm256_and_si256(
+      LookupAVX2(permutation, _mm256_add_epi32(_mm256_add_epi32(ii, offsetI),
+                                                LookupAVX2(permutation, _mm256_add_epi32(jj, offsetJ)))),
+      seven);
+  const __m256i g2 = _mm256_and_si256(
+      LookupAVX2(permutation, _mm256_add_epi32(_mm256_add_epi32(ii, oneInt),
+                                                LookupAVX2(permutation, _mm256_add_epi32(jj, oneInt)))),
+      seven);
+
+  const __m256 n0 = SimplexCornersAVX2(x0, y0, g0);
+  const __m256 n1 = SimplexCornersAVX2(x1, y1, g1);
+  const __m256 n2 = SimplexCornersAVX2(x2, y2, g2);
+  return _mm256_mul_ps(_mm256_set1_ps(sNoiseScale), _mm256_add_ps(_mm256_add_ps(n0, n1), n2));
+}
+
+YEAGER_SIMD_TARGET("avx2")
+static __m256 ShapeOctaveAVX2(__m256 noise, NoiseFractalType::Enum type)
+{
+  const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+  switch (type) {
+    case NoiseFractalType::eFRACTAL_RIDGED:
+      noise = _mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_and_ps(noise, absMask));
+      return _mm256_mul_ps(noise, noise);
+    case NoiseFractalType::eFRACTAL_BILLOW:
+      return _mm256_sub_ps(_mm256_mul_ps(_mm256_and_ps(noise, absMask), _mm256_set1_ps(2.0f)), _mm256_set1_ps(1.0f));
+    case NoiseFractalType::eFRACTAL_FBM:
+    default:
+      return noise;
+  }
+}
+
+YEAGER_SIMD_TARGET("avx2")
+void GradientNoise::FractalBatchAVX2(const float* x, const float* y, const NoiseFractalSettings& settings,
+                                     float* output) const
+{
+  const __m256 px = _mm256_loadu_ps(x);
+  const __m256 py = _mm256_loadu_ps(y);
+  __m256 sum = _mm256_setzero_ps();
+  float amplitude = 1.0f;
+  float amplitudeSum = 0.0f;
+  float frequency = settings.Frequency;
+  for (int octave = 0; octave < settings.Octaves; octave++) {
+    const __m256 f = _mm256_set1_ps(frequency);
+    const __m256 noise =
+        ShapeOctaveAVX2(SampleAVX2(m_Permutation, _mm256_mul_ps(px, f), _mm256_mul_ps(py, f)), settings.Type);
+    sum = _mm256_add_ps(sum, _mm256_mul_ps(noise, _mm256_set1_ps(amplitude)));
+    amplitudeSum += amplitude;
+    amplitude *= settings.Gain;
+    frequency *= settings.Lacunarity;
+  }
+  const __m256 result = amplitudeSum > 0.0f ? _mm256_div_ps(sum, _mm256_set1_ps(amplitudeSum)) : _mm256_setzero_ps();
+  _mm256_storeu_ps(output, result);
+}
+
+#else
+
+void GradientNoise::FractalBatchSSE41(const float* x, const float* y, const NoiseFractalSettings& settings,
+                                      float* output) const
+{
+  FractalBatchScalar(x, y, settings, output);
+}
+
+void GradientNoise::FractalBatchAVX2(const float* x, const float* y, const NoiseFractalSettings& settings,
+                                     float* output) const
+{
+  FractalBatchScalar(x, y, settings, output);
+}
+
+#endif
+
+void GradientNoise::FractalBatch(const float* x, const float* y, const NoiseFractalSettings& settings,
+                                 float* output) const
+{
+  switch (m_Path) {
+    case NoiseSIMDPath::eSIMD_AVX2:
+      FractalBatchAVX2(x, y, settings, output);
+      break;
+    case NoiseSIMDPath::eSIMD_SSE41:
+      FractalBatchSSE41(x, y, settings, output);
+      break;
+    case NoiseSIMDPath::eSIMD_SCALAR:
+    default:
+      FractalBatchScalar(x, y, settings, output);
+  }
+}
+
+void GradientNoise::SampleBatch(const float* x, const float* y, float* output) const
+{
+  /* A single fBm octave at frequency one is the raw sample, the division by the amplitude sum of 1 is exact */
+  NoiseFractalSettings settings;
+  settings.Octaves = 1;
+  settings.Frequency = 1.0f;
+  FractalBatch(x, y, settings, output);
+}
+
+void GradientNoise::FillRow(float* output, int x, int y, int count, const NoiseFractalSettings& settings,
+                            float amplitude, float offset) const
+{
+  alignas(32) float px[YEAGER_NOISE_BATCH], py[YEAGER_NOISE_BATCH], values[YEAGER_NOISE_BATCH];
+  for (int lane = 0; lane < YEAGER_NOISE_BATCH; lane++) {
+    py[lane] = static_cast<float>(y);
+  }
+
+  int done = 0;
+  for (; done + YEAGER_NOISE_BATCH <= count; done += YEAGER_NOISE_BATCH) {
+    for (int lane = 0; lane < YEAGER_NOISE_BATCH; lane++) {
+      px[lane] = static_cast<float>(x + done + lane);
+    }
+    FractalBatch(px, py, settings, values);
+    for (int lane = 0; lane < YEAGER_NOISE_BATCH; lane++) {
+      output[done + lane] = values[lane] * amplitude + offset;
+    }
+  }
+
+  for (; done < count; done++) {
+    output[done] = Fractal(static_cast<float>(x + done), static_cast<float>(y), settings) * amplitude + offset;
+  }
+}
+
+void GradientNoise::FillArray2D(Math::Array2D<float>* array, int beginX, int beginY, int width, int height,
+                                const NoiseFractalSettings& settings, float amplitude, float offset,
+                                WorkerPool* pool) const
+{
+  pool->ParallelFor(0, height, 8, [&](size_t begin, size_t end) {
+    /* Linear rows are filled in place, the tiled layout has no contiguous rows so they are filled in a scratch row and
+     * stored element by element */
+    std::vector<float> scratch(array->IsLinear() ? 0 : width);
+    for (int row = begin; row < static_cast<int>(end); row++) {
+      float* output = array->IsLinear() ? array->GetAddress(beginX, beginY + row) : scratch.data();
+      FillRow(output, beginX, beginY + row, width, settings, amplitude, offset);
+      for (int x = 0; x < width && !array->IsLinear(); x++) {
+        array->Set(beginX + x, beginY + row, scratch[x]);
+      }
+    }
+  });
+}
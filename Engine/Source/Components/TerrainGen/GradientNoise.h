@@ -0,0 +1,106 @@
+//    Yeager Engine, free and open source 3D/2D renderer written in OpenGL
+//    In case of questions and bugs, please, refer to the issue tab on github
+//    Repo : https://github.com/schwq/YeagerEngine
+//    Copyright (C) 2023 - Present
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Common/Math/Mathematics.h"
+#include "Common/Utils/Common.h"
+#include "Common/Utils/LogEngine.h"
+#include "Common/Utils/Utilities.h"
+#include "Components/Kernel/Process/WorkerPool.h"
+
+namespace Yeager {
+
+/** Samples evaluated by a single call of the batch functions, the width of a AVX2 register */
+#define YEAGER_NOISE_BATCH 8
+
+struct NoiseFractalType {
+  enum Enum { eFRACTAL_FBM, eFRACTAL_RIDGED, eFRACTAL_BILLOW };
+  YEAGER_ENUM_TO_STRING(NoiseFractalType)
+};
+
+struct NoiseSIMDPath {
+  enum Enum { eSIMD_SCALAR, eSIMD_SSE41, eSIMD_AVX2 };
+  YEAGER_ENUM_TO_STRING(NoiseSIMDPath)
+};
+
+/// @brief Octaves summed by the fractal functions, each octave multiplies the frequency by the lacunarity and the amplitude by the gain
+struct NoiseFractalSettings {
+  NoiseFractalType::Enum Type = NoiseFractalType::eFRACTAL_FBM;
+  int Octaves = 5;
+  float Frequency = 1.0f / 64.0f;
+  float Lacunarity = 2.0f;
+  float Gain = 0.5f;
+};
+
+/**
+ * @brief Seedable 2D simplex gradient noise. The permutation table is built from the seed with a fixed generator, so
+ * the same seed gives the same values in every platform and thread. The object is read only after SetSeed and can be
+ * sampled by many threads at once.
+ * The SIMD paths (SSE4.1 and AVX2, chosen at runtime) do the same float operations in the same order of the scalar
+ * path and return the same values bit by bit
+ */
+class GradientNoise {
+ public:
+  explicit GradientNoise(uint64_t seed = 0);
+
+  void SetSeed(uint64_t seed);
+  YEAGER_NODISCARD uint64_t GetSeed() const { return m_Seed; }
+
+  /** Single sample, in the range [-1, 1] */
+  YEAGER_NODISCARD float Sample(float x, float y) const;
+
+  /** fBm and billow are in the range [-1, 1], ridged in [0, 1] */
+  YEAGER_NODISCARD float Fractal(float x, float y, const NoiseFractalSettings& settings) const;
+
+  /** YEAGER_NOISE_BATCH samples per call, with the best path supported by the hardware */
+  void SampleBatch(const float* x, const float* y, float* output) const;
+  void FractalBatch(const float* x, const float* y, const NoiseFractalSettings& settings, float* output) const;
+
+  /**
+   * @brief Fills count consecutive samples of a row, starting at the grid position (x, y). The fractal frequency
+   * converts the grid position to noise space, the output is noise * amplitude + offset
+   */
+  void FillRow(float* output, int x, int y, int count, const NoiseFractalSettings& settings, float amplitude = 1.0f,
+               float offset = 0.0f) const;
+
+  /**
+   * @brief Fills the region [beginX, beginX + width) x [beginY, beginY + height) of the array, the rows are split
+   * between the workers of the pool
+   */
+  void FillArray2D(Math::Array2D<float>* array, int beginX, int beginY, int width, int height,
+                   const NoiseFractalSettings& settings, float amplitude = 1.0f, float offset = 0.0f,
+                   WorkerPool* pool = WorkerPool::GetGlobal()) const;
+
+  /** Forces a path, the benchmark uses it to compare them. Paths not supported by the hardware are ignored */
+  void SetSIMDPath(NoiseSIMDPath::Enum path);
+  YEAGER_NODISCARD NoiseSIMDPath::Enum GetSIMDPath() const { return m_Path; }
+  static NoiseSIMDPath::Enum GetBestSIMDPath();
+
+ private:
+  void FractalBatchScalar(const float* x, const float* y, const NoiseFractalSettings& settings, float* output) const;
+  void FractalBatchSSE41(const float* x, const float* y, const NoiseFractalSettings& settings, float* output) const;
+  void FractalBatchAVX2(const float* x, const float* y, const NoiseFractalSettings& settings, float* output) const;
+
+  uint64_t m_Seed = 0;
+  /* Doubled so the lookups of the corners never wrap */
+  alignas(32) int32_t m_Permutation[512] = {};
+  NoiseSIMDPath::Enum m_Path = NoiseSIMDPath::eSIMD_SCALAR;
+};
+
+}  // namespace Yeager
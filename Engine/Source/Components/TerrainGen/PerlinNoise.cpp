@@ -1,5 +1,8 @@
 #include "PerlinNoise.h"
 #include "Components/Kernel/Memory/Allocator.h"
+#include "TerrainHeightMap.h"
+
+#include <random>
 
 using namespace Yeager;
 
@@ -7,16 +10,10 @@ PerlinNoise::PerlinNoise(int width, int lenght)
 {
   m_Width = width;
   m_Lenght = lenght;
-  m_Seed = BaseAllocator::Allocate<float>(m_Width * m_Lenght);
-  m_Noise = BaseAllocator::Allocate<float>(m_Lenght * m_Width);
   RegenerateSeed();
 }
 
-PerlinNoise::~PerlinNoise()
-{
-  BaseAllocator::Deallocate(m_Seed);
-  BaseAllocator::Deallocate(m_Noise);
-}
+PerlinNoise::~PerlinNoise() {}
 
 void PerlinNoise::GeneratePerlin(Yeager::Math::Array2D<float>* arr, int octaves, int bias, int width, int height,
                                  float max_height, bool regenerate_seed)
@@ -28,7 +25,10 @@ void PerlinNoise::GeneratePerlin(Yeager::Math::Array2D<float>* arr, int octaves,
   m_Width = width;
   m_Lenght = height;
 
-  PerlinNoise2D(m_Width, m_Lenght, m_Seed, octaves, bias, m_Noise);
+  m_OctaveCount = octaves;
+  m_ScallingBias = bias;
+  m_Noise.resize(m_Width * m_Lenght);
+  PerlinNoise2D(m_Width, m_Lenght, octaves, bias, m_Noise.data());
   for (int x = 0; x < m_Width; x++) {
     for (int y = 0; y < m_Lenght; y++) {
       arr->At(x, y) = m_Noise[m_Width * y + x] * max_height;
@@ -39,63 +39,45 @@ void PerlinNoise::GeneratePerlin(Yeager::Math::Array2D<float>* arr, int octaves,
 bool PerlinNoise::SavePerlinNoiseMapToFile(Cchar path)
 {
   if (Generated) {
-    std::ofstream fl;
-    fl.open(path, std::ofstream::out | std::ofstream::binary);
-    if (fl.is_open()) {
-      for (int x = 0; x < m_Width; x++) {
-        for (int y = 0; y < m_Lenght; y++) {
-          fl << m_Noise[m_Width * y + x] << ' ';
-        }
-      }
-      return true;
-      fl.close();
-    } else {
+    /* The noise in [0, 1] as a binary heightmap, see TerrainHeightMapFile */
+    TerrainHeightMapInfo info;
+    info.Width = m_Width;
+    info.Height = m_Lenght;
+    info.MinHeight = 0.0f;
+    info.MaxHeight = 1.0f;
+    info.Seed = GetSeed();
+    if (!TerrainHeightMapFile::Write(path, m_Noise.data(), info)) {
       Yeager::Log(WARNING, "Cannot open file to save perlin noise! [{}]", path);
       return false;
     }
+    return true;
   } else {
     Yeager::Log(WARNING, "Perlin noise isnt generated yet! Cannot save to file!");
     return false;
   }
 }
 
-void PerlinNoise::PerlinNoise2D(int width, int height, float* seed, int octaves, float bias, float* output)
+void PerlinNoise::PerlinNoise2D(int width, int height, int octaves, float bias, float* output)
 {
-  for (int x = 0; x < width; x++) {
-    for (int y = 0; y < height; y++) {
-      float fNoise = 0.0f;
-      float fScaleAcc = 0.0f;
-      float fScale = 1.0f;
-
-      for (int oc = 0; oc < m_OctaveCount; oc++) {
-        int nPitch = m_Width >> oc;
-        int nSampleX1 = (x / nPitch) * nPitch;
-        int nSampleY1 = (y / nPitch) * nPitch;
-
-        int nSampleX2 = (nSampleX1 + nPitch) % width;
-        int nSampleY2 = (nSampleY1 + nPitch) % width;
+  /* The first octave spans the whole map, like the widest pitch of the old value noise */
+  NoiseFractalSettings settings;
+  settings.Type = NoiseFractalType::eFRACTAL_FBM;
+  settings.Octaves = octaves;
+  settings.Frequency = 1.0f / static_cast<float>(std::max(width, height));
+  settings.Gain = bias != 0.0f ? 1.0f / bias : 0.5f;
 
-        float fBlendX = (float)(x - nSampleX1) / (float)nPitch;
-        float fBlendY = (float)(y - nSampleY1) / (float)nPitch;
-
-        float fSampleT =
-            (1.0f - fBlendX) * m_Seed[nSampleY1 * width + nSampleX1] + fBlendX * m_Seed[nSampleY1 * width + nSampleX2];
-        float fSampleB =
-            (1.0f - fBlendX) * m_Seed[nSampleY2 * width + nSampleX1] + fBlendX * m_Seed[nSampleY2 * width + nSampleX2];
-
-        fScaleAcc += fScale;
-        fNoise += (fBlendY * (fSampleB - fSampleT) + fSampleT) * fScale;
-        fScale = fScale / bias;
-      }
-
-      output[y * width + x] = fNoise / fScaleAcc;
+  /* fBm is in [-1, 1], mapped to [0, 1] */
+  WorkerPool::GetGlobal()->ParallelFor(0, height, 8, [&](size_t begin, size_t end) {
+    for (int y = begin; y < static_cast<int>(end); y++) {
+      m_Gradient.FillRow(output + y * width, 0, y, width, settings, 0.5f, 0.5f);
     }
-  }
+  });
 }
 
-constexpr void PerlinNoise::RegenerateSeed() noexcept
+void PerlinNoise::RegenerateSeed()
 {
-  for (int x = 0; x < m_Lenght * m_Width; x++) {
-    m_Seed[x] = (float)rand() / (float)RAND_MAX;
-  }
+  std::random_device device;
+  const uint64_t seed = (static_cast<uint64_t>(device()) << 32) | device();
+  m_Gradient.SetSeed(seed);
+  Yeager::LogDebug(INFO, "Terrain noise seed regenerated: {}", seed);
 }
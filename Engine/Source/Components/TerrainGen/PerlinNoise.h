@@ -22,24 +22,37 @@
 #include "Common/Utils/Common.h"
 #include "Common/Utils/LogEngine.h"
 #include "Common/Utils/Utilities.h"
+#include "GradientNoise.h"
 
 namespace Yeager {
+
+/**
+ * @brief Noise of the procedural terrains, the heightmap is a fBm of the seedable GradientNoise. The same seed always
+ * generates the same terrain, RegenerateSeed picks a new one and logs it so the terrain can be generated again
+ */
 class PerlinNoise {
  public:
   PerlinNoise(int width = 256, int lenght = 256);
   ~PerlinNoise();
 
+  /**
+   * @brief Fills the array with the noise in the range [0, max_height], octaves and bias are the octaves of the fBm and
+   * the ratio between the amplitude of two octaves (each octave has 1 / bias of the previous amplitude)
+   */
   void GeneratePerlin(Yeager::Math::Array2D<float>* arr, int octaves, int bias, int width, int height, float max_height,
                       bool regenerate_seed = false);
-  void PerlinNoise2D(int width, int height, float* seed, int octaves, float bias, float* output);
+  void PerlinNoise2D(int width, int height, int octaves, float bias, float* output);
   constexpr void ChangeSize(int width, int height) noexcept
   {
     m_Lenght = height;
     m_Width = width;
   }
-  constexpr void RegenerateSeed() noexcept;
+  void RegenerateSeed();
+  void SetSeed(uint64_t seed) { m_Gradient.SetSeed(seed); }
+  /** Saves the noise in [0, 1] as a binary heightmap with the seed, see TerrainHeightMapFile */
   bool SavePerlinNoiseMapToFile(Cchar path);
-  YEAGER_NODISCARD inline float* GetSeed() noexcept { return m_Seed; }
+  YEAGER_NODISCARD inline uint64_t GetSeed() const noexcept { return m_Gradient.GetSeed(); }
+  YEAGER_NODISCARD inline const GradientNoise* GetGradientNoise() const noexcept { return &m_Gradient; }
   constexpr inline int GetOctaveCount() noexcept { return m_OctaveCount; }
   constexpr inline Vector2 GetSize() noexcept { return Vector2(m_Width, m_Lenght); }
   constexpr inline bool GetIsGenerated() noexcept { return Generated; }
@@ -48,8 +61,8 @@ class PerlinNoise {
   bool Generated = false;
   int m_Width = 256;
   int m_Lenght = 256;
-  float* m_Seed = YEAGER_NULLPTR;
-  float* m_Noise = YEAGER_NULLPTR;
+  GradientNoise m_Gradient;
+  std::vector<float> m_Noise;
   int m_OctaveCount = 5;
   float m_ScallingBias = 5.0f;
 };
@@ -1,7 +1,35 @@
 #include "ProceduralTerrain.h"
+#include "Components/Kernel/Hardware/HardwareInfo.h"
 #include "Components/Kernel/Memory/Allocator.h"
 using namespace Yeager;
 
+#ifdef YEAGER_SIMD_SSE2
+#include <immintrin.h>
+#endif
+
+/* SplitMix64, the random values of the generators only depend on the seed and what is hashed with it */
+static YEAGER_FORCE_INLINE uint64_t MixBits(uint64_t value)
+{
+  value += 0x9E3779B97F4A7C15ULL;
+  value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+  return value ^ (value >> 31);
+}
+
+/* Uniform value in [0, 1) from the top 24 bits of the hash */
+static YEAGER_FORCE_INLINE float HashToUnitFloat(uint64_t hash)
+{
+  return static_cast<float>(hash >> 40) * (1.0f / 16777216.0f);
+}
+
+/* Value in [-1, 1) of a sample at a level of the midpoint displacement, salt tells apart the values of the same cell */
+static YEAGER_FORCE_INLINE float RandomCellValue(uint64_t seed, int level, int salt, int x, int y)
+{
+  const uint64_t key = (static_cast<uint64_t>(level) << 34) ^ (static_cast<uint64_t>(salt) << 56) ^
+                       (static_cast<uint64_t>(y) << 17) ^ static_cast<uint64_t>(x);
+  return HashToUnitFloat(MixBits(seed ^ MixBits(key))) * 2.0f - 1.0f;
+}
+
 ProceduralTerrain::ProceduralTerrain(std::vector<String> TexturesPaths, int TerrainChunkPositionX,
                                      int TerrainChunkPositionY)
 {
@@ -40,7 +68,51 @@ void ProceduralTerrain::GenerateTerrain(Shader* shader, int octaves, int bias, b
 
 float ProceduralTerrain::GetHeightInterpolated(float x, float z) const
 {
-  return 0;
+  if (!m_HeightField.IsBuilt()) {
+    return 0;
+  }
+  const Vector3 translation = Vector3(GetModelMatrix()[3]);
+  return m_HeightField.SampleHeight(x - translation.x, z - translation.z) + translation.y;
+}
+
+void ProceduralTerrain::GetHeightsInterpolated(const float* x, const float* z, float* heights, size_t count) const
+{
+  if (!m_HeightField.IsBuilt()) {
+    std::fill(heights, heights + count, 0.0f);
+    return;
+  }
+
+  /* The field works in the space of the terrain, the points are moved in small batches to keep them in the cache */
+  const Vector3 translation = Vector3(GetModelMatrix()[3]);
+  float localX[YEAGER_TERRAIN_QUERY_BATCH * 32], localZ[YEAGER_TERRAIN_QUERY_BATCH * 32];
+  for (size_t first = 0; first < count; first += YEAGER_TERRAIN_QUERY_BATCH * 32) {
+    const size_t batch = std::min<size_t>(count - first, YEAGER_TERRAIN_QUERY_BATCH * 32);
+    for (size_t point = 0; point < batch; point++) {
+      localX[point] = x[first + point] - translation.x;
+      localZ[point] = z[first + point] - translation.z;
+    }
+    m_HeightField.SampleHeights(localX, localZ, heights + first, batch);
+    for (size_t point = 0; point < batch; point++) {
+      heights[first + point] += translation.y;
+    }
+  }
+}
+
+bool ProceduralTerrain::Raycast(const Vector3& origin, const Vector3& direction, TerrainRayHit* hit,
+                                float maxDistance) const
+{
+  const Vector3 translation = Vector3(GetModelMatrix()[3]);
+  TerrainRay ray;
+  ray.Origin = origin - translation;
+  ray.Direction = direction;
+  ray.MaxDistance = maxDistance;
+  if (!m_HeightField.Raycast(ray, hit)) {
+    return false;
+  }
+  if (hit) {
+    hit->Position += translation;
+  }
+  return true;
 }
 
 void TerrainVertex::InitVertex(ProceduralTerrain* Terrain, int x, int z)
@@ -53,6 +125,139 @@ void TerrainVertex::InitVertex(ProceduralTerrain* Terrain, int x, int z)
   TexCoords = Vector2(TextureScale * (float)x / Size, TextureScale * (float)z / Size);
 }
 
+size_t TerrainMeshBuilder::CalculateBandRows(int rows, WorkerPool* pool)
+{
+  /* A few bands per thread keeps the workers busy when some bands finish earlier */
+  return std::max<size_t>(16, rows / (pool->GetConcurrency() * 4));
+}
+
+void TerrainMeshBuilder::Build(const TerrainMeshBuildDesc& desc, std::vector<TerrainVertex>* vertices,
+                               std::vector<GLuint>* indices, WorkerPool* pool)
+{
+  const int width = desc.Width;
+  const int height = desc.Height;
+  vertices->resize(width * height);
+  indices->resize(std::max(0, width - 1) * std::max(0, height - 1) * 6);
+
+  /* The vertices are stored column by column, the indices and normals read them row by row (width as stride) */
+  pool->ParallelFor(0, width, CalculateBandRows(width, pool), [&](size_t begin, size_t end) {
+    BuildVertices(desc, vertices->data(), begin, end, 0, height);
+  });
+  pool->ParallelFor(0, std::max(0, height - 1), CalculateBandRows(height, pool), [&](size_t begin, size_t end) {
+    BuildIndices(desc, indices->data(), begin, end);
+  });
+  pool->ParallelFor(0, height, CalculateBandRows(height, pool), [&](size_t begin, size_t end) {
+    BuildNormals(desc, vertices->data(), begin, end, 0, width);
+  });
+}
+
+TerrainDirtyRect TerrainMeshBuilder::UpdateRegion(const TerrainMeshBuildDesc& desc, const TerrainDirtyRect& rect,
+                                                  std::vector<TerrainVertex>* vertices, WorkerPool* pool)
+{
+  if (rect.IsEmpty()) {
+    return rect;
+  }
+
+  /* The normal of a vertex sums the faces around it, so the ring of vertices around the rect changes as well. The
+   * vertices are stored column by column, the rows of the normals pass are the columns of the heightmap */
+  const TerrainDirtyRect ring = rect.Expanded(1, desc.Width, desc.Height);
+  const int rows = ring.MaxX - ring.MinX + 1;
+  pool->ParallelFor(rect.MinX, rect.MaxX + 1, CalculateBandRows(rows, pool), [&](size_t begin, size_t end) {
+    BuildVertices(desc, vertices->data(), begin, end, rect.MinZ, rect.MaxZ + 1);
+  });
+  pool->ParallelFor(ring.MinX, ring.MaxX + 1, CalculateBandRows(rows, pool), [&](size_t begin, size_t end) {
+    BuildNormals(desc, vertices->data(), begin, end, ring.MinZ, ring.MaxZ + 1);
+  });
+  return ring;
+}
+
+void TerrainMeshBuilder::BuildVertices(const TerrainMeshBuildDesc& desc, TerrainVertex* vertices, int beginX, int endX,
+                                       int beginY, int endY)
+{
+  for (int x = beginX; x < endX; x++) {
+    for (int y = beginY; y < endY; y++) {
+      TerrainVertex& vertex = vertices[x * desc.Height + y];
+      vertex.Position = Vector3(x * desc.WorldScale, desc.HeightMap->At(x, y), y * desc.WorldScale);
+      vertex.TexCoords = Vector2(desc.TextureScale * (float)x / desc.Size, desc.TextureScale * (float)y / desc.Size);
+    }
+  }
+}
+
+void TerrainMeshBuilder::BuildIndices(const TerrainMeshBuildDesc& desc, GLuint* indices, int beginZ, int endZ)
+{
+  const int width = desc.Width;
+  for (int z = beginZ; z < endZ; z++) {
+    GLuint* quad = indices + static_cast<size_t>(z) * (width - 1) * 6;
+    for (int x = 0; x < width - 1; x++, quad += 6) {
+      Uint IndexBottomLeft = z * width + x;
+      Uint IndexTopLeft = (z + 1) * width + x;
+      Uint IndexTopRight = (z + 1) * width + x + 1;
+      Uint IndexBottomRight = z * width + x + 1;
+      quad[0] = IndexBottomLeft;
+      quad[1] = IndexTopLeft;
+      quad[2] = IndexTopRight;
+      quad[3] = IndexBottomLeft;
+      quad[4] = IndexTopRight;
+      quad[5] = IndexBottomRight;
+    }
+  }
+}
+
+void TerrainMeshBuilder::BuildNormals(const TerrainMeshBuildDesc& desc, TerrainVertex* vertices, int beginZ, int endZ,
+                                      int beginX, int endX)
+{
+  const int width = desc.Width;
+  const int quadsX = width - 1;
+  const int quadsZ = desc.Height - 1;
+
+  /* First pass, the two face normals of every quad touching the vertices of the band */
+  const int firstQuadRow = std::max(0, beginZ - 1);
+  const int lastQuadRow = std::min(endZ, quadsZ);
+  const int firstQuadColumn = std::max(0, beginX - 1);
+  const int lastQuadColumn = std::min(endX, quadsX);
+  const int faceColumns = std::max(0, lastQuadColumn - firstQuadColumn);
+  std::vector<Vector3> faces(std::max(0, lastQuadRow - firstQuadRow) * faceColumns * 2);
+  auto position = [&](int z, int x) -> const Vector3& { return vertices[z * width + x].Position; };
+  auto face = [&](int z, int x, int triangle) -> Vector3& {
+    return faces[((z - firstQuadRow) * faceColumns + x - firstQuadColumn) * 2 + triangle];
+  };
+
+  for (int z = firstQuadRow; z < lastQuadRow; z++) {
+    for (int x = firstQuadColumn; x < lastQuadColumn; x++) {
+      const Vector3& BottomLeft = position(z, x);
+      const Vector3& TopLeft = position(z + 1, x);
+      const Vector3& TopRight = position(z + 1, x + 1);
+      const Vector3& BottomRight = position(z, x + 1);
+      face(z, x, 0) = glm::normalize(glm::cross(TopLeft - BottomLeft, TopRight - BottomLeft));
+      face(z, x, 1) = glm::normalize(glm::cross(TopRight - BottomLeft, BottomRight - BottomLeft));
+    }
+  }
+
+  /* Second pass, each vertex sums the faces around it in the order of the index buffer, no two bands write the same
+   * vertex. A vertex is the top right of the quad (z - 1, x - 1), top left of (z - 1, x), bottom right of (z, x - 1)
+   * and bottom left of (z, x) */
+  for (int z = beginZ; z < endZ; z++) {
+    for (int x = beginX; x < endX; x++) {
+      Vector3 normal(0.0f);
+      if (z > 0 && x > 0) {
+        normal += face(z - 1, x - 1, 0);
+        normal += face(z - 1, x - 1, 1);
+      }
+      if (z > 0 && x < quadsX) {
+        normal += face(z - 1, x, 0);
+      }
+      if (z < quadsZ && x > 0) {
+        normal += face(z, x - 1, 1);
+      }
+      if (z < quadsZ && x < quadsX) {
+        normal += face(z, x, 0);
+        normal += face(z, x, 1);
+      }
+      vertices[z * width + x].Normals = glm::normalize(normal);
+    }
+  }
+}
+
 void ProceduralTerrain::Setup()
 {
   m_DrawData.Renderer.GenBuffers();
@@ -68,86 +273,211 @@ void ProceduralTerrain::Setup()
   m_DrawData.Renderer.VertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(TerrainVertex),
                                           (const void*)offsetof(TerrainVertex, Normals));
 
-  int v_index = 0;
-  m_DrawData.Vertices.resize(m_MetricData.m_Width * m_MetricData.m_Height);
-  for (int x = 0; x < m_MetricData.m_Width; x++) {
-    for (int y = 0; y < m_MetricData.m_Height; y++) {
-      m_DrawData.Vertices[v_index].InitVertex(this, x, y);
-      v_index++;
+  TerrainMeshBuilder::Build(GetMeshBuildDesc(), &m_DrawData.Vertices, &m_DrawData.Indices);
+
+  /* The vertices go last, the renderer only accepts sub uploads when the last buffer data was dynamic */
+  m_DrawData.Renderer.BufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(m_DrawData.Indices[0]) * m_DrawData.Indices.size(),
+                                 &m_DrawData.Indices[0], GL_STATIC_DRAW);
+  m_DrawData.Renderer.BufferData(GL_ARRAY_BUFFER, sizeof(m_DrawData.Vertices[0]) * m_DrawData.Vertices.size(),
+                                 &m_DrawData.Vertices[0], GL_DYNAMIC_DRAW);
+
+  m_DrawData.Renderer.UnbindVertexArray();
+
+  m_Editor.SetHeightMap(m_MetricData.m_HeightMap.get(), m_MetricData.m_Width, m_MetricData.m_Height,
+                        m_MetricData.m_MinHeight, m_MetricData.m_MaxHeight);
+  m_HeightField.Build(m_MetricData.m_HeightMap.get(), m_MetricData.m_Width, m_MetricData.m_Height, GetWorldScale());
+
+  if (m_LODEnabled) {
+    SetupLOD();
+  }
+}
+
+TerrainMeshBuildDesc ProceduralTerrain::GetMeshBuildDesc() const
+{
+  TerrainMeshBuildDesc desc;
+  desc.HeightMap = m_MetricData.m_HeightMap.get();
+  desc.Width = m_MetricData.m_Width;
+  desc.Height = m_MetricData.m_Height;
+  desc.WorldScale = GetWorldScale();
+  desc.Size = GetSize();
+  desc.TextureScale = GetTextureScale();
+  return desc;
+}
+
+TerrainDirtyRect ProceduralTerrain::ApplyBrush(const TerrainBrush& brush, const Vector3& worldPosition)
+{
+  /* World units to samples of the heightmap, the radius of the brush is given in world units as well */
+  const Vector3 local = worldPosition - Vector3(GetModelMatrix()[3]);
+  TerrainBrush samples = brush;
+  samples.Radius = brush.Radius / GetWorldScale();
+  return m_Editor.ApplyBrush(samples, local.x / GetWorldScale(), local.z / GetWorldScale());
+}
+
+size_t ProceduralTerrain::UpdateDirtyRegions()
+{
+  size_t uploaded = 0;
+  const TerrainMeshBuildDesc desc = GetMeshBuildDesc();
+  for (const auto& rect : m_Editor.TakeDirtyRects()) {
+    const TerrainDirtyRect ring = TerrainMeshBuilder::UpdateRegion(desc, rect, &m_DrawData.Vertices);
+    m_HeightField.UpdateRegion(rect);
+
+    /* Each column of the heightmap is a range of the vertex buffer, a ring as tall as the terrain is a single range */
+    const size_t columnVertices = ring.MaxZ - ring.MinZ + 1;
+    const bool wholeColumns = columnVertices == static_cast<size_t>(m_MetricData.m_Height);
+    const int uploads = wholeColumns ? 1 : ring.MaxX - ring.MinX + 1;
+    const size_t uploadVertices = wholeColumns ? ring.GetArea() : columnVertices;
+    for (int x = 0; x < uploads; x++) {
+      const size_t first = static_cast<size_t>(ring.MinX + x) * m_MetricData.m_Height + ring.MinZ;
+      m_DrawData.Renderer.SubBufferData(GL_ARRAY_BUFFER, sizeof(TerrainVertex) * first,
+                                        sizeof(TerrainVertex) * uploadVertices, &m_DrawData.Vertices[first]);
+      uploaded += sizeof(TerrainVertex) * uploadVertices;
     }
+
+    if (m_LODEnabled) {
+      m_Quadtree.UpdateRegion(rect);
+      m_LODRenderer.UpdateHeightRegion(m_Quadtree, rect);
+      uploaded += sizeof(float) * rect.GetArea();
+    }
+  }
+  return uploaded;
+}
+
+bool ProceduralTerrain::SaveHeightMap(const String& path, const TerrainHeightMapWriteSettings& settings)
+{
+  if (!m_MetricData.m_HeightMap) {
+    Yeager::Log(WARNING, "Cannot save the heightmap of a terrain not generated yet!");
+    return false;
   }
 
-  for (int z = 0; z < m_MetricData.m_Height - 1; z++) {
-    for (int x = 0; x < m_MetricData.m_Width - 1; x++) {
-      Uint IndexBottomLeft = z * m_MetricData.m_Width + x;
-      Uint IndexTopLeft = (z + 1) * m_MetricData.m_Width + x;
-      Uint IndexTopRight = (z + 1) * m_MetricData.m_Width + x + 1;
-      Uint IndexBottomRight = z * m_MetricData.m_Width + x + 1;
-      m_DrawData.Indices.push_back(IndexBottomLeft);
-      m_DrawData.Indices.push_back(IndexTopLeft);
-      m_DrawData.Indices.push_back(IndexTopRight);
-      m_DrawData.Indices.push_back(IndexBottomLeft);
-      m_DrawData.Indices.push_back(IndexTopRight);
-      m_DrawData.Indices.push_back(IndexBottomRight);
+  TerrainHeightMapInfo info;
+  info.Width = m_MetricData.m_Width;
+  info.Height = m_MetricData.m_Height;
+  info.MinHeight = m_MetricData.m_MinHeight;
+  info.MaxHeight = m_MetricData.m_MaxHeight;
+  info.WorldScale = GetWorldScale();
+  info.TextureScale = GetTextureScale();
+  info.TerrainSize = GetSize();
+  info.Seed = m_Perlin.GetSeed();
+
+  const Yeager::Math::Array2D<float>* heightMap = m_MetricData.m_HeightMap.get();
+  if (heightMap->IsPacked()) {
+    return TerrainHeightMapFile::Write(path, heightMap->GetAddress(0, 0), info, settings);
+  }
+  /* Write takes the samples as a single block of rows, pitched and tiled arrays are packed first */
+  std::vector<float> samples(static_cast<size_t>(heightMap->GetCols()) * heightMap->GetRows());
+  for (int z = 0; z < heightMap->GetRows(); z++) {
+    for (int x = 0; x < heightMap->GetCols(); x++) {
+      samples[static_cast<size_t>(z) * heightMap->GetCols() + x] = heightMap->At(x, z);
     }
   }
+  return TerrainHeightMapFile::Write(path, samples.data(), info, settings);
+}
 
-  Uint n_index = 0;
-  for (Uint x = 0; x < m_DrawData.Indices.size(); x += 3) {
-    Uint Index0 = m_DrawData.Indices[x];
-    Uint Index1 = m_DrawData.Indices[x + 1];
-    Uint Index2 = m_DrawData.Indices[x + 2];
-    Vector3 v1 = m_DrawData.Vertices[Index1].Position - m_DrawData.Vertices[Index0].Position;
-    Vector3 v2 = m_DrawData.Vertices[Index2].Position - m_DrawData.Vertices[Index0].Position;
-    Vector3 Normal = glm::cross(v1, v2);
-    Normal = glm::normalize(Normal);
-    m_DrawData.Vertices[Index0].Normals += Normal;
-    m_DrawData.Vertices[Index1].Normals += Normal;
-    m_DrawData.Vertices[Index2].Normals += Normal;
+bool ProceduralTerrain::LoadHeightMap(const String& path)
+{
+  TerrainHeightMapFile file;
+  if (!file.Open(path)) {
+    return false;
   }
 
-  for (Uint x = 0; x < m_DrawData.Vertices.size(); x++) {
-    m_DrawData.Vertices[x].Normals = glm::normalize(m_DrawData.Vertices[x].Normals);
+  const TerrainHeightMapInfo info = file.GetInfo();
+  auto heightMap = BaseAllocator::MakeSharedPtr<Yeager::Math::Array2D<float>>(info.Width, info.Height);
+  if (!file.Read(heightMap.get())) {
+    return false;
   }
 
-  m_DrawData.Renderer.BufferData(GL_ARRAY_BUFFER, sizeof(m_DrawData.Vertices[0]) * m_DrawData.Vertices.size(),
-                                 &m_DrawData.Vertices[0], GL_STATIC_DRAW);
-  m_DrawData.Renderer.BufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(m_DrawData.Indices[0]) * m_DrawData.Indices.size(),
-                                 &m_DrawData.Indices[0], GL_STATIC_DRAW);
+  m_MetricData.m_HeightMap = heightMap;
+  m_MetricData.m_Width = info.Width;
+  m_MetricData.m_Height = info.Height;
+  m_MetricData.m_MinHeight = info.MinHeight;
+  m_MetricData.m_MaxHeight = info.MaxHeight;
+  m_MetricData.WorldScale = info.WorldScale;
+  m_MetricData.m_TerrainSize = info.TerrainSize;
+  m_TextureData.m_TextureScale = info.TextureScale;
+  m_Perlin.SetSeed(info.Seed);
+  Setup();
+  return true;
+}
 
-  m_DrawData.Renderer.UnbindVertexArray();
+Matrix4 ProceduralTerrain::GetModelMatrix() const
+{
+  return glm::translate(Matrix4(1.0f), Vector3(m_MetricData.m_TerrainChunkPositionX * m_MetricData.m_TerrainSize,
+                                               -m_MetricData.m_MaxHeight,
+                                               m_MetricData.m_TerrainChunkPositionY * m_MetricData.m_TerrainSize));
 }
 
-void ProceduralTerrain::Draw(Shader* shader)
+void ProceduralTerrain::SetDrawUniforms(Shader* shader)
 {
   shader->UseShader();
-  Matrix4 model = Matrix4(1.0f);
-
-  model = glm::translate(
-      model, Vector3(m_MetricData.m_TerrainChunkPositionX * m_MetricData.m_TerrainSize, -m_MetricData.m_MaxHeight,
-                     m_MetricData.m_TerrainChunkPositionY * m_MetricData.m_TerrainSize));
-  shader->SetMat4("model", model);
+  shader->SetMat4("model", GetModelMatrix());
+  shader->SetFloat("MinHeight", m_MetricData.m_MinHeight);
+  shader->SetFloat("MaxHeight", m_MetricData.m_MaxHeight);
 
   shader->SetFloat("TextureHeight0", m_TextureData.m_MultiTextureHeights.Height0);
   shader->SetFloat("TextureHeight1", m_TextureData.m_MultiTextureHeights.Height1);
   shader->SetFloat("TextureHeight2", m_TextureData.m_MultiTextureHeights.Height2);
   shader->SetFloat("TextureHeight3", m_TextureData.m_MultiTextureHeights.Height3);
 
-  m_DrawData.Renderer.BindVertexArray();
-
   for (int x = 0; x < MAX_TEXTURE_TILES; x++) {
     glActiveTexture(GL_TEXTURE0 + x);
-    const char* name = ("TerrainTexture" + std::to_string(x)).c_str();
-    shader->SetInt(name, x);
+    shader->SetInt("TerrainTexture" + std::to_string(x), x);
     glBindTexture(GL_TEXTURE_2D, m_TextureData.m_TexturesLoaded[x].GetTextureID());
   }
+}
+
+void ProceduralTerrain::Draw(Shader* shader)
+{
+  SetDrawUniforms(shader);
 
+  m_DrawData.Renderer.BindVertexArray();
   m_DrawData.Renderer.Draw(GL_TRIANGLES, (m_MetricData.m_Height - 1) * (m_MetricData.m_Width - 1) * 6, GL_UNSIGNED_INT,
                            NULL);
   m_DrawData.Renderer.UnbindVertexArray();
   MaterialTexture2D::Unbind2DTextures();
 }
 
+void ProceduralTerrain::EnableLOD(const TerrainLODSettings& settings)
+{
+  m_LODSettings = settings;
+  m_LODEnabled = true;
+  SetupLOD();
+}
+
+void ProceduralTerrain::DisableLOD()
+{
+  m_LODEnabled = false;
+  m_LODRenderer.DeleteBuffers();
+  m_LODSelection.clear();
+}
+
+void ProceduralTerrain::SetupLOD()
+{
+  if (!m_MetricData.m_HeightMap) {
+    Yeager::Log(WARNING, "Terrain level of detail enabled before the terrain was generated!");
+    return;
+  }
+  m_Quadtree.Build(m_MetricData.m_HeightMap.get(), m_MetricData.m_Width, m_MetricData.m_Height, m_LODSettings);
+  m_LODRenderer.Setup(m_Quadtree);
+}
+
+void ProceduralTerrain::DrawLOD(Shader* shader, const Vector3& camera, const Matrix4& projection, float viewportHeight)
+{
+  if (!m_LODEnabled || !m_LODRenderer.IsGenerated()) {
+    return;
+  }
+
+  /* The selection runs in the space of the terrain, before the model matrix */
+  const Vector3 localCamera = Vector3(glm::inverse(GetModelMatrix()) * Vector4(camera, 1.0f));
+  const TerrainLODView view = TerrainLODView::FromProjection(localCamera, projection, viewportHeight);
+  const TerrainLODRanges ranges = m_Quadtree.ComputeRanges(view, GetWorldScale());
+  m_LODSelection.clear();
+  m_Quadtree.Select(view, GetWorldScale(), ranges, &m_LODSelection);
+
+  SetDrawUniforms(shader);
+  m_LODRenderer.Draw(shader, m_Quadtree, m_LODSelection, view, ranges, GetWorldScale(), GetTextureScale(), GetSize());
+  MaterialTexture2D::Unbind2DTextures();
+}
+
 std::vector<Vector3> ProceduralTerrain::GetRandomPointsInTerrain(int amount) noexcept
 {
   std::vector<Vector3> vector;
@@ -187,84 +517,184 @@ void FaultFormationTerrain::CreateFaultFormationTerrain(Shader* shader, int Terr
 
 void FaultFormationTerrain::CreateFaultFormationInternal(int It, int MinHeight, int MaxHeight, float FIR)
 {
+  const std::vector<TerrainFault> Faults =
+      GenerateFaults(m_Perlin.GetSeed(), m_MetricData.m_TerrainSize, It, MinHeight, MaxHeight);
+  ApplyFaults(m_MetricData.m_HeightMap.get(), m_MetricData.m_TerrainSize, Faults);
+  ApplyFilterFIR(FIR);
+}
+
+std::vector<TerrainFault> FaultFormationTerrain::GenerateFaults(uint64_t Seed, int Size, int It, int MinHeight,
+                                                                int MaxHeight)
+{
+  std::vector<TerrainFault> Faults(std::max(It, 0));
   float DeltaHeight = MaxHeight - MinHeight;
+  uint64_t State = Seed;
   for (int CurIt = 0; CurIt < It; CurIt++) {
     float IterationRatio = ((float)CurIt / (float)It);
-    float Height = MaxHeight - IterationRatio * DeltaHeight;
     Vector2 p1, p2;
-    GenerateRandomPoints(p1, p2);
+    GenerateRandomPoints(State, Size, p1, p2);
+    Faults[CurIt] = TerrainFault{(int)p1.x, (int)p1.y, (int)p2.x, (int)p2.y, MaxHeight - IterationRatio * DeltaHeight};
+  }
+  return Faults;
+}
 
-    int DirX = p2.x - p1.x;
-    int DirZ = p2.y - p1.y;
+void FaultFormationTerrain::GenerateRandomPoints(uint64_t& State, int Size, Vector2& p1, Vector2& p2)
+{
+  auto next = [&]() { return static_cast<float>(MixBits(State++) % static_cast<uint64_t>(Size)); };
+  p1.x = next();
+  p1.y = next();
 
-    for (int z = 0; z < m_MetricData.m_TerrainSize; z++) {
-      for (int x = 0; x < m_MetricData.m_TerrainSize; x++) {
-        int DirX_in = x - p1.x;
-        int DirZ_in = z - p1.y;
+  do {
+    p2.x = next();
+    p2.y = next();
+  } while (Size > 1 && p1.x == p2.x && p1.y == p2.y);
+}
 
-        int CrossProduct = DirX_in * DirZ - DirX * DirZ_in;
-        if (CrossProduct > 0) {
-          float CurHeight = m_MetricData.m_HeightMap->At(x, z);
-          m_MetricData.m_HeightMap->Set(x, z, CurHeight + Height);
-        }
-      }
-    }
+/* The cross product of the fault and the sample grows by DirZ per column, starting at Base in the column 0 */
+static void ApplyFaultRowScalar(float* Row, int Begin, int Size, int Base, int DirZ, float Height)
+{
+  for (int x = Begin; x < Size; x++) {
+    const int CrossProduct = Base + x * DirZ;
+    Row[x] = CrossProduct > 0 ? Row[x] + Height : Row[x];
+  }
+}
+
+#ifdef YEAGER_SIMD_SSE2
+
+/* The sum is blended instead of masked, adding a zero would turn the negative zeros positive */
+YEAGER_SIMD_TARGET("sse4.1")
+static int ApplyFaultRowSSE41(float* Row, int Size, int Base, int DirZ, float Height)
+{
+  const __m128i Step = _mm_set1_epi32(DirZ * 4);
+  const __m128 Heights = _mm_set1_ps(Height);
+  __m128i CrossProduct = _mm_add_epi32(_mm_set1_epi32(Base), _mm_mullo_epi32(_mm_setr_epi32(0, 1, 2, 3),
+                                                                              _mm_set1_epi32(DirZ)));
+  int x = 0;
+  for (; x + 4 <= Size; x += 4) {
+    const __m128 Mask = _mm_castsi128_ps(_mm_cmpgt_epi32(CrossProduct, _mm_setzero_si128()));
+    const __m128 Values = _mm_loadu_ps(Row + x);
+    _mm_storeu_ps(Row + x, _mm_blendv_ps(Values, _mm_add_ps(Values, Heights), Mask));
+    CrossProduct = _mm_add_epi32(CrossProduct, Step);
   }
+  return x;
+}
 
-  ApplyFilterFIR(FIR);
+YEAGER_SIMD_TARGET("avx2")
+static int ApplyFaultRowAVX2(float* Row, int Size, int Base, int DirZ, float Height)
+{
+  const __m256i Step = _mm256_set1_epi32(DirZ * 8);
+  const __m256 Heights = _mm256_set1_ps(Height);
+  __m256i CrossProduct = _mm256_add_epi32(
+      _mm256_set1_epi32(Base), _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(DirZ)));
+  int x = 0;
+  for (; x + 8 <= Size; x += 8) {
+    const __m256 Mask = _mm256_castsi256_ps(_mm256_cmpgt_epi32(CrossProduct, _mm256_setzero_si256()));
+    const __m256 Values = _mm256_loadu_ps(Row + x);
+    _mm256_storeu_ps(Row + x, _mm256_blendv_ps(Values, _mm256_add_ps(Values, Heights), Mask));
+    CrossProduct = _mm256_add_epi32(CrossProduct, Step);
+  }
+  return x;
+}
+
+#endif
+
+static void ApplyFaultRow(float* Row, int Size, int z, const TerrainFault& Fault, NoiseSIMDPath::Enum Path)
+{
+  const int DirX = Fault.X2 - Fault.X1;
+  const int DirZ = Fault.Z2 - Fault.Z1;
+  const int Base = -Fault.X1 * DirZ - DirX * (z - Fault.Z1);
+  int Done = 0;
+#ifdef YEAGER_SIMD_SSE2
+  switch (Path) {
+    case NoiseSIMDPath::eSIMD_AVX2:
+      Done = ApplyFaultRowAVX2(Row, Size, Base, DirZ, Fault.Height);
+      break;
+    case NoiseSIMDPath::eSIMD_SSE41:
+      Done = ApplyFaultRowSSE41(Row, Size, Base, DirZ, Fault.Height);
+      break;
+    case NoiseSIMDPath::eSIMD_SCALAR:
+    default:
+      break;
+  }
+#endif
+  ApplyFaultRowScalar(Row, Done, Size, Base, DirZ, Fault.Height);
 }
 
-void FaultFormationTerrain::GenerateRandomPoints(Vector2& p1, Vector2& p2)
+void FaultFormationTerrain::ApplyFaults(Yeager::Math::Array2D<float>* HeightMap, int Size,
+                                        const std::vector<TerrainFault>& Faults, NoiseSIMDPath::Enum Path,
+                                        WorkerPool* Pool)
 {
-  p1.x = rand() % m_MetricData.m_TerrainSize;
-  p2.y = rand() % m_MetricData.m_TerrainSize;
+  if ((Path == NoiseSIMDPath::eSIMD_AVX2 && !HardwareSupportsAVX2()) ||
+      (Path == NoiseSIMDPath::eSIMD_SSE41 && !HardwareSupportsSSE41())) {
+    Path = NoiseSIMDPath::eSIMD_SCALAR;
+  }
 
-  int Count = 0;
-  do {
-    p2.x = rand() % m_MetricData.m_TerrainSize;
-    p2.y = rand() % m_MetricData.m_TerrainSize;
-  } while (p1 == p2);
+  Pool->ParallelFor(0, Size, YEAGER_TERRAIN_GENERATOR_BAND_ROWS, [&](size_t Begin, size_t End) {
+    /* The tiled layout has no contiguous rows, they are copied out and back for each batch */
+    std::vector<float> Scratch(HeightMap->IsLinear() ? 0 : Size);
+    for (size_t First = 0; First < Faults.size(); First += YEAGER_TERRAIN_FAULT_BATCH) {
+      const size_t Last = std::min(First + YEAGER_TERRAIN_FAULT_BATCH, Faults.size());
+      for (int z = Begin; z < static_cast<int>(End); z++) {
+        float* Row = HeightMap->IsLinear() ? HeightMap->GetAddress(0, z) : Scratch.data();
+        for (int x = 0; x < Size && !HeightMap->IsLinear(); x++) {
+          Row[x] = HeightMap->Get(x, z);
+        }
+        for (size_t Fault = First; Fault < Last; Fault++) {
+          ApplyFaultRow(Row, Size, z, Faults[Fault], Path);
+        }
+        for (int x = 0; x < Size && !HeightMap->IsLinear(); x++) {
+          HeightMap->Set(x, z, Row[x]);
+        }
+      }
+    }
+  });
 }
 
 void FaultFormationTerrain::ApplyFilterFIR(float FIR)
 {
-  for (int z = 0; z < m_MetricData.m_TerrainSize; z++) {
-    float PrevVal = m_MetricData.m_HeightMap->At(0, z);
-    for (int x = 1; x < m_MetricData.m_TerrainSize; x++) {
-      PrevVal = FIRFilterSinglePoint(x, z, PrevVal, FIR);
+  ApplyFilterFIR(m_MetricData.m_HeightMap.get(), m_MetricData.m_TerrainSize, FIR);
+}
+
+void FaultFormationTerrain::ApplyFilterFIR(Yeager::Math::Array2D<float>* HeightMap, int Size, float FIR)
+{
+  for (int z = 0; z < Size; z++) {
+    float PrevVal = HeightMap->At(0, z);
+    for (int x = 1; x < Size; x++) {
+      PrevVal = FIRFilterSinglePoint(HeightMap, x, z, PrevVal, FIR);
     }
   }
 
   // right to left
-  for (int z = 0; z < m_MetricData.m_TerrainSize; z++) {
-    float PrevVal = m_MetricData.m_HeightMap->At(m_MetricData.m_TerrainSize - 1, z);
-    for (int x = m_MetricData.m_TerrainSize - 2; x >= 0; x--) {
-      PrevVal = FIRFilterSinglePoint(x, z, PrevVal, FIR);
+  for (int z = 0; z < Size; z++) {
+    float PrevVal = HeightMap->At(Size - 1, z);
+    for (int x = Size - 2; x >= 0; x--) {
+      PrevVal = FIRFilterSinglePoint(HeightMap, x, z, PrevVal, FIR);
     }
   }
 
   // bottom to top
-  for (int x = 0; x < m_MetricData.m_TerrainSize; x++) {
-    float PrevVal = m_MetricData.m_HeightMap->At(x, 0);
-    for (int z = 1; z < m_MetricData.m_TerrainSize; z++) {
-      PrevVal = FIRFilterSinglePoint(x, z, PrevVal, FIR);
+  for (int x = 0; x < Size; x++) {
+    float PrevVal = HeightMap->At(x, 0);
+    for (int z = 1; z < Size; z++) {
+      PrevVal = FIRFilterSinglePoint(HeightMap, x, z, PrevVal, FIR);
     }
   }
 
   // top to bottom
-  for (int x = 0; x < m_MetricData.m_TerrainSize; x++) {
-    float PrevVal = m_MetricData.m_HeightMap->At(x, m_MetricData.m_TerrainSize - 1);
-    for (int z = m_MetricData.m_TerrainSize - 2; z >= 0; z--) {
-      PrevVal = FIRFilterSinglePoint(x, z, PrevVal, FIR);
+  for (int x = 0; x < Size; x++) {
+    float PrevVal = HeightMap->At(x, Size - 1);
+    for (int z = Size - 2; z >= 0; z--) {
+      PrevVal = FIRFilterSinglePoint(HeightMap, x, z, PrevVal, FIR);
     }
   }
 }
 
-float FaultFormationTerrain::FIRFilterSinglePoint(int x, int z, float PrevFactalVal, float FIR)
+float FaultFormationTerrain::FIRFilterSinglePoint(Yeager::Math::Array2D<float>* HeightMap, int x, int z,
+                                                  float PrevFactalVal, float FIR)
 {
-  float CurVal = m_MetricData.m_HeightMap->At(x, z);
+  float CurVal = HeightMap->At(x, z);
   float NewVal = FIR * PrevFactalVal + (1 - FIR) * CurVal;
-  m_MetricData.m_HeightMap->Set(x, z, NewVal);
+  HeightMap->Set(x, z, NewVal);
   return NewVal;
 }
 
@@ -285,95 +715,124 @@ void MidPointDisplacementTerrain::CreateMidPointDisplacement(Shader* shader, int
   m_Perlin.GeneratePerlin(m_MetricData.m_HeightMap.get(), octaves, bias, m_MetricData.m_Width, m_MetricData.m_Height,
                           m_MetricData.m_MaxHeight);
 
-  CreateMidPointDisplacementF32(Roughness);
+  CreateMidPointDisplacementF32(m_MetricData.m_HeightMap.get(), m_MetricData.m_TerrainSize, Roughness,
+                                m_Perlin.GetSeed());
   m_MetricData.m_HeightMap->Normalize(MinHeight, MaxHeight);
   Setup();
 }
 
-void MidPointDisplacementTerrain::CreateMidPointDisplacementF32(float Roughness)
+void MidPointDisplacementTerrain::CreateMidPointDisplacementF32(Yeager::Math::Array2D<float>* HeightMap, int Size,
+                                                                float Roughness, uint64_t Seed, WorkerPool* Pool)
 {
-  int RectSize = Yeager::Math::CalculateNextPowerOfTwo(m_MetricData.m_TerrainSize);
+  int RectSize = Yeager::Math::CalculateNextPowerOfTwo(Size);
   float CurHeight = (float)RectSize / 2.0f;
   float HeightReduce = pow(2.0f, -Roughness);
 
-  while (RectSize > 0) {
-    DiamondStep(RectSize, CurHeight);
-    SquareStep(RectSize, CurHeight);
+  /* A rect of a single sample has no midpoint left to displace */
+  while (RectSize > 1) {
+    DiamondStep(HeightMap, Size, RectSize, CurHeight, Seed, Pool);
+    SquareStep(HeightMap, Size, RectSize, CurHeight, Seed, Pool);
 
     RectSize /= 2;
     CurHeight *= HeightReduce;
   }
 }
 
-void MidPointDisplacementTerrain::DiamondStep(int RectSize, float CurHeight)
+/**
+ * Runs the rect of every (x, y) of a level. The rects of different rows write samples no other row reads, except the
+ * ones whose midpoint wraps around the last row or column of a size not power of two. Those run alone after the bands,
+ * in the same order on every thread count
+ */
+template <typename Function>
+static void ForEachRect(int Size, int RectSize, WorkerPool* Pool, Function&& Rect)
+{
+  const int HalfRectSize = RectSize / 2;
+  const int RectRows = (Size + RectSize - 1) / RectSize;
+  const size_t Grain = std::max(1, YEAGER_TERRAIN_GENERATOR_BAND_ROWS / RectSize);
+
+  Pool->ParallelFor(0, RectRows, Grain, [&](size_t Begin, size_t End) {
+    for (int y = Begin * RectSize; y < static_cast<int>(End) * RectSize && y + HalfRectSize < Size; y += RectSize) {
+      for (int x = 0; x + HalfRectSize < Size; x += RectSize) {
+        Rect(x, y);
+      }
+    }
+  });
+
+  const int FirstWrappingX = (Size - HalfRectSize + RectSize - 1) / RectSize * RectSize;
+  for (int y = 0; y < Size; y += RectSize) {
+    for (int x = y + HalfRectSize < Size ? FirstWrappingX : 0; x < Size; x += RectSize) {
+      Rect(x, y);
+    }
+  }
+}
+
+void MidPointDisplacementTerrain::DiamondStep(Yeager::Math::Array2D<float>* HeightMap, int Size, int RectSize,
+                                              float CurHeight, uint64_t Seed, WorkerPool* Pool)
 {
   int HalfRectSize = RectSize / 2;
 
-  for (int y = 0; y < m_MetricData.m_TerrainSize; y += RectSize) {
-    for (int x = 0; x < m_MetricData.m_TerrainSize; x += RectSize) {
-      int next_y = (y + RectSize) % m_MetricData.m_TerrainSize;
-      int next_x = (x + RectSize) % m_MetricData.m_TerrainSize;
+  ForEachRect(Size, RectSize, Pool, [&](int x, int y) {
+    int next_y = (y + RectSize) % Size;
+    int next_x = (x + RectSize) % Size;
 
-      if (next_x < x) {
-        next_x = m_MetricData.m_TerrainSize - 1;
-      }
+    if (next_x < x) {
+      next_x = Size - 1;
+    }
 
-      if (next_y < y) {
-        next_y = m_MetricData.m_TerrainSize - 1;
-      }
+    if (next_y < y) {
+      next_y = Size - 1;
+    }
 
-      float TopLeft = m_MetricData.m_HeightMap->Get(x, y);
-      float TopRight = m_MetricData.m_HeightMap->Get(next_x, y);
-      float BottomLeft = m_MetricData.m_HeightMap->Get(x, next_y);
-      float BottomRight = m_MetricData.m_HeightMap->Get(next_x, next_y);
+    float TopLeft = HeightMap->Get(x, y);
+    float TopRight = HeightMap->Get(next_x, y);
+    float BottomLeft = HeightMap->Get(x, next_y);
+    float BottomRight = HeightMap->Get(next_x, next_y);
 
-      int mid_x = (x + HalfRectSize) % m_MetricData.m_TerrainSize;
-      int mid_y = (y + HalfRectSize) % m_MetricData.m_TerrainSize;
+    int mid_x = (x + HalfRectSize) % Size;
+    int mid_y = (y + HalfRectSize) % Size;
 
-      float RandValue = Yeager::Math::RandomFloatRange(CurHeight, -CurHeight);
-      float MidPoint = (TopLeft + TopRight + BottomLeft + BottomRight) / 4.0f;
-      m_MetricData.m_HeightMap->Set(mid_x, mid_y, MidPoint + RandValue);
-    }
-  }
+    float RandValue = RandomCellValue(Seed, RectSize, 0, mid_x, mid_y) * CurHeight;
+    float MidPoint = (TopLeft + TopRight + BottomLeft + BottomRight) / 4.0f;
+    HeightMap->Set(mid_x, mid_y, MidPoint + RandValue);
+  });
 }
 
-void MidPointDisplacementTerrain::SquareStep(int RectSize, float CurHeight)
+void MidPointDisplacementTerrain::SquareStep(Yeager::Math::Array2D<float>* HeightMap, int Size, int RectSize,
+                                             float CurHeight, uint64_t Seed, WorkerPool* Pool)
 {
   int HalfRectSize = RectSize / 2;
 
-  for (int y = 0; y > m_MetricData.m_TerrainSize; y += RectSize) {
-    for (int x = 0; x > m_MetricData.m_TerrainSize; x += RectSize) {
-      int next_y = (y + RectSize) % m_MetricData.m_TerrainSize;
-      int next_x = (x + RectSize) % m_MetricData.m_TerrainSize;
+  ForEachRect(Size, RectSize, Pool, [&](int x, int y) {
+    int next_y = (y + RectSize) % Size;
+    int next_x = (x + RectSize) % Size;
 
-      if (next_x < x) {
-        next_x = m_MetricData.m_TerrainSize - 1;
-      }
+    if (next_x < x) {
+      next_x = Size - 1;
+    }
 
-      if (next_y < y) {
-        next_y = m_MetricData.m_TerrainSize - 1;
-      }
+    if (next_y < y) {
+      next_y = Size - 1;
+    }
 
-      int mid_x = (x + HalfRectSize) % m_MetricData.m_TerrainSize;
-      int mid_y = (y + HalfRectSize) % m_MetricData.m_TerrainSize;
+    int mid_x = (x + HalfRectSize) % Size;
+    int mid_y = (y + HalfRectSize) % Size;
 
-      int prev_mid_x = (x - HalfRectSize + m_MetricData.m_TerrainSize) % m_MetricData.m_TerrainSize;
-      int prev_mid_y = (y - HalfRectSize + m_MetricData.m_TerrainSize) % m_MetricData.m_TerrainSize;
+    int prev_mid_x = (x - HalfRectSize + Size) % Size;
+    int prev_mid_y = (y - HalfRectSize + Size) % Size;
 
-      float CurTopLeft = m_MetricData.m_HeightMap->Get(x, y);
-      float CurTopRight = m_MetricData.m_HeightMap->Get(next_x, y);
-      float CurCenter = m_MetricData.m_HeightMap->Get(mid_x, mid_y);
-      float PrevYCenter = m_MetricData.m_HeightMap->Get(mid_x, prev_mid_y);
-      float CurBotLeft = m_MetricData.m_HeightMap->Get(x, next_y);
-      float PrevXCenter = m_MetricData.m_HeightMap->Get(prev_mid_x, mid_y);
+    float CurTopLeft = HeightMap->Get(x, y);
+    float CurTopRight = HeightMap->Get(next_x, y);
+    float CurCenter = HeightMap->Get(mid_x, mid_y);
+    float PrevYCenter = HeightMap->Get(mid_x, prev_mid_y);
+    float CurBotLeft = HeightMap->Get(x, next_y);
+    float PrevXCenter = HeightMap->Get(prev_mid_x, mid_y);
 
-      float CurLeftMid = (CurTopLeft + CurCenter + CurBotLeft + PrevXCenter) / 4.0f +
-                         Yeager::Math::RandomFloatRange(-CurHeight, CurHeight);
-      float CurTopMid = (CurTopLeft + CurCenter + CurTopRight + PrevYCenter) / 4.0f +
-                        Yeager::Math::RandomFloatRange(-CurHeight, CurHeight);
+    float CurLeftMid = (CurTopLeft + CurCenter + CurBotLeft + PrevXCenter) / 4.0f +
+                       RandomCellValue(Seed, RectSize, 1, x, mid_y) * CurHeight;
+    float CurTopMid = (CurTopLeft + CurCenter + CurTopRight + PrevYCenter) / 4.0f +
+                      RandomCellValue(Seed, RectSize, 2, mid_x, y) * CurHeight;
 
-      m_MetricData.m_HeightMap->Set(mid_x, y, CurTopMid);
-      m_MetricData.m_HeightMap->Set(x, mid_y, CurLeftMid);
-    }
-  }
-}
\ No newline at end of file
+    HeightMap->Set(mid_x, y, CurTopMid);
+    HeightMap->Set(x, mid_y, CurLeftMid);
+  });
+}
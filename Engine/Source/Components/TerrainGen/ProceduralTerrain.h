@@ -24,8 +24,13 @@
 #include "Common/Utils/Utilities.h"
 #include "Components/Renderer/GL/OpenGLRender.h"
 #include "Components/Renderer/Shader/ShaderHandle.h"
+#include "Components/Kernel/Process/WorkerPool.h"
 #include "Components/Renderer/Texture/TextureHandle.h"
 #include "PerlinNoise.h"
+#include "TerrainEditor.h"
+#include "TerrainHeightField.h"
+#include "TerrainHeightMap.h"
+#include "TerrainLOD.h"
 
 namespace Yeager {
 
@@ -73,6 +78,43 @@ struct TerrainVertex {
   void InitVertex(ProceduralTerrain* Terrain, int x, int z);
 };
 
+/// @brief Values of the terrain used to build the vertices of the grid, the same ones TerrainVertex::InitVertex reads
+struct TerrainMeshBuildDesc {
+  Yeager::Math::Array2D<float>* HeightMap = YEAGER_NULLPTR;
+  int Width = 0;
+  int Height = 0;
+  float WorldScale = 1.0f;
+  float Size = 256.0f;
+  float TextureScale = 256.0f;
+};
+
+/// @brief  CPU side of the terrain setup, builds the vertices, indices and normals of the grid in bands of rows run by the worker pool.
+///         Every band only writes its own rows and the normals are gathered per vertex (first the face normals of the band, then the sum
+///         of the faces around each vertex in the same order the old serial loop added them), so the output is deterministic and equal
+///         bit by bit to the serial setup
+class TerrainMeshBuilder {
+ public:
+  static void Build(const TerrainMeshBuildDesc& desc, std::vector<TerrainVertex>* vertices, std::vector<GLuint>* indices,
+                    WorkerPool* pool = WorkerPool::GetGlobal());
+
+  /**
+   * @brief Rebuilds the vertices of the rect after the heightmap was edited and the normals of the rect and the ring
+   *        around it, equal bit by bit to a full Build of the edited heightmap
+   * @return The rect of vertices changed, the ring included
+   */
+  static TerrainDirtyRect UpdateRegion(const TerrainMeshBuildDesc& desc, const TerrainDirtyRect& rect,
+                                       std::vector<TerrainVertex>* vertices,
+                                       WorkerPool* pool = WorkerPool::GetGlobal());
+
+ protected:
+  static void BuildVertices(const TerrainMeshBuildDesc& desc, TerrainVertex* vertices, int beginX, int endX,
+                            int beginY, int endY);
+  static void BuildIndices(const TerrainMeshBuildDesc& desc, GLuint* indices, int beginZ, int endZ);
+  static void BuildNormals(const TerrainMeshBuildDesc& desc, TerrainVertex* vertices, int beginZ, int endZ, int beginX,
+                           int endX);
+  static size_t CalculateBandRows(int rows, WorkerPool* pool);
+};
+
 /// @brief  This struct is different for the TextureHeightDesc struct, it contains the heights used when doing
 ///         multi texturing in the terrain, interpolating between textures used to render the mesh of the terrain
 struct MultiTextureHeight {
@@ -144,14 +186,81 @@ class ProceduralTerrain {
   void Draw(Shader* shader);
 
   /**
-   * @brief     Get the value of the height interpolated between two points
+   * @brief Builds the quadtree of the level of detail over the heightmap, from now on Setup also rebuilds it.
+   *        Must be called after the terrain is generated
+   */
+  void EnableLOD(const TerrainLODSettings& settings = TerrainLODSettings());
+  void DisableLOD();
+  YEAGER_NODISCARD bool IsLODEnabled() const { return m_LODEnabled; }
+
+  /**
+   * @brief                 Draws the terrain with the level of detail, selecting the nodes for the camera
+   * @note                  The shader must be the TerrainCDLOD one, attribs declared like in Draw
+   * @param camera          Position of the camera in the world
+   * @param projection      Projection matrix of the camera, gives the field of view of the screen space error
+   * @param viewportHeight  Height of the viewport in pixels
+   */
+  void DrawLOD(Shader* shader, const Vector3& camera, const Matrix4& projection, float viewportHeight);
+
+  YEAGER_NODISCARD const TerrainQuadtree* GetQuadtree() const { return &m_Quadtree; }
+
+  /**
+   * @brief                 Sculpts the heightmap, the mesh is only updated by the next UpdateDirtyRegions
+   * @param brush           Brush to apply, the radius is in world units
+   * @param worldPosition   Center of the brush in the world, only X and Z are used
+   * @return                The samples of the heightmap changed by the stroke
+   */
+  TerrainDirtyRect ApplyBrush(const TerrainBrush& brush, const Vector3& worldPosition);
+
+  /**
+   * @brief   Remeshes the regions edited since the last call and uploads only the changed vertices, the level of
+   *          detail updates its bounds and heightmap texture for the same regions. Called once per frame while
+   *          sculpting
+   * @return  Bytes uploaded to the GPU
+   */
+  size_t UpdateDirtyRegions();
+
+  YEAGER_NODISCARD TerrainHeightEditor* GetEditor() { return &m_Editor; }
+
+  /**
+   * @brief Saves the heightmap with the values needed to build the terrain again (size, scales, heights and seed)
+   */
+  bool SaveHeightMap(const String& path,
+                     const TerrainHeightMapWriteSettings& settings = TerrainHeightMapWriteSettings());
+
+  /**
+   * @brief Replaces the heightmap with the one saved in the file and setups the terrain, nothing is generated again
+   * @return False and the terrain untouched if the file cannot be read
+   */
+  bool LoadHeightMap(const String& path);
+
+  /**
+   * @brief     Get the height of the terrain at a position of the world, interpolated between the samples around it
    * 
    * @param x   The x position to find the value
    * @param z   The z position to find the value
-   * @return    The interpolated value 
+   * @return    The interpolated height in the world, positions outside the terrain are clamped to its border
    */
   float GetHeightInterpolated(float x, float z) const;
 
+  /**
+   * @brief         Batch version of GetHeightInterpolated, sampled with SIMD when the hardware allows it
+   * @param x       X positions in the world
+   * @param z       Z positions in the world, same count of x
+   * @param heights Output heights in the world
+   */
+  void GetHeightsInterpolated(const float* x, const float* z, float* heights, size_t count) const;
+
+  /**
+   * @brief             Finds the nearest point of the terrain hit by the ray, the hit is given in the world
+   * @param direction   Direction of the ray, distances are in units of it
+   * @return            False if the ray misses the terrain before the max distance
+   */
+  bool Raycast(const Vector3& origin, const Vector3& direction, TerrainRayHit* hit,
+               float maxDistance = std::numeric_limits<float>::max()) const;
+
+  YEAGER_NODISCARD const TerrainHeightField* GetHeightField() const { return &m_HeightField; }
+
   /**
    * @brief   Get the Texture Scale (MultiTexturing)
    * 
@@ -192,12 +301,52 @@ class ProceduralTerrain {
 
   YEAGER_NODISCARD TerrainChunkInformation* GetChunkInformation() { return &m_ChunkInfo; }
 
+  /**
+   * @brief The noise of the terrain, setting its seed and calling GenerateTerrain without regenerating the seed gives
+   *        the same terrain again
+   */
+  YEAGER_NODISCARD PerlinNoise* GetPerlinNoise() { return &m_Perlin; }
+
+  YEAGER_NODISCARD const TerrainMetricData& GetMetricData() const { return m_MetricData; }
+
+  /** Position in the world of the sample (0, 0) of the heightmap at height zero, the translation of the model matrix */
+  YEAGER_NODISCARD Vector3 GetWorldOrigin() const { return Vector3(GetModelMatrix()[3]); }
+
  protected:
+  /** Model matrix, textures and heights shared by Draw and DrawLOD */
+  Matrix4 GetModelMatrix() const;
+  TerrainMeshBuildDesc GetMeshBuildDesc() const;
+  void SetDrawUniforms(Shader* shader);
+  void SetupLOD();
+
   TerrainDrawData m_DrawData;
   TerrainMetricData m_MetricData;
   TerrainTexturingData m_TextureData;
   TerrainChunkInformation m_ChunkInfo;
   PerlinNoise m_Perlin;
+
+  TerrainQuadtree m_Quadtree;
+  TerrainLODRenderer m_LODRenderer;
+  TerrainLODSettings m_LODSettings;
+  std::vector<TerrainLODNode> m_LODSelection;
+  bool m_LODEnabled = false;
+
+  TerrainHeightEditor m_Editor;
+  TerrainHeightField m_HeightField;
+};
+
+/** Faults applied by each pass over a band of rows, the rows stay in the cache for the whole batch */
+#define YEAGER_TERRAIN_FAULT_BATCH 16
+/** Rows of the heightmap in each band of the fault formation and of the midpoint displacement steps */
+#define YEAGER_TERRAIN_GENERATOR_BAND_ROWS 8
+
+/// @brief A fault line through the samples (X1, Z1) and (X2, Z2), the samples at the left of it rise by Height
+struct TerrainFault {
+  int X1 = 0;
+  int Z1 = 0;
+  int X2 = 0;
+  int Z2 = 0;
+  float Height = 0.0f;
 };
 
 /** Fault formation terrain is a type of terrain that creates faults like in the real life, represeting the sismics actions of nature */
@@ -229,6 +378,29 @@ class FaultFormationTerrain : public ProceduralTerrain {
   void CreateFaultFormationTerrain(Shader* shader, int TerrainSize, int It, int MinHeight, int MaxHeight, float FIR,
                                    int octaves, int bias);
 
+  /**
+   * @brief           Applys the erosive filter to a heightmap of Size x Size samples, in any layout of the array.
+   *                  Used by the terrain after the faults, and by the benchmarks without a terrain
+   * @param FIR       The filter value, between 0.0 and 0.99
+   */
+  static void ApplyFilterFIR(Yeager::Math::Array2D<float>* HeightMap, int Size, float FIR);
+
+  /**
+   * @brief           The faults of It iterations, the same seed always gives the same faults. The height of each fault
+   *                  goes down from MaxHeight to MinHeight along the iterations
+   */
+  static std::vector<TerrainFault> GenerateFaults(uint64_t Seed, int Size, int It, int MinHeight, int MaxHeight);
+
+  /**
+   * @brief           Raises the samples at the left of every fault, in the order of the faults. Bands of rows run in
+   *                  the worker pool and each band applies YEAGER_TERRAIN_FAULT_BATCH faults per pass, row by row with
+   *                  SIMD. Every sample sees the faults in the same order, so the result is equal bit by bit to
+   *                  applying the faults one by one over the whole grid, whatever the path and the threads
+   */
+  static void ApplyFaults(Yeager::Math::Array2D<float>* HeightMap, int Size, const std::vector<TerrainFault>& Faults,
+                          NoiseSIMDPath::Enum Path = GradientNoise::GetBestSIMDPath(),
+                          WorkerPool* Pool = WorkerPool::GetGlobal());
+
  protected:
   /**
    * @brief           Generate the faults in the heightmap, getting random points, and choosing one side to be submerged and appling the filter
@@ -241,12 +413,13 @@ class FaultFormationTerrain : public ProceduralTerrain {
   void CreateFaultFormationInternal(int It, int MinHeight, int MaxHeight, float FIR);
 
   /**
-   * @brief     Generates two random points in the terrain for the calculation on the fault formation
+   * @brief     Generates two random and different points in the terrain for the calculation on the fault formation
    * @note      This function is different from the GetRandomPointsInTheTerrain, because in doesnt not get hte values from the heightmap!
+   * @param State State of the random generator, advanced by the call
    * @param p1  The first point
    * @param p2  The second point
    */
-  void GenerateRandomPoints(Vector2& p1, Vector2& p2);
+  static void GenerateRandomPoints(uint64_t& State, int Size, Vector2& p1, Vector2& p2);
 
   /**
    * @brief     Applys the erosive filter to the high points of the fault, creating a more natural feel 
@@ -263,7 +436,8 @@ class FaultFormationTerrain : public ProceduralTerrain {
    * @param FIR           The filter constant 
    * @return              Returns the new value of the factal value, to be used the next time calling this function
    */
-  float FIRFilterSinglePoint(int x, int z, float PrevFactalVal, float FIR);
+  static float FIRFilterSinglePoint(Yeager::Math::Array2D<float>* HeightMap, int x, int z, float PrevFactalVal,
+                                    float FIR);
 };
 
 /** Midpoint displacement terrain is used to create mountain like terrains, picking a point and decreasing the surrondings of it */
@@ -295,21 +469,27 @@ class MidPointDisplacementTerrain : public ProceduralTerrain {
   void CreateMidPointDisplacement(Shader* shader, int Size, int Roughness, float MinHeight, float MaxHeight,
                                   int octaves, int bias);
 
- protected:
   /**
-  * @brief            Creates the montain like effect on the terrain, given a roughness value
+  * @brief            Creates the montain like effect on a heightmap of Size x Size samples, given a roughness value.
+  *                   Works in any layout of the array, the benchmarks call it without a terrain. Every level of the
+  *                   diamond and square steps runs in bands of the worker pool, the random value of each sample is a
+  *                   hash of the seed, the level and the position, so the same seed gives the same heightmap whatever
+  *                   the threads
   * 
   * @param Roughness  The ronghness value of the terrain
   */
-  void CreateMidPointDisplacementF32(float Roughness);
+  static void CreateMidPointDisplacementF32(Yeager::Math::Array2D<float>* HeightMap, int Size, float Roughness,
+                                            uint64_t Seed, WorkerPool* Pool = WorkerPool::GetGlobal());
 
+ protected:
   /**
    * @brief           Calculate the points between the vertices on the rectangle of the terrain
    * 
    * @param RectSize  Rectangle size
    * @param CurHeight The point in the line between vertices
    */
-  void DiamondStep(int RectSize, float CurHeight);
+  static void DiamondStep(Yeager::Math::Array2D<float>* HeightMap, int Size, int RectSize, float CurHeight,
+                          uint64_t Seed, WorkerPool* Pool);
 
   /**
    * @brief           Calculate the points on the vertices of the current square of the terrain 
@@ -317,6 +497,7 @@ class MidPointDisplacementTerrain : public ProceduralTerrain {
    * @param RectSize  Rectangle size
    * @param CurHeight The points in the vertices of the square
    */
-  void SquareStep(int RectSize, float CurHeight);
+  static void SquareStep(Yeager::Math::Array2D<float>* HeightMap, int Size, int RectSize, float CurHeight,
+                         uint64_t Seed, WorkerPool* Pool);
 };
 }  // namespace Yeager
\ No newline at end of file
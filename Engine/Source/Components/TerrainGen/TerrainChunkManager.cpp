@@ -0,0 +1,414 @@
+#include "TerrainChunkManager.h"
+#include "Components/Kernel/Memory/Allocator.h"
+using namespace Yeager;
+
+std::shared_ptr<TerrainChunkMesh> TerrainChunkBuilder::Build(const GradientNoise& noise,
+                                                             const TerrainStreamingSettings& settings,
+                                                             TerrainChunkCoord coord)
+{
+  const int quads = settings.ChunkQuads;
+  const int side = quads + 1;
+  const int border = side + 2;
+  const float half = settings.MaxHeight * 0.5f;
+
+  /* Heights of the chunk plus one sample of the neighbours around it, sampled at the global grid position */
+  std::vector<float> heights(border * border);
+  for (int z = 0; z < border; z++) {
+    noise.FillRow(&heights[z * border], coord.X * quads - 1, coord.Z * quads - 1 + z, border, settings.Noise, half,
+                  half);
+  }
+  auto height = [&](int x, int z) { return heights[(z + 1) * border + x + 1]; };
+
+  auto mesh = BaseAllocator::MakeSharedPtr<TerrainChunkMesh>();
+  mesh->Coord = coord;
+  mesh->Vertices.resize(side * side);
+  mesh->MinHeight = std::numeric_limits<float>::max();
+  mesh->MaxHeight = std::numeric_limits<float>::lowest();
+
+  const float scale = settings.WorldScale;
+  const float texture = static_cast<float>(settings.TextureRepeat) / quads;
+  for (int z = 0; z < side; z++) {
+    for (int x = 0; x < side; x++) {
+      TerrainVertex& vertex = mesh->Vertices[z * side + x];
+      const float y = height(x, z);
+      vertex.Position = Vector3(x * scale, y, z * scale);
+      vertex.TexCoords = Vector2(x * texture, z * texture);
+      const float slopeX = height(x - 1, z) - height(x + 1, z);
+      const float slopeZ = height(x, z - 1) - height(x, z + 1);
+      vertex.Normals = glm::normalize(Vector3(slopeX, 2.0f * scale, slopeZ));
+      mesh->MinHeight = std::min(mesh->MinHeight, y);
+      mesh->MaxHeight = std::max(mesh->MaxHeight, y);
+    }
+  }
+  return mesh;
+}
+
+void TerrainChunkBuilder::BuildIndices(const TerrainStreamingSettings& settings, std::vector<GLuint>* indices)
+{
+  const int quads = settings.ChunkQuads;
+  const int side = quads + 1;
+  indices->clear();
+  indices->reserve(quads * quads * 6);
+  for (int z = 0; z < quads; z++) {
+    for (int x = 0; x < quads; x++) {
+      Uint IndexBottomLeft = z * side + x;
+      Uint IndexTopLeft = (z + 1) * side + x;
+      Uint IndexTopRight = (z + 1) * side + x + 1;
+      Uint IndexBottomRight = z * side + x + 1;
+      indices->push_back(IndexBottomLeft);
+      indices->push_back(IndexTopLeft);
+      indices->push_back(IndexTopRight);
+      indices->push_back(IndexBottomLeft);
+      indices->push_back(IndexTopRight);
+      indices->push_back(IndexBottomRight);
+    }
+  }
+}
+
+TerrainChunkManager::TerrainChunkManager(const TerrainStreamingSettings& settings, std::vector<String> TexturesPaths,
+                                         WorkerPool* pool)
+    : m_Settings(settings), m_Noise(settings.Seed), m_Pool(pool)
+{
+  TerrainChunkBuilder::BuildIndices(m_Settings, &m_Indices);
+  BuildLoadOffsets();
+
+  if (!TexturesPaths.empty()) {
+    if (TexturesPaths.size() != MAX_TEXTURE_TILES) {
+      Yeager::Log(ERROR, "Textures paths given to the terrain streaming isnt equal to {}!", MAX_TEXTURE_TILES);
+    } else {
+      for (int x = 0; x < MAX_TEXTURE_TILES; x++) {
+        m_TextureData.m_TexturesLoaded[x].GenerateFromFile(TexturesPaths[x], false);
+      }
+      m_HasTextures = true;
+    }
+  }
+  UpdateTextureHeights();
+
+  Yeager::Log(INFO, "Terrain streaming started, chunks of {} quads, load radius {}, seed {}", m_Settings.ChunkQuads,
+              m_Settings.LoadRadius, m_Settings.Seed);
+}
+
+TerrainChunkManager::~TerrainChunkManager()
+{
+  WaitForChunksInFlight();
+  ReleaseChunks();
+  if (m_IndexBuffer != 0) {
+    GL_CALL(glDeleteBuffers(1, &m_IndexBuffer));
+  }
+}
+
+void TerrainChunkManager::SetSettings(const TerrainStreamingSettings& settings)
+{
+  /* The workers read the noise and the settings, they must be done before changing them */
+  WaitForChunksInFlight();
+  ReleaseChunks();
+  if (m_IndexBuffer != 0 && settings.ChunkQuads != m_Settings.ChunkQuads) {
+    GL_CALL(glDeleteBuffers(1, &m_IndexBuffer));
+    m_IndexBuffer = 0;
+  }
+
+  m_Settings = settings;
+  m_Noise.SetSeed(m_Settings.Seed);
+  TerrainChunkBuilder::BuildIndices(m_Settings, &m_Indices);
+  BuildLoadOffsets();
+  UpdateTextureHeights();
+  UpdateStats();
+}
+
+void TerrainChunkManager::WaitForChunksInFlight()
+{
+  {
+    std::unique_lock<std::mutex> lock(m_FinishedMutex);
+    m_FinishedCondition.wait(lock, [this]() { return m_Finished.size() == m_ChunksInFlight; });
+  }
+  CollectFinishedChunks();
+}
+
+TerrainChunkCoord TerrainChunkManager::WorldToChunk(const Vector3& position) const
+{
+  const float size = m_Settings.GetChunkWorldSize();
+  return TerrainChunkCoord{static_cast<int>(std::floor(position.x / size)),
+                           static_cast<int>(std::floor(position.z / size))};
+}
+
+void TerrainChunkManager::Update(const Vector3& viewerPosition)
+{
+  m_Stats.RequestedThisFrame = 0;
+  m_Stats.UploadedThisFrame = 0;
+
+  const TerrainChunkCoord center = WorldToChunk(viewerPosition);
+  CollectFinishedChunks();
+  EvictChunks(center);
+  RequestChunks(center);
+  if (m_Settings.UploadToGPU) {
+    UploadChunks(center);
+  }
+  UpdateStats();
+}
+
+void TerrainChunkManager::CollectFinishedChunks()
+{
+  std::vector<std::shared_ptr<TerrainChunkMesh>> finished;
+  {
+    std::lock_guard<std::mutex> lock(m_FinishedMutex);
+    finished.swap(m_Finished);
+    m_ChunksInFlight -= finished.size();
+  }
+
+  for (auto& mesh : finished) {
+    auto chunk = m_Chunks.find(mesh->Coord);
+    if (chunk != m_Chunks.end()) {
+      chunk->second.Mesh = mesh;
+      chunk->second.InFlight = false;
+    }
+    m_Stats.TotalGenerated++;
+  }
+}
+
+void TerrainChunkManager::EvictChunks(TerrainChunkCoord center)
+{
+  const int radius = m_Settings.LoadRadius + m_Settings.EvictionMargin;
+  for (auto chunk = m_Chunks.begin(); chunk != m_Chunks.end();) {
+    /* Chunks still being generated are evicted once they arrive */
+    if (chunk->second.InFlight || IsInsideRadius(chunk->first, center, radius)) {
+      chunk++;
+      continue;
+    }
+    if (chunk->second.Mesh) {
+      CacheMesh(chunk->second.Mesh);
+    }
+    chunk = m_Chunks.erase(chunk);
+  }
+}
+
+void TerrainChunkManager::RequestChunks(TerrainChunkCoord center)
+{
+  for (const auto& offset : m_LoadOffsets) {
+    const TerrainChunkCoord coord{center.X + offset.X, center.Z + offset.Z};
+    if (m_Chunks.find(coord) != m_Chunks.end()) {
+      continue;
+    }
+
+    /* Cached chunks come back without using the budget, only the upload is done again */
+    if (auto cached = TakeCachedMesh(coord)) {
+      m_Chunks[coord].Mesh = cached;
+      m_Stats.CacheHits++;
+      continue;
+    }
+
+    if (m_Stats.RequestedThisFrame >= m_Settings.GenerationBudget ||
+        m_ChunksInFlight >= m_Settings.MaxChunksInFlight) {
+      continue;
+    }
+
+    m_Chunks[coord].InFlight = true;
+    m_Stats.RequestedThisFrame++;
+    {
+      std::lock_guard<std::mutex> lock(m_FinishedMutex);
+      m_ChunksInFlight++;
+    }
+
+    /* Streamed in the background, behind the tasks a frame waits on */
+    m_Pool->Submit(
+        [this, coord, settings = m_Settings]() {
+          std::shared_ptr<TerrainChunkMesh> mesh = TerrainChunkBuilder::Build(m_Noise, settings, coord);
+          std::lock_guard<std::mutex> lock(m_FinishedMutex);
+          m_Finished.push_back(mesh);
+          m_FinishedCondition.notify_all();
+        },
+        TaskPriority::eLOW);
+  }
+}
+
+void TerrainChunkManager::UploadChunks(TerrainChunkCoord center)
+{
+  /* Nearest first, the same order the chunks were requested */
+  for (const auto& offset : m_LoadOffsets) {
+    if (m_Stats.UploadedThisFrame >= m_Settings.UploadBudget) {
+      break;
+    }
+    auto chunk = m_Chunks.find(TerrainChunkCoord{center.X + offset.X, center.Z + offset.Z});
+    if (chunk != m_Chunks.end() && chunk->second.Mesh && !chunk->second.Renderer) {
+      Upload(&chunk->second);
+      m_Stats.UploadedThisFrame++;
+    }
+  }
+}
+
+void TerrainChunkManager::Upload(Chunk* chunk)
+{
+  chunk->Renderer = std::make_unique<SimpleRenderer>();
+  chunk->Renderer->GenBuffers();
+  chunk->Renderer->BindBuffers();
+
+  chunk->Renderer->VertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(TerrainVertex),
+                                       (const void*)offsetof(TerrainVertex, Position));
+  chunk->Renderer->VertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(TerrainVertex),
+                                       (const void*)offsetof(TerrainVertex, TexCoords));
+  chunk->Renderer->VertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(TerrainVertex),
+                                       (const void*)offsetof(TerrainVertex, Normals));
+
+  const auto& vertices = chunk->Mesh->Vertices;
+  chunk->Renderer->BufferData(GL_ARRAY_BUFFER, sizeof(TerrainVertex) * vertices.size(), vertices.data(),
+                              GL_STATIC_DRAW);
+
+  /* Every chunk has the same grid, the index buffer is shared and bound to the vertex array of each one */
+  if (m_IndexBuffer == 0) {
+    GL_CALL(glGenBuffers(1, &m_IndexBuffer));
+    GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_IndexBuffer));
+    GL_CALL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * m_Indices.size(), m_Indices.data(),
+                         GL_STATIC_DRAW));
+  } else {
+    GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_IndexBuffer));
+  }
+
+  SimpleRenderer::UnbindVertexArray();
+}
+
+void TerrainChunkManager::Draw(Shader* shader)
+{
+  if (!m_Settings.UploadToGPU) {
+    return;
+  }
+
+  shader->UseShader();
+  shader->SetFloat("MinHeight", 0.0f);
+  shader->SetFloat("MaxHeight", m_Settings.MaxHeight);
+  shader->SetFloat("TextureHeight0", m_TextureData.m_MultiTextureHeights.Height0);
+  shader->SetFloat("TextureHeight1", m_TextureData.m_MultiTextureHeights.Height1);
+  shader->SetFloat("TextureHeight2", m_TextureData.m_MultiTextureHeights.Height2);
+  shader->SetFloat("TextureHeight3", m_TextureData.m_MultiTextureHeights.Height3);
+
+  if (m_HasTextures) {
+    for (int x = 0; x < MAX_TEXTURE_TILES; x++) {
+      glActiveTexture(GL_TEXTURE0 + x);
+      shader->SetInt("TerrainTexture" + std::to_string(x), x);
+      glBindTexture(GL_TEXTURE_2D, m_TextureData.m_TexturesLoaded[x].GetTextureID());
+    }
+  }
+
+  const float size = m_Settings.GetChunkWorldSize();
+  const GLsizei count = m_Indices.size();
+  for (auto& [coord, chunk] : m_Chunks) {
+    if (!chunk.Renderer) {
+      continue;
+    }
+    /* The vertices are local to the chunk, the offset of the chunk keeps the floats small far from the origin */
+    const Matrix4 model =
+        glm::translate(Matrix4(1.0f), Vector3(coord.X * size, -m_Settings.MaxHeight, coord.Z * size));
+    shader->SetMat4("model", model);
+    chunk.Renderer->BindVertexArray();
+    GL_CALL(glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, NULL));
+  }
+
+  SimpleRenderer::UnbindVertexArray();
+  if (m_HasTextures) {
+    MaterialTexture2D::Unbind2DTextures();
+  }
+}
+
+void TerrainChunkManager::CacheMesh(std::shared_ptr<TerrainChunkMesh> mesh)
+{
+  m_Cache.push_front(mesh);
+  m_CacheLookup[mesh->Coord] = m_Cache.begin();
+  while (m_Cache.size() > m_Settings.MaxCachedChunks) {
+    m_CacheLookup.erase(m_Cache.back()->Coord);
+    m_Cache.pop_back();
+  }
+}
+
+std::shared_ptr<TerrainChunkMesh> TerrainChunkManager::TakeCachedMesh(TerrainChunkCoord coord)
+{
+  auto found = m_CacheLookup.find(coord);
+  if (found == m_CacheLookup.end()) {
+    return YEAGER_NULLPTR;
+  }
+  std::shared_ptr<TerrainChunkMesh> mesh = *found->second;
+  m_Cache.erase(found->second);
+  m_CacheLookup.erase(found);
+  return mesh;
+}
+
+void TerrainChunkManager::ReleaseChunks()
+{
+  m_Chunks.clear();
+  m_Cache.clear();
+  m_CacheLookup.clear();
+}
+
+void TerrainChunkManager::UpdateStats()
+{
+  m_Stats.ResidentChunks = 0;
+  m_Stats.UploadedChunks = 0;
+  m_Stats.MemoryBytes = 0;
+  for (const auto& [coord, chunk] : m_Chunks) {
+    if (chunk.Mesh) {
+      m_Stats.ResidentChunks++;
+      m_Stats.MemoryBytes += chunk.Mesh->GetMemorySize();
+    }
+    if (chunk.Renderer) {
+      m_Stats.UploadedChunks++;
+    }
+  }
+  for (const auto& mesh : m_Cache) {
+    m_Stats.MemoryBytes += mesh->GetMemorySize();
+  }
+  m_Stats.CachedChunks = m_Cache.size();
+  m_Stats.ChunksInFlight = m_ChunksInFlight;
+}
+
+void TerrainChunkManager::UpdateTextureHeights()
+{
+  /* Same proportions of the default heights of the single terrain (64, 128, 192 and 256 of 256) */
+  m_TextureData.m_MultiTextureHeights.Height0 = m_Settings.MaxHeight * 0.25f;
+  m_TextureData.m_MultiTextureHeights.Height1 = m_Settings.MaxHeight * 0.5f;
+  m_TextureData.m_MultiTextureHeights.Height2 = m_Settings.MaxHeight * 0.75f;
+  m_TextureData.m_MultiTextureHeights.Height3 = m_Settings.MaxHeight;
+  m_TextureData.m_TextureScale = m_Settings.TextureRepeat;
+}
+
+void TerrainChunkManager::BuildLoadOffsets()
+{
+  m_LoadOffsets.clear();
+  const int radius = m_Settings.LoadRadius;
+  for (int z = -radius; z <= radius; z++) {
+    for (int x = -radius; x <= radius; x++) {
+      if (IsInsideRadius(TerrainChunkCoord{x, z}, TerrainChunkCoord{}, radius)) {
+        m_LoadOffsets.push_back(TerrainChunkCoord{x, z});
+      }
+    }
+  }
+  std::stable_sort(m_LoadOffsets.begin(), m_LoadOffsets.end(),
+                   [](const TerrainChunkCoord& a, const TerrainChunkCoord& b) {
+                     return a.X * a.X + a.Z * a.Z < b.X * b.X + b.Z * b.Z;
+                   });
+}
+
+bool TerrainChunkManager::IsInsideRadius(TerrainChunkCoord coord, TerrainChunkCoord center, int radius) const
+{
+  const int x = coord.X - center.X;
+  const int z = coord.Z - center.Z;
+  return x * x + z * z <= radius * radius;
+}
+
+std::shared_ptr<const TerrainChunkMesh> TerrainChunkManager::GetChunkMesh(TerrainChunkCoord coord) const
+{
+  auto chunk = m_Chunks.find(coord);
+  return chunk != m_Chunks.end() ? chunk->second.Mesh : YEAGER_NULLPTR;
+}
+
+size_t TerrainChunkManager::GetMemoryBound() const
+{
+  const size_t side = m_Settings.ChunkQuads + 1;
+  const size_t chunkSize = sizeof(TerrainChunkMesh) + side * side * sizeof(TerrainVertex);
+
+  /* Resident chunks live inside the eviction radius, plus the ones still in flight when the camera moved away */
+  size_t resident = 0;
+  const int radius = m_Settings.LoadRadius + m_Settings.EvictionMargin;
+  for (int z = -radius; z <= radius; z++) {
+    for (int x = -radius; x <= radius; x++) {
+      resident += IsInsideRadius(TerrainChunkCoord{x, z}, TerrainChunkCoord{}, radius) ? 1 : 0;
+    }
+  }
+  return (resident + m_Settings.MaxChunksInFlight + m_Settings.MaxCachedChunks) * chunkSize;
+}
@@ -0,0 +1,197 @@
+//    Yeager Engine, free and open source 3D/2D renderer written in OpenGL
+//    In case of questions and bugs, please, refer to the issue tab on github
+//    Repo : https://github.com/schwq/YeagerEngine
+//    Copyright (C) 2023 - Present
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Common/Math/Mathematics.h"
+#include "Common/Utils/Common.h"
+#include "Common/Utils/LogEngine.h"
+#include "Common/Utils/Utilities.h"
+#include "Components/Kernel/Process/WorkerPool.h"
+#include "GradientNoise.h"
+#include "ProceduralTerrain.h"
+
+#include <limits>
+#include <list>
+
+namespace Yeager {
+
+struct TerrainChunkCoord {
+  int X = 0;
+  int Z = 0;
+
+  bool operator==(const TerrainChunkCoord& other) const { return X == other.X && Z == other.Z; }
+  bool operator<(const TerrainChunkCoord& other) const { return X != other.X ? X < other.X : Z < other.Z; }
+};
+
+/// @brief Values shared by every chunk of the streamed terrain, changing them regenerates the chunks
+struct TerrainStreamingSettings {
+  /* Quads of each side of a chunk, a chunk has ChunkQuads + 1 vertices per side and shares the border with its
+   * neighbours */
+  int ChunkQuads = 64;
+  float WorldScale = 1.0f;
+  float MaxHeight = 256.0f;
+  /* Texture repeats per chunk, whole numbers keep the texture continuous between chunks */
+  int TextureRepeat = 8;
+  NoiseFractalSettings Noise;
+  uint64_t Seed = 0;
+
+  /* Chunks inside this radius (in chunks, around the chunk of the camera) are generated and drawn */
+  int LoadRadius = 6;
+  /* Chunks are evicted only once they are this many chunks beyond the load radius, so moving on a chunk border does
+   * not thrash */
+  int EvictionMargin = 1;
+  /* Evicted chunks keep the CPU mesh in a LRU up to this amount, coming back to them only uploads the mesh again */
+  Uint MaxCachedChunks = 64;
+  /* Chunks submitted to the workers each frame, and the most chunks being generated at once */
+  Uint GenerationBudget = 4;
+  Uint MaxChunksInFlight = 16;
+  /* Chunks uploaded to the GPU each frame, the upload runs in the thread with the OpenGL context */
+  Uint UploadBudget = 2;
+  /* The headless benchmark streams without a OpenGL context */
+  bool UploadToGPU = true;
+
+  YEAGER_NODISCARD float GetChunkWorldSize() const { return ChunkQuads * WorldScale; }
+};
+
+/// @brief CPU side of a chunk, the vertices are local to the chunk origin and stored row by row (z * side + x)
+struct TerrainChunkMesh {
+  TerrainChunkCoord Coord;
+  std::vector<TerrainVertex> Vertices;
+  float MinHeight = 0.0f;
+  float MaxHeight = 0.0f;
+
+  YEAGER_NODISCARD size_t GetMemorySize() const
+  {
+    return sizeof(TerrainChunkMesh) + Vertices.capacity() * sizeof(TerrainVertex);
+  }
+};
+
+/**
+ * @brief Builds the mesh of a single chunk, used by the workers of the chunk manager. The heights come from the noise
+ * sampled at the global grid position of each vertex, the border vertices of two neighbours sample the same position
+ * and get the same height. The normals are central differences over a border of one sample around the chunk, so the
+ * border normals are also equal bit by bit between neighbours and the lighting has no seams
+ */
+class TerrainChunkBuilder {
+ public:
+  static std::shared_ptr<TerrainChunkMesh> Build(const GradientNoise& noise, const TerrainStreamingSettings& settings,
+                                                 TerrainChunkCoord coord);
+
+  /** Indices of the grid of a chunk, the same for every chunk */
+  static void BuildIndices(const TerrainStreamingSettings& settings, std::vector<GLuint>* indices);
+};
+
+struct TerrainStreamingStats {
+  Uint ResidentChunks = 0;
+  Uint UploadedChunks = 0;
+  Uint CachedChunks = 0;
+  Uint ChunksInFlight = 0;
+  Uint RequestedThisFrame = 0;
+  Uint UploadedThisFrame = 0;
+  Uint CacheHits = 0;
+  Uint TotalGenerated = 0;
+  size_t MemoryBytes = 0;
+};
+
+/**
+ * @brief Streams the terrain in chunks around the camera. Each frame Update finds the chunks inside the load radius,
+ * submits the missing ones (nearest first) to the worker pool within the generation budget, uploads the finished ones
+ * within the upload budget, and evicts the chunks far from the camera to a LRU of CPU meshes. The resident chunks are
+ * bounded by the radius and the cached by MaxCachedChunks, so the memory does not grow with the distance travelled.
+ * Update and Draw must be called from the thread with the OpenGL context
+ */
+class TerrainChunkManager {
+ public:
+  /**
+   * @param TexturesPaths Textures of the terrain shader, loaded once for every chunk. Empty when streaming without
+   *                      OpenGL (UploadToGPU false)
+   */
+  TerrainChunkManager(const TerrainStreamingSettings& settings, std::vector<String> TexturesPaths = {},
+                      WorkerPool* pool = WorkerPool::GetGlobal());
+  ~TerrainChunkManager();
+
+  TerrainChunkManager(const TerrainChunkManager&) = delete;
+  TerrainChunkManager& operator=(const TerrainChunkManager&) = delete;
+
+  void Update(const Vector3& viewerPosition);
+  void Draw(Shader* shader);
+
+  /** Waits for the chunks being generated, drops every chunk and starts streaming again with the new settings */
+  void SetSettings(const TerrainStreamingSettings& settings);
+  YEAGER_NODISCARD const TerrainStreamingSettings& GetSettings() const { return m_Settings; }
+
+  /** Blocks until the workers finished every chunk submitted */
+  void WaitForChunksInFlight();
+
+  YEAGER_NODISCARD TerrainChunkCoord WorldToChunk(const Vector3& position) const;
+  YEAGER_NODISCARD const TerrainStreamingStats& GetStats() const { return m_Stats; }
+
+  /** CPU mesh of a resident chunk, null when the chunk is not generated yet */
+  YEAGER_NODISCARD std::shared_ptr<const TerrainChunkMesh> GetChunkMesh(TerrainChunkCoord coord) const;
+
+  /** Upper limit of the memory of the resident and cached meshes with the current settings */
+  YEAGER_NODISCARD size_t GetMemoryBound() const;
+
+ private:
+  struct Chunk {
+    std::shared_ptr<TerrainChunkMesh> Mesh = YEAGER_NULLPTR;
+    std::unique_ptr<SimpleRenderer> Renderer = YEAGER_NULLPTR;
+    bool InFlight = false;
+  };
+
+  void CollectFinishedChunks();
+  void RequestChunks(TerrainChunkCoord center);
+  void UploadChunks(TerrainChunkCoord center);
+  void EvictChunks(TerrainChunkCoord center);
+  void Upload(Chunk* chunk);
+  void CacheMesh(std::shared_ptr<TerrainChunkMesh> mesh);
+  std::shared_ptr<TerrainChunkMesh> TakeCachedMesh(TerrainChunkCoord coord);
+  void ReleaseChunks();
+  void UpdateStats();
+  void UpdateTextureHeights();
+  void BuildLoadOffsets();
+
+  YEAGER_NODISCARD bool IsInsideRadius(TerrainChunkCoord coord, TerrainChunkCoord center, int radius) const;
+
+  TerrainStreamingSettings m_Settings;
+  GradientNoise m_Noise;
+  WorkerPool* m_Pool = YEAGER_NULLPTR;
+  /* Offsets of the chunks inside the load radius, nearest first */
+  std::vector<TerrainChunkCoord> m_LoadOffsets;
+
+  std::map<TerrainChunkCoord, Chunk> m_Chunks;
+  /* Most recently evicted at the front */
+  std::list<std::shared_ptr<TerrainChunkMesh>> m_Cache;
+  std::map<TerrainChunkCoord, std::list<std::shared_ptr<TerrainChunkMesh>>::iterator> m_CacheLookup;
+
+  std::vector<std::shared_ptr<TerrainChunkMesh>> m_Finished;
+  std::mutex m_FinishedMutex;
+  std::condition_variable m_FinishedCondition;
+  /* Submitted and not collected yet, changed by the main thread with the mutex locked */
+  Uint m_ChunksInFlight = 0;
+
+  std::vector<GLuint> m_Indices;
+  GLuint m_IndexBuffer = 0;
+  TerrainTexturingData m_TextureData;
+  bool m_HasTextures = false;
+
+  TerrainStreamingStats m_Stats;
+};
+
+}  // namespace Yeager
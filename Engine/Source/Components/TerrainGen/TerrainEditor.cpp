@@ -0,0 +1,196 @@
+#include "TerrainEditor.h"
+using namespace Yeager;
+
+String TerrainBrushType::ToString(TerrainBrushType::Enum type)
+{
+  switch (type) {
+    case eRAISE:
+      return "Raise";
+    case eLOWER:
+      return "Lower";
+    case eFLATTEN:
+      return "Flatten";
+    case eSMOOTH:
+      return "Smooth";
+    default:
+      return "Undefined";
+  }
+}
+
+bool TerrainDirtyRect::Touches(const TerrainDirtyRect& other, int margin) const
+{
+  if (IsEmpty() || other.IsEmpty()) {
+    return false;
+  }
+  return MinX <= other.MaxX + margin && other.MinX <= MaxX + margin && MinZ <= other.MaxZ + margin &&
+         other.MinZ <= MaxZ + margin;
+}
+
+void TerrainDirtyRect::Merge(const TerrainDirtyRect& other)
+{
+  if (other.IsEmpty()) {
+    return;
+  }
+  if (IsEmpty()) {
+    *this = other;
+    return;
+  }
+  MinX = std::min(MinX, other.MinX);
+  MinZ = std::min(MinZ, other.MinZ);
+  MaxX = std::max(MaxX, other.MaxX);
+  MaxZ = std::max(MaxZ, other.MaxZ);
+}
+
+TerrainDirtyRect TerrainDirtyRect::Expanded(int samples, int width, int height) const
+{
+  if (IsEmpty()) {
+    return *this;
+  }
+  TerrainDirtyRect rect;
+  rect.MinX = std::max(0, MinX - samples);
+  rect.MinZ = std::max(0, MinZ - samples);
+  rect.MaxX = std::min(width - 1, MaxX + samples);
+  rect.MaxZ = std::min(height - 1, MaxZ + samples);
+  return rect;
+}
+
+TerrainHeightEditor::TerrainHeightEditor(Math::Array2D<float>* heightMap, int width, int height, float minHeight,
+                                         float maxHeight)
+{
+  SetHeightMap(heightMap, width, height, minHeight, maxHeight);
+}
+
+void TerrainHeightEditor::SetHeightMap(Math::Array2D<float>* heightMap, int width, int height, float minHeight,
+                                       float maxHeight)
+{
+  m_HeightMap = heightMap;
+  m_Width = width;
+  m_Height = height;
+  m_MinHeight = minHeight;
+  m_MaxHeight = maxHeight;
+  m_DirtyRects.clear();
+}
+
+float TerrainHeightEditor::GetBrushWeight(const TerrainBrush& brush, float distance)
+{
+  const float inner = brush.Radius * (1.0f - std::clamp(brush.Falloff, 0.0f, 1.0f));
+  if (distance <= inner) {
+    return 1.0f;
+  }
+  if (distance >= brush.Radius) {
+    return 0.0f;
+  }
+  /* Smoothstep from the radius to the inner circle, no ridge on the border of the stroke */
+  const float t = (brush.Radius - distance) / (brush.Radius - inner);
+  return t * t * (3.0f - 2.0f * t);
+}
+
+TerrainDirtyRect TerrainHeightEditor::ApplyBrush(const TerrainBrush& brush, float centerX, float centerZ)
+{
+  TerrainDirtyRect rect;
+  if (!m_HeightMap || brush.Radius <= 0.0f) {
+    return rect;
+  }
+
+  rect.MinX = std::max(0, static_cast<int>(std::ceil(centerX - brush.Radius)));
+  rect.MinZ = std::max(0, static_cast<int>(std::ceil(centerZ - brush.Radius)));
+  rect.MaxX = std::min(m_Width - 1, static_cast<int>(std::floor(centerX + brush.Radius)));
+  rect.MaxZ = std::min(m_Height - 1, static_cast<int>(std::floor(centerZ + brush.Radius)));
+  if (rect.IsEmpty()) {
+    return rect;
+  }
+
+  /* The smooth brush averages the 3x3 samples around each one, read from a copy of the region and its border. Only the
+   * linear layouts have contiguous rows, the tiled one is read and written element by element */
+  const bool linear = m_HeightMap->IsLinear();
+  TerrainDirtyRect source = rect.Expanded(1, m_Width, m_Height);
+  const int sourceWidth = source.MaxX - source.MinX + 1;
+  if (brush.Type == TerrainBrushType::eSMOOTH) {
+    m_Scratch.resize(source.GetArea());
+    for (int z = source.MinZ; z <= source.MaxZ; z++) {
+      float* copy = &m_Scratch[(z - source.MinZ) * sourceWidth];
+      if (linear) {
+        std::memcpy(copy, m_HeightMap->GetAddress(source.MinX, z), sizeof(float) * sourceWidth);
+        continue;
+      }
+      for (int x = source.MinX; x <= source.MaxX; x++) {
+        copy[x - source.MinX] = m_HeightMap->At(x, z);
+      }
+    }
+  }
+  auto scratch = [&](int x, int z) { return m_Scratch[(z - source.MinZ) * sourceWidth + x - source.MinX]; };
+
+  const float strength = brush.Type == TerrainBrushType::eFLATTEN || brush.Type == TerrainBrushType::eSMOOTH
+                             ? std::clamp(brush.Strength, 0.0f, 1.0f)
+                             : brush.Strength;
+  for (int z = rect.MinZ; z <= rect.MaxZ; z++) {
+    float* row = linear ? m_HeightMap->GetAddress(0, z) : YEAGER_NULLPTR;
+    for (int x = rect.MinX; x <= rect.MaxX; x++) {
+      const float weight = GetBrushWeight(brush, std::hypot(x - centerX, z - centerZ)) * strength;
+      if (weight <= 0.0f) {
+        continue;
+      }
+      float& sample = linear ? row[x] : m_HeightMap->At(x, z);
+      float height = sample;
+      switch (brush.Type) {
+        case TerrainBrushType::eRAISE:
+          height += weight;
+          break;
+        case TerrainBrushType::eLOWER:
+          height -= weight;
+          break;
+        case TerrainBrushType::eFLATTEN:
+          height += (brush.TargetHeight - height) * weight;
+          break;
+        case TerrainBrushType::eSMOOTH: {
+          float sum = 0.0f;
+          int count = 0;
+          for (int nz = std::max(z - 1, source.MinZ); nz <= std::min(z + 1, source.MaxZ); nz++) {
+            for (int nx = std::max(x - 1, source.MinX); nx <= std::min(x + 1, source.MaxX); nx++) {
+              sum += scratch(nx, nz);
+              count++;
+            }
+          }
+          height += (sum / count - height) * weight;
+          break;
+        }
+        default:
+          break;
+      }
+      sample = std::clamp(height, m_MinHeight, m_MaxHeight);
+    }
+  }
+
+  MarkDirty(rect);
+  return rect;
+}
+
+void TerrainHeightEditor::MarkDirty(const TerrainDirtyRect& rect)
+{
+  if (rect.IsEmpty()) {
+    return;
+  }
+
+  /* Rects next to each other share the ring of normals around them, they are remeshed once as a single rect */
+  TerrainDirtyRect merged = rect;
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (auto it = m_DirtyRects.begin(); it != m_DirtyRects.end(); it++) {
+      if (merged.Touches(*it, 2)) {
+        merged.Merge(*it);
+        m_DirtyRects.erase(it);
+        changed = true;
+        break;
+      }
+    }
+  }
+  m_DirtyRects.push_back(merged);
+}
+
+std::vector<TerrainDirtyRect> TerrainHeightEditor::TakeDirtyRects()
+{
+  std::vector<TerrainDirtyRect> rects;
+  rects.swap(m_DirtyRects);
+  return rects;
+}
@@ -0,0 +1,109 @@
+//    Yeager Engine, free and open source 3D/2D renderer written in OpenGL
+//    In case of questions and bugs, please, refer to the issue tab on github
+//    Repo : https://github.com/schwq/YeagerEngine
+//    Copyright (C) 2023 - Present
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Common/Math/Mathematics.h"
+#include "Common/Utils/Common.h"
+#include "Common/Utils/LogEngine.h"
+#include "Common/Utils/Utilities.h"
+
+namespace Yeager {
+
+/// @brief Region of samples of the heightmap, both corners included. X is the column of the heightmap and Z the row
+struct TerrainDirtyRect {
+  int MinX = 0;
+  int MinZ = 0;
+  int MaxX = -1;
+  int MaxZ = -1;
+
+  YEAGER_NODISCARD bool IsEmpty() const { return MaxX < MinX || MaxZ < MinZ; }
+  YEAGER_NODISCARD size_t GetArea() const
+  {
+    return IsEmpty() ? 0 : static_cast<size_t>(MaxX - MinX + 1) * (MaxZ - MinZ + 1);
+  }
+
+  /** True when the rects overlap or are less than margin samples apart */
+  YEAGER_NODISCARD bool Touches(const TerrainDirtyRect& other, int margin = 0) const;
+  void Merge(const TerrainDirtyRect& other);
+
+  /** Grows the rect by samples on every side, clamped to the heightmap of width x height samples */
+  YEAGER_NODISCARD TerrainDirtyRect Expanded(int samples, int width, int height) const;
+};
+
+struct TerrainBrushType {
+  enum Enum { eRAISE, eLOWER, eFLATTEN, eSMOOTH };
+  YEAGER_ENUM_TO_STRING(TerrainBrushType)
+};
+
+/// @brief A circular brush over the heightmap, Radius is in samples
+struct TerrainBrush {
+  TerrainBrushType::Enum Type = TerrainBrushType::eRAISE;
+  float Radius = 16.0f;
+  /* Raise and lower move the center by Strength height units, flatten and smooth blend the center by Strength
+   * (0 to 1) to the target */
+  float Strength = 1.0f;
+  /* Fraction of the radius, from the border to the center, where the brush fades out */
+  float Falloff = 0.5f;
+  /* Height the flatten brush goes to */
+  float TargetHeight = 0.0f;
+};
+
+/**
+ * @brief Sculpts the heightmap of a terrain with brushes, every stroke marks the samples it changed as dirty. The dirty
+ * rects touching each other are merged, so the terrain remeshes and uploads each region once no matter how many
+ * strokes went over it since the last update. Heights are clamped between the min and max heights of the terrain
+ */
+class TerrainHeightEditor {
+ public:
+  TerrainHeightEditor() = default;
+  TerrainHeightEditor(Math::Array2D<float>* heightMap, int width, int height, float minHeight, float maxHeight);
+
+  void SetHeightMap(Math::Array2D<float>* heightMap, int width, int height, float minHeight, float maxHeight);
+
+  /**
+   * @brief Applies the brush centered at the sample (centerX, centerZ), the position can be between samples
+   * @return The rect of samples changed by the stroke, empty when the brush is outside the heightmap
+   */
+  TerrainDirtyRect ApplyBrush(const TerrainBrush& brush, float centerX, float centerZ);
+
+  /** Marks a region changed outside the editor, the next update remeshes it */
+  void MarkDirty(const TerrainDirtyRect& rect);
+
+  YEAGER_NODISCARD bool HasDirtyRects() const { return !m_DirtyRects.empty(); }
+  YEAGER_NODISCARD const std::vector<TerrainDirtyRect>& GetDirtyRects() const { return m_DirtyRects; }
+
+  /** Returns the dirty rects and clears them, called by whoever updates the mesh */
+  std::vector<TerrainDirtyRect> TakeDirtyRects();
+
+  /** Weight of the brush at the distance from its center, 1 inside the falloff and 0 outside the radius */
+  static float GetBrushWeight(const TerrainBrush& brush, float distance);
+
+ private:
+  Math::Array2D<float>* m_HeightMap = YEAGER_NULLPTR;
+  int m_Width = 0;
+  int m_Height = 0;
+  float m_MinHeight = 0.0f;
+  float m_MaxHeight = 0.0f;
+
+  std::vector<TerrainDirtyRect> m_DirtyRects;
+  /* Copy of the region under the smooth brush, so every sample reads the heights before the stroke */
+  std::vector<float> m_Scratch;
+};
+
+}  // namespace Yeager
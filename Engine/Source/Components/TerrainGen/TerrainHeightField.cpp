@@ -0,0 +1,428 @@
+#include "TerrainHeightField.h"
+#include "Components/Kernel/Hardware/HardwareInfo.h"
+using namespace Yeager;
+
+#ifdef YEAGER_SIMD_SSE2
+#include <immintrin.h>
+#endif
+
+/* The boxes of the pyramid grow by this much (world units), rays grazing the border of two nodes enter both */
+static const float sBoxEpsilon = 1e-3f;
+/* Deepest stack of the raycast, at most 4 children pending per level */
+#define YEAGER_TERRAIN_RAY_STACK 128
+
+void TerrainHeightField::Build(Math::Array2D<float>* heightMap, int width, int height, float worldScale,
+                               WorkerPool* pool)
+{
+  if (width < 2 || height < 2 || !heightMap->IsLinear()) {
+    Yeager::Log(WARNING, "Terrain height field needs at least 2x2 samples in linear rows, got {}x{}!", width, height);
+    return;
+  }
+
+  m_Samples = heightMap->GetAddress(0, 0);
+  m_Pitch = heightMap->GetPitch();
+  m_Width = width;
+  m_Height = height;
+  m_WorldScale = worldScale;
+  m_Path = GradientNoise::GetBestSIMDPath();
+
+  int levels = 1;
+  while (GetNodesX(levels - 1) > 1 || GetNodesZ(levels - 1) > 1) {
+    levels++;
+  }
+  m_MinMax.assign(levels, std::vector<Vector2>());
+
+  m_MinMax[0].resize(static_cast<size_t>(GetNodesX(0)) * GetNodesZ(0));
+  pool->ParallelFor(0, GetNodesZ(0), 64, [&](size_t begin, size_t end) {
+    for (int cellZ = begin; cellZ < static_cast<int>(end); cellZ++) {
+      for (int cellX = 0; cellX < GetNodesX(0); cellX++) {
+        m_MinMax[0][static_cast<size_t>(cellZ) * GetNodesX(0) + cellX] = CalculateCellMinMax(cellX, cellZ);
+      }
+    }
+  });
+
+  for (int level = 1; level < levels; level++) {
+    m_MinMax[level].resize(static_cast<size_t>(GetNodesX(level)) * GetNodesZ(level));
+    for (int nodeZ = 0; nodeZ < GetNodesZ(level); nodeZ++) {
+      for (int nodeX = 0; nodeX < GetNodesX(level); nodeX++) {
+        m_MinMax[level][static_cast<size_t>(nodeZ) * GetNodesX(level) + nodeX] =
+            JoinChildrenMinMax(level, nodeX, nodeZ);
+      }
+    }
+  }
+}
+
+void TerrainHeightField::UpdateRegion(const TerrainDirtyRect& rect)
+{
+  if (!IsBuilt() || rect.IsEmpty()) {
+    return;
+  }
+
+  /* A sample is a corner of the cells on both of its sides */
+  int beginX = std::clamp(rect.MinX - 1, 0, GetNodesX(0) - 1);
+  int beginZ = std::clamp(rect.MinZ - 1, 0, GetNodesZ(0) - 1);
+  int endX = std::clamp(rect.MaxX, 0, GetNodesX(0) - 1);
+  int endZ = std::clamp(rect.MaxZ, 0, GetNodesZ(0) - 1);
+  for (int cellZ = beginZ; cellZ <= endZ; cellZ++) {
+    for (int cellX = beginX; cellX <= endX; cellX++) {
+      m_MinMax[0][static_cast<size_t>(cellZ) * GetNodesX(0) + cellX] = CalculateCellMinMax(cellX, cellZ);
+    }
+  }
+  for (int level = 1; level < GetLevelCount(); level++) {
+    beginX /= 2, beginZ /= 2, endX /= 2, endZ /= 2;
+    for (int nodeZ = beginZ; nodeZ <= endZ; nodeZ++) {
+      for (int nodeX = beginX; nodeX <= endX; nodeX++) {
+        m_MinMax[level][static_cast<size_t>(nodeZ) * GetNodesX(level) + nodeX] =
+            JoinChildrenMinMax(level, nodeX, nodeZ);
+      }
+    }
+  }
+}
+
+int TerrainHeightField::GetNodesX(int level) const
+{
+  return ((m_Width - 1) + (1 << level) - 1) >> level;
+}
+
+int TerrainHeightField::GetNodesZ(int level) const
+{
+  return ((m_Height - 1) + (1 << level) - 1) >> level;
+}
+
+Vector2 TerrainHeightField::CalculateCellMinMax(int cellX, int cellZ) const
+{
+  const float h00 = Sample(cellX, cellZ);
+  const float h10 = Sample(cellX + 1, cellZ);
+  const float h01 = Sample(cellX, cellZ + 1);
+  const float h11 = Sample(cellX + 1, cellZ + 1);
+  return Vector2(std::min({h00, h10, h01, h11}), std::max({h00, h10, h01, h11}));
+}
+
+Vector2 TerrainHeightField::JoinChildrenMinMax(int level, int nodeX, int nodeZ) const
+{
+  Vector2 minMax(std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest());
+  for (int childZ = nodeZ * 2; childZ < std::min(nodeZ * 2 + 2, GetNodesZ(level - 1)); childZ++) {
+    for (int childX = nodeX * 2; childX < std::min(nodeX * 2 + 2, GetNodesX(level - 1)); childX++) {
+      const Vector2& child = m_MinMax[level - 1][static_cast<size_t>(childZ) * GetNodesX(level - 1) + childX];
+      minMax.x = std::min(minMax.x, child.x);
+      minMax.y = std::max(minMax.y, child.y);
+    }
+  }
+  return minMax;
+}
+
+void TerrainHeightField::SetSIMDPath(NoiseSIMDPath::Enum path)
+{
+  if (path == NoiseSIMDPath::eSIMD_AVX2 && !HardwareSupportsAVX2()) {
+    Yeager::Log(WARNING, "Terrain height field SIMD path {} not supported by the hardware!",
+                NoiseSIMDPath::ToString(path));
+    return;
+  }
+  m_Path = path;
+}
+
+/* The clamps are written as the max and min of the SIMD path, so both agree even on negative zeros */
+TerrainHeightField::Cell TerrainHeightField::FindCell(float x, float z) const
+{
+  const float fx = std::min(std::max(x / m_WorldScale, 0.0f), static_cast<float>(m_Width - 1));
+  const float fz = std::min(std::max(z / m_WorldScale, 0.0f), static_cast<float>(m_Height - 1));
+  Cell cell;
+  cell.X = std::min(static_cast<int>(fx), m_Width - 2);
+  cell.Z = std::min(static_cast<int>(fz), m_Height - 2);
+  cell.TX = fx - static_cast<float>(cell.X);
+  cell.TZ = fz - static_cast<float>(cell.Z);
+  return cell;
+}
+
+float TerrainHeightField::SampleHeight(float x, float z) const
+{
+  const Cell cell = FindCell(x, z);
+  const float h00 = Sample(cell.X, cell.Z);
+  const float h10 = Sample(cell.X + 1, cell.Z);
+  const float h01 = Sample(cell.X, cell.Z + 1);
+  const float h11 = Sample(cell.X + 1, cell.Z + 1);
+  const float h0 = h00 + (h10 - h00) * cell.TX;
+  const float h1 = h01 + (h11 - h01) * cell.TX;
+  return h0 + (h1 - h0) * cell.TZ;
+}
+
+/* Normal of the bilinear surface, (-dh/dx, 1, -dh/dz) scaled by the world scale */
+Vector3 TerrainHeightField::SampleNormal(float x, float z) const
+{
+  const Cell cell = FindCell(x, z);
+  const float h00 = Sample(cell.X, cell.Z);
+  const float h10 = Sample(cell.X + 1, cell.Z);
+  const float h01 = Sample(cell.X, cell.Z + 1);
+  const float h11 = Sample(cell.X + 1, cell.Z + 1);
+  const float bottom = h10 - h00;
+  const float top = h11 - h01;
+  const float left = h01 - h00;
+  const float right = h11 - h10;
+  const float dx = bottom + (top - bottom) * cell.TZ;
+  const float dz = left + (right - left) * cell.TX;
+  const float inverseLength = 1.0f / std::sqrt(dx * dx + m_WorldScale * m_WorldScale + dz * dz);
+  return Vector3(-dx * inverseLength, m_WorldScale * inverseLength, -dz * inverseLength);
+}
+
+#ifdef YEAGER_SIMD_SSE2
+
+/* The four corners of the cells of 8 points, same math of FindCell */
+struct HeightFieldCornersAVX2 {
+  __m256 H00, H10, H01, H11;
+  __m256 TX, TZ;
+};
+
+YEAGER_SIMD_TARGET("avx2")
+static HeightFieldCornersAVX2 GatherCornersAVX2(const float* samples, int pitch, int width, int height,
+                                                float worldScale, const float* x, const float* z)
+{
+  const __m256 scale = _mm256_set1_ps(worldScale);
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 fx = _mm256_min_ps(_mm256_set1_ps(static_cast<float>(width - 1)),
+                                  _mm256_max_ps(zero, _mm256_div_ps(_mm256_loadu_ps(x), scale)));
+  const __m256 fz = _mm256_min_ps(_mm256_set1_ps(static_cast<float>(height - 1)),
+                                  _mm256_max_ps(zero, _mm256_div_ps(_mm256_loadu_ps(z), scale)));
+  const __m256i cellX = _mm256_min_epi32(_mm256_cvttps_epi32(fx), _mm256_set1_epi32(width - 2));
+  const __m256i cellZ = _mm256_min_epi32(_mm256_cvttps_epi32(fz), _mm256_set1_epi32(height - 2));
+
+  const __m256i index = _mm256_add_epi32(_mm256_mullo_epi32(cellZ, _mm256_set1_epi32(pitch)), cellX);
+  const __m256i up = _mm256_add_epi32(index, _mm256_set1_epi32(pitch));
+  const __m256i one = _mm256_set1_epi32(1);
+
+  HeightFieldCornersAVX2 corners;
+  corners.H00 = _mm256_i32gather_ps(samples, index, 4);
+  corners.H10 = _mm256_i32gather_ps(samples, _mm256_add_epi32(index, one), 4);
+  corners.H01 = _mm256_i32gather_ps(samples, up, 4);
+  corners.H11 = _mm256_i32gather_ps(samples, _mm256_add_epi32(up, one), 4);
+  corners.TX = _mm256_sub_ps(fx, _mm256_cvtepi32_ps(cellX));
+  corners.TZ = _mm256_sub_ps(fz, _mm256_cvtepi32_ps(cellZ));
+  return corners;
+}
+
+YEAGER_SIMD_TARGET("avx2")
+static __m256 LerpAVX2(__m256 a, __m256 b, __m256 t)
+{
+  return _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), t));
+}
+
+YEAGER_SIMD_TARGET("avx2")
+static void SampleHeightsAVX2(const float* samples, int pitch, int width, int height, float worldScale, const float* x,
+                              const float* z, float* heights)
+{
+  const HeightFieldCornersAVX2 c = GatherCornersAVX2(samples, pitch, width, height, worldScale, x, z);
+  const __m256 h0 = LerpAVX2(c.H00, c.H10, c.TX);
+  const __m256 h1 = LerpAVX2(c.H01, c.H11, c.TX);
+  _mm256_storeu_ps(heights, LerpAVX2(h0, h1, c.TZ));
+}
+
+YEAGER_SIMD_TARGET("avx2")
+static void SampleNormalsAVX2(const float* samples, int pitch, int width, int height, float worldScale, const float* x,
+                              const float* z, Vector3* normals)
+{
+  const HeightFieldCornersAVX2 c = GatherCornersAVX2(samples, pitch, width, height, worldScale, x, z);
+  const __m256 dx = LerpAVX2(_mm256_sub_ps(c.H10, c.H00), _mm256_sub_ps(c.H11, c.H01), c.TZ);
+  const __m256 dz = LerpAVX2(_mm256_sub_ps(c.H01, c.H00), _mm256_sub_ps(c.H11, c.H10), c.TX);
+  const __m256 scale = _mm256_set1_ps(worldScale);
+  const __m256 lengthSquared =
+      _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(scale, scale)), _mm256_mul_ps(dz, dz));
+  const __m256 inverseLength = _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(lengthSquared));
+  const __m256 sign = _mm256_set1_ps(-0.0f);
+
+  alignas(32) float nx[YEAGER_TERRAIN_QUERY_BATCH], ny[YEAGER_TERRAIN_QUERY_BATCH], nz[YEAGER_TERRAIN_QUERY_BATCH];
+  _mm256_store_ps(nx, _mm256_mul_ps(_mm256_xor_ps(dx, sign), inverseLength));
+  _mm256_store_ps(ny, _mm256_mul_ps(scale, inverseLength));
+  _mm256_store_ps(nz, _mm256_mul_ps(_mm256_xor_ps(dz, sign), inverseLength));
+  for (int lane = 0; lane < YEAGER_TERRAIN_QUERY_BATCH; lane++) {
+    normals[lane] = Vector3(nx[lane], ny[lane], nz[lane]);
+  }
+}
+
+#endif
+
+void TerrainHeightField::SampleHeights(const float* x, const float* z, float* heights, size_t count) const
+{
+  size_t point = 0;
+#ifdef YEAGER_SIMD_SSE2
+  if (m_Path == NoiseSIMDPath::eSIMD_AVX2) {
+    for (; point + YEAGER_TERRAIN_QUERY_BATCH <= count; point += YEAGER_TERRAIN_QUERY_BATCH) {
+      SampleHeightsAVX2(m_Samples, m_Pitch, m_Width, m_Height, m_WorldScale, x + point, z + point, heights + point);
+    }
+  }
+#endif
+  for (; point < count; point++) {
+    heights[point] = SampleHeight(x[point], z[point]);
+  }
+}
+
+void TerrainHeightField::SampleNormals(const float* x, const float* z, Vector3* normals, size_t count) const
+{
+  size_t point = 0;
+#ifdef YEAGER_SIMD_SSE2
+  if (m_Path == NoiseSIMDPath::eSIMD_AVX2) {
+    for (; point + YEAGER_TERRAIN_QUERY_BATCH <= count; point += YEAGER_TERRAIN_QUERY_BATCH) {
+      SampleNormalsAVX2(m_Samples, m_Pitch, m_Width, m_Height, m_WorldScale, x + point, z + point, normals + point);
+    }
+  }
+#endif
+  for (; point < count; point++) {
+    normals[point] = SampleNormal(x[point], z[point]);
+  }
+}
+
+/* Möller-Trumbore, both faces of the triangle are hit */
+static bool IntersectTriangle(const TerrainRay& ray, const Vector3& a, const Vector3& b, const Vector3& c,
+                              float* distance)
+{
+  const Vector3 edge1 = b - a;
+  const Vector3 edge2 = c - a;
+  const Vector3 p = glm::cross(ray.Direction, edge2);
+  const float determinant = glm::dot(edge1, p);
+  if (std::fabs(determinant) < 1e-12f) {
+    return false;
+  }
+  const float inverse = 1.0f / determinant;
+  const Vector3 s = ray.Origin - a;
+  const float u = glm::dot(s, p) * inverse;
+  if (u < 0.0f || u > 1.0f) {
+    return false;
+  }
+  const Vector3 q = glm::cross(s, edge1);
+  const float v = glm::dot(ray.Direction, q) * inverse;
+  if (v < 0.0f || u + v > 1.0f) {
+    return false;
+  }
+  *distance = glm::dot(edge2, q) * inverse;
+  return true;
+}
+
+bool TerrainHeightField::IntersectCell(const TerrainRay& ray, int cellX, int cellZ, float maxDistance,
+                                       TerrainRayHit* hit) const
+{
+  /* The same two triangles of the terrain mesh, split by the diagonal from (x, z) to (x + 1, z + 1) */
+  const float x0 = cellX * m_WorldScale, x1 = (cellX + 1) * m_WorldScale;
+  const float z0 = cellZ * m_WorldScale, z1 = (cellZ + 1) * m_WorldScale;
+  const Vector3 p00(x0, Sample(cellX, cellZ), z0);
+  const Vector3 p10(x1, Sample(cellX + 1, cellZ), z0);
+  const Vector3 p01(x0, Sample(cellX, cellZ + 1), z1);
+  const Vector3 p11(x1, Sample(cellX + 1, cellZ + 1), z1);
+
+  bool found = false;
+  const Vector3* triangles[2][3] = {{&p00, &p10, &p11}, {&p00, &p11, &p01}};
+  for (const auto& triangle : triangles) {
+    float distance;
+    if (!IntersectTriangle(ray, *triangle[0], *triangle[1], *triangle[2], &distance) || distance < 0.0f ||
+        distance > maxDistance) {
+      continue;
+    }
+    maxDistance = distance;
+    found = true;
+    if (hit) {
+      hit->Distance = distance;
+      hit->Position = ray.Origin + ray.Direction * distance;
+      /* Both triangles wind clockwise seen from above */
+      hit->Normal = glm::normalize(glm::cross(*triangle[2] - *triangle[0], *triangle[1] - *triangle[0]));
+      hit->CellX = cellX;
+      hit->CellZ = cellZ;
+    }
+  }
+  return found;
+}
+
+/* Slab test of the ray against the box, enter is the distance the ray gets in the box */
+static bool IntersectBox(const TerrainRay& ray, const Vector3& inverse, const Vector3& min, const Vector3& max,
+                         float maxDistance, float* enter)
+{
+  float tMin = 0.0f, tMax = maxDistance;
+  for (int axis = 0; axis < 3; axis++) {
+    if (ray.Direction[axis] == 0.0f) {
+      if (ray.Origin[axis] < min[axis] || ray.Origin[axis] > max[axis]) {
+        return false;
+      }
+      continue;
+    }
+    float t0 = (min[axis] - ray.Origin[axis]) * inverse[axis];
+    float t1 = (max[axis] - ray.Origin[axis]) * inverse[axis];
+    if (t0 > t1) {
+      std::swap(t0, t1);
+    }
+    tMin = std::max(tMin, t0);
+    tMax = std::min(tMax, t1);
+    if (tMin > tMax) {
+      return false;
+    }
+  }
+  *enter = tMin;
+  return true;
+}
+
+bool TerrainHeightField::Raycast(const TerrainRay& ray, TerrainRayHit* hit) const
+{
+  if (!IsBuilt()) {
+    return false;
+  }
+
+  struct Node {
+    int Level;
+    int X;
+    int Z;
+    float Enter;
+  };
+
+  const Vector3 inverse(1.0f / ray.Direction.x, 1.0f / ray.Direction.y, 1.0f / ray.Direction.z);
+  auto boxOf = [&](int level, int nodeX, int nodeZ, Vector3* min, Vector3* max) {
+    const Vector2& minMax = m_MinMax[level][static_cast<size_t>(nodeZ) * GetNodesX(level) + nodeX];
+    *min = Vector3((nodeX << level) * m_WorldScale - sBoxEpsilon, minMax.x - sBoxEpsilon,
+                   (nodeZ << level) * m_WorldScale - sBoxEpsilon);
+    *max = Vector3(std::min((nodeX + 1) << level, m_Width - 1) * m_WorldScale + sBoxEpsilon, minMax.y + sBoxEpsilon,
+                   std::min((nodeZ + 1) << level, m_Height - 1) * m_WorldScale + sBoxEpsilon);
+  };
+
+  Node stack[YEAGER_TERRAIN_RAY_STACK];
+  int top = 0;
+  Vector3 min, max;
+  float enter;
+  boxOf(GetLevelCount() - 1, 0, 0, &min, &max);
+  if (!IntersectBox(ray, inverse, min, max, ray.MaxDistance, &enter)) {
+    return false;
+  }
+  stack[top++] = Node{GetLevelCount() - 1, 0, 0, enter};
+
+  float nearest = ray.MaxDistance;
+  bool found = false;
+  while (top > 0) {
+    const Node node = stack[--top];
+    if (node.Enter > nearest) {
+      continue;
+    }
+
+    if (node.Level == 0) {
+      TerrainRayHit cellHit;
+      if (IntersectCell(ray, node.X, node.Z, nearest, &cellHit)) {
+        nearest = cellHit.Distance;
+        found = true;
+        if (hit) {
+          *hit = cellHit;
+        }
+      }
+      continue;
+    }
+
+    /* The children are pushed farthest first, so the nearest one is opened next */
+    Node children[4];
+    int count = 0;
+    const int level = node.Level - 1;
+    for (int childZ = node.Z * 2; childZ < std::min(node.Z * 2 + 2, GetNodesZ(level)); childZ++) {
+      for (int childX = node.X * 2; childX < std::min(node.X * 2 + 2, GetNodesX(level)); childX++) {
+        boxOf(level, childX, childZ, &min, &max);
+        if (IntersectBox(ray, inverse, min, max, nearest, &enter)) {
+          children[count++] = Node{level, childX, childZ, enter};
+        }
+      }
+    }
+    std::sort(children, children + count, [](const Node& a, const Node& b) { return a.Enter > b.Enter; });
+    for (int child = 0; child < count; child++) {
+      stack[top++] = children[child];
+    }
+  }
+  return found;
+}
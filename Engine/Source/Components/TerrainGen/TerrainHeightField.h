@@ -0,0 +1,119 @@
+//    Yeager Engine, free and open source 3D/2D renderer written in OpenGL
+//    In case of questions and bugs, please, refer to the issue tab on github
+//    Repo : https://github.com/schwq/YeagerEngine
+//    Copyright (C) 2023 - Present
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Common/Math/Mathematics.h"
+#include "Common/Utils/Common.h"
+#include "Common/Utils/LogEngine.h"
+#include "Common/Utils/Utilities.h"
+#include "Components/Kernel/Process/WorkerPool.h"
+#include "GradientNoise.h"
+#include "TerrainEditor.h"
+
+namespace Yeager {
+
+/* Points sampled by each SIMD batch of the height queries */
+#define YEAGER_TERRAIN_QUERY_BATCH 8
+
+/// @brief Ray in the space of the terrain (before the model matrix), the direction does not need to be normalized
+struct TerrainRay {
+  Vector3 Origin = Vector3(0.0f);
+  Vector3 Direction = Vector3(0.0f, -1.0f, 0.0f);
+  /* In units of the direction */
+  float MaxDistance = std::numeric_limits<float>::max();
+};
+
+struct TerrainRayHit {
+  Vector3 Position = Vector3(0.0f);
+  Vector3 Normal = Vector3(0.0f, 1.0f, 0.0f);
+  float Distance = 0.0f;
+  /* Cell of the heightmap hit, the quad between the samples (X, Z) and (X + 1, Z + 1) */
+  int CellX = -1;
+  int CellZ = -1;
+};
+
+/**
+ * @brief Read only queries over a heightmap (heights, normals and rays), positions are in the space of the terrain, the
+ * sample (x, z) is at (x * WorldScale, z * WorldScale).
+ * Heights and normals are the bilinear surface of the samples, the batch functions sample YEAGER_TERRAIN_QUERY_BATCH
+ * points at once with AVX2 gathers and return the same values of the single queries bit by bit.
+ * Rays hit the two triangles of each quad drawn by the terrain. A min/max pyramid over the quads (every level joins 2x2
+ * nodes of the level below) lets the raycast skip any node the ray passes above or below, visiting the nodes front to
+ * back, so only the nodes near the surface along the ray are opened
+ */
+class TerrainHeightField {
+ public:
+  /** The heightmap (width x height samples, X as the column) must outlive the height field and have linear rows */
+  void Build(Math::Array2D<float>* heightMap, int width, int height, float worldScale,
+             WorkerPool* pool = WorkerPool::GetGlobal());
+
+  /** Refreshes the pyramid over the samples of the rect after the heightmap was edited */
+  void UpdateRegion(const TerrainDirtyRect& rect);
+
+  YEAGER_NODISCARD float SampleHeight(float x, float z) const;
+  YEAGER_NODISCARD Vector3 SampleNormal(float x, float z) const;
+
+  /** Heights of count points given as separated X and Z arrays, positions outside the heightmap are clamped */
+  void SampleHeights(const float* x, const float* z, float* heights, size_t count) const;
+  void SampleNormals(const float* x, const float* z, Vector3* normals, size_t count) const;
+
+  /** Nearest hit of the ray with the surface, false if the ray misses the terrain before its max distance */
+  bool Raycast(const TerrainRay& ray, TerrainRayHit* hit) const;
+
+  /** Hit of the ray with the two triangles of the cell, used by the raycast and to validate it */
+  bool IntersectCell(const TerrainRay& ray, int cellX, int cellZ, float maxDistance, TerrainRayHit* hit) const;
+
+  /** Forces a path of the batch queries, SSE4.1 has no gathers and runs the scalar path */
+  void SetSIMDPath(NoiseSIMDPath::Enum path);
+  YEAGER_NODISCARD NoiseSIMDPath::Enum GetSIMDPath() const { return m_Path; }
+
+  YEAGER_NODISCARD bool IsBuilt() const { return m_Samples != YEAGER_NULLPTR; }
+  YEAGER_NODISCARD int GetLevelCount() const { return m_MinMax.size(); }
+  YEAGER_NODISCARD int GetWidth() const { return m_Width; }
+  YEAGER_NODISCARD int GetHeight() const { return m_Height; }
+  YEAGER_NODISCARD float GetWorldScale() const { return m_WorldScale; }
+
+ private:
+  struct Cell {
+    int X;
+    int Z;
+    float TX;
+    float TZ;
+  };
+
+  YEAGER_FORCE_INLINE Cell FindCell(float x, float z) const;
+  YEAGER_FORCE_INLINE float Sample(int x, int z) const { return m_Samples[static_cast<size_t>(z) * m_Pitch + x]; }
+
+  Vector2 CalculateCellMinMax(int cellX, int cellZ) const;
+  Vector2 JoinChildrenMinMax(int level, int nodeX, int nodeZ) const;
+  YEAGER_NODISCARD int GetNodesX(int level) const;
+  YEAGER_NODISCARD int GetNodesZ(int level) const;
+
+  const float* m_Samples = YEAGER_NULLPTR;
+  int m_Pitch = 0;
+  int m_Width = 0;
+  int m_Height = 0;
+  float m_WorldScale = 1.0f;
+  NoiseSIMDPath::Enum m_Path = NoiseSIMDPath::eSIMD_SCALAR;
+
+  /* Min and max heights of the nodes of each level, node by node in rows. The level 0 are the cells of the heightmap */
+  std::vector<std::vector<Vector2>> m_MinMax;
+};
+
+}  // namespace Yeager
@@ -0,0 +1,551 @@
+#include "TerrainHeightMap.h"
+#include "Common/FS/DirectorySystem.h"
+#include "Components/Kernel/Caching/Cache.h"
+#include "Components/Kernel/Memory/Allocator.h"
+using namespace Yeager;
+
+/* Shortest match worth a LZ sequence, and the bits of the hash table of the last position of every 4 bytes */
+#define YEAGER_TERRAIN_LZ_MIN_MATCH 4
+#define YEAGER_TERRAIN_LZ_HASH_BITS 14
+#define YEAGER_TERRAIN_LZ_MAX_OFFSET 65535
+
+String TerrainHeightMapFormat::ToString(TerrainHeightMapFormat::Enum type)
+{
+  switch (type) {
+    case eUNORM16:
+      return "Unorm 16";
+    case eFLOAT32:
+      return "Float 32";
+    default:
+      return "Undefined";
+  }
+}
+
+String TerrainHeightMapCompression::ToString(TerrainHeightMapCompression::Enum type)
+{
+  switch (type) {
+    case eNONE:
+      return "None";
+    case eDELTA_LZ:
+      return "Delta LZ";
+    default:
+      return "Undefined";
+  }
+}
+
+static uint64_t AlignOffset(uint64_t offset)
+{
+  return (offset + 7) & ~static_cast<uint64_t>(7);
+}
+
+static void WriteLZLength(std::vector<uint8_t>* output, size_t length)
+{
+  while (length >= 255) {
+    output->push_back(255);
+    length -= 255;
+  }
+  output->push_back(static_cast<uint8_t>(length));
+}
+
+static bool ReadLZLength(const uint8_t** input, const uint8_t* end, size_t* length)
+{
+  uint8_t byte = 255;
+  while (byte == 255) {
+    if (*input >= end) {
+      return false;
+    }
+    byte = *(*input)++;
+    *length += byte;
+  }
+  return true;
+}
+
+/**
+ * Byte oriented LZ77 like LZ4, every sequence is a token (literals count in the high 4 bits, match length - 4 in the
+ * low 4 bits, 15 means more length bytes follow), the literals, and the 16 bits offset of the match. The last sequence
+ * only has literals
+ */
+static void CompressLZ(const uint8_t* input, size_t size, std::vector<uint8_t>* output)
+{
+  std::vector<uint32_t> table(1 << YEAGER_TERRAIN_LZ_HASH_BITS, UINT32_MAX);
+  size_t anchor = 0;
+  size_t position = 0;
+
+  auto emit = [&](size_t literals, size_t match, size_t offset) {
+    const size_t extra = match > 0 ? match - YEAGER_TERRAIN_LZ_MIN_MATCH : 0;
+    output->push_back(static_cast<uint8_t>((std::min<size_t>(literals, 15) << 4) | std::min<size_t>(extra, 15)));
+    if (literals >= 15) {
+      WriteLZLength(output, literals - 15);
+    }
+    output->insert(output->end(), input + anchor, input + anchor + literals);
+    if (match > 0) {
+      output->push_back(static_cast<uint8_t>(offset & 0xFF));
+      output->push_back(static_cast<uint8_t>(offset >> 8));
+      if (extra >= 15) {
+        WriteLZLength(output, extra - 15);
+      }
+    }
+  };
+
+  while (position + YEAGER_TERRAIN_LZ_MIN_MATCH <= size) {
+    uint32_t sequence;
+    std::memcpy(&sequence, input + position, sizeof(uint32_t));
+    const uint32_t hash = (sequence * 2654435761u) >> (32 - YEAGER_TERRAIN_LZ_HASH_BITS);
+    const uint32_t candidate = table[hash];
+    table[hash] = static_cast<uint32_t>(position);
+
+    if (candidate != UINT32_MAX && position - candidate <= YEAGER_TERRAIN_LZ_MAX_OFFSET &&
+        std::memcmp(input + candidate, input + position, YEAGER_TERRAIN_LZ_MIN_MATCH) == 0) {
+      size_t length = YEAGER_TERRAIN_LZ_MIN_MATCH;
+      while (position + length < size && input[candidate + length] == input[position + length]) {
+        length++;
+      }
+      emit(position - anchor, length, position - candidate);
+      position += length;
+      anchor = position;
+    } else {
+      position++;
+    }
+  }
+  emit(size - anchor, 0, 0);
+}
+
+static bool DecompressLZ(const uint8_t* input, size_t size, uint8_t* output, size_t outputSize)
+{
+  const uint8_t* end = input + size;
+  uint8_t* out = output;
+  uint8_t* outEnd = output + outputSize;
+
+  while (input < end) {
+    const uint8_t token = *input++;
+    size_t literals = token >> 4;
+    if (literals == 15 && !ReadLZLength(&input, end, &literals)) {
+      return false;
+    }
+    if (literals > static_cast<size_t>(end - input) || literals > static_cast<size_t>(outEnd - out)) {
+      return false;
+    }
+    std::memcpy(out, input, literals);
+    input += literals;
+    out += literals;
+    if (input == end) {
+      break;
+    }
+
+    if (end - input < 2) {
+      return false;
+    }
+    const size_t offset = input[0] | (input[1] << 8);
+    input += 2;
+    size_t length = token & 0x0F;
+    if (length == 15 && !ReadLZLength(&input, end, &length)) {
+      return false;
+    }
+    length += YEAGER_TERRAIN_LZ_MIN_MATCH;
+    if (offset == 0 || offset > static_cast<size_t>(out - output) || length > static_cast<size_t>(outEnd - out)) {
+      return false;
+    }
+    /* The match can overlap the bytes it writes, copied byte by byte */
+    const uint8_t* match = out - offset;
+    for (size_t x = 0; x < length; x++) {
+      out[x] = match[x];
+    }
+    out += length;
+  }
+  return out == outEnd;
+}
+
+/* Samples of the rows as the integer codes of the format, the float samples keep their bits */
+static void EncodeRows(const float* samples, int width, int rows, Uint sampleBytes, float quantizeMin,
+                       float quantizeMax, uint8_t* output)
+{
+  const size_t count = static_cast<size_t>(width) * rows;
+  if (sampleBytes == sizeof(float)) {
+    std::memcpy(output, samples, count * sizeof(float));
+    return;
+  }
+  const float scale = quantizeMax > quantizeMin ? 65535.0f / (quantizeMax - quantizeMin) : 0.0f;
+  uint16_t* codes = reinterpret_cast<uint16_t*>(output);
+  for (size_t x = 0; x < count; x++) {
+    codes[x] = static_cast<uint16_t>(std::clamp((samples[x] - quantizeMin) * scale + 0.5f, 0.0f, 65535.0f));
+  }
+}
+
+/* Prediction of a code from its left, lower and lower left neighbours in the block (the plane through them), the
+ * first row of a block only has the left one */
+template <typename Code>
+static Code PredictCode(const Code* codes, int width, int row, int x)
+{
+  const size_t index = static_cast<size_t>(row) * width + x;
+  if (row == 0) {
+    return x > 0 ? codes[index - 1] : 0;
+  }
+  if (x == 0) {
+    return codes[index - width];
+  }
+  return static_cast<Code>(codes[index - 1] + codes[index - width] - codes[index - width - 1]);
+}
+
+/* Difference of every code to its prediction, zigzag encoded so small negative differences are small numbers too. The
+ * bytes of all differences are then split in planes (all the low bytes, then the next ones), on smooth terrains the
+ * high planes are long runs of zeros the LZ removes */
+template <typename Code>
+static void DeltaPlanes(const uint8_t* codes, int width, int rows, uint8_t* output)
+{
+  typedef std::make_signed_t<Code> Signed;
+  const size_t count = static_cast<size_t>(width) * rows;
+  const Code* input = reinterpret_cast<const Code*>(codes);
+  for (int row = 0; row < rows; row++) {
+    for (int x = 0; x < width; x++) {
+      const size_t index = static_cast<size_t>(row) * width + x;
+      const Signed delta = static_cast<Signed>(input[index] - PredictCode(input, width, row, x));
+      const Code sign = static_cast<Code>(delta >> (sizeof(Code) * 8 - 1));
+      const Code zigzag = static_cast<Code>((static_cast<Code>(delta) << 1) ^ sign);
+      for (size_t byte = 0; byte < sizeof(Code); byte++) {
+        output[byte * count + index] = static_cast<uint8_t>(zigzag >> (byte * 8));
+      }
+    }
+  }
+}
+
+template <typename Code>
+static void UndoDeltaPlanes(const uint8_t* planes, int width, int rows, uint8_t* output)
+{
+  const size_t count = static_cast<size_t>(width) * rows;
+  Code* codes = reinterpret_cast<Code*>(output);
+  for (int row = 0; row < rows; row++) {
+    for (int x = 0; x < width; x++) {
+      const size_t index = static_cast<size_t>(row) * width + x;
+      Code zigzag = 0;
+      for (size_t byte = 0; byte < sizeof(Code); byte++) {
+        zigzag |= static_cast<Code>(planes[byte * count + index]) << (byte * 8);
+      }
+      const Code delta = static_cast<Code>((zigzag >> 1) ^ (0 - (zigzag & 1)));
+      codes[index] = static_cast<Code>(PredictCode(codes, width, row, x) + delta);
+    }
+  }
+}
+
+bool TerrainHeightMapFile::Write(const String& path, const float* samples, const TerrainHeightMapInfo& info,
+                                 const TerrainHeightMapWriteSettings& settings, size_t* bytesWritten)
+{
+  if (!samples || info.Width <= 0 || info.Height <= 0) {
+    Yeager::Log(ERROR, "Cannot write empty heightmap to {}", path);
+    return false;
+  }
+
+  TerrainHeightMapFileHeader header;
+  std::memcpy(header.MagicConst, YEAGER_CACHE_MAGIC_CONST, sizeof(char) * 4);
+  header.Version = YEAGER_TERRAIN_HEIGHTMAP_VERSION;
+  header.Width = info.Width;
+  header.Height = info.Height;
+  header.Format = settings.Format;
+  header.Compression = settings.Compression;
+  header.MinHeight = info.MinHeight;
+  header.MaxHeight = info.MaxHeight;
+  header.WorldScale = info.WorldScale;
+  header.TextureScale = info.TextureScale;
+  header.TerrainSize = info.TerrainSize;
+  header.Seed = info.Seed;
+
+  const size_t count = static_cast<size_t>(info.Width) * info.Height;
+  const auto [lowest, highest] = std::minmax_element(samples, samples + count);
+  header.QuantizeMin = *lowest;
+  header.QuantizeMax = *highest;
+  const Uint sampleBytes = settings.Format == TerrainHeightMapFormat::eUNORM16 ? sizeof(uint16_t) : sizeof(float);
+
+  std::vector<uint8_t> buffer;
+  if (settings.Compression == TerrainHeightMapCompression::eNONE) {
+    header.SamplesOffset = AlignOffset(sizeof(TerrainHeightMapFileHeader));
+    header.FileSize = AlignOffset(header.SamplesOffset + count * sampleBytes);
+    buffer.assign(header.FileSize, 0);
+    EncodeRows(samples, info.Width, info.Height, sampleBytes, header.QuantizeMin, header.QuantizeMax,
+               buffer.data() + header.SamplesOffset);
+  } else {
+    header.BlockRows = YEAGER_TERRAIN_HEIGHTMAP_BLOCK_ROWS;
+    header.BlockCount = (info.Height + header.BlockRows - 1) / header.BlockRows;
+    std::vector<std::vector<uint8_t>> compressed(header.BlockCount);
+    WorkerPool::GetGlobal()->ParallelFor(0, header.BlockCount, 1, [&](size_t begin, size_t end) {
+      std::vector<uint8_t> codes, planes;
+      for (size_t block = begin; block < end; block++) {
+        const int firstRow = block * header.BlockRows;
+        const int rows = std::min<int>(header.BlockRows, info.Height - firstRow);
+        codes.resize(static_cast<size_t>(info.Width) * rows * sampleBytes);
+        planes.resize(codes.size());
+        EncodeRows(samples + static_cast<size_t>(firstRow) * info.Width, info.Width, rows, sampleBytes,
+                   header.QuantizeMin, header.QuantizeMax, codes.data());
+        if (sampleBytes == sizeof(uint16_t)) {
+          DeltaPlanes<uint16_t>(codes.data(), info.Width, rows, planes.data());
+        } else {
+          DeltaPlanes<uint32_t>(codes.data(), info.Width, rows, planes.data());
+        }
+        CompressLZ(planes.data(), planes.size(), &compressed[block]);
+      }
+    });
+
+    std::vector<TerrainHeightMapBlock> blocks(header.BlockCount);
+    header.BlocksOffset = AlignOffset(sizeof(TerrainHeightMapFileHeader));
+    header.SamplesOffset = AlignOffset(header.BlocksOffset + blocks.size() * sizeof(TerrainHeightMapBlock));
+    uint64_t offset = header.SamplesOffset;
+    for (size_t block = 0; block < blocks.size(); block++) {
+      blocks[block].Offset = offset;
+      blocks[block].Size = compressed[block].size();
+      offset += compressed[block].size();
+    }
+    header.FileSize = AlignOffset(offset);
+    buffer.assign(header.FileSize, 0);
+    std::memcpy(buffer.data() + header.BlocksOffset, blocks.data(), blocks.size() * sizeof(TerrainHeightMapBlock));
+    for (size_t block = 0; block < blocks.size(); block++) {
+      std::memcpy(buffer.data() + blocks[block].Offset, compressed[block].data(), compressed[block].size());
+    }
+  }
+  std::memcpy(buffer.data(), &header, sizeof(TerrainHeightMapFileHeader));
+
+  /* Writes to a temporary file first, a crash while writing must not leave a corrupted heightmap behind */
+  const String temporaryPath = path + ".tmp";
+  {
+    std::ofstream output(temporaryPath, std::ios_base::binary | std::ios_base::trunc);
+    if (!output.is_open()) {
+      Yeager::Log(ERROR, "Cannot write terrain heightmap {}", path);
+      return false;
+    }
+    output.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    /* Closed here so a failed flush is seen before the file replaces the old one */
+    output.close();
+    if (output.fail()) {
+      Yeager::Log(ERROR, "Cannot write terrain heightmap {}, the disk may be full", path);
+      std::error_code error;
+      std::filesystem::remove(temporaryPath, error);
+      return false;
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temporaryPath, path, error);
+  if (error) {
+    Yeager::Log(ERROR, "Cannot move terrain heightmap to {}, {}", path, error.message());
+    return false;
+  }
+
+  if (bytesWritten) {
+    *bytesWritten = buffer.size();
+  }
+  return true;
+}
+
+bool TerrainHeightMapFile::Open(const String& path)
+{
+  Close();
+  if (!Yeager::ValidatesPath(path, false) || !m_File.Map(path)) {
+    return false;
+  }
+
+  const TerrainHeightMapFileHeader* header = m_File.At<TerrainHeightMapFileHeader>(0);
+  if (!header || std::memcmp(header->MagicConst, YEAGER_CACHE_MAGIC_CONST, sizeof(char) * 4) != 0 ||
+      header->Version != YEAGER_TERRAIN_HEIGHTMAP_VERSION || header->FileSize != m_File.GetSize() ||
+      header->Width == 0 || header->Height == 0 || header->Format > TerrainHeightMapFormat::eFLOAT32 ||
+      header->Compression > TerrainHeightMapCompression::eDELTA_LZ) {
+    Yeager::Log(WARNING, "Terrain heightmap {} is invalid or from another version", path);
+    m_File.Unmap();
+    return false;
+  }
+
+  m_Header = header;
+  const size_t samples = static_cast<size_t>(header->Width) * header->Height;
+  bool valid = true;
+  if (header->Compression == TerrainHeightMapCompression::eNONE) {
+    valid = m_File.At<uint8_t>(header->SamplesOffset, samples * GetSampleBytes()) != YEAGER_NULLPTR;
+  } else {
+    m_Blocks = m_File.At<TerrainHeightMapBlock>(header->BlocksOffset, header->BlockCount);
+    valid = m_Blocks && header->BlockRows > 0 &&
+            header->BlockCount == (header->Height + header->BlockRows - 1) / header->BlockRows;
+    for (uint64_t block = 0; valid && block < header->BlockCount; block++) {
+      valid = m_File.At<uint8_t>(m_Blocks[block].Offset, m_Blocks[block].Size) != YEAGER_NULLPTR;
+    }
+  }
+
+  if (!valid) {
+    Yeager::Log(WARNING, "Terrain heightmap {} is truncated", path);
+    Close();
+    return false;
+  }
+  return true;
+}
+
+void TerrainHeightMapFile::Close()
+{
+  m_File.Unmap();
+  m_Header = YEAGER_NULLPTR;
+  m_Blocks = YEAGER_NULLPTR;
+}
+
+TerrainHeightMapInfo TerrainHeightMapFile::GetInfo() const
+{
+  TerrainHeightMapInfo info;
+  if (m_Header) {
+    info.Width = m_Header->Width;
+    info.Height = m_Header->Height;
+    info.MinHeight = m_Header->MinHeight;
+    info.MaxHeight = m_Header->MaxHeight;
+    info.WorldScale = m_Header->WorldScale;
+    info.TextureScale = m_Header->TextureScale;
+    info.TerrainSize = m_Header->TerrainSize;
+    info.Seed = m_Header->Seed;
+  }
+  return info;
+}
+
+TerrainHeightMapFormat::Enum TerrainHeightMapFile::GetFormat() const
+{
+  return static_cast<TerrainHeightMapFormat::Enum>(m_Header->Format);
+}
+
+TerrainHeightMapCompression::Enum TerrainHeightMapFile::GetCompression() const
+{
+  return static_cast<TerrainHeightMapCompression::Enum>(m_Header->Compression);
+}
+
+Uint TerrainHeightMapFile::GetSampleBytes() const
+{
+  return GetFormat() == TerrainHeightMapFormat::eUNORM16 ? sizeof(uint16_t) : sizeof(float);
+}
+
+void TerrainHeightMapFile::DecodeRows(const uint8_t* data, int firstRow, int rows,
+                                      Math::Array2D<float>* heightMap) const
+{
+  const int width = m_Header->Width;
+  const float scale = (m_Header->QuantizeMax - m_Header->QuantizeMin) / 65535.0f;
+  for (int row = 0; row < rows; row++) {
+    float* output = heightMap->GetAddress(0, firstRow + row);
+    if (GetFormat() == TerrainHeightMapFormat::eFLOAT32) {
+      std::memcpy(output, data + sizeof(float) * width * row, width * sizeof(float));
+      continue;
+    }
+    const uint16_t* codes = reinterpret_cast<const uint16_t*>(data) + static_cast<size_t>(width) * row;
+    for (int x = 0; x < width; x++) {
+      output[x] = m_Header->QuantizeMin + codes[x] * scale;
+    }
+  }
+}
+
+bool TerrainHeightMapFile::ReadBlock(const TerrainHeightMapBlock& block, int firstRow, Math::Array2D<float>* heightMap,
+                                     std::vector<uint8_t>* scratch) const
+{
+  const int rows = std::min<int>(m_Header->BlockRows, m_Header->Height - firstRow);
+  const size_t bytes = static_cast<size_t>(m_Header->Width) * rows * GetSampleBytes();
+  scratch->resize(bytes * 2);
+  uint8_t* planes = scratch->data();
+  uint8_t* codes = scratch->data() + bytes;
+  if (!DecompressLZ(m_File.GetData() + block.Offset, block.Size, planes, bytes)) {
+    return false;
+  }
+  if (GetFormat() == TerrainHeightMapFormat::eUNORM16) {
+    UndoDeltaPlanes<uint16_t>(planes, m_Header->Width, rows, codes);
+  } else {
+    UndoDeltaPlanes<uint32_t>(planes, m_Header->Width, rows, codes);
+  }
+  DecodeRows(codes, firstRow, rows, heightMap);
+  return true;
+}
+
+bool TerrainHeightMapFile::Read(Math::Array2D<float>* heightMap, WorkerPool* pool) const
+{
+  if (!IsOpen()) {
+    return false;
+  }
+  if (!heightMap->IsLinear()) {
+    Yeager::Log(WARNING, "Terrain heightmap can only be read into an array with linear rows!");
+    return false;
+  }
+  if (heightMap->GetCols() != static_cast<int>(m_Header->Width) ||
+      heightMap->GetRows() != static_cast<int>(m_Header->Height)) {
+    Yeager::Log(WARNING, "Terrain heightmap of {}x{} cannot be read into an array of {}x{}!", m_Header->Width,
+                m_Header->Height, heightMap->GetCols(), heightMap->GetRows());
+    return false;
+  }
+
+  if (GetCompression() == TerrainHeightMapCompression::eNONE) {
+    const uint8_t* samples = m_File.GetData() + m_Header->SamplesOffset;
+    const size_t rowBytes = static_cast<size_t>(m_Header->Width) * GetSampleBytes();
+    pool->ParallelFor(0, m_Header->Height, YEAGER_TERRAIN_HEIGHTMAP_BLOCK_ROWS, [&](size_t begin, size_t end) {
+      DecodeRows(samples + begin * rowBytes, begin, end - begin, heightMap);
+    });
+    return true;
+  }
+
+  std::atomic<bool> valid = true;
+  pool->ParallelFor(0, m_Header->BlockCount, 1, [&](size_t begin, size_t end) {
+    std::vector<uint8_t> scratch;
+    for (size_t block = begin; block < end; block++) {
+      if (!ReadBlock(m_Blocks[block], block * m_Header->BlockRows, heightMap, &scratch)) {
+        valid = false;
+      }
+    }
+  });
+  if (!valid) {
+    Yeager::Log(WARNING, "Terrain heightmap has corrupted compressed blocks!");
+  }
+  return valid;
+}
+
+std::shared_ptr<Math::Array2D<float>> TerrainHeightMapFile::ImportRaw16(const String& path, float minHeight,
+                                                                        float maxHeight, int* width, int* height)
+{
+  MappedFile file;
+  if (!Yeager::ValidatesPath(path, false) || !file.Map(path)) {
+    Yeager::Log(WARNING, "Cannot import raw heightmap {}", path);
+    return YEAGER_NULLPTR;
+  }
+
+  const size_t samples = file.GetSize() / sizeof(uint16_t);
+  if (*width <= 0 || *height <= 0) {
+    *width = *height = static_cast<int>(std::lround(std::sqrt(static_cast<double>(samples))));
+  }
+  if (static_cast<size_t>(*width) * *height != samples || file.GetSize() % sizeof(uint16_t) != 0) {
+    Yeager::Log(WARNING, "Raw heightmap {} has {} bytes, does not match {}x{} 16 bits samples", path, file.GetSize(),
+                *width, *height);
+    return YEAGER_NULLPTR;
+  }
+
+  auto heightMap = BaseAllocator::MakeSharedPtr<Math::Array2D<float>>(*width, *height);
+  const uint8_t* data = file.GetData();
+  const float scale = (maxHeight - minHeight) / 65535.0f;
+  const int rowSamples = *width;
+  WorkerPool::GetGlobal()->ParallelFor(0, *height, YEAGER_TERRAIN_HEIGHTMAP_BLOCK_ROWS, [&](size_t begin, size_t end) {
+    for (size_t row = begin; row < end; row++) {
+      float* output = heightMap->GetAddress(0, row);
+      const uint8_t* input = data + row * rowSamples * sizeof(uint16_t);
+      for (int x = 0; x < rowSamples; x++) {
+        /* Little endian, like the files written by the other tools */
+        output[x] = minHeight + static_cast<uint16_t>(input[x * 2] | (input[x * 2 + 1] << 8)) * scale;
+      }
+    }
+  });
+  return heightMap;
+}
+
+bool TerrainHeightMapFile::ExportRaw16(const String& path, const float* samples, int width, int height, float minHeight,
+                                       float maxHeight)
+{
+  const size_t count = static_cast<size_t>(width) * height;
+  std::vector<uint8_t> buffer(count * sizeof(uint16_t));
+  const float scale = maxHeight > minHeight ? 65535.0f / (maxHeight - minHeight) : 0.0f;
+  for (size_t x = 0; x < count; x++) {
+    const uint16_t code = static_cast<uint16_t>(std::clamp((samples[x] - minHeight) * scale + 0.5f, 0.0f, 65535.0f));
+    buffer[x * 2] = static_cast<uint8_t>(code & 0xFF);
+    buffer[x * 2 + 1] = static_cast<uint8_t>(code >> 8);
+  }
+
+  std::ofstream output(path, std::ios_base::binary | std::ios_base::trunc);
+  if (!output.is_open()) {
+    Yeager::Log(ERROR, "Cannot export raw heightmap {}", path);
+    return false;
+  }
+  output.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+  output.close();
+  if (output.fail()) {
+    Yeager::Log(ERROR, "Cannot export raw heightmap {}, the disk may be full", path);
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,153 @@
+//    Yeager Engine, free and open source 3D/2D renderer written in OpenGL
+//    In case of questions and bugs, please, refer to the issue tab on github
+//    Repo : https://github.com/schwq/YeagerEngine
+//    Copyright (C) 2023 - Present
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Common/Math/Mathematics.h"
+#include "Common/FS/MappedFile.h"
+#include "Common/Utils/Common.h"
+#include "Common/Utils/LogEngine.h"
+#include "Common/Utils/Utilities.h"
+#include "Components/Kernel/Process/WorkerPool.h"
+
+namespace Yeager {
+
+#define YEAGER_TERRAIN_HEIGHTMAP_EXT_STR ".ygen_heightmap"
+#define YEAGER_TERRAIN_HEIGHTMAP_VERSION 1
+/* Rows compressed together, the blocks are decompressed in parallel */
+#define YEAGER_TERRAIN_HEIGHTMAP_BLOCK_ROWS 64
+
+struct TerrainHeightMapFormat {
+  /* 16 bits samples quantized between the lowest and highest sample of the heightmap */
+  enum Enum { eUNORM16, eFLOAT32 };
+  YEAGER_ENUM_TO_STRING(TerrainHeightMapFormat)
+};
+
+struct TerrainHeightMapCompression {
+  /* Delta of each sample to the plane of its neighbours (left + lower - lower left, the first row and column use the
+   * one neighbour they have), the bytes of the deltas split in planes and then LZ */
+  enum Enum { eNONE, eDELTA_LZ };
+  YEAGER_ENUM_TO_STRING(TerrainHeightMapCompression)
+};
+
+/**
+ * Binary heightmap file (name).ygen_heightmap, every section starts 8 bytes aligned so the file can be mapped and the
+ * uncompressed samples read in place. Offsets are from the start of the file
+ * Header - TerrainHeightMapFileHeader
+ * Blocks - BlockCount * TerrainHeightMapBlock, only when compressed, each block holds BlockRows rows of samples
+ * Samples - Width x Height samples row by row (X is the column), or the compressed blocks one after another
+ */
+struct TerrainHeightMapFileHeader {
+  char MagicConst[4] = {0};
+  uint32_t Version = 0;
+  uint32_t Width = 0;
+  uint32_t Height = 0;
+  uint32_t Format = 0;
+  uint32_t Compression = 0;
+  float MinHeight = 0.0f;
+  float MaxHeight = 0.0f;
+  float QuantizeMin = 0.0f;
+  float QuantizeMax = 0.0f;
+  float WorldScale = 1.0f;
+  float TextureScale = 1.0f;
+  float TerrainSize = 0.0f;
+  uint32_t BlockRows = 0;
+  uint64_t Seed = 0;
+  uint64_t BlocksOffset = 0;
+  uint64_t BlockCount = 0;
+  uint64_t SamplesOffset = 0;
+  uint64_t FileSize = 0;
+};
+
+struct TerrainHeightMapBlock {
+  uint64_t Offset = 0;
+  uint64_t Size = 0;
+};
+
+/// @brief Values of the terrain saved with the samples, enough to build the same terrain again without the noise
+struct TerrainHeightMapInfo {
+  int Width = 0;
+  int Height = 0;
+  float MinHeight = 0.0f;
+  float MaxHeight = 256.0f;
+  float WorldScale = 1.0f;
+  float TextureScale = 256.0f;
+  float TerrainSize = 256.0f;
+  uint64_t Seed = 0;
+};
+
+struct TerrainHeightMapWriteSettings {
+  TerrainHeightMapFormat::Enum Format = TerrainHeightMapFormat::eUNORM16;
+  TerrainHeightMapCompression::Enum Compression = TerrainHeightMapCompression::eDELTA_LZ;
+};
+
+/**
+ * @brief Compact binary storage of the terrain heightmaps, replaces the text dump of the noise. Open maps the file and
+ * validates the header, Read decodes the samples straight from the mapping into the heightmap, block by block in the
+ * worker pool. Raw R16 (little endian unsigned 16 bits, no header) is supported to exchange heightmaps with other tools
+ */
+class TerrainHeightMapFile {
+ public:
+  TerrainHeightMapFile() = default;
+
+  /**
+   * @brief Writes the samples (width x height of the info, row by row), returns false and logs on failure
+   * @param bytesWritten Size of the file written, optional
+   */
+  static bool Write(const String& path, const float* samples, const TerrainHeightMapInfo& info,
+                    const TerrainHeightMapWriteSettings& settings = TerrainHeightMapWriteSettings(),
+                    size_t* bytesWritten = YEAGER_NULLPTR);
+
+  /** Maps the file and validates the header and the sections, returns false if the file is missing or corrupted */
+  bool Open(const String& path);
+  void Close();
+  YEAGER_NODISCARD bool IsOpen() const { return m_Header != YEAGER_NULLPTR; }
+
+  YEAGER_NODISCARD TerrainHeightMapInfo GetInfo() const;
+  YEAGER_NODISCARD TerrainHeightMapFormat::Enum GetFormat() const;
+  YEAGER_NODISCARD TerrainHeightMapCompression::Enum GetCompression() const;
+  YEAGER_NODISCARD size_t GetFileSize() const { return m_File.GetSize(); }
+
+  /**
+   * @brief Decodes the samples into the heightmap, that must have the width and height of the file and linear rows.
+   * Returns false if a compressed block is corrupted
+   */
+  bool Read(Math::Array2D<float>* heightMap, WorkerPool* pool = WorkerPool::GetGlobal()) const;
+
+  /**
+   * @brief Reads a raw R16 file, samples from 0 to 65535 are mapped to [minHeight, maxHeight]. A width or height of 0
+   * takes the file as a square heightmap
+   */
+  static std::shared_ptr<Math::Array2D<float>> ImportRaw16(const String& path, float minHeight, float maxHeight,
+                                                           int* width, int* height);
+  /** Writes the samples as raw R16, heights are clamped to [minHeight, maxHeight] */
+  static bool ExportRaw16(const String& path, const float* samples, int width, int height, float minHeight,
+                          float maxHeight);
+
+ private:
+  bool ReadBlock(const TerrainHeightMapBlock& block, int firstRow, Math::Array2D<float>* heightMap,
+                 std::vector<uint8_t>* scratch) const;
+  void DecodeRows(const uint8_t* data, int firstRow, int rows, Math::Array2D<float>* heightMap) const;
+  YEAGER_NODISCARD Uint GetSampleBytes() const;
+
+  MappedFile m_File;
+  const TerrainHeightMapFileHeader* m_Header = YEAGER_NULLPTR;
+  const TerrainHeightMapBlock* m_Blocks = YEAGER_NULLPTR;
+};
+
+}  // namespace Yeager
@@ -0,0 +1,493 @@
+#include "TerrainLOD.h"
+using namespace Yeager;
+
+TerrainLODFrameStats TerrainLODRenderer::sFrameStats;
+
+TerrainLODView TerrainLODView::FromProjection(const Vector3& camera, const Matrix4& projection, float viewportHeight)
+{
+  TerrainLODView view;
+  view.CameraPosition = camera;
+  view.ProjectionScale = projection[1][1];
+  view.ViewportHeight = viewportHeight;
+  return view;
+}
+
+void TerrainQuadtree::Build(Math::Array2D<float>* heightMap, int width, int height, const TerrainLODSettings& settings,
+                            WorkerPool* pool)
+{
+  if (!heightMap->IsLinear()) {
+    Yeager::Log(WARNING, "Terrain quadtree needs a heightmap with linear rows, the tiled layout is not supported!");
+    return;
+  }
+
+  m_HeightMap = heightMap;
+  m_Samples = heightMap->GetAddress(0, 0);
+  m_Pitch = heightMap->GetPitch();
+  m_Width = width;
+  m_Height = height;
+  m_Settings = settings;
+  m_Settings.LeafQuads = std::max(4, (settings.LeafQuads + 3) / 4 * 4);
+
+  const int quads = std::max(width, height) - 1;
+  int levels = 1;
+  while ((m_Settings.LeafQuads << (levels - 1)) < quads) {
+    levels++;
+  }
+
+  /* The leaves read the samples, each level above joins the four children */
+  m_MinMax.assign(levels, std::vector<Vector2>());
+  m_MinMax[0].resize(GetNodesX(0) * GetNodesZ(0));
+  pool->ParallelFor(0, GetNodesZ(0), 1, [&](size_t begin, size_t end) {
+    for (int nodeZ = begin; nodeZ < static_cast<int>(end); nodeZ++) {
+      for (int nodeX = 0; nodeX < GetNodesX(0); nodeX++) {
+        m_MinMax[0][nodeZ * GetNodesX(0) + nodeX] = CalculateLeafMinMax(nodeX, nodeZ);
+      }
+    }
+  });
+
+  for (int level = 1; level < levels; level++) {
+    m_MinMax[level].resize(GetNodesX(level) * GetNodesZ(level));
+    for (int nodeZ = 0; nodeZ < GetNodesZ(level); nodeZ++) {
+      for (int nodeX = 0; nodeX < GetNodesX(level); nodeX++) {
+        m_MinMax[level][nodeZ * GetNodesX(level) + nodeX] = JoinChildrenMinMax(level, nodeX, nodeZ);
+      }
+    }
+  }
+
+  UpdateHeightRange();
+
+  /* The error only grows with the level, a coarser level is never better than a finer one */
+  const TerrainDirtyRect whole{0, 0, m_Width - 1, m_Height - 1};
+  m_LevelErrors.assign(levels, 0.0f);
+  for (int level = 1; level < levels; level++) {
+    m_LevelErrors[level] = std::max(m_LevelErrors[level - 1], CalculateLevelError(level, whole, pool));
+  }
+
+  Yeager::LogDebug(INFO, "Terrain quadtree built, {}x{} samples, {} levels of {} quads, coarsest error {}", width,
+                   height, levels, m_Settings.LeafQuads, m_LevelErrors.back());
+}
+
+Vector2 TerrainQuadtree::CalculateLeafMinMax(int nodeX, int nodeZ) const
+{
+  const int leaf = m_Settings.LeafQuads;
+  Vector2 minMax(std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest());
+  for (int z = nodeZ * leaf; z <= std::min((nodeZ + 1) * leaf, m_Height - 1); z++) {
+    for (int x = nodeX * leaf; x <= std::min((nodeX + 1) * leaf, m_Width - 1); x++) {
+      minMax.x = std::min(minMax.x, Sample(x, z));
+      minMax.y = std::max(minMax.y, Sample(x, z));
+    }
+  }
+  return minMax;
+}
+
+Vector2 TerrainQuadtree::JoinChildrenMinMax(int level, int nodeX, int nodeZ) const
+{
+  Vector2 minMax(std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest());
+  for (int quadrant = 0; quadrant < 4; quadrant++) {
+    const int childX = nodeX * 2 + (quadrant & 1);
+    const int childZ = nodeZ * 2 + (quadrant >> 1);
+    if (NodeExists(level - 1, childX, childZ)) {
+      const Vector2& child = m_MinMax[level - 1][childZ * GetNodesX(level - 1) + childX];
+      minMax.x = std::min(minMax.x, child.x);
+      minMax.y = std::max(minMax.y, child.y);
+    }
+  }
+  return minMax;
+}
+
+void TerrainQuadtree::UpdateHeightRange()
+{
+  m_MinHeight = std::numeric_limits<float>::max();
+  m_MaxHeight = std::numeric_limits<float>::lowest();
+  for (const auto& minMax : m_MinMax.back()) {
+    m_MinHeight = std::min(m_MinHeight, minMax.x);
+    m_MaxHeight = std::max(m_MaxHeight, minMax.y);
+  }
+}
+
+void TerrainQuadtree::UpdateRegion(const TerrainDirtyRect& rect, WorkerPool* pool)
+{
+  if (!IsBuilt() || rect.IsEmpty()) {
+    return;
+  }
+
+  /* A sample on the border of two leaves belongs to both, the nodes of each level above are the parents of the ones
+   * below */
+  const int leaf = m_Settings.LeafQuads;
+  int beginX = std::max(0, rect.MinX - 1) / leaf;
+  int beginZ = std::max(0, rect.MinZ - 1) / leaf;
+  int endX = std::min(rect.MaxX / leaf, GetNodesX(0) - 1);
+  int endZ = std::min(rect.MaxZ / leaf, GetNodesZ(0) - 1);
+  for (int nodeZ = beginZ; nodeZ <= endZ; nodeZ++) {
+    for (int nodeX = beginX; nodeX <= endX; nodeX++) {
+      m_MinMax[0][nodeZ * GetNodesX(0) + nodeX] = CalculateLeafMinMax(nodeX, nodeZ);
+    }
+  }
+  for (int level = 1; level < GetLevelCount(); level++) {
+    beginX /= 2, beginZ /= 2, endX /= 2, endZ /= 2;
+    for (int nodeZ = beginZ; nodeZ <= endZ; nodeZ++) {
+      for (int nodeX = beginX; nodeX <= endX; nodeX++) {
+        m_MinMax[level][nodeZ * GetNodesX(level) + nodeX] = JoinChildrenMinMax(level, nodeX, nodeZ);
+      }
+    }
+  }
+  UpdateHeightRange();
+
+  /* The errors only grow until the next Build, a stroke that flattens the terrain keeps the finer levels a bit longer
+   * than needed but never shows less detail than the error asks for */
+  for (int level = 1; level < GetLevelCount(); level++) {
+    const TerrainDirtyRect cells = rect.Expanded(1 << level, m_Width, m_Height);
+    m_LevelErrors[level] =
+        std::max({m_LevelErrors[level], m_LevelErrors[level - 1], CalculateLevelError(level, cells, pool)});
+  }
+}
+
+float TerrainQuadtree::CalculateLevelError(int level, const TerrainDirtyRect& rect, WorkerPool* pool) const
+{
+  /* The most a sample differs from the bilinear of the cell of the level around it, the grid of the level is clamped
+   * to the border of the heightmap like the vertices drawn */
+  const int step = 1 << level;
+  std::mutex mutex;
+  float error = 0.0f;
+  pool->ParallelFor(rect.MinZ, rect.MaxZ + 1, 64, [&](size_t begin, size_t end) {
+    float local = 0.0f;
+    for (int z = begin; z < static_cast<int>(end); z++) {
+      const int z0 = z / step * step;
+      const int z1 = std::min(z0 + step, m_Height - 1);
+      const float tz = z1 > z0 ? static_cast<float>(z - z0) / (z1 - z0) : 0.0f;
+      for (int x = rect.MinX; x <= rect.MaxX; x++) {
+        const int x0 = x / step * step;
+        const int x1 = std::min(x0 + step, m_Width - 1);
+        const float tx = x1 > x0 ? static_cast<float>(x - x0) / (x1 - x0) : 0.0f;
+        const float bottom = Sample(x0, z0) + (Sample(x1, z0) - Sample(x0, z0)) * tx;
+        const float top = Sample(x0, z1) + (Sample(x1, z1) - Sample(x0, z1)) * tx;
+        local = std::max(local, std::abs(bottom + (top - bottom) * tz - Sample(x, z)));
+      }
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    error = std::max(error, local);
+  });
+  return error;
+}
+
+TerrainLODRanges TerrainQuadtree::ComputeRanges(const TerrainLODView& view, float worldScale) const
+{
+  TerrainLODRanges ranges;
+  const int levels = GetLevelCount();
+  ranges.Range.resize(levels);
+  ranges.MorphStart.resize(levels);
+
+  /* Distance where a error of one unit covers one pixel */
+  const float pixelDistance = view.ViewportHeight * view.ProjectionScale * 0.5f;
+  const float morph = std::clamp(m_Settings.MorphRegion, 0.01f, 0.99f);
+  const float heightSpan = m_MaxHeight - m_MinHeight;
+
+  float previous = 0.0f;
+  for (int level = 0; level < levels - 1; level++) {
+    /* The level l is used until the level above is good enough. The range must also be wider than the parent node
+     * (diagonal with the heights) before the morph starts, otherwise a node could touch one two levels coarser */
+    const float parentSize = (m_Settings.LeafQuads << (level + 1)) * worldScale;
+    const float diagonal = std::sqrt(2.0f * parentSize * parentSize + heightSpan * heightSpan);
+    const float range = std::max({m_LevelErrors[level + 1] * pixelDistance / std::max(m_Settings.PixelError, 0.01f),
+                                  2.0f * previous, diagonal / (1.0f - morph)});
+    ranges.Range[level] = range;
+    ranges.MorphStart[level] = range - morph * (range - previous);
+    previous = range;
+  }
+  ranges.Range.back() = std::numeric_limits<float>::max();
+  ranges.MorphStart.back() = std::numeric_limits<float>::max();
+  return ranges;
+}
+
+void TerrainQuadtree::Select(const TerrainLODView& view, float worldScale, const TerrainLODRanges& ranges,
+                             std::vector<TerrainLODNode>* selection) const
+{
+  const int top = GetLevelCount() - 1;
+  for (int nodeZ = 0; nodeZ < GetNodesZ(top); nodeZ++) {
+    for (int nodeX = 0; nodeX < GetNodesX(top); nodeX++) {
+      SelectNode(top, nodeX, nodeZ, view, worldScale, ranges, selection);
+    }
+  }
+}
+
+bool TerrainQuadtree::SelectNode(int level, int nodeX, int nodeZ, const TerrainLODView& view, float worldScale,
+                                 const TerrainLODRanges& ranges, std::vector<TerrainLODNode>* selection) const
+{
+  const TerrainLODNode node = MakeNode(level, nodeX, nodeZ, -1);
+  const Bounds bounds = GetBounds(node, worldScale);
+
+  /* Out of the range of the level, the parent draws this area */
+  if (!IntersectsSphere(bounds, view.CameraPosition, ranges.Range[level])) {
+    return false;
+  }
+
+  if (level == 0 || !IntersectsSphere(bounds, view.CameraPosition, ranges.Range[level - 1])) {
+    selection->push_back(node);
+    return true;
+  }
+
+  /* The children inside the finer range are selected, the quarters of the others are drawn at this level */
+  for (int quadrant = 0; quadrant < 4; quadrant++) {
+    const int childX = nodeX * 2 + (quadrant & 1);
+    const int childZ = nodeZ * 2 + (quadrant >> 1);
+    if (!NodeExists(level - 1, childX, childZ)) {
+      continue;
+    }
+    if (!SelectNode(level - 1, childX, childZ, view, worldScale, ranges, selection)) {
+      selection->push_back(MakeNode(level, nodeX, nodeZ, quadrant));
+    }
+  }
+  return true;
+}
+
+TerrainLODNode TerrainQuadtree::MakeNode(int level, int nodeX, int nodeZ, int quadrant) const
+{
+  TerrainLODNode node;
+  node.Size = m_Settings.LeafQuads << level;
+  node.X = nodeX * node.Size;
+  node.Z = nodeZ * node.Size;
+  node.Level = level;
+  node.Quadrant = quadrant;
+
+  /* A quarter has the heights of the child under it */
+  const Vector2& minMax = quadrant < 0 ? m_MinMax[level][nodeZ * GetNodesX(level) + nodeX]
+                                       : m_MinMax[level - 1][(nodeZ * 2 + (quadrant >> 1)) * GetNodesX(level - 1) +
+                                                             nodeX * 2 + (quadrant & 1)];
+  node.MinHeight = minMax.x;
+  node.MaxHeight = minMax.y;
+  return node;
+}
+
+TerrainQuadtree::Bounds TerrainQuadtree::GetBounds(const TerrainLODNode& node, float worldScale) const
+{
+  int x = node.X, z = node.Z, size = node.Size;
+  if (node.Quadrant >= 0) {
+    size /= 2;
+    x += (node.Quadrant & 1) * size;
+    z += (node.Quadrant >> 1) * size;
+  }
+  Bounds bounds;
+  bounds.Min = Vector3(x * worldScale, node.MinHeight, z * worldScale);
+  bounds.Max = Vector3(std::min(x + size, m_Width - 1) * worldScale, node.MaxHeight,
+                       std::min(z + size, m_Height - 1) * worldScale);
+  return bounds;
+}
+
+bool TerrainQuadtree::IntersectsSphere(const Bounds& bounds, const Vector3& center, float radius)
+{
+  const Vector3 closest = glm::clamp(center, bounds.Min, bounds.Max);
+  const Vector3 delta = center - closest;
+  /* The radius of the last level is the max float, the square goes to infinity and always intersects */
+  return glm::dot(delta, delta) <= radius * radius;
+}
+
+bool TerrainQuadtree::NodeExists(int level, int nodeX, int nodeZ) const
+{
+  return nodeX < GetNodesX(level) && nodeZ < GetNodesZ(level);
+}
+
+int TerrainQuadtree::GetNodesX(int level) const
+{
+  const int size = m_Settings.LeafQuads << level;
+  return std::max(1, (m_Width - 1 + size - 1) / size);
+}
+
+int TerrainQuadtree::GetNodesZ(int level) const
+{
+  const int size = m_Settings.LeafQuads << level;
+  return std::max(1, (m_Height - 1 + size - 1) / size);
+}
+
+float TerrainQuadtree::GetMorphFactor(const TerrainLODRanges& ranges, int level, float distance)
+{
+  const float start = ranges.MorphStart[level];
+  const float end = ranges.Range[level];
+  return std::clamp((distance - start) / std::max(end - start, 1e-4f), 0.0f, 1.0f);
+}
+
+Vector2 TerrainQuadtree::MorphGridPosition(const Vector2& grid, float morph)
+{
+  return grid - glm::fract(grid * 0.5f) * 2.0f * morph;
+}
+
+Vector3 TerrainQuadtree::EvaluateVertex(const TerrainLODNode& node, int gridX, int gridZ, const TerrainLODView& view,
+                                        const TerrainLODRanges& ranges, float worldScale) const
+{
+  const float step = static_cast<float>(1 << node.Level);
+  auto position = [&](const Vector2& grid) {
+    const float x = std::min(node.X + grid.x * step, static_cast<float>(m_Width - 1));
+    const float z = std::min(node.Z + grid.y * step, static_cast<float>(m_Height - 1));
+    return Vector3(x * worldScale, SampleHeight(x, z), z * worldScale);
+  };
+
+  /* The morph is found with the position in the grid of the node, then the vertex is moved */
+  const Vector2 grid(gridX, gridZ);
+  const float morph = GetMorphFactor(ranges, node.Level, glm::distance(view.CameraPosition, position(grid)));
+  return position(MorphGridPosition(grid, morph));
+}
+
+float TerrainQuadtree::Sample(int x, int z) const
+{
+  return m_Samples[static_cast<size_t>(z) * m_Pitch + x];
+}
+
+float TerrainQuadtree::SampleHeight(float x, float z) const
+{
+  x = std::clamp(x, 0.0f, static_cast<float>(m_Width - 1));
+  z = std::clamp(z, 0.0f, static_cast<float>(m_Height - 1));
+  const int x0 = static_cast<int>(x);
+  const int z0 = static_cast<int>(z);
+  const int x1 = std::min(x0 + 1, m_Width - 1);
+  const int z1 = std::min(z0 + 1, m_Height - 1);
+  const float tx = x - x0;
+  const float tz = z - z0;
+  const float bottom = Sample(x0, z0) + (Sample(x1, z0) - Sample(x0, z0)) * tx;
+  const float top = Sample(x0, z1) + (Sample(x1, z1) - Sample(x0, z1)) * tx;
+  return bottom + (top - bottom) * tz;
+}
+
+Uint TerrainQuadtree::GetTriangleCount(const TerrainLODNode& node) const
+{
+  const Uint triangles = m_Settings.LeafQuads * m_Settings.LeafQuads * 2;
+  return node.Quadrant < 0 ? triangles : triangles / 4;
+}
+
+TerrainLODRenderer::~TerrainLODRenderer()
+{
+  DeleteBuffers();
+}
+
+void TerrainLODRenderer::Setup(const TerrainQuadtree& quadtree)
+{
+  DeleteBuffers();
+
+  m_LeafQuads = quadtree.GetLeafQuads();
+  const int side = m_LeafQuads + 1;
+  const int half = m_LeafQuads / 2;
+
+  std::vector<Vector2> grid(side * side);
+  for (int z = 0; z < side; z++) {
+    for (int x = 0; x < side; x++) {
+      grid[z * side + x] = Vector2(x, z);
+    }
+  }
+
+  /* Quarter by quarter, a quarter is a range of a quarter of the buffer */
+  std::vector<GLuint> indices;
+  indices.reserve(m_LeafQuads * m_LeafQuads * 6);
+  for (int quadrant = 0; quadrant < 4; quadrant++) {
+    const int beginX = (quadrant & 1) * half;
+    const int beginZ = (quadrant >> 1) * half;
+    for (int z = beginZ; z < beginZ + half; z++) {
+      for (int x = beginX; x < beginX + half; x++) {
+        Uint IndexBottomLeft = z * side + x;
+        Uint IndexTopLeft = (z + 1) * side + x;
+        Uint IndexTopRight = (z + 1) * side + x + 1;
+        Uint IndexBottomRight = z * side + x + 1;
+        indices.push_back(IndexBottomLeft);
+        indices.push_back(IndexTopLeft);
+        indices.push_back(IndexTopRight);
+        indices.push_back(IndexBottomLeft);
+        indices.push_back(IndexTopRight);
+        indices.push_back(IndexBottomRight);
+      }
+    }
+  }
+
+  GL_CALL(glGenVertexArrays(1, &m_Vao));
+  GL_CALL(glGenBuffers(1, &m_Vbo));
+  GL_CALL(glGenBuffers(1, &m_Ebo));
+  GL_CALL(glBindVertexArray(m_Vao));
+  GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, m_Vbo));
+  GL_CALL(glBufferData(GL_ARRAY_BUFFER, sizeof(Vector2) * grid.size(), grid.data(), GL_STATIC_DRAW));
+  GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_Ebo));
+  GL_CALL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * indices.size(), indices.data(), GL_STATIC_DRAW));
+  GL_CALL(glEnableVertexAttribArray(0));
+  GL_CALL(glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vector2), (const void*)0));
+  GL_CALL(glBindVertexArray(0));
+
+  /* Linear filtering gives the heights of the morphed vertices between two samples */
+  GL_CALL(glGenTextures(1, &m_HeightTexture));
+  GL_CALL(glBindTexture(GL_TEXTURE_2D, m_HeightTexture));
+  GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+  GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+  GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+  GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+  GL_CALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+  GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, quadtree.GetPitch()));
+  GL_CALL(glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, quadtree.GetWidth(), quadtree.GetHeight(), 0, GL_RED, GL_FLOAT,
+                       quadtree.GetSamples()));
+  GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+  GL_CALL(glBindTexture(GL_TEXTURE_2D, 0));
+
+  m_Generated = true;
+}
+
+void TerrainLODRenderer::UpdateHeightRegion(const TerrainQuadtree& quadtree, const TerrainDirtyRect& rect)
+{
+  if (!m_Generated || rect.IsEmpty()) {
+    return;
+  }
+
+  /* Only the rows of the rect are read from the samples of the heightmap */
+  const float* samples = quadtree.GetSamples() + static_cast<size_t>(rect.MinZ) * quadtree.GetPitch() + rect.MinX;
+  GL_CALL(glBindTexture(GL_TEXTURE_2D, m_HeightTexture));
+  GL_CALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+  GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, quadtree.GetPitch()));
+  GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, rect.MinX, rect.MinZ, rect.MaxX - rect.MinX + 1, rect.MaxZ - rect.MinZ + 1,
+                          GL_RED, GL_FLOAT, samples));
+  GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+  GL_CALL(glBindTexture(GL_TEXTURE_2D, 0));
+}
+
+void TerrainLODRenderer::DeleteBuffers()
+{
+  if (m_Generated) {
+    GL_CALL(glDeleteBuffers(1, &m_Vbo));
+    GL_CALL(glDeleteBuffers(1, &m_Ebo));
+    GL_CALL(glDeleteVertexArrays(1, &m_Vao));
+    GL_CALL(glDeleteTextures(1, &m_HeightTexture));
+    m_Generated = false;
+  }
+}
+
+void TerrainLODRenderer::Draw(Shader* shader, const TerrainQuadtree& quadtree,
+                              const std::vector<TerrainLODNode>& selection, const TerrainLODView& view,
+                              const TerrainLODRanges& ranges, float worldScale, float textureScale, float size)
+{
+  if (!m_Generated) {
+    return;
+  }
+
+  shader->UseShader();
+  GL_CALL(glActiveTexture(GL_TEXTURE0 + YEAGER_TERRAIN_LOD_HEIGHTMAP_UNIT));
+  GL_CALL(glBindTexture(GL_TEXTURE_2D, m_HeightTexture));
+  shader->SetInt("HeightMap", YEAGER_TERRAIN_LOD_HEIGHTMAP_UNIT);
+  shader->SetVec2("HeightMapSize", Vector2(quadtree.GetWidth(), quadtree.GetHeight()));
+  shader->SetVec3("CameraPosition", view.CameraPosition);
+  shader->SetFloat("WorldScale", worldScale);
+  shader->SetFloat("TextureScale", textureScale);
+  shader->SetFloat("TerrainSize", size);
+
+  const GLsizei quarter = (m_LeafQuads / 2) * (m_LeafQuads / 2) * 6;
+  GL_CALL(glBindVertexArray(m_Vao));
+  for (const auto& node : selection) {
+    shader->SetVec2("NodeOffset", Vector2(node.X, node.Z));
+    shader->SetFloat("NodeStep", static_cast<float>(1 << node.Level));
+    shader->SetFloat("MorphStart", ranges.MorphStart[node.Level]);
+    shader->SetFloat("MorphEnd", ranges.Range[node.Level]);
+
+    if (node.Quadrant < 0) {
+      GL_CALL(glDrawElements(GL_TRIANGLES, quarter * 4, GL_UNSIGNED_INT, NULL));
+    } else {
+      GL_CALL(glDrawElements(GL_TRIANGLES, quarter, GL_UNSIGNED_INT,
+                             (const void*)(sizeof(GLuint) * quarter * node.Quadrant)));
+    }
+    sFrameStats.NodesDrawn++;
+    sFrameStats.TrianglesDrawn += quadtree.GetTriangleCount(node);
+  }
+  GL_CALL(glBindVertexArray(0));
+  GL_CALL(glActiveTexture(GL_TEXTURE0));
+
+  sFrameStats.TrianglesFullResolution += (quadtree.GetWidth() - 1) * (quadtree.GetHeight() - 1) * 2;
+}
@@ -0,0 +1,221 @@
+//    Yeager Engine, free and open source 3D/2D renderer written in OpenGL
+//    In case of questions and bugs, please, refer to the issue tab on github
+//    Repo : https://github.com/schwq/YeagerEngine
+//    Copyright (C) 2023 - Present
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Common/Math/Mathematics.h"
+#include "Common/Utils/Common.h"
+#include "Common/Utils/LogEngine.h"
+#include "Common/Utils/Utilities.h"
+#include "Components/Kernel/Process/WorkerPool.h"
+#include "Components/Renderer/GL/OpenGLRender.h"
+#include "Components/Renderer/Shader/ShaderHandle.h"
+#include "TerrainEditor.h"
+
+namespace Yeager {
+
+/** Texture unit of the heightmap in the level of detail shader, the units before it are the terrain textures */
+#define YEAGER_TERRAIN_LOD_HEIGHTMAP_UNIT 4
+
+/// @brief Values of the terrain level of detail (CDLOD), see TerrainQuadtree
+struct TerrainLODSettings {
+  /* Quads of each side of the grid drawn for every node, a node of level l covers LeafQuads << l quads of the
+   * heightmap. Rounded to a multiple of 4 so the quarters of a node keep the parity of the morph */
+  int LeafQuads = 32;
+  /* Most error in pixels allowed on screen before a finer level is selected */
+  float PixelError = 2.0f;
+  /* Fraction of the range of each level where the vertices morph to the coarser level */
+  float MorphRegion = 0.3f;
+};
+
+/// @brief Viewer of the selection, the camera is in the space of the terrain (before the model matrix)
+struct TerrainLODView {
+  Vector3 CameraPosition = Vector3(0.0f);
+  /* Element [1][1] of the projection, 1 / tan(fov / 2) */
+  float ProjectionScale = 2.414213f;
+  float ViewportHeight = 1080.0f;
+
+  static TerrainLODView FromProjection(const Vector3& camera, const Matrix4& projection, float viewportHeight);
+};
+
+/// @brief A node selected to be drawn. Nodes cover Size + 1 samples starting at the sample (X, Z), with a step of
+/// 1 << Level samples between the vertices of the grid. Quadrant -1 draws the whole node, 0 to 3 only a quarter of it
+/// (bit 0 is the right half, bit 1 the upper half) when the other quarters were selected at a finer level
+struct TerrainLODNode {
+  int X = 0;
+  int Z = 0;
+  int Size = 0;
+  int Level = 0;
+  int Quadrant = -1;
+  float MinHeight = 0.0f;
+  float MaxHeight = 0.0f;
+};
+
+/// @brief Distances of each level computed from the view, the level l is drawn up to Range[l] and morphs to the level
+/// l + 1 between MorphStart[l] and Range[l]. The last level has no range
+struct TerrainLODRanges {
+  std::vector<float> Range;
+  std::vector<float> MorphStart;
+};
+
+/**
+ * @brief Counters of the terrain level of detail, reseted every frame by TerrainLODRenderer::ResetFrameStats.
+ * Triangles at full resolution is what the same terrains would draw without the level of detail
+ */
+struct TerrainLODFrameStats {
+  Uint NodesDrawn = 0;
+  Uint TrianglesDrawn = 0;
+  Uint TrianglesFullResolution = 0;
+};
+
+/**
+ * @brief CPU side of the continuous distance dependent level of detail (CDLOD) of a heightmap. The quadtree keeps the
+ * min and max heights of every node and the error of each level (the most a sample differs from the grid of the
+ * level), the error in pixels gives the distance each level is good enough. The ranges at least double per level and
+ * are wider than the nodes, so neighbour nodes are never more than one level apart and the vertices of the finer node
+ * are fully morphed on the border with a coarser one, closing the cracks without skirts.
+ * Selection and morphing run on the CPU, EvaluateVertex does the same math of the TerrainCDLOD shader
+ */
+class TerrainQuadtree {
+ public:
+  /**
+   * @brief Builds the nodes over the heightmap (width x height samples, X as the column), the heightmap must outlive
+   * the quadtree and have linear rows
+   */
+  void Build(Math::Array2D<float>* heightMap, int width, int height, const TerrainLODSettings& settings,
+             WorkerPool* pool = WorkerPool::GetGlobal());
+
+  /**
+   * @brief Refreshes the bounds of the nodes over the samples of the rect after the heightmap was edited. The errors of
+   * the levels only grow here, Build computes them again from scratch
+   */
+  void UpdateRegion(const TerrainDirtyRect& rect, WorkerPool* pool = WorkerPool::GetGlobal());
+
+  YEAGER_NODISCARD TerrainLODRanges ComputeRanges(const TerrainLODView& view, float worldScale) const;
+
+  /** Appends the nodes to draw for the view, every quad of the heightmap is covered by exactly one node */
+  void Select(const TerrainLODView& view, float worldScale, const TerrainLODRanges& ranges,
+              std::vector<TerrainLODNode>* selection) const;
+
+  /** 0 keeps the vertex in the grid of its level, 1 moves the odd vertices over the even ones (the coarser grid) */
+  static float GetMorphFactor(const TerrainLODRanges& ranges, int level, float distance);
+  static Vector2 MorphGridPosition(const Vector2& grid, float morph);
+
+  /**
+   * @brief Position of the vertex (gridX, gridZ) of the node after morphing, gridX and gridZ go from 0 to LeafQuads
+   */
+  YEAGER_NODISCARD Vector3 EvaluateVertex(const TerrainLODNode& node, int gridX, int gridZ, const TerrainLODView& view,
+                                          const TerrainLODRanges& ranges, float worldScale) const;
+
+  /** Bilinear height, positions outside the heightmap are clamped to the border */
+  YEAGER_NODISCARD float SampleHeight(float x, float z) const;
+
+  YEAGER_NODISCARD int GetLevelCount() const { return m_LevelErrors.size(); }
+  YEAGER_NODISCARD float GetLevelError(int level) const { return m_LevelErrors[level]; }
+  YEAGER_NODISCARD int GetLeafQuads() const { return m_Settings.LeafQuads; }
+  YEAGER_NODISCARD int GetWidth() const { return m_Width; }
+  YEAGER_NODISCARD int GetHeight() const { return m_Height; }
+  YEAGER_NODISCARD const float* GetSamples() const { return m_Samples; }
+  /** Samples between the start of two rows of GetSamples */
+  YEAGER_NODISCARD int GetPitch() const { return m_Pitch; }
+  YEAGER_NODISCARD const TerrainLODSettings& GetSettings() const { return m_Settings; }
+  YEAGER_NODISCARD bool IsBuilt() const { return m_HeightMap != YEAGER_NULLPTR; }
+
+  /** Triangles drawn for the node, whole nodes and quarters */
+  YEAGER_NODISCARD Uint GetTriangleCount(const TerrainLODNode& node) const;
+
+ private:
+  struct Bounds {
+    Vector3 Min;
+    Vector3 Max;
+  };
+
+  bool SelectNode(int level, int nodeX, int nodeZ, const TerrainLODView& view, float worldScale,
+                  const TerrainLODRanges& ranges, std::vector<TerrainLODNode>* selection) const;
+  TerrainLODNode MakeNode(int level, int nodeX, int nodeZ, int quadrant) const;
+  Bounds GetBounds(const TerrainLODNode& node, float worldScale) const;
+  bool NodeExists(int level, int nodeX, int nodeZ) const;
+  float CalculateLevelError(int level, const TerrainDirtyRect& rect, WorkerPool* pool) const;
+  Vector2 CalculateLeafMinMax(int nodeX, int nodeZ) const;
+  Vector2 JoinChildrenMinMax(int level, int nodeX, int nodeZ) const;
+  void UpdateHeightRange();
+  static bool IntersectsSphere(const Bounds& bounds, const Vector3& center, float radius);
+
+  YEAGER_NODISCARD int GetNodesX(int level) const;
+  YEAGER_NODISCARD int GetNodesZ(int level) const;
+  YEAGER_NODISCARD float Sample(int x, int z) const;
+
+  Math::Array2D<float>* m_HeightMap = YEAGER_NULLPTR;
+  const float* m_Samples = YEAGER_NULLPTR;
+  int m_Pitch = 0;
+  int m_Width = 0;
+  int m_Height = 0;
+  TerrainLODSettings m_Settings;
+
+  /* Min and max heights of the nodes of each level, node by node in rows */
+  std::vector<std::vector<Vector2>> m_MinMax;
+  std::vector<float> m_LevelErrors;
+  float m_MinHeight = 0.0f;
+  float m_MaxHeight = 0.0f;
+};
+
+/**
+ * @brief OpenGL side of the level of detail. Every node is drawn with the same grid of LeafQuads x LeafQuads quads, the
+ * index buffer is ordered by quarter so a quarter of a node is a range of it. The heights are read in the vertex shader
+ * from a float texture of the heightmap
+ */
+class TerrainLODRenderer {
+ public:
+  TerrainLODRenderer() = default;
+  ~TerrainLODRenderer();
+
+  TerrainLODRenderer(const TerrainLODRenderer&) = delete;
+  TerrainLODRenderer& operator=(const TerrainLODRenderer&) = delete;
+
+  /** Uploads the grid and the heightmap of the quadtree, called again after the heightmap changes */
+  void Setup(const TerrainQuadtree& quadtree);
+  void DeleteBuffers();
+
+  /** Uploads the samples of the rect to the heightmap texture, after the quadtree was updated for the same rect */
+  void UpdateHeightRegion(const TerrainQuadtree& quadtree, const TerrainDirtyRect& rect);
+
+  /**
+   * @brief Draws the nodes, the terrain uniforms (model, textures, heights) must be set before calling this
+   */
+  void Draw(Shader* shader, const TerrainQuadtree& quadtree, const std::vector<TerrainLODNode>& selection,
+            const TerrainLODView& view, const TerrainLODRanges& ranges, float worldScale, float textureScale,
+            float size);
+
+  YEAGER_NODISCARD bool IsGenerated() const { return m_Generated; }
+
+  static const TerrainLODFrameStats& GetFrameStats() { return sFrameStats; }
+  /**
+   * @brief Must be called once per frame before the terrains are drawn
+   */
+  static void ResetFrameStats() { sFrameStats = TerrainLODFrameStats(); }
+
+ private:
+  static TerrainLODFrameStats sFrameStats;
+
+  GLuint m_Vao = 0, m_Vbo = 0, m_Ebo = 0;
+  GLuint m_HeightTexture = 0;
+  int m_LeafQuads = 0;
+  bool m_Generated = false;
+};
+
+}  // namespace Yeager
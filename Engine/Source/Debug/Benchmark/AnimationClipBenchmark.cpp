@@ -0,0 +1,202 @@
+#include "Benchmark.h"
+#include "Components/Kernel/Caching/Cache.h"
+#include "Components/Renderer/AnimationEngine/AnimationClip.h"
+#include "Components/Renderer/AnimationEngine/AnimationEngine.h"
+using namespace Yeager;
+
+#define YEAGER_ANIMATION_CLIP_BENCHMARK_KEYS 241
+#define YEAGER_ANIMATION_CLIP_BENCHMARK_DURATION 240.0
+#define YEAGER_ANIMATION_CLIP_BENCHMARK_SAMPLES 1000000
+
+/* Smooth synthetic motion, the second channel has no scaling keys like the channels some exporters write */
+static aiScene* BuildClipScene()
+{
+  aiScene* scene = new aiScene();
+  scene->mRootNode = new aiNode("Root");
+  scene->mRootNode->mNumChildren = 1;
+  scene->mRootNode->mChildren = new aiNode*[1];
+  scene->mRootNode->mChildren[0] = new aiNode("Bone");
+  scene->mRootNode->mChildren[0]->mParent = scene->mRootNode;
+
+  aiAnimation* animation = new aiAnimation();
+  animation->mName = aiString("Synthetic");
+  animation->mDuration = YEAGER_ANIMATION_CLIP_BENCHMARK_DURATION;
+  animation->mTicksPerSecond = 30.0;
+  animation->mNumChannels = 2;
+  animation->mChannels = new aiNodeAnim*[2];
+
+  const Uint keys = YEAGER_ANIMATION_CLIP_BENCHMARK_KEYS;
+  for (Uint channel = 0; channel < 2; channel++) {
+    aiNodeAnim* node = new aiNodeAnim();
+    node->mNodeName = aiString(channel == 0 ? "Root" : "Bone");
+    node->mNumPositionKeys = keys;
+    node->mPositionKeys = new aiVectorKey[keys];
+    node->mNumRotationKeys = keys;
+    node->mRotationKeys = new aiQuatKey[keys];
+    node->mNumScalingKeys = channel == 0 ? keys : 0;
+    node->mScalingKeys = channel == 0 ? new aiVectorKey[keys] : YEAGER_NULLPTR;
+    for (Uint x = 0; x < keys; x++) {
+      const double time = YEAGER_ANIMATION_CLIP_BENCHMARK_DURATION * x / (keys - 1);
+      const float phase = static_cast<float>(time) * 0.05f + channel;
+      node->mPositionKeys[x] = aiVectorKey(time, aiVector3D(2.0f * std::sin(phase), std::cos(phase), 0.5f * phase));
+      const aiQuaternion rotation(aiVector3D(0.0f, 1.0f, 0.0f), phase);
+      node->mRotationKeys[x] = aiQuatKey(time, rotation);
+      if (node->mScalingKeys) {
+        node->mScalingKeys[x] = aiVectorKey(time, aiVector3D(1.0f + 0.25f * std::sin(phase)));
+      }
+    }
+    animation->mChannels[channel] = node;
+  }
+
+  scene->mNumAnimations = 1;
+  scene->mAnimations = new aiAnimation*[1];
+  scene->mAnimations[0] = animation;
+  return scene;
+}
+
+/* A copy of the cache with one track pointing past the end of the file, the load must reject it */
+static bool LoadsCorruptedCopy(const String& path, const String& corruptedPath, uint64_t hash, uint64_t timestamp,
+                               uint32_t positionCount, bool moveOffset)
+{
+  std::vector<char> bytes(std::filesystem::file_size(path));
+  std::ifstream(path, std::ios_base::binary).read(bytes.data(), bytes.size());
+  const auto* header = reinterpret_cast<const AnimationClipFileHeader*>(bytes.data());
+  const auto* clip = reinterpret_cast<const AnimationClipDesc*>(bytes.data() + header->ClipsOffset);
+  auto* track = reinterpret_cast<AnimationClipTrack*>(bytes.data() + clip->TracksOffset);
+  track->PositionCount = positionCount;
+  if (moveOffset) {
+    track->PositionKeysOffset = header->FileSize - sizeof(AnimationClipKey) / 2;
+  }
+  std::ofstream(corruptedPath, std::ios_base::binary | std::ios_base::trunc).write(bytes.data(), bytes.size());
+
+  AnimationClipFile corrupted;
+  const bool loaded = corrupted.Load(corruptedPath, hash, timestamp);
+  std::filesystem::remove(corruptedPath);
+  return loaded;
+}
+
+static bool EqualMatrices(const Matrix4& a, const Matrix4& b)
+{
+  for (int column = 0; column < 4; column++) {
+    for (int row = 0; row < 4; row++) {
+      if (std::abs(a[column][row] - b[column][row]) > 1e-4f)
+        return false;
+    }
+  }
+  return true;
+}
+
+/* One clip set played by two meshes with the bones in a different order and other offsets, like two characters sharing
+ * an animation file. Each mesh must get the pose at its own bone ids, multiplied by its own offsets */
+static bool SharesClipSetBetweenMeshes(const String& path, uint64_t hash, uint64_t timestamp)
+{
+  auto file = BaseAllocator::MakeSharedPtr<AnimationClipFile>();
+  if (!file->Load(path, hash, timestamp))
+    return false;
+
+  auto set = BaseAllocator::MakeSharedPtr<AnimationClipSet>();
+  set->Skeleton = AnimationSkeleton::Build(*file);
+  set->Animations.push_back(Animation(file, 0));
+  set->Animations[0].BindSkeleton(set->Skeleton);
+
+  std::map<String, BoneInfo> firstMesh;
+  firstMesh["Root"].ID = 0;
+  firstMesh["Bone"].ID = 1;
+  std::map<String, BoneInfo> secondMesh;
+  secondMesh["Bone"] = BoneInfo{0, glm::translate(Matrix4(1.0f), Vector3(1.0f, 2.0f, 3.0f))};
+  secondMesh["Root"] = BoneInfo{2, glm::scale(Matrix4(1.0f), Vector3(2.0f))};
+
+  AnimationEngine first, second;
+  first.LoadClipSet(set, firstMesh);
+  second.LoadClipSet(set, secondMesh);
+  std::vector<Matrix4> firstPose, secondPose;
+  for (const float seconds : {0.0f, 1.7f, 4.2f}) {
+    if (!first.SamplePose(0, seconds, &firstPose) || !second.SamplePose(0, seconds, &secondPose))
+      return false;
+    /* The first mesh has identity offsets, so its matrices are the global transforms of the nodes */
+    for (const auto& [name, info] : secondMesh) {
+      if (!EqualMatrices(secondPose[info.ID], firstPose[firstMesh[name].ID] * info.OffSet))
+        return false;
+    }
+    if (EqualMatrices(firstPose[0], firstPose[1]))
+      return false;
+  }
+  return true;
+}
+
+static void AnimationClipBenchmarkSuite(BenchmarkReport* report)
+{
+  const std::filesystem::path folder = std::filesystem::temp_directory_path();
+  const String sourcePath = (folder / "YeagerAnimationClipSource.fbx").string();
+  const String path = (folder / ("YeagerAnimationClip" YEAGER_ANIMATION_CLIP_CACHE_EXT_STR)).string();
+  const String corruptedPath = (folder / ("YeagerAnimationClipCorrupted" YEAGER_ANIMATION_CLIP_CACHE_EXT_STR)).string();
+
+  aiScene* scene = BuildClipScene();
+  const AnimationClipCompileSettings settings;
+  AnimationClipCompileReport compiled;
+  const bool written = AnimationClipCompiler::Compile(scene, sourcePath, path, settings, &compiled);
+  delete scene;
+
+  const uint64_t hash = CreateFileHash(sourcePath);
+  const uint64_t timestamp = AnimationClipFile::GetSourceTimestamp(sourcePath);
+  AnimationClipFile file;
+  if (!written || !file.Load(path, hash, timestamp)) {
+    report->Fail("Animation clip cache cannot be compiled and loaded back!");
+    return;
+  }
+
+  report->AddMetric("Source Keys", compiled.SourceKeys);
+  report->AddMetric("Compiled Keys", compiled.CompiledKeys);
+  report->AddMetric("Compression", static_cast<double>(compiled.SourceBytes) / compiled.CompiledBytes, "x");
+  report->AddMetric("Max Position Error", compiled.MaxPositionError, "units");
+  report->AddMetric("Max Rotation Error", compiled.MaxRotationError, "rad");
+  report->AddMetric("Max Scale Error", compiled.MaxScaleError, "units");
+
+  /* The key reduction tolerance plus the 16 bits quantization of the values and of the key times */
+  const float quantization = 2e-3f;
+  if (compiled.MaxPositionError > settings.PositionTolerance + quantization ||
+      compiled.MaxRotationError > settings.RotationTolerance + quantization ||
+      compiled.MaxScaleError > settings.ScaleTolerance + quantization) {
+    report->Fail("Animation clip cache does not sample back the source keys within the tolerance!");
+  }
+
+  /* The channel without scaling keys must sample the identity scale */
+  const AnimationClipDesc* clip = file.GetClip(0);
+  const AnimationClipTrack* tracks = file.GetTracks(clip);
+  Vector3 position, scale;
+  glm::quat rotation;
+  file.SampleTrack(&tracks[1], clip->Duration, clip->Duration * 0.5f, &position, &rotation, &scale);
+  if (tracks[1].ScaleCount != 0 || scale != Vector3(1.0f)) {
+    report->Fail("Animation clip track without scaling keys does not sample the identity scale!");
+  }
+
+  if (!SharesClipSetBetweenMeshes(path, hash, timestamp)) {
+    report->Fail("Animation clip set shared by two meshes does not use the bones of each mesh!");
+  }
+
+  BenchmarkMeasure sample;
+  sample.Name = "Animation Clip Sample";
+  sample.ItemsUnit = "samples";
+  sample.Items = YEAGER_ANIMATION_CLIP_BENCHMARK_SAMPLES;
+  float checksum = 0.0f;
+  sample.Seconds = Benchmark::MeasureBestSeconds(3, [&]() {
+    for (Uint x = 0; x < YEAGER_ANIMATION_CLIP_BENCHMARK_SAMPLES; x++) {
+      const float time = clip->Duration * (x % 1024) / 1023.0f;
+      file.SampleTrack(&tracks[x % clip->TrackCount], clip->Duration, time, &position, &rotation, &scale);
+      checksum += position.x;
+    }
+  });
+  report->AddMeasure(sample);
+  report->AddMetric("Sample Checksum", checksum);
+
+  /* Key ranges past the end of the file, by the count and by the offset */
+  if (LoadsCorruptedCopy(path, corruptedPath, hash, timestamp, UINT32_MAX / sizeof(AnimationClipKey), false) ||
+      LoadsCorruptedCopy(path, corruptedPath, hash, timestamp, 1, true)) {
+    report->Fail("Animation clip cache with keys out of the file was loaded!");
+  }
+  /* The file is still mapped by the view, the remove may fail on systems that lock mapped files */
+  std::error_code error;
+  std::filesystem::remove(path, error);
+}
+
+YEAGER_BENCHMARK_SUITE("AnimationClip", AnimationClipBenchmarkSuite);
@@ -0,0 +1,156 @@
+#include "Benchmark.h"
+#include "Components/TerrainGen/GradientNoise.h"
+#include "Components/TerrainGen/ProceduralTerrain.h"
+#include "Components/TerrainGen/TerrainEditor.h"
+using namespace Yeager;
+
+#define YEAGER_ARRAY2D_BENCHMARK_REPETITIONS 3
+#define YEAGER_ARRAY2D_BENCHMARK_FIR 0.5f
+#define YEAGER_ARRAY2D_BENCHMARK_ROUGHNESS 1.0f
+
+static void FillHeightMap(Math::Array2D<float>* heightMap, int size)
+{
+  for (int z = 0; z < size; z++) {
+    for (int x = 0; x < size; x++) {
+      const float height = 64.0f * std::sin(x * 0.05f) * std::cos(z * 0.031f) + 8.0f * std::sin(x * z * 0.001f);
+      heightMap->Set(x, z, 128.0f + height);
+    }
+  }
+}
+
+/* Same algorithms over different layouts must give the same heights bit by bit */
+static bool EqualHeightMaps(Math::Array2D<float>* a, Math::Array2D<float>* b, int size)
+{
+  for (int z = 0; z < size; z++) {
+    for (int x = 0; x < size; x++) {
+      if (std::memcmp(&a->At(x, z), &b->At(x, z), sizeof(float)) != 0) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/* Rows, columns and views must reach the same elements of At in every layout */
+static bool CheckAccessors(Math::Array2D<float>* array, int size)
+{
+  float rowSum = 0.0f, columnSum = 0.0f, expectedRow = 0.0f, expectedColumn = 0.0f;
+  for (float value : array->GetRow(size / 3)) {
+    rowSum += value;
+  }
+  for (float value : array->GetColumn(size / 5)) {
+    columnSum += value;
+  }
+  for (int x = 0; x < size; x++) {
+    expectedRow += array->At(x, size / 3);
+    expectedColumn += array->At(size / 5, x);
+  }
+
+  const Math::Array2DView<float> view = array->GetView(7, 11, size / 2, size / 2).SubView(3, 5, 16, 16);
+  return rowSum == expectedRow && columnSum == expectedColumn && &view.At(2, 9) == &array->At(12, 25);
+}
+
+/* A noise region and brush strokes written through the row pointers of the linear layouts and At of the tiled one */
+static void FillAndSculpt(Math::Array2D<float>* heightMap)
+{
+  const NoiseFractalSettings noise;
+  GradientNoise(1337).FillArray2D(heightMap, 5, 3, heightMap->GetCols() - 11, heightMap->GetRows() - 9, noise, 32.0f,
+                                  64.0f);
+
+  TerrainHeightEditor editor(heightMap, heightMap->GetCols(), heightMap->GetRows(), 0.0f, 256.0f);
+  TerrainBrush brush;
+  brush.Radius = 13.0f;
+  brush.Strength = 4.0f;
+  editor.ApplyBrush(brush, 37.5f, 41.0f);
+  brush.Type = TerrainBrushType::eSMOOTH;
+  brush.Strength = 0.8f;
+  editor.ApplyBrush(brush, 45.0f, 29.5f);
+}
+
+static const char* GetLayoutName(Math::Array2DLayout::Enum layout)
+{
+  switch (layout) {
+    case Math::Array2DLayout::eLINEAR_PITCHED:
+      return "Pitched";
+    case Math::Array2DLayout::eTILED:
+      return "Tiled";
+    case Math::Array2DLayout::eLINEAR:
+    default:
+      return "Linear";
+  }
+}
+
+static void Array2DBenchmarkSuite(BenchmarkReport* report)
+{
+  /* 2048 has rows of exactly 8 KB, the columns of the linear layout alias in the cache */
+  for (int size : {2048, 2049}) {
+    const String name = std::to_string(size) + "x" + std::to_string(size);
+    Math::Array2D<float> firReference(size, size);
+    Math::Array2D<float> midPointReference(size, size);
+    double firLinear = 0.0, midPointLinear = 0.0;
+
+    for (const auto layout :
+         {Math::Array2DLayout::eLINEAR, Math::Array2DLayout::eLINEAR_PITCHED, Math::Array2DLayout::eTILED}) {
+      const String layoutName = GetLayoutName(layout);
+      Math::Array2D<float> heightMap(size, size, layout);
+      FillHeightMap(&heightMap, size);
+      if (!CheckAccessors(&heightMap, size)) {
+        report->Fail("Array2D " + layoutName + " rows, columns or views differ from At!");
+      }
+      if (layout != Math::Array2DLayout::eLINEAR) {
+        Math::Array2D<float> sculpted(size, size);
+        FillHeightMap(&sculpted, size);
+        FillAndSculpt(&sculpted);
+        FillAndSculpt(&heightMap);
+        if (!EqualHeightMaps(&heightMap, &sculpted, size)) {
+          report->Fail("Noise fill or brushes over the " + layoutName + " layout differ from the linear layout!");
+        }
+        FillHeightMap(&heightMap, size);
+      }
+
+      BenchmarkMeasure fir;
+      fir.Name = "Fault Formation FIR " + layoutName + " " + name;
+      fir.ItemsUnit = "samples";
+      fir.Items = static_cast<double>(size) * size;
+      fir.Seconds = Benchmark::MeasureBestSeconds(YEAGER_ARRAY2D_BENCHMARK_REPETITIONS, [&]() {
+        FaultFormationTerrain::ApplyFilterFIR(&heightMap, size, YEAGER_ARRAY2D_BENCHMARK_FIR);
+      });
+      report->AddMeasure(fir);
+
+      if (layout == Math::Array2DLayout::eLINEAR) {
+        firLinear = fir.Seconds;
+        firReference.CopyFrom(heightMap);
+      } else {
+        report->AddMetric("FIR Speedup " + layoutName + " " + name, firLinear / std::max(fir.Seconds, 1e-9), "x");
+        if (!EqualHeightMaps(&heightMap, &firReference, size)) {
+          report->Fail("FIR filter over the " + layoutName + " layout differs from the linear layout!");
+        }
+      }
+
+      /* The random values of the displacement only depend on the seed, every layout gets the same values */
+      FillHeightMap(&heightMap, size);
+      BenchmarkMeasure midPoint;
+      midPoint.Name = "Midpoint Displacement " + layoutName + " " + name;
+      midPoint.ItemsUnit = "samples";
+      midPoint.Items = static_cast<double>(size) * size;
+      midPoint.Seconds = Benchmark::MeasureBestSeconds(YEAGER_ARRAY2D_BENCHMARK_REPETITIONS, [&]() {
+        MidPointDisplacementTerrain::CreateMidPointDisplacementF32(&heightMap, size, YEAGER_ARRAY2D_BENCHMARK_ROUGHNESS,
+                                                                   1337);
+      });
+      report->AddMeasure(midPoint);
+
+      if (layout == Math::Array2DLayout::eLINEAR) {
+        midPointLinear = midPoint.Seconds;
+        midPointReference.CopyFrom(heightMap);
+      } else {
+        report->AddMetric("Midpoint Speedup " + layoutName + " " + name,
+                          midPointLinear / std::max(midPoint.Seconds, 1e-9), "x");
+        if (!EqualHeightMaps(&heightMap, &midPointReference, size)) {
+          report->Fail("Midpoint displacement over the " + layoutName + " layout differs from the linear layout!");
+        }
+      }
+    }
+  }
+}
+
+YEAGER_BENCHMARK_SUITE("Array2D", Array2DBenchmarkSuite);
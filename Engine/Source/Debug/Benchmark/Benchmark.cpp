@@ -0,0 +1,127 @@
+#include "Benchmark.h"
+
+#include <cstdlib>
+using namespace Yeager;
+
+void BenchmarkReport::AddMetric(const String& name, double value, const String& unit)
+{
+  BenchmarkMetric metric;
+  metric.Name = name;
+  metric.Value = value;
+  metric.Unit = unit;
+  m_Metrics.push_back(metric);
+}
+
+void BenchmarkReport::Fail(const String& reason)
+{
+  Yeager::Log(ERROR, "Benchmark suite {} failed: {}", m_Suite, reason);
+  m_Failed = true;
+}
+
+void BenchmarkReport::Print() const
+{
+  Yeager::Log(INFO, "Benchmark suite {}", m_Suite);
+  for (const auto& measure : m_Measures) {
+    Yeager::Log(INFO, "  {:<40} {:>10.3f} ms  {:>14.0f} {}/s  {:>14.0f} {}/s per core ({} threads)", measure.Name,
+                measure.Seconds * 1000.0, measure.GetItemsPerSecond(), measure.ItemsUnit,
+                measure.GetItemsPerSecondPerThread(), measure.ItemsUnit, measure.Threads);
+  }
+  for (const auto& metric : m_Metrics) {
+    Yeager::Log(INFO, "  {:<40} {:>14.6g} {}", metric.Name, metric.Value, metric.Unit);
+  }
+}
+
+std::map<String, BenchmarkSuiteFunction>& Benchmark::GetSuites()
+{
+  /* Function static so suites can be registered during the static initialization of any translation unit */
+  static std::map<String, BenchmarkSuiteFunction> suites;
+  return suites;
+}
+
+bool Benchmark::RegisterSuite(const String& name, BenchmarkSuiteFunction function)
+{
+  GetSuites()[name] = function;
+  return true;
+}
+
+std::vector<String> Benchmark::GetSuitesNames()
+{
+  std::vector<String> names;
+  for (const auto& suite : GetSuites()) {
+    names.push_back(suite.first);
+  }
+  return names;
+}
+
+std::optional<String> Benchmark::SearchSuiteArgument(int argc, char* argv[])
+{
+  for (int x = 1; x < argc; x++) {
+    if (String(argv[x]) == "-Benchmark") {
+      return x + 1 < argc ? String(argv[x + 1]) : String("All");
+    }
+  }
+  return std::nullopt;
+}
+
+std::map<String, String> Benchmark::sOptions;
+
+void Benchmark::ParseOptions(int argc, char* argv[])
+{
+  for (int x = 1; x < argc; x++) {
+    const String argument(argv[x]);
+    const size_t equal = argument.find('=');
+    if (argument.rfind("--", 0) == 0 && equal != String::npos) {
+      sOptions[argument.substr(2, equal - 2)] = argument.substr(equal + 1);
+    }
+  }
+}
+
+String Benchmark::GetOption(const String& name, const String& defaultValue)
+{
+  const auto option = sOptions.find(name);
+  return option != sOptions.end() ? option->second : defaultValue;
+}
+
+double Benchmark::GetNumberOption(const String& name, double defaultValue)
+{
+  const auto option = sOptions.find(name);
+  if (option == sOptions.end()) {
+    return defaultValue;
+  }
+  char* end = YEAGER_NULLPTR;
+  const double value = std::strtod(option->second.c_str(), &end);
+  if (end == option->second.c_str() || *end != '\0') {
+    Yeager::Log(WARNING, "Benchmark option {} is not a number: {}", name, option->second);
+    return defaultValue;
+  }
+  return value;
+}
+
+int Benchmark::Run(const String& name)
+{
+  std::vector<String> names;
+  if (name == "All") {
+    names = GetSuitesNames();
+  } else if (GetSuites().find(name) != GetSuites().end()) {
+    names.push_back(name);
+  } else {
+    String available;
+    for (const auto& suite : GetSuitesNames()) {
+      available += suite + " ";
+    }
+    Yeager::Log(ERROR, "Benchmark suite {} not found! Available suites: {}", name, available);
+    return EXIT_FAILURE;
+  }
+
+  Yeager::Log(INFO, "Running {} benchmark suites, {} hardware threads", names.size(),
+              std::thread::hardware_concurrency());
+
+  bool failed = false;
+  for (const auto& suite : names) {
+    BenchmarkReport report(suite);
+    GetSuites()[suite](&report);
+    report.Print();
+    failed |= report.HasFailed();
+  }
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,129 @@
+//    Yeager Engine, free and open source 3D/2D renderer written in OpenGL
+//    In case of questions and bugs, please, refer to the issue tab on github
+//    Repo : https://github.com/schwq/YeagerEngine
+//    Copyright (C) 2023 - Present
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Common/Utils/Common.h"
+#include "Common/Utils/LogEngine.h"
+#include "Common/Utils/Utilities.h"
+
+#include <limits>
+
+namespace Yeager {
+
+/**
+ * @brief A single timed measure of a benchmark suite, Items is the amount of work done by one repetition (vertices,
+ * samples, queries) so the report can show the throughput of each thread
+ */
+struct BenchmarkMeasure {
+  String Name = YEAGER_NULL_LITERAL;
+  String ItemsUnit = "items";
+  double Items = 0.0;
+  double Seconds = 0.0;
+  Uint Threads = 1;
+
+  YEAGER_NODISCARD double GetItemsPerSecond() const { return Seconds > 0.0 ? Items / Seconds : 0.0; }
+  YEAGER_NODISCARD double GetItemsPerSecondPerThread() const { return GetItemsPerSecond() / std::max<Uint>(1, Threads); }
+};
+
+struct BenchmarkMetric {
+  String Name = YEAGER_NULL_LITERAL;
+  double Value = 0.0;
+  String Unit = YEAGER_EMPTY_LITERAL;
+};
+
+/**
+ * @brief Results of a suite, the measures and metrics are logged once the suite is done. A suite that validates its
+ * results (error against a reference, for example) calls Fail and the benchmark returns a error code
+ */
+class BenchmarkReport {
+ public:
+  BenchmarkReport(const String& suite) : m_Suite(suite) {}
+
+  void AddMeasure(const BenchmarkMeasure& measure) { m_Measures.push_back(measure); }
+  void AddMetric(const String& name, double value, const String& unit = YEAGER_EMPTY_LITERAL);
+  void Fail(const String& reason);
+  void Print() const;
+
+  YEAGER_NODISCARD bool HasFailed() const { return m_Failed; }
+  YEAGER_NODISCARD const std::vector<BenchmarkMeasure>& GetMeasures() const { return m_Measures; }
+  YEAGER_NODISCARD const std::vector<BenchmarkMetric>& GetMetrics() const { return m_Metrics; }
+
+ private:
+  String m_Suite = YEAGER_NULL_LITERAL;
+  std::vector<BenchmarkMeasure> m_Measures;
+  std::vector<BenchmarkMetric> m_Metrics;
+  bool m_Failed = false;
+};
+
+using BenchmarkSuiteFunction = std::function<void(BenchmarkReport*)>;
+
+/**
+ * @brief Registry of the benchmark suites of the engine. The suites run headless (no window, no OpenGL context), started
+ * from the command line with -Benchmark <suite>, or -Benchmark All to run every registered suite. The options of the
+ * suites follow as --Name=Value, for example -Benchmark PhysXScenes --Steps=600 --Threads=4
+ */
+class Benchmark {
+ public:
+  static bool RegisterSuite(const String& name, BenchmarkSuiteFunction function);
+
+  /**
+   * @brief Searchs for the -Benchmark argument, returns the suite name when found
+   */
+  static std::optional<String> SearchSuiteArgument(int argc, char* argv[]);
+
+  /** Keeps every --Name=Value argument, the suites read them with GetOption */
+  static void ParseOptions(int argc, char* argv[]);
+  /** Value of the option, or the default when it was not given */
+  static String GetOption(const String& name, const String& defaultValue);
+  /** Numeric value of the option, the default when it was not given or is not a number */
+  static double GetNumberOption(const String& name, double defaultValue);
+
+  /**
+   * @brief Runs the suite (or every suite when name is All) and returns the process return code
+   */
+  static int Run(const String& name);
+
+  static std::vector<String> GetSuitesNames();
+
+  /**
+   * @brief Runs the function repetitions times and returns the fastest run in seconds, the fastest run is the one less
+   * disturbed by the rest of the system
+   */
+  template <typename Function>
+  static double MeasureBestSeconds(Uint repetitions, Function&& function)
+  {
+    double best = std::numeric_limits<double>::max();
+    for (Uint x = 0; x < std::max<Uint>(1, repetitions); x++) {
+      const auto start = std::chrono::steady_clock::now();
+      function();
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      best = std::min(best, elapsed.count());
+    }
+    return best;
+  }
+
+ private:
+  static std::map<String, BenchmarkSuiteFunction>& GetSuites();
+  static std::map<String, String> sOptions;
+};
+
+#define YEAGER_BENCHMARK_SUITE(name, function) \
+  static const bool s##function##Registered = Yeager::Benchmark::RegisterSuite(name, function)
+
+}  // namespace Yeager
@@ -0,0 +1,94 @@
+#include "Benchmark.h"
+#include "Components/TerrainGen/GradientNoise.h"
+using namespace Yeager;
+
+#define YEAGER_NOISE_BENCHMARK_SEED 1337
+#define YEAGER_NOISE_BENCHMARK_SIZE 1024
+#define YEAGER_NOISE_BENCHMARK_REPETITIONS 3
+
+struct NoiseGoldenValue {
+  float X, Y;
+  float Value;
+};
+
+/* Values of the scalar path with the benchmark seed, any change of the permutation generator or of the simplex math
+ * breaks the terrains saved by seed and must show up here */
+static const NoiseGoldenValue sNoiseSampleGolden[] = {{0.0f, 0.0f, 0.0f},
+                                                      {0.5f, 0.25f, -0.513867676f},
+                                                      {12.75f, -3.5f, 0.0423738062f},
+                                                      {-101.3f, 47.9f, 0.737935603f},
+                                                      {1024.0f, 768.5f, 0.457287878f}};
+
+/* Fractal values at the same points scaled by 37, default settings, one row per fractal type */
+static const float sNoiseFractalGolden[3][5] = {
+    {0.0f, 0.243172616f, -0.406746745f, 0.0996204689f, -0.11957787f},
+    {1.0f, 0.228402361f, 0.380473912f, 0.197703704f, 0.742788613f},
+    {-1.0f, 0.0759557113f, -0.0151851047f, 0.173069522f, -0.640187442f}};
+
+static void NoiseBenchmarkSuite(BenchmarkReport* report)
+{
+  GradientNoise noise(YEAGER_NOISE_BENCHMARK_SEED);
+  const NoiseSIMDPath::Enum best = GradientNoise::GetBestSIMDPath();
+
+  /* Golden values, checked with the scalar path */
+  noise.SetSIMDPath(NoiseSIMDPath::eSIMD_SCALAR);
+  float goldenError = 0.0f;
+  for (Uint point = 0; point < 5; point++) {
+    const NoiseGoldenValue& golden = sNoiseSampleGolden[point];
+    goldenError = std::max(goldenError, std::fabs(noise.Sample(golden.X, golden.Y) - golden.Value));
+    for (Uint type = 0; type < 3; type++) {
+      NoiseFractalSettings settings;
+      settings.Type = static_cast<NoiseFractalType::Enum>(type);
+      const float value = noise.Fractal(golden.X * 37.0f, golden.Y * 37.0f, settings);
+      goldenError = std::max(goldenError, std::fabs(value - sNoiseFractalGolden[type][point]));
+    }
+  }
+  report->AddMetric("Golden values max error", goldenError);
+  if (goldenError > 1e-6f) {
+    report->Fail("Gradient noise differs from the golden values, terrains generated from a seed changed!");
+  }
+
+  /* Throughput of each path in a single thread, then the best path over the worker pool */
+  const int size = YEAGER_NOISE_BENCHMARK_SIZE;
+  NoiseFractalSettings settings;
+  std::vector<float> reference;
+  for (Uint path = NoiseSIMDPath::eSIMD_SCALAR; path <= best; path++) {
+    noise.SetSIMDPath(static_cast<NoiseSIMDPath::Enum>(path));
+    Math::Array2D<float> array(size, size, 0.0f);
+
+    BenchmarkMeasure measure;
+    measure.Name = "Fractal Noise " + NoiseSIMDPath::ToString(noise.GetSIMDPath()) + " (5 octaves)";
+    measure.ItemsUnit = "samples";
+    measure.Items = static_cast<double>(size) * size;
+    measure.Seconds = Benchmark::MeasureBestSeconds(YEAGER_NOISE_BENCHMARK_REPETITIONS, [&]() {
+      for (int row = 0; row < size; row++) {
+        noise.FillRow(array.GetAddress(0, row), 0, row, size, settings);
+      }
+    });
+    report->AddMeasure(measure);
+
+    if (reference.empty()) {
+      reference.assign(array.GetAddress(0, 0), array.GetAddress(0, 0) + array.GetSize());
+    } else if (std::memcmp(reference.data(), array.GetAddress(0, 0), reference.size() * sizeof(float)) != 0) {
+      report->Fail("Noise path " + NoiseSIMDPath::ToString(noise.GetSIMDPath()) + " differs from the scalar path!");
+    }
+  }
+
+  noise.SetSIMDPath(best);
+  WorkerPool* pool = WorkerPool::GetGlobal();
+  Math::Array2D<float> array(size, size, 0.0f);
+  BenchmarkMeasure parallel;
+  parallel.Name = "Fractal Noise " + NoiseSIMDPath::ToString(best) + " FillArray2D";
+  parallel.ItemsUnit = "samples";
+  parallel.Items = static_cast<double>(size) * size;
+  parallel.Threads = pool->GetConcurrency();
+  parallel.Seconds = Benchmark::MeasureBestSeconds(YEAGER_NOISE_BENCHMARK_REPETITIONS, [&]() {
+    noise.FillArray2D(&array, 0, 0, size, size, settings, 1.0f, 0.0f, pool);
+  });
+  report->AddMeasure(parallel);
+  if (std::memcmp(reference.data(), array.GetAddress(0, 0), reference.size() * sizeof(float)) != 0) {
+    report->Fail("Noise filled by the worker pool differs from the single thread fill!");
+  }
+}
+
+YEAGER_BENCHMARK_SUITE("Noise", NoiseBenchmarkSuite);
@@ -0,0 +1,199 @@
+#include "Benchmark.h"
+#include "Components/Kernel/Process/WorkerPool.h"
+#include "Components/Physics/PhysXHandle.h"
+
+#include <random>
+using namespace Yeager;
+using namespace physx;
+
+#define YEAGER_PHYSX_ALLOCATOR_BENCHMARK_BLOCKS 1024
+#define YEAGER_PHYSX_ALLOCATOR_BENCHMARK_OPERATIONS 1000000
+#define YEAGER_PHYSX_ALLOCATOR_BENCHMARK_BOXES 1000
+#define YEAGER_PHYSX_ALLOCATOR_BENCHMARK_STEPS 120
+
+/* Sizes of the blocks PhysX asks for in a step, mostly small with a few large buffers */
+static std::vector<size_t> BuildSizes(size_t count)
+{
+  std::mt19937 random(1337);
+  std::geometric_distribution<size_t> small(1.0 / 96.0);
+  std::uniform_int_distribution<size_t> large(4096, 65536);
+  std::vector<size_t> sizes(count);
+  for (size_t x = 0; x < count; x++) {
+    sizes[x] = x % 64 == 0 ? large(random) : small(random) + 1;
+  }
+  return sizes;
+}
+
+/* A window of live blocks, each operation frees the oldest block of the slot and allocates another */
+template <typename Allocate, typename Free>
+static void ReplaySizes(const std::vector<size_t>& sizes, Allocate&& allocate, Free&& free)
+{
+  std::vector<void*> blocks(YEAGER_PHYSX_ALLOCATOR_BENCHMARK_BLOCKS, YEAGER_NULLPTR);
+  for (size_t x = 0; x < sizes.size(); x++) {
+    void*& block = blocks[x % blocks.size()];
+    if (block) {
+      free(block);
+    }
+    block = allocate(sizes[x]);
+  }
+  for (void* block : blocks) {
+    free(block);
+  }
+}
+
+static void CheckTracking(BenchmarkReport* report)
+{
+  YgPxAllocatorCallback allocator;
+  std::vector<void*> blocks;
+  size_t requested = 0;
+  for (size_t size = 1; size <= 5000; size += 7) {
+    void* block = allocator.allocate(size, size % 2 ? "Odd" : "Even", __FILE__, __LINE__);
+    if (!block || reinterpret_cast<uintptr_t>(block) % 16 != 0) {
+      report->Fail("PhysX allocator gave a block of " + std::to_string(size) + " bytes not aligned to 16!");
+      return;
+    }
+    /* The header before the block must not be touched by the writes */
+    std::memset(block, 0xab, size);
+    blocks.push_back(block);
+    requested += size;
+  }
+
+  const PhysXAllocatorStats stats = allocator.GetStats();
+  size_t namesBytes = 0;
+  for (const PhysXAllocationNameStats& name : allocator.GetNameStats()) {
+    namesBytes += name.LiveBytes;
+  }
+  if (stats.LiveBytes != requested || namesBytes != requested || stats.LiveAllocations != blocks.size()) {
+    report->Fail("PhysX allocator counted " + std::to_string(stats.LiveBytes) + " live bytes of " +
+                 std::to_string(requested) + "!");
+  }
+  report->AddMetric("Pool Overhead", 100.0 * (stats.PooledBytesUsed + stats.LargeBytes) / requested - 100.0, "%");
+
+  for (void* block : blocks) {
+    allocator.deallocate(block);
+  }
+  if (allocator.GetStats().LiveBytes != 0 || allocator.GetStats().PeakBytes != requested) {
+    report->Fail("PhysX allocator does not count the freed blocks!");
+  }
+}
+
+/* Blocks allocated and freed from every worker at once, the pools and the counters are shared */
+static void CheckThreads(BenchmarkReport* report)
+{
+  YgPxAllocatorCallback allocator;
+  WorkerPool* pool = WorkerPool::GetGlobal();
+  const std::vector<size_t> sizes = BuildSizes(YEAGER_PHYSX_ALLOCATOR_BENCHMARK_OPERATIONS / 4);
+  std::atomic<Uint> corrupted = 0;
+  const size_t grain = sizes.size() / (pool->GetConcurrency() * 4) + 1;
+  pool->ParallelFor(0, sizes.size(), grain, [&](size_t begin, size_t end) {
+    std::vector<std::pair<uint8_t*, size_t>> blocks;
+    for (size_t x = begin; x < end; x++) {
+      uint8_t* block = static_cast<uint8_t*>(allocator.allocate(sizes[x], "Thread", __FILE__, __LINE__));
+      std::memset(block, static_cast<int>(x & 0xff), sizes[x]);
+      blocks.push_back({block, sizes[x]});
+      if (blocks.size() > 32) {
+        /* A block given to two threads would have been written by the other one */
+        auto [oldest, size] = blocks[x % blocks.size()];
+        if (oldest[0] != oldest[size - 1]) {
+          corrupted++;
+        }
+        allocator.deallocate(oldest);
+        blocks[x % blocks.size()] = blocks.back();
+        blocks.pop_back();
+      }
+    }
+    for (auto [block, size] : blocks) {
+      allocator.deallocate(block);
+    }
+  });
+
+  const PhysXAllocatorStats stats = allocator.GetStats();
+  if (corrupted > 0 || stats.LiveBytes != 0 || stats.LiveAllocations != 0 || stats.PooledBytesUsed != 0) {
+    report->Fail("PhysX allocator lost blocks between the threads!");
+  }
+  report->AddMetric("Threads", pool->GetConcurrency());
+}
+
+static void PhysXAllocatorBenchmarkSuite(BenchmarkReport* report)
+{
+  CheckTracking(report);
+  CheckThreads(report);
+
+  const std::vector<size_t> sizes = BuildSizes(YEAGER_PHYSX_ALLOCATOR_BENCHMARK_OPERATIONS);
+  YgPxAllocatorCallback allocator;
+  BenchmarkMeasure pooled;
+  pooled.Name = "PhysX Allocator Pools";
+  pooled.ItemsUnit = "allocations";
+  pooled.Items = sizes.size();
+  pooled.Seconds = Benchmark::MeasureBestSeconds(5, [&]() {
+    ReplaySizes(
+        sizes, [&](size_t size) { return allocator.allocate(size, "Replay", __FILE__, __LINE__); },
+        [&](void* block) { allocator.deallocate(block); });
+  });
+  report->AddMeasure(pooled);
+
+  BenchmarkMeasure platform;
+  platform.Name = "PhysX Allocator Platform";
+  platform.ItemsUnit = "allocations";
+  platform.Items = sizes.size();
+  platform.Seconds = Benchmark::MeasureBestSeconds(5, [&]() {
+    ReplaySizes(
+        sizes, [](size_t size) { return platformAlignedAlloc(size); }, [](void* block) { platformAlignedFree(block); });
+  });
+  report->AddMeasure(platform);
+  report->AddMetric("Pool Speedup", platform.Seconds / pooled.Seconds, "x");
+  allocator.ReleasePools();
+
+  /* The memory of a scene, every byte must be back with the engine after the handle is terminated */
+  const size_t engineBytes = BaseAllocator::GetTagStats(MemoryTag::ePHYSX).mLiveBytes.load();
+  PhysXHandle physics(YEAGER_NULLPTR);
+  physics.SetPxPvdEnabled(false);
+  if (!physics.InitPxEngine()) {
+    report->Fail("PhysX engine cannot be initialized!");
+    return;
+  }
+  const size_t initBytes = physics.GetPxAllocator()->GetStats().LiveBytes;
+
+  PxMaterial* material = physics.GetMaterialCache()->Acquire(YEAGER_PHYSX_DEFAULT_MATERIAL);
+  std::vector<PxRigidDynamic*> boxes;
+  for (Uint x = 0; x < YEAGER_PHYSX_ALLOCATOR_BENCHMARK_BOXES; x++) {
+    const PxVec3 position((x % 10) * 2.5f, 1.0f + (x / 100) * 2.5f, ((x / 10) % 10) * 2.5f);
+    PxRigidDynamic* box = PxCreateDynamic(*physics.GetPxPhysics(), PxTransform(position),
+                                          PxBoxGeometry(1.0f, 1.0f, 1.0f), *material, 1.0f);
+    physics.GetPxScene()->addActor(*box);
+    boxes.push_back(box);
+  }
+  for (Uint x = 0; x < YEAGER_PHYSX_ALLOCATOR_BENCHMARK_STEPS; x++) {
+    physics.GetPxScene()->simulate(1.0f / 60.0f);
+    physics.GetPxScene()->fetchResults(true);
+  }
+
+  const PhysXAllocatorStats scene = physics.GetPxAllocator()->GetStats();
+  report->AddMetric("Scene Live", (static_cast<double>(scene.LiveBytes) - initBytes) / (1024.0 * 1024.0), "MB");
+  report->AddMetric("Scene Peak", scene.PeakBytes / (1024.0 * 1024.0), "MB");
+  report->AddMetric("Scene Pools", scene.PooledBytes / (1024.0 * 1024.0), "MB");
+  const std::vector<PhysXAllocationNameStats> names = physics.GetPxAllocator()->GetNameStats();
+  for (size_t x = 0; x < names.size() && x < 3; x++) {
+    report->AddMetric("Top Name " + names[x].Name, names[x].LiveBytes / 1024.0, "KB");
+  }
+  if (names.size() < 2) {
+    report->Fail("PhysX allocator has no names, the foundation does not report them!");
+  }
+
+  for (PxRigidDynamic* box : boxes) {
+    physics.GetPxScene()->removeActor(*box);
+    PX_RELEASE(box);
+  }
+  physics.GetMaterialCache()->Release(material);
+  physics.TerminateEngine();
+
+  const PhysXAllocatorStats terminated = physics.GetPxAllocator()->GetStats();
+  if (terminated.LiveBytes != 0 || terminated.PooledBytes != 0 || terminated.LargeBytes != 0) {
+    report->Fail("PhysX kept " + std::to_string(terminated.LiveBytes) + " bytes after the engine was terminated!");
+  }
+  if (BaseAllocator::GetTagStats(MemoryTag::ePHYSX).mLiveBytes.load() != engineBytes) {
+    report->Fail("PhysX memory was not given back to the engine allocator!");
+  }
+}
+
+YEAGER_BENCHMARK_SUITE("PhysXAllocator", PhysXAllocatorBenchmarkSuite);
@@ -0,0 +1,355 @@
+#include "Benchmark.h"
+#include "Components/Physics/PhysXConvexDecomposition.h"
+#include "Components/Physics/PhysXHandle.h"
+
+#include <random>
+using namespace Yeager;
+using namespace physx;
+
+#define YEAGER_PHYSX_CONVEX_BENCHMARK_MAJOR_RADIUS 4.0f
+#define YEAGER_PHYSX_CONVEX_BENCHMARK_MINOR_RADIUS 1.0f
+#define YEAGER_PHYSX_CONVEX_BENCHMARK_REPETITIONS 3
+#define YEAGER_PHYSX_CONVEX_BENCHMARK_COVERAGE_SAMPLES 4096
+#define YEAGER_PHYSX_CONVEX_BENCHMARK_OBSTACLES 4
+#define YEAGER_PHYSX_CONVEX_BENCHMARK_BOXES 256
+#define YEAGER_PHYSX_CONVEX_BENCHMARK_PILE 32
+#define YEAGER_PHYSX_CONVEX_BENCHMARK_STEPS 300
+
+/* A torus lying on the XZ plane, concave in the middle so a single hull fills the hole */
+static PhysXTriangleMeshInput BuildTorusMesh(float major, float minor, int rings, int sides)
+{
+  PhysXTriangleMeshInput mesh;
+  for (int ring = 0; ring < rings; ring++) {
+    const float u = ring * PxTwoPi / rings;
+    for (int side = 0; side < sides; side++) {
+      const float v = side * PxTwoPi / sides;
+      const float radius = major + minor * std::cos(v);
+      mesh.Vertices.push_back(PxVec3(radius * std::cos(u), minor * std::sin(v), radius * std::sin(u)));
+    }
+  }
+  for (int ring = 0; ring < rings; ring++) {
+    for (int side = 0; side < sides; side++) {
+      const PxU32 a = ring * sides + side;
+      const PxU32 b = ((ring + 1) % rings) * sides + side;
+      const PxU32 c = ((ring + 1) % rings) * sides + (side + 1) % sides;
+      const PxU32 d = ring * sides + (side + 1) % sides;
+      mesh.Indices.insert(mesh.Indices.end(), {a, c, b, a, d, c});
+    }
+  }
+  return mesh;
+}
+
+/* The triangles of the hull are counter clockwise seen from outside, the slivers of coplanar points have no normal */
+static bool IsInsideHull(const PhysXConvexHull& hull, const PxVec3& point, float tolerance)
+{
+  for (size_t x = 0; x + 2 < hull.Indices.size(); x += 3) {
+    const PxVec3& a = hull.Vertices[hull.Indices[x]];
+    const PxVec3 normal = (hull.Vertices[hull.Indices[x + 1]] - a).cross(hull.Vertices[hull.Indices[x + 2]] - a);
+    if (normal.magnitudeSquared() > 1e-12f && normal.getNormalized().dot(point - a) > tolerance) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void CheckDecomposition(BenchmarkReport* report, const PhysXTriangleMeshInput& torus,
+                               const PhysXConvexDecompositionSettings& settings)
+{
+  std::vector<std::vector<PxVec3>> points;
+  BenchmarkMeasure decomposition;
+  decomposition.Name = "PhysX Convex Decomposition Torus";
+  decomposition.ItemsUnit = "triangles";
+  decomposition.Items = torus.Indices.size() / 3;
+  decomposition.Seconds = Benchmark::MeasureBestSeconds(YEAGER_PHYSX_CONVEX_BENCHMARK_REPETITIONS, [&]() {
+    PhysXConvexDecomposition::Decompose(torus, settings, &points);
+  });
+  report->AddMeasure(decomposition);
+
+  std::vector<PhysXConvexHull> hulls(points.size());
+  double volume = 0.0;
+  for (size_t x = 0; x < points.size(); x++) {
+    if (!hulls[x].Build(points[x])) {
+      report->Fail("PhysX convex decomposition gave a flat hull!");
+      return;
+    }
+    volume += hulls[x].Volume;
+  }
+  if (hulls.size() < 2 || hulls.size() > settings.MaxHulls) {
+    report->Fail("PhysX convex decomposition gave " + std::to_string(hulls.size()) + " hulls for a torus!");
+  }
+
+  /* The hulls together must be about the torus, not the disc a single hull makes of it */
+  const double torusVolume = 2.0 * PxPi * PxPi * YEAGER_PHYSX_CONVEX_BENCHMARK_MAJOR_RADIUS *
+                             YEAGER_PHYSX_CONVEX_BENCHMARK_MINOR_RADIUS * YEAGER_PHYSX_CONVEX_BENCHMARK_MINOR_RADIUS;
+  PhysXConvexHull single;
+  single.Build(torus.Vertices);
+  const double ratio = volume / torusVolume;
+  if (ratio < 0.9 || ratio > 1.3) {
+    report->Fail("PhysX convex decomposition hulls hold " + std::to_string(ratio) + " times the torus volume!");
+  }
+
+  /* Points inside the torus must be inside a hull, the hole must stay empty */
+  std::mt19937 random(1337);
+  std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+  const float tolerance = 1e-4f;
+  Uint covered = 0;
+  for (Uint x = 0; x < YEAGER_PHYSX_CONVEX_BENCHMARK_COVERAGE_SAMPLES; x++) {
+    /* Inside the tube, away from the surface by a tenth of its radius so the tessellation does not count */
+    const float u = unit(random) * PxTwoPi, v = unit(random) * PxTwoPi;
+    const float distance = std::sqrt(unit(random)) * YEAGER_PHYSX_CONVEX_BENCHMARK_MINOR_RADIUS * 0.9f;
+    const float radius = YEAGER_PHYSX_CONVEX_BENCHMARK_MAJOR_RADIUS + distance * std::cos(v);
+    const PxVec3 point(radius * std::cos(u), distance * std::sin(v), radius * std::sin(u));
+    covered += std::any_of(hulls.begin(), hulls.end(),
+                           [&](const PhysXConvexHull& hull) { return IsInsideHull(hull, point, tolerance); });
+  }
+  const double coverage = static_cast<double>(covered) / YEAGER_PHYSX_CONVEX_BENCHMARK_COVERAGE_SAMPLES;
+  if (coverage < 0.95) {
+    report->Fail("PhysX convex decomposition covers " + std::to_string(coverage * 100.0) + "% of the torus!");
+  }
+  if (std::any_of(hulls.begin(), hulls.end(),
+                  [&](const PhysXConvexHull& hull) { return IsInsideHull(hull, PxVec3(0.0f), 0.0f); })) {
+    report->Fail("PhysX convex decomposition fills the hole of the torus!");
+  }
+
+  report->AddMetric("Decomposition Hulls", hulls.size());
+  report->AddMetric("Decomposition Volume Ratio", ratio, "x");
+  report->AddMetric("Single Hull Volume Ratio", single.Volume / torusVolume, "x");
+  report->AddMetric("Decomposition Coverage", coverage * 100.0, "%");
+}
+
+/* Cooks the decomposition twice, the second load must come from the cache and give the same hulls */
+static std::vector<PxConvexMesh*> CheckCookedDecomposition(BenchmarkReport* report, PhysXHandle* physics,
+                                                           const PhysXTriangleMeshInput& torus,
+                                                           const PhysXConvexDecompositionSettings& settings)
+{
+  PhysXCookingCache* cache = physics->GetCookingCache();
+  PhysXGeometryHandle* geometry = physics->GetGeometryHandle();
+  cache->ResetStats();
+
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<PxConvexMesh*> cold = geometry->CreateConvexDecomposition(torus, settings);
+  const double coldSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  const PhysXCookingCacheStats coldStats = cache->GetStats();
+
+  const auto warmStart = std::chrono::steady_clock::now();
+  std::vector<PxConvexMesh*> warm = geometry->CreateConvexDecomposition(torus, settings);
+  const double warmSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - warmStart).count();
+  const PhysXCookingCacheStats warmStats = cache->GetStats();
+
+  /* The decomposition and each hull are read back */
+  if (warmStats.Hits - coldStats.Hits != cold.size() + 1 || warmStats.Cooked != coldStats.Cooked) {
+    report->Fail("PhysX cooking cache missed the convex decomposition it had written!");
+  }
+  if (cold.empty() || cold.size() != warm.size()) {
+    report->Fail("PhysX convex decomposition loaded from the cache differs from the cooked one!");
+  }
+  for (size_t x = 0; x < cold.size(); x++) {
+    if (!PhysXGeometryHandle::ValidateConvexMesh(*cold[x]) || cold[x]->getNbVertices() > settings.VertexLimit) {
+      report->Fail("PhysX convex decomposition cooked an invalid hull!");
+    }
+    if (x < warm.size() && cold[x]->getNbVertices() != warm[x]->getNbVertices()) {
+      report->Fail("PhysX convex decomposition loaded from the cache differs from the cooked one!");
+    }
+  }
+  for (PxConvexMesh* mesh : warm) {
+    PX_RELEASE(mesh);
+  }
+  report->AddMetric("Decomposition Cold Load", coldSeconds * 1000.0, "ms");
+  report->AddMetric("Decomposition Warm Load", warmSeconds * 1000.0, "ms");
+  return cold;
+}
+
+static void CheckSingleHull(BenchmarkReport* report, PhysXHandle* physics, const PhysXTriangleMeshInput& torus)
+{
+  PhysXGeometryHandle* geometry = physics->GetGeometryHandle();
+  PxConvexMesh* hull = geometry->CreateConvexMesh(torus.Vertices, 32);
+  PxConvexMesh* inflated = geometry->CreateConvexMesh(torus.Vertices, 32, 0.25f);
+  if (!hull || !inflated || !PhysXGeometryHandle::ValidateConvexMesh(*hull) ||
+      !PhysXGeometryHandle::ValidateConvexMesh(*inflated) || hull->getNbVertices() > 32 ||
+      inflated->getNbVertices() > 32) {
+    report->Fail("PhysX cooked an invalid single hull!");
+  } else {
+    PxReal volume = 0.0f, inflatedVolume = 0.0f;
+    PxMat33 inertia;
+    PxVec3 center;
+    hull->getMassInformation(volume, inertia, center);
+    inflated->getMassInformation(inflatedVolume, inertia, center);
+    if (!(inflatedVolume > volume)) {
+      report->Fail("PhysX inflated hull is not larger than the hull!");
+    }
+    report->AddMetric("Inflated Hull Growth", inflatedVolume / volume, "x");
+  }
+  PX_RELEASE(hull);
+  PX_RELEASE(inflated);
+}
+
+struct ConvexContactRun {
+  double Seconds = 0.0;
+  uint64_t ContactPairs = 0;
+  float LowestBox = PX_MAX_F32;
+};
+
+/**
+ * Boxes raining on static tori half sunk in the ground, the tori as one triangle mesh each or as the shapes of their
+ * decomposition. The contacts against a triangle mesh are generated triangle by triangle, against the hulls by convex
+ * pairs
+ */
+static void RunContacts(PhysXHandle* physics, PxMaterial* material, PxTriangleMesh* triangleMesh,
+                        const std::vector<PxConvexMesh*>& hulls, ConvexContactRun* run)
+{
+  PxPhysics* px = physics->GetPxPhysics();
+  PxScene* scene = physics->GetPxScene();
+  std::vector<PxRigidActor*> actors = {PxCreatePlane(*px, PxPlane(0.0f, 1.0f, 0.0f, 0.0f), *material)};
+  scene->addActor(*actors.front());
+  for (int x = 0; x < YEAGER_PHYSX_CONVEX_BENCHMARK_OBSTACLES; x++) {
+    PxRigidStatic* obstacle = px->createRigidStatic(PxTransform(PxVec3((x - 1.5f) * 10.0f, 0.0f, 0.0f)));
+    if (triangleMesh) {
+      PxRigidActorExt::createExclusiveShape(*obstacle, PxTriangleMeshGeometry(triangleMesh), *material);
+    } else {
+      for (PxConvexMesh* hull : hulls) {
+        PxRigidActorExt::createExclusiveShape(*obstacle, PxConvexMeshGeometry(hull), *material);
+      }
+    }
+    scene->addActor(*obstacle);
+    actors.push_back(obstacle);
+  }
+
+  std::mt19937 random(1337);
+  std::uniform_real_distribution<float> spread(-1.0f, 1.0f);
+  std::vector<PxRigidDynamic*> boxes;
+  for (int x = 0; x < YEAGER_PHYSX_CONVEX_BENCHMARK_BOXES; x++) {
+    const PxVec3 position(spread(random) * 20.0f, 3.0f + x * 0.1f, spread(random) * 5.0f);
+    PxRigidDynamic* box = PxCreateDynamic(*px, PxTransform(position), PxBoxGeometry(0.3f, 0.3f, 0.3f), *material, 1.0f);
+    scene->addActor(*box);
+    boxes.push_back(box);
+    actors.push_back(box);
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int step = 0; step < YEAGER_PHYSX_CONVEX_BENCHMARK_STEPS; step++) {
+    scene->simulate(1.0f / 60.0f);
+    scene->fetchResults(true);
+    PxSimulationStatistics statistics;
+    scene->getSimulationStatistics(statistics);
+    run->ContactPairs += statistics.nbDiscreteContactPairsTotal;
+  }
+  run->Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  for (PxRigidDynamic* box : boxes) {
+    run->LowestBox = std::min(run->LowestBox, box->getGlobalPose().p.y);
+  }
+
+  for (PxRigidActor* actor : actors) {
+    scene->removeActor(*actor);
+    PX_RELEASE(actor);
+  }
+}
+
+/* Decomposed tori as dynamic bodies, they must pile on the ground instead of falling through or exploding */
+static void RunPile(BenchmarkReport* report, PhysXHandle* physics, PxMaterial* material,
+                    const std::vector<PxConvexMesh*>& hulls)
+{
+  PxPhysics* px = physics->GetPxPhysics();
+  PxScene* scene = physics->GetPxScene();
+  PxRigidStatic* ground = PxCreatePlane(*px, PxPlane(0.0f, 1.0f, 0.0f, 0.0f), *material);
+  scene->addActor(*ground);
+
+  std::vector<PxRigidDynamic*> tori;
+  for (int x = 0; x < YEAGER_PHYSX_CONVEX_BENCHMARK_PILE; x++) {
+    const PxTransform pose(PxVec3((x % 4) * 3.0f - 4.5f, 2.0f + x * 1.5f, ((x / 4) % 2) * 3.0f),
+                           PxQuat(x * 0.4f, PxVec3(1.0f, 0.0f, 0.0f)));
+    PxRigidDynamic* torus = px->createRigidDynamic(pose);
+    for (PxConvexMesh* hull : hulls) {
+      PxRigidActorExt::createExclusiveShape(*torus, PxConvexMeshGeometry(hull), *material);
+    }
+    PxRigidBodyExt::updateMassAndInertia(*torus, 1.0f);
+    scene->addActor(*torus);
+    tori.push_back(torus);
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int step = 0; step < YEAGER_PHYSX_CONVEX_BENCHMARK_STEPS * 2; step++) {
+    scene->simulate(1.0f / 60.0f);
+    scene->fetchResults(true);
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  float lowest = PX_MAX_F32, fastest = 0.0f;
+  for (PxRigidDynamic* torus : tori) {
+    lowest = std::min(lowest, torus->getGlobalPose().p.y);
+    fastest = std::max(fastest, torus->getLinearVelocity().magnitude());
+  }
+  if (lowest < -0.5f || fastest > 5.0f) {
+    report->Fail("PhysX decomposed tori do not settle on the ground, lowest " + std::to_string(lowest) + " fastest " +
+                 std::to_string(fastest));
+  }
+
+  BenchmarkMeasure pile;
+  pile.Name = "PhysX Decomposed Torus Pile";
+  pile.ItemsUnit = "steps";
+  pile.Items = YEAGER_PHYSX_CONVEX_BENCHMARK_STEPS * 2;
+  pile.Seconds = seconds;
+  report->AddMeasure(pile);
+
+  for (PxRigidDynamic* torus : tori) {
+    scene->removeActor(*torus);
+    PX_RELEASE(torus);
+  }
+  scene->removeActor(*ground);
+  PX_RELEASE(ground);
+}
+
+static void PhysXConvexBenchmarkSuite(BenchmarkReport* report)
+{
+  const PhysXTriangleMeshInput torus =
+      BuildTorusMesh(YEAGER_PHYSX_CONVEX_BENCHMARK_MAJOR_RADIUS, YEAGER_PHYSX_CONVEX_BENCHMARK_MINOR_RADIUS, 48, 24);
+  const PhysXConvexDecompositionSettings settings;
+  CheckDecomposition(report, torus, settings);
+
+  PhysXHandle physics(YEAGER_NULLPTR);
+  physics.SetPxPvdEnabled(false);
+  if (!physics.InitPxEngine()) {
+    report->Fail("PhysX engine cannot be initialized!");
+    return;
+  }
+  const std::filesystem::path folder = std::filesystem::temp_directory_path() / "YeagerPhysXConvexBenchmark";
+  std::error_code error;
+  std::filesystem::remove_all(folder, error);
+  physics.GetCookingCache()->SetFolder(folder.string());
+
+  std::vector<PxConvexMesh*> hulls = CheckCookedDecomposition(report, &physics, torus, settings);
+  CheckSingleHull(report, &physics, torus);
+
+  PxMaterial* material = physics.GetMaterialCache()->Acquire(YEAGER_PHYSX_DEFAULT_MATERIAL);
+  PxTriangleMesh* triangleMesh = physics.GetGeometryHandle()->CreateTriangleMesh(torus);
+  if (triangleMesh && !hulls.empty()) {
+    ConvexContactRun triangles, convex;
+    RunContacts(&physics, material, triangleMesh, hulls, &triangles);
+    RunContacts(&physics, material, YEAGER_NULLPTR, hulls, &convex);
+    for (const auto& [name, run] : {std::make_pair("Triangle Mesh", &triangles), std::make_pair("Convex", &convex)}) {
+      BenchmarkMeasure measure;
+      measure.Name = String("PhysX Contacts ") + name + " Obstacles";
+      measure.ItemsUnit = "steps";
+      measure.Items = YEAGER_PHYSX_CONVEX_BENCHMARK_STEPS;
+      measure.Seconds = run->Seconds;
+      report->AddMeasure(measure);
+      report->AddMetric(String(name) + " Contact Pairs", static_cast<double>(run->ContactPairs) /
+                                                             YEAGER_PHYSX_CONVEX_BENCHMARK_STEPS, "pairs/step");
+      if (run->LowestBox < 0.0f) {
+        report->Fail(String("PhysX boxes fell through the ground between the ") + name + " obstacles!");
+      }
+    }
+    report->AddMetric("Convex Step Speedup", triangles.Seconds / std::max(convex.Seconds, 1e-9), "x");
+    RunPile(report, &physics, material, hulls);
+  }
+
+  PX_RELEASE(triangleMesh);
+  for (PxConvexMesh* hull : hulls) {
+    PX_RELEASE(hull);
+  }
+  physics.GetMaterialCache()->Release(material);
+  physics.GetCookingCache()->SetFolder(YEAGER_EMPTY_LITERAL);
+  std::filesystem::remove_all(folder, error);
+  physics.TerminateEngine();
+}
+
+YEAGER_BENCHMARK_SUITE("PhysXConvex", PhysXConvexBenchmarkSuite);
@@ -0,0 +1,171 @@
+#include "Benchmark.h"
+#include "Components/Physics/PhysXHandle.h"
+#include "Components/TerrainGen/GradientNoise.h"
+
+#include <random>
+using namespace Yeager;
+using namespace physx;
+
+#define YEAGER_PHYSX_COOKING_BENCHMARK_GRID 257
+#define YEAGER_PHYSX_COOKING_BENCHMARK_HULL_POINTS 4096
+#define YEAGER_PHYSX_COOKING_BENCHMARK_REPETITIONS 5
+
+/* A noise terrain as a triangle mesh, the kind of collision that makes the cooking slow */
+static PhysXTriangleMeshInput BuildGridMesh(int size)
+{
+  Math::Array2D<float> heightMap(size, size);
+  NoiseFractalSettings noise;
+  noise.Frequency = 1.0f / 64.0f;
+  GradientNoise(1337).FillArray2D(&heightMap, 0, 0, size, size, noise, 32.0f, 0.0f);
+
+  PhysXTriangleMeshInput mesh;
+  for (int z = 0; z < size; z++) {
+    for (int x = 0; x < size; x++) {
+      mesh.Vertices.push_back(PxVec3(x, heightMap.At(x, z), z));
+    }
+  }
+  for (int z = 0; z < size - 1; z++) {
+    for (int x = 0; x < size - 1; x++) {
+      const PxU32 bottomLeft = z * size + x;
+      const PxU32 topLeft = (z + 1) * size + x;
+      mesh.Indices.insert(mesh.Indices.end(),
+                          {bottomLeft, topLeft, topLeft + 1, bottomLeft, topLeft + 1, bottomLeft + 1});
+    }
+  }
+  return mesh;
+}
+
+static std::vector<PxVec3> BuildHullPoints(size_t count)
+{
+  std::mt19937 random(1337);
+  std::normal_distribution<float> normal(0.0f, 1.0f);
+  std::vector<PxVec3> points(count);
+  for (auto& point : points) {
+    point = PxVec3(normal(random), normal(random), normal(random)).getNormalized() * 4.0f;
+  }
+  return points;
+}
+
+static void PhysXCookingBenchmarkSuite(BenchmarkReport* report)
+{
+  PhysXHandle physics(YEAGER_NULLPTR);
+  physics.SetPxPvdEnabled(false);
+  if (!physics.InitPxEngine()) {
+    report->Fail("PhysX engine cannot be initialized!");
+    return;
+  }
+
+  const std::filesystem::path folder = std::filesystem::temp_directory_path() / "YeagerPhysXCookingBenchmark";
+  std::error_code error;
+  std::filesystem::remove_all(folder, error);
+
+  PhysXCookingCache* cache = physics.GetCookingCache();
+  PhysXGeometryHandle* geometry = physics.GetGeometryHandle();
+  const PhysXTriangleMeshInput grid = BuildGridMesh(YEAGER_PHYSX_COOKING_BENCHMARK_GRID);
+  const std::vector<PxVec3> hull = BuildHullPoints(YEAGER_PHYSX_COOKING_BENCHMARK_HULL_POINTS);
+  const String name = std::to_string(YEAGER_PHYSX_COOKING_BENCHMARK_GRID) + "x" +
+                      std::to_string(YEAGER_PHYSX_COOKING_BENCHMARK_GRID);
+
+  PxTriangleMesh* cooked = YEAGER_NULLPTR;
+  PxConvexMesh* cookedHull = YEAGER_NULLPTR;
+
+  /* Cold, the cache is disabled so every repetition cooks */
+  cache->SetFolder(YEAGER_EMPTY_LITERAL);
+  BenchmarkMeasure cold;
+  cold.Name = "PhysX Triangle Mesh Cold " + name;
+  cold.ItemsUnit = "triangles";
+  cold.Items = grid.Indices.size() / 3;
+  cold.Seconds = Benchmark::MeasureBestSeconds(YEAGER_PHYSX_COOKING_BENCHMARK_REPETITIONS, [&]() {
+    PX_RELEASE(cooked);
+    cooked = geometry->CreateTriangleMesh(grid);
+  });
+  report->AddMeasure(cold);
+
+  BenchmarkMeasure coldHull;
+  coldHull.Name = "PhysX Convex Mesh Cold";
+  coldHull.ItemsUnit = "points";
+  coldHull.Items = hull.size();
+  coldHull.Seconds = Benchmark::MeasureBestSeconds(YEAGER_PHYSX_COOKING_BENCHMARK_REPETITIONS, [&]() {
+    PX_RELEASE(cookedHull);
+    cookedHull = geometry->CreateConvexMesh(hull, 64);
+  });
+  report->AddMeasure(coldHull);
+
+  /* The first load with the folder writes the cache, the repetitions after it are warm */
+  cache->SetFolder(folder.string());
+  cache->ResetStats();
+  PxTriangleMesh* first = geometry->CreateTriangleMesh(grid);
+  PxConvexMesh* firstHull = geometry->CreateConvexMesh(hull, 64);
+  PX_RELEASE(first);
+  PX_RELEASE(firstHull);
+
+  PxTriangleMesh* loaded = YEAGER_NULLPTR;
+  PxConvexMesh* loadedHull = YEAGER_NULLPTR;
+  BenchmarkMeasure warm;
+  warm.Name = "PhysX Triangle Mesh Warm " + name;
+  warm.ItemsUnit = "triangles";
+  warm.Items = cold.Items;
+  warm.Seconds = Benchmark::MeasureBestSeconds(YEAGER_PHYSX_COOKING_BENCHMARK_REPETITIONS, [&]() {
+    PX_RELEASE(loaded);
+    loaded = geometry->CreateTriangleMesh(grid);
+  });
+  report->AddMeasure(warm);
+
+  BenchmarkMeasure warmHull;
+  warmHull.Name = "PhysX Convex Mesh Warm";
+  warmHull.ItemsUnit = "points";
+  warmHull.Items = hull.size();
+  warmHull.Seconds = Benchmark::MeasureBestSeconds(YEAGER_PHYSX_COOKING_BENCHMARK_REPETITIONS, [&]() {
+    PX_RELEASE(loadedHull);
+    loadedHull = geometry->CreateConvexMesh(hull, 64);
+  });
+  report->AddMeasure(warmHull);
+
+  const PhysXCookingCacheStats stats = cache->GetStats();
+  report->AddMetric("Triangle Mesh Load Speedup", cold.Seconds / std::max(warm.Seconds, 1e-9), "x");
+  report->AddMetric("Convex Mesh Load Speedup", coldHull.Seconds / std::max(warmHull.Seconds, 1e-9), "x");
+  report->AddMetric("Cache Hits", stats.Hits);
+  report->AddMetric("Cache Bytes Written", stats.BytesWritten / 1024.0, "KB");
+
+  /* The warm loads must all come from the cache and give back the same meshes */
+  if (stats.Cooked != 2 || stats.Hits != 2 * YEAGER_PHYSX_COOKING_BENCHMARK_REPETITIONS) {
+    report->Fail("PhysX cooking cache missed meshes it had written!");
+  }
+  if (!cooked || !loaded || cooked->getNbVertices() != loaded->getNbVertices() ||
+      cooked->getNbTriangles() != loaded->getNbTriangles() ||
+      !(cooked->getLocalBounds().minimum == loaded->getLocalBounds().minimum) ||
+      !(cooked->getLocalBounds().maximum == loaded->getLocalBounds().maximum)) {
+    report->Fail("PhysX triangle mesh loaded from the cache differs from the cooked one!");
+  }
+  if (!cookedHull || !loadedHull || cookedHull->getNbVertices() != loadedHull->getNbVertices() ||
+      cookedHull->getNbPolygons() != loadedHull->getNbPolygons()) {
+    report->Fail("PhysX convex mesh loaded from the cache differs from the cooked one!");
+  }
+
+  /* Other cooking params must not read the cache of the defaults */
+  PxTriangleMeshDesc desc;
+  desc.points.count = grid.Vertices.size();
+  desc.points.stride = sizeof(PxVec3);
+  desc.points.data = grid.Vertices.data();
+  desc.triangles.count = grid.Indices.size() / 3;
+  desc.triangles.stride = 3 * sizeof(PxU32);
+  desc.triangles.data = grid.Indices.data();
+  PxTolerancesScale scale;
+  PxCookingParams params(scale);
+  PxCookingParams welded(scale);
+  welded.meshPreprocessParams |= PxMeshPreprocessingFlag::eWELD_VERTICES;
+  welded.meshWeldTolerance = 0.01f;
+  if (PhysXCookingCache::HashTriangleMesh(desc, params) == PhysXCookingCache::HashTriangleMesh(desc, welded)) {
+    report->Fail("PhysX cooking cache key ignores the cooking params!");
+  }
+
+  PX_RELEASE(cooked);
+  PX_RELEASE(loaded);
+  PX_RELEASE(cookedHull);
+  PX_RELEASE(loadedHull);
+  cache->SetFolder(YEAGER_EMPTY_LITERAL);
+  std::filesystem::remove_all(folder, error);
+  physics.TerminateEngine();
+}
+
+YEAGER_BENCHMARK_SUITE("PhysXCooking", PhysXCookingBenchmarkSuite);
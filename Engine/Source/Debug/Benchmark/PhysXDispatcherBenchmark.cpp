@@ -0,0 +1,162 @@
+#include "Benchmark.h"
+#include "Components/Kernel/Process/WorkerPool.h"
+#include "Components/Physics/PhysXHandle.h"
+
+#include <condition_variable>
+using namespace Yeager;
+using namespace physx;
+
+#define YEAGER_PHYSX_DISPATCHER_BENCHMARK_PILE 12
+#define YEAGER_PHYSX_DISPATCHER_BENCHMARK_STEPS 180
+
+/* A worker held busy while the tasks are queued, then they must come out by priority, oldest first */
+static void CheckPriorities(BenchmarkReport* report)
+{
+  WorkerPool pool(1);
+  std::mutex mutex;
+  std::condition_variable condition;
+  bool released = false;
+  std::vector<int> order;
+  pool.Submit([&]() {
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [&] { return released; });
+  });
+
+  const TaskPriority::Enum priorities[] = {TaskPriority::eLOW, TaskPriority::eNORMAL, TaskPriority::eHIGH,
+                                           TaskPriority::eLOW, TaskPriority::eHIGH};
+  for (int x = 0; x < 5; x++) {
+    pool.Submit(
+        [&, x]() {
+          std::lock_guard<std::mutex> lock(mutex);
+          order.push_back(x);
+          condition.notify_all();
+        },
+        priorities[x]);
+  }
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    released = true;
+    condition.notify_all();
+    condition.wait(lock, [&] { return order.size() == 5; });
+  }
+  if (order != std::vector<int>{2, 4, 1, 0, 3}) {
+    report->Fail("Worker pool does not run the tasks by priority!");
+  }
+}
+
+struct DispatcherRun {
+  double Seconds = 0.0;
+  PhysXCpuDispatcherStats Stats;
+};
+
+/* A pile of boxes falling on each other, enough islands and contacts for the step to be split in many tasks */
+static bool RunPile(Uint maxThreads, Uint backgroundTasks, DispatcherRun* run)
+{
+  PhysXHandle physics(YEAGER_NULLPTR);
+  physics.SetPxPvdEnabled(false);
+  if (!physics.InitPxEngine()) {
+    return false;
+  }
+  physics.GetCpuDispatcher()->SetMaxThreads(maxThreads);
+
+  PxMaterial* material = physics.GetMaterialCache()->Acquire(YEAGER_PHYSX_DEFAULT_MATERIAL);
+  std::vector<PxRigidDynamic*> boxes;
+  for (int y = 0; y < YEAGER_PHYSX_DISPATCHER_BENCHMARK_PILE; y++) {
+    for (int z = 0; z < YEAGER_PHYSX_DISPATCHER_BENCHMARK_PILE; z++) {
+      for (int x = 0; x < YEAGER_PHYSX_DISPATCHER_BENCHMARK_PILE; x++) {
+        const PxVec3 position(x * 2.2f + (y % 2) * 0.5f, y * 2.2f + 1.5f, z * 2.2f + (y % 2) * 0.5f);
+        PxRigidDynamic* box = PxCreateDynamic(*physics.GetPxPhysics(), PxTransform(position),
+                                              PxBoxGeometry(1.0f, 1.0f, 1.0f), *material, 1.0f);
+        physics.GetPxScene()->addActor(*box);
+        boxes.push_back(box);
+      }
+    }
+  }
+
+  /* Background work queued behind the step, the way the terrain streaming runs while the frame is simulated */
+  std::atomic<bool> stop = false;
+  std::atomic<Uint> backgroundRunning = 0;
+  WorkerPool* pool = physics.GetCpuDispatcher()->GetWorkerPool();
+  for (Uint x = 0; x < backgroundTasks; x++) {
+    backgroundRunning++;
+    pool->Submit(
+        [&]() {
+          while (!stop) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+          }
+          backgroundRunning--;
+        },
+        TaskPriority::eLOW);
+  }
+
+  physics.GetCpuDispatcher()->ResetStats();
+  const auto start = std::chrono::steady_clock::now();
+  for (Uint x = 0; x < YEAGER_PHYSX_DISPATCHER_BENCHMARK_STEPS; x++) {
+    physics.GetPxScene()->simulate(1.0f / 60.0f);
+    physics.GetPxScene()->fetchResults(true);
+  }
+  run->Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  run->Stats = physics.GetCpuDispatcher()->GetStats();
+
+  stop = true;
+  while (backgroundRunning > 0) {
+    std::this_thread::yield();
+  }
+  for (PxRigidDynamic* box : boxes) {
+    physics.GetPxScene()->removeActor(*box);
+    PX_RELEASE(box);
+  }
+  physics.GetMaterialCache()->Release(material);
+  physics.TerminateEngine();
+  return true;
+}
+
+static void PhysXDispatcherBenchmarkSuite(BenchmarkReport* report)
+{
+  CheckPriorities(report);
+
+  const Uint workers = WorkerPool::GetGlobal()->GetWorkersCount();
+  report->AddMetric("Workers", workers);
+  std::vector<Uint> limits = {1, 2, 4, 0};
+  limits.erase(std::remove_if(limits.begin(), limits.end(), [&](Uint limit) { return limit >= workers; }),
+               limits.end());
+  limits.push_back(0);
+  limits.erase(std::unique(limits.begin(), limits.end()), limits.end());
+
+  for (const Uint limit : limits) {
+    DispatcherRun run;
+    if (!RunPile(limit, 0, &run)) {
+      report->Fail("PhysX engine cannot be initialized!");
+      return;
+    }
+    const Uint threads = limit == 0 ? std::max<Uint>(1, workers) : limit;
+    BenchmarkMeasure measure;
+    measure.Name = "PhysX Step " + std::to_string(threads) + " Threads";
+    measure.ItemsUnit = "steps";
+    measure.Items = YEAGER_PHYSX_DISPATCHER_BENCHMARK_STEPS;
+    measure.Seconds = run.Seconds;
+    report->AddMeasure(measure);
+
+    if (run.Stats.Tasks == 0) {
+      report->Fail("PhysX steps ran without a task of the dispatcher!");
+    }
+    if (run.Stats.PeakRunning > threads) {
+      report->Fail("PhysX dispatcher ran " + std::to_string(run.Stats.PeakRunning) + " tasks at once, the limit is " +
+                   std::to_string(threads) + "!");
+    }
+  }
+
+  /* Every worker but one held by low priority work, the step must still finish on the worker left */
+  if (workers > 1) {
+    DispatcherRun idle;
+    DispatcherRun busy;
+    if (!RunPile(0, 0, &idle) || !RunPile(0, workers - 1, &busy)) {
+      report->Fail("PhysX engine cannot be initialized!");
+      return;
+    }
+    report->AddMetric("Step Idle Pool", idle.Seconds * 1000.0 / YEAGER_PHYSX_DISPATCHER_BENCHMARK_STEPS, "ms");
+    report->AddMetric("Step Busy Pool", busy.Seconds * 1000.0 / YEAGER_PHYSX_DISPATCHER_BENCHMARK_STEPS, "ms");
+  }
+}
+
+YEAGER_BENCHMARK_SUITE("PhysXDispatcher", PhysXDispatcherBenchmarkSuite);
@@ -0,0 +1,169 @@
+#include "Benchmark.h"
+#include "Components/Physics/PhysXHandle.h"
+
+#include <random>
+using namespace Yeager;
+using namespace physx;
+
+#define YEAGER_PHYSX_FIXED_STEP_BENCHMARK_SECONDS 4
+#define YEAGER_PHYSX_FIXED_STEP_BENCHMARK_PYRAMID 10
+
+/* Steps the accumulator alone must give for frames of the same length, the time is rounded to nanoseconds */
+static uint64_t ExpectedSteps(float deltaTime, Uint frames, float stepRate)
+{
+  const uint64_t frame = std::llround(static_cast<double>(deltaTime) * 1e9);
+  const uint64_t step = std::llround(1e9 / stepRate);
+  return (frame * frames) / step;
+}
+
+static void CheckAccumulator(BenchmarkReport* report)
+{
+  /* Frame rates above, at and below the step rate, none of them drop time */
+  for (const float fps : {30.0f, 60.0f, 75.0f, 144.0f, 240.0f}) {
+    PhysXFixedStep fixedStep(60.0f, 4);
+    const Uint frames = fps * YEAGER_PHYSX_FIXED_STEP_BENCHMARK_SECONDS;
+    for (Uint x = 0; x < frames; x++) {
+      fixedStep.Advance(1.0f / fps);
+    }
+    if (fixedStep.GetStepCount() != ExpectedSteps(1.0f / fps, frames, 60.0f) || fixedStep.GetDroppedSeconds() != 0.0) {
+      report->Fail("PhysX fixed step gave " + std::to_string(fixedStep.GetStepCount()) + " steps at " +
+                   std::to_string(fps) + " fps!");
+    }
+  }
+
+  /* Jittered frames, the same sequence must give the same steps every time */
+  std::vector<Uint> first;
+  std::vector<Uint> second;
+  double total = 0.0;
+  PhysXFixedStep jittered(60.0f, 4);
+  for (std::vector<Uint>* steps : {&first, &second}) {
+    std::mt19937 random(1337);
+    std::uniform_real_distribution<float> frame(0.002f, 0.05f);
+    jittered.Reset();
+    total = 0.0;
+    for (Uint x = 0; x < 2048; x++) {
+      const float deltaTime = frame(random);
+      total += std::llround(static_cast<double>(deltaTime) * 1e9) * 1e-9;
+      steps->push_back(jittered.Advance(deltaTime));
+    }
+  }
+  if (first != second) {
+    report->Fail("PhysX fixed step is not deterministic for the same frame times!");
+  }
+  /* Every nanosecond is a step, in the accumulator or dropped */
+  const double accounted = jittered.GetStepCount() * jittered.GetStepSeconds() +
+                           jittered.GetAlpha() * jittered.GetStepSeconds() + jittered.GetDroppedSeconds();
+  if (std::abs(accounted - total) > 1e-6) {
+    report->Fail("PhysX fixed step lost time, " + std::to_string(accounted) + " of " + std::to_string(total) + " s");
+  }
+
+  /* A hitch of a second runs the max substeps and drops the rest, the fraction of a step stays */
+  PhysXFixedStep hitch(60.0f, 4);
+  const Uint hitchSteps = hitch.Advance(1.0f);
+  if (hitchSteps != 4 || hitch.GetDroppedSeconds() < 0.9 || hitch.GetAlpha() >= 1.0f) {
+    report->Fail("PhysX fixed step does not clamp the steps of a hitch!");
+  }
+  report->AddMetric("Hitch Steps", hitchSteps);
+  report->AddMetric("Hitch Dropped", hitch.GetDroppedSeconds() * 1000.0, "ms");
+}
+
+struct FixedStepRun {
+  uint64_t Steps = 0;
+  PxTransform Top;
+  double Seconds = 0.0;
+  bool Interpolated = false;
+};
+
+/* A pyramid of boxes that falls apart, stepped at the frame rate the way the application steps it */
+static bool RunPyramid(float fps, FixedStepRun* run)
+{
+  PhysXHandle physics(YEAGER_NULLPTR);
+  physics.SetPxPvdEnabled(false);
+  if (!physics.InitPxEngine()) {
+    return false;
+  }
+
+  PxMaterial* material = physics.GetMaterialCache()->Acquire(YEAGER_PHYSX_DEFAULT_MATERIAL);
+  std::vector<PxRigidDynamic*> boxes;
+  for (int level = 0; level < YEAGER_PHYSX_FIXED_STEP_BENCHMARK_PYRAMID; level++) {
+    for (int x = 0; x < YEAGER_PHYSX_FIXED_STEP_BENCHMARK_PYRAMID - level; x++) {
+      const PxVec3 position(x * 2.0f + level - YEAGER_PHYSX_FIXED_STEP_BENCHMARK_PYRAMID, level * 2.0f + 1.5f, 0.0f);
+      PxRigidDynamic* box = PxCreateDynamic(*physics.GetPxPhysics(), PxTransform(position),
+                                            PxBoxGeometry(1.0f, 1.0f, 1.0f), *material, 1.0f);
+      physics.GetPxScene()->addActor(*box);
+      physics.RegisterDynamicActor(box);
+      boxes.push_back(box);
+    }
+  }
+  /* Knocks the pyramid over so the poses keep changing */
+  boxes.front()->setLinearVelocity(PxVec3(-20.0f, 0.0f, 0.0f));
+
+  const Uint frames = fps * YEAGER_PHYSX_FIXED_STEP_BENCHMARK_SECONDS;
+  const auto start = std::chrono::steady_clock::now();
+  for (Uint x = 0; x < frames; x++) {
+    physics.StartSimulation(1.0f / fps);
+    /* Somewhere in the frame a published pose is drawn between two steps */
+    const Uint top = boxes.size() - 1;
+    const PxTransform drawn = physics.GetInterpolatedPose(top);
+    if (!(drawn.p == physics.GetPublishedPose(top).Transform.p)) {
+      run->Interpolated = true;
+    }
+  }
+  physics.EndSimulation();
+  run->Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  run->Steps = physics.GetFixedStep()->GetStepCount();
+  run->Top = boxes.back()->getGlobalPose();
+
+  for (PxRigidDynamic* box : boxes) {
+    physics.UnregisterDynamicActor(box, reinterpret_cast<uintptr_t>(box->userData) - 1);
+    physics.GetPxScene()->removeActor(*box);
+    PX_RELEASE(box);
+  }
+  physics.GetMaterialCache()->Release(material);
+  physics.TerminateEngine();
+  return true;
+}
+
+static void PhysXFixedStepBenchmarkSuite(BenchmarkReport* report)
+{
+  CheckAccumulator(report);
+
+  std::map<float, FixedStepRun> runs;
+  for (const float fps : {30.0f, 60.0f, 144.0f, 240.0f}) {
+    FixedStepRun& run = runs[fps];
+    if (!RunPyramid(fps, &run)) {
+      report->Fail("PhysX engine cannot be initialized!");
+      return;
+    }
+
+    BenchmarkMeasure measure;
+    measure.Name = "PhysX Fixed Step " + std::to_string(static_cast<int>(fps)) + " fps";
+    measure.ItemsUnit = "steps";
+    measure.Items = run.Steps;
+    measure.Seconds = run.Seconds;
+    report->AddMeasure(measure);
+
+    const Uint frames = fps * YEAGER_PHYSX_FIXED_STEP_BENCHMARK_SECONDS;
+    if (run.Steps != ExpectedSteps(1.0f / fps, frames, YEAGER_PHYSX_DEFAULT_STEP_RATE)) {
+      report->Fail("PhysX handle ran " + std::to_string(run.Steps) + " steps at " + std::to_string(fps) + " fps!");
+    }
+    /* Frames shorter than a step must draw the boxes between the steps */
+    if (fps > YEAGER_PHYSX_DEFAULT_STEP_RATE && !run.Interpolated) {
+      report->Fail("PhysX poses are not interpolated at " + std::to_string(fps) + " fps!");
+    }
+  }
+
+  /* The steps are the same whatever the frame rate, the same count of steps ends in the same place */
+  const FixedStepRun& reference = runs[60.0f];
+  for (const auto& [fps, run] : runs) {
+    if (run.Steps == reference.Steps && !(run.Top.p == reference.Top.p && run.Top.q == reference.Top.q)) {
+      report->Fail("PhysX fixed step at " + std::to_string(fps) + " fps ends somewhere else than at 60 fps!");
+    }
+  }
+  report->AddMetric("Simulation Cost 60 fps",
+                    runs[60.0f].Seconds * 1000.0 / (60.0 * YEAGER_PHYSX_FIXED_STEP_BENCHMARK_SECONDS), "ms/frame");
+  report->AddMetric("Simulation Cost 240 fps",
+                    runs[240.0f].Seconds * 1000.0 / (240.0 * YEAGER_PHYSX_FIXED_STEP_BENCHMARK_SECONDS), "ms/frame");
+}
+
+YEAGER_BENCHMARK_SUITE("PhysXFixedStep", PhysXFixedStepBenchmarkSuite);
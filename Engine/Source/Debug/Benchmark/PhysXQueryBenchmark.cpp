@@ -0,0 +1,180 @@
+#include "Benchmark.h"
+#include "Components/Physics/PhysXHandle.h"
+
+#include <random>
+using namespace Yeager;
+using namespace physx;
+
+#define YEAGER_PHYSX_QUERY_BENCHMARK_OBSTACLES 4096
+#define YEAGER_PHYSX_QUERY_BENCHMARK_RAYCASTS 32768
+#define YEAGER_PHYSX_QUERY_BENCHMARK_SWEEPS 8192
+#define YEAGER_PHYSX_QUERY_BENCHMARK_OVERLAPS 8192
+#define YEAGER_PHYSX_QUERY_BENCHMARK_FIELD 256.0f
+#define YEAGER_PHYSX_QUERY_BENCHMARK_REPETITIONS 5
+
+/* Boxes and spheres scattered over a ground plane, the probes of a level full of props */
+static void BuildObstacles(PhysXHandle* physics, PxMaterial* material, std::vector<PxRigidStatic*>* obstacles)
+{
+  std::mt19937 random(1337);
+  const float field = YEAGER_PHYSX_QUERY_BENCHMARK_FIELD;
+  std::uniform_real_distribution<float> position(-field, field);
+  std::uniform_real_distribution<float> size(0.5f, 4.0f);
+  for (Uint x = 0; x < YEAGER_PHYSX_QUERY_BENCHMARK_OBSTACLES; x++) {
+    const PxTransform pose(PxVec3(position(random), size(random), position(random)));
+    PxGeometryHolder geometry;
+    if (x % 2 == 0) {
+      geometry.storeAny(PxBoxGeometry(size(random), size(random), size(random)));
+    } else {
+      geometry.storeAny(PxSphereGeometry(size(random)));
+    }
+    PxRigidStatic* actor = PxCreateStatic(*physics->GetPxPhysics(), pose, geometry.any(), *material);
+    physics->GetPxScene()->addActor(*actor);
+    obstacles->push_back(actor);
+  }
+}
+
+static void BuildBatch(PhysXQueryBatch* batch)
+{
+  std::mt19937 random(7);
+  const float field = YEAGER_PHYSX_QUERY_BENCHMARK_FIELD;
+  std::uniform_real_distribution<float> position(-field, field);
+  std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+  for (Uint x = 0; x < YEAGER_PHYSX_QUERY_BENCHMARK_RAYCASTS; x++) {
+    PhysXRaycastRequest raycast;
+    raycast.Origin = PxVec3(position(random), 10.0f, position(random));
+    raycast.Direction = PxVec3(unit(random), -1.0f, unit(random)).getNormalized();
+    raycast.MaxDistance = 64.0f;
+    batch->Raycasts.push_back(raycast);
+  }
+  for (Uint x = 0; x < YEAGER_PHYSX_QUERY_BENCHMARK_SWEEPS; x++) {
+    PhysXSweepRequest sweep;
+    sweep.Geometry.storeAny(PxCapsuleGeometry(0.4f, 0.9f));
+    sweep.Pose = PxTransform(PxVec3(position(random), 2.0f, position(random)));
+    sweep.Direction = PxVec3(unit(random), 0.0f, unit(random) + 2.0f).getNormalized();
+    sweep.MaxDistance = 16.0f;
+    batch->Sweeps.push_back(sweep);
+  }
+  for (Uint x = 0; x < YEAGER_PHYSX_QUERY_BENCHMARK_OVERLAPS; x++) {
+    PhysXOverlapRequest overlap;
+    overlap.Geometry.storeAny(PxSphereGeometry(6.0f));
+    overlap.Pose = PxTransform(PxVec3(position(random), 1.0f, position(random)));
+    batch->Overlaps.push_back(overlap);
+  }
+}
+
+/* One query after the other in the calling thread, how the probes of the engine ran before the batches */
+static void ExecuteSerial(PxScene* scene, PhysXQueryBatch* batch)
+{
+  batch->RaycastHits.Resize(batch->Raycasts.size());
+  batch->SweepHits.Resize(batch->Sweeps.size());
+  batch->OverlapHits.Resize(batch->Overlaps.size());
+  for (size_t x = 0; x < batch->Raycasts.size(); x++) {
+    const PhysXRaycastRequest& raycast = batch->Raycasts[x];
+    PxRaycastBuffer buffer;
+    scene->raycast(raycast.Origin, raycast.Direction, raycast.MaxDistance, buffer, PxHitFlag::eDEFAULT, raycast.Filter);
+    batch->RaycastHits.Hit[x] = buffer.hasBlock;
+    batch->RaycastHits.Distance[x] = buffer.hasBlock ? buffer.block.distance : PX_MAX_F32;
+  }
+  for (size_t x = 0; x < batch->Sweeps.size(); x++) {
+    const PhysXSweepRequest& sweep = batch->Sweeps[x];
+    PxSweepBuffer buffer;
+    scene->sweep(sweep.Geometry.any(), sweep.Pose, sweep.Direction, sweep.MaxDistance, buffer, PxHitFlag::eDEFAULT,
+                 sweep.Filter);
+    batch->SweepHits.Hit[x] = buffer.hasBlock;
+    batch->SweepHits.Distance[x] = buffer.hasBlock ? buffer.block.distance : PX_MAX_F32;
+  }
+  PxOverlapHit touches[YEAGER_PHYSX_QUERY_MAX_OVERLAP_TOUCHES];
+  for (size_t x = 0; x < batch->Overlaps.size(); x++) {
+    const PhysXOverlapRequest& overlap = batch->Overlaps[x];
+    PxQueryFilterData filter = overlap.Filter;
+    filter.flags |= PxQueryFlag::eNO_BLOCK;
+    PxOverlapBuffer buffer(touches, YEAGER_PHYSX_QUERY_MAX_OVERLAP_TOUCHES);
+    scene->overlap(overlap.Geometry.any(), overlap.Pose, buffer, filter);
+    batch->OverlapHits.Count[x] = buffer.getNbTouches();
+  }
+}
+
+static bool SameResults(const PhysXQueryBatch& serial, const PhysXQueryBatch& batched)
+{
+  return serial.RaycastHits.Hit == batched.RaycastHits.Hit &&
+         serial.RaycastHits.Distance == batched.RaycastHits.Distance &&
+         serial.SweepHits.Hit == batched.SweepHits.Hit && serial.SweepHits.Distance == batched.SweepHits.Distance &&
+         serial.OverlapHits.Count == batched.OverlapHits.Count;
+}
+
+static void PhysXQueryBenchmarkSuite(BenchmarkReport* report)
+{
+  PhysXHandle physics(YEAGER_NULLPTR);
+  physics.SetPxPvdEnabled(false);
+  if (!physics.InitPxEngine()) {
+    report->Fail("PhysX engine cannot be initialized!");
+    return;
+  }
+
+  PxMaterial* material = physics.GetMaterialCache()->Acquire(YEAGER_PHYSX_DEFAULT_MATERIAL);
+  std::vector<PxRigidStatic*> obstacles;
+  BuildObstacles(&physics, material, &obstacles);
+
+  PhysXQueryBatch serial;
+  BuildBatch(&serial);
+  PhysXQueryBatch batched;
+  BuildBatch(&batched);
+  const size_t queries = serial.GetRequestCount();
+
+  /* The first batch flushes the query structures of the new actors, it stays out of the measures */
+  physics.ExecuteQueries(&batched);
+
+  BenchmarkMeasure single;
+  single.Name = "PhysX Scene Queries Serial";
+  single.ItemsUnit = "queries";
+  single.Items = queries;
+  single.Seconds = Benchmark::MeasureBestSeconds(YEAGER_PHYSX_QUERY_BENCHMARK_REPETITIONS,
+                                                 [&]() { ExecuteSerial(physics.GetPxScene(), &serial); });
+  report->AddMeasure(single);
+
+  WorkerPool one(0);
+  BenchmarkMeasure batchedSingle;
+  batchedSingle.Name = "PhysX Scene Queries Batched";
+  batchedSingle.ItemsUnit = "queries";
+  batchedSingle.Items = queries;
+  batchedSingle.Seconds = Benchmark::MeasureBestSeconds(YEAGER_PHYSX_QUERY_BENCHMARK_REPETITIONS,
+                                                        [&]() { physics.ExecuteQueries(&batched, &one); });
+  batchedSingle.Threads = one.GetConcurrency();
+  report->AddMeasure(batchedSingle);
+  if (!SameResults(serial, batched)) {
+    report->Fail("PhysX batched scene queries differ from the serial ones!");
+  }
+
+  WorkerPool* pool = WorkerPool::GetGlobal();
+  BenchmarkMeasure batchedParallel;
+  batchedParallel.Name = "PhysX Scene Queries Batched";
+  batchedParallel.ItemsUnit = "queries";
+  batchedParallel.Items = queries;
+  batchedParallel.Seconds = Benchmark::MeasureBestSeconds(YEAGER_PHYSX_QUERY_BENCHMARK_REPETITIONS,
+                                                          [&]() { physics.ExecuteQueries(&batched, pool); });
+  batchedParallel.Threads = pool->GetConcurrency();
+  report->AddMeasure(batchedParallel);
+  if (!SameResults(serial, batched)) {
+    report->Fail("PhysX batched scene queries in parallel differ from the serial ones!");
+  }
+
+  size_t hits = 0;
+  for (uint8_t hit : batched.RaycastHits.Hit) {
+    hits += hit;
+  }
+  report->AddMetric("Raycast Hit Ratio", static_cast<double>(hits) / batched.Raycasts.size());
+  report->AddMetric("Parallel Speedup", single.Seconds / std::max(batchedParallel.Seconds, 1e-9), "x");
+  if (hits == 0) {
+    report->Fail("PhysX batched raycasts hit nothing, the benchmark scene is empty!");
+  }
+
+  for (PxRigidStatic* actor : obstacles) {
+    physics.GetPxScene()->removeActor(*actor);
+    PX_RELEASE(actor);
+  }
+  physics.GetMaterialCache()->Release(material);
+  physics.TerminateEngine();
+}
+
+YEAGER_BENCHMARK_SUITE("PhysXQueries", PhysXQueryBenchmarkSuite);
@@ -0,0 +1,329 @@
+#include "Benchmark.h"
+#include "Components/Physics/PhysXHandle.h"
+#include "Components/TerrainGen/GradientNoise.h"
+
+#include <cmath>
+#include <random>
+using namespace Yeager;
+using namespace physx;
+
+/* Defaults of the options of the suite, -Benchmark PhysXScenes --Steps=600 --SolverIterations=8 --Threads=2 */
+#define YEAGER_PHYSX_SCENES_BENCHMARK_STEPS 300
+#define YEAGER_PHYSX_SCENES_BENCHMARK_SOLVER_ITERATIONS 4
+#define YEAGER_PHYSX_SCENES_BENCHMARK_CONTROLLERS 256
+#define YEAGER_PHYSX_SCENES_BENCHMARK_TERRAIN 129
+
+/// @brief Everything a scene adds to the handle, released before the handle is terminated
+struct PhysXBenchmarkScene {
+  std::vector<PxRigidActor*> Actors;
+  std::vector<PxJoint*> Joints;
+  std::vector<PxController*> Controllers;
+  PxMaterial* Material = YEAGER_NULLPTR;
+  Uint SolverIterations = YEAGER_PHYSX_SCENES_BENCHMARK_SOLVER_ITERATIONS;
+  /* Lowest height a body may end at, below it went through the ground */
+  float MinHeight = -1.0f;
+};
+
+using PhysXBenchmarkSceneBuilder = void (*)(PhysXHandle* physics, PhysXBenchmarkScene* scene);
+
+static PxRigidDynamic* AddDynamic(PhysXHandle* physics, PhysXBenchmarkScene* scene, const PxTransform& transform,
+                                  const PxGeometry& geometry)
+{
+  PxRigidDynamic* body = PxCreateDynamic(*physics->GetPxPhysics(), transform, geometry, *scene->Material, 1.0f);
+  body->setSolverIterationCounts(scene->SolverIterations, 1);
+  physics->GetPxScene()->addActor(*body);
+  scene->Actors.push_back(body);
+  return body;
+}
+
+/* Pyramids of boxes resting on each other, the solver cost of tall stacks */
+static void BuildBoxPyramids(PhysXHandle* physics, PhysXBenchmarkScene* scene)
+{
+  const int levels = 20;
+  for (int pyramid = 0; pyramid < 4; pyramid++) {
+    const float z = pyramid * 6.0f;
+    for (int level = 0; level < levels; level++) {
+      for (int x = 0; x < levels - level; x++) {
+        const PxVec3 position((x - (levels - level) * 0.5f) * 2.05f, level * 2.0f + 1.0f, z);
+        AddDynamic(physics, scene, PxTransform(position), PxBoxGeometry(1.0f, 1.0f, 1.0f));
+      }
+    }
+  }
+}
+
+/* Spheres dropped in a walled pit, many contacts between dynamic bodies */
+static void BuildSpherePile(PhysXHandle* physics, PhysXBenchmarkScene* scene)
+{
+  const int side = 16;
+  const float half = side * 0.5f * 1.1f + 1.0f;
+  for (int wall = 0; wall < 4; wall++) {
+    const PxVec3 normal = wall < 2 ? PxVec3(wall == 0 ? 1.0f : -1.0f, 0.0f, 0.0f)
+                                   : PxVec3(0.0f, 0.0f, wall == 2 ? 1.0f : -1.0f);
+    const PxVec3 extents = wall < 2 ? PxVec3(0.5f, 10.0f, half) : PxVec3(half, 10.0f, 0.5f);
+    const PxVec3 position = normal * -(half + 0.5f) + PxVec3(0.0f, 10.0f, 0.0f);
+    PxRigidStatic* body =
+        PxCreateStatic(*physics->GetPxPhysics(), PxTransform(position), PxBoxGeometry(extents), *scene->Material);
+    physics->GetPxScene()->addActor(*body);
+    scene->Actors.push_back(body);
+  }
+
+  std::mt19937 random(1337);
+  std::uniform_real_distribution<float> jitter(-0.05f, 0.05f);
+  for (int y = 0; y < 8; y++) {
+    for (int z = 0; z < side; z++) {
+      for (int x = 0; x < side; x++) {
+        const PxVec3 position((x - side * 0.5f) * 1.1f + jitter(random), y * 1.1f + 1.0f,
+                              (z - side * 0.5f) * 1.1f + jitter(random));
+        AddDynamic(physics, scene, PxTransform(position), PxSphereGeometry(0.5f));
+      }
+    }
+  }
+}
+
+/* Chains of capsules joined by limited spherical joints falling in a heap, the joints of ragdolls */
+static void BuildCapsuleChains(PhysXHandle* physics, PhysXBenchmarkScene* scene)
+{
+  const float radius = 0.3f;
+  const float halfHeight = 0.5f;
+  const int links = 10;
+  for (int chain = 0; chain < 64; chain++) {
+    /* Capsules lie along X, the chains cross each other on the way down */
+    const PxQuat rotation(chain % 2 ? PxHalfPi : 0.0f, PxVec3(0.0f, 1.0f, 0.0f));
+    const PxVec3 direction = rotation.rotate(PxVec3(1.0f, 0.0f, 0.0f));
+    const PxVec3 start((chain % 8 - 4) * 3.0f, 3.0f + chain * 0.4f, (chain / 8 - 4) * 3.0f);
+    PxRigidDynamic* previous = YEAGER_NULLPTR;
+    for (int link = 0; link < links; link++) {
+      const PxVec3 position = start + direction * ((link - links * 0.5f) * (halfHeight + radius) * 2.0f);
+      PxRigidDynamic* body =
+          AddDynamic(physics, scene, PxTransform(position, rotation), PxCapsuleGeometry(radius, halfHeight));
+      if (previous) {
+        const PxTransform tail(PxVec3(halfHeight + radius, 0.0f, 0.0f));
+        const PxTransform head(PxVec3(-(halfHeight + radius), 0.0f, 0.0f));
+        PxSphericalJoint* joint = PxSphericalJointCreate(*physics->GetPxPhysics(), previous, tail, body, head);
+        joint->setLimitCone(PxJointLimitCone(PxPi / 4.0f, PxPi / 4.0f));
+        joint->setSphericalJointFlag(PxSphericalJointFlag::eLIMIT_ENABLED, true);
+        scene->Joints.push_back(joint);
+      }
+      previous = body;
+    }
+  }
+}
+
+/* A noise terrain as a triangle mesh, centered on the origin and above the ground plane of the handle */
+static PxRigidStatic* AddTerrain(PhysXHandle* physics, PhysXBenchmarkScene* scene, Math::Array2D<float>* heightMap)
+{
+  const int size = YEAGER_PHYSX_SCENES_BENCHMARK_TERRAIN;
+  NoiseFractalSettings noise;
+  noise.Frequency = 1.0f / 32.0f;
+  GradientNoise(1337).FillArray2D(heightMap, 0, 0, size, size, noise, 6.0f, 8.0f);
+
+  PhysXTriangleMeshInput mesh;
+  for (int z = 0; z < size; z++) {
+    for (int x = 0; x < size; x++) {
+      mesh.Vertices.push_back(PxVec3(x - size / 2, heightMap->At(x, z), z - size / 2));
+    }
+  }
+  for (int z = 0; z < size - 1; z++) {
+    for (int x = 0; x < size - 1; x++) {
+      const PxU32 bottomLeft = z * size + x;
+      const PxU32 topLeft = (z + 1) * size + x;
+      mesh.Indices.insert(mesh.Indices.end(),
+                          {bottomLeft, topLeft, topLeft + 1, bottomLeft, topLeft + 1, bottomLeft + 1});
+    }
+  }
+
+  PxTriangleMesh* triangleMesh = physics->GetGeometryHandle()->CreateTriangleMesh(mesh);
+  PxRigidStatic* terrain = physics->GetPxPhysics()->createRigidStatic(PxTransform(PxIdentity));
+  PxRigidActorExt::createExclusiveShape(*terrain, PxTriangleMeshGeometry(triangleMesh), *scene->Material);
+  /* The shape holds its own reference */
+  triangleMesh->release();
+  physics->GetPxScene()->addActor(*terrain);
+  scene->Actors.push_back(terrain);
+  return terrain;
+}
+
+/* Boxes, spheres and capsules rained on the terrain, the cost of the mesh contacts */
+static void BuildTerrainDebris(PhysXHandle* physics, PhysXBenchmarkScene* scene)
+{
+  Math::Array2D<float> heightMap(YEAGER_PHYSX_SCENES_BENCHMARK_TERRAIN, YEAGER_PHYSX_SCENES_BENCHMARK_TERRAIN);
+  AddTerrain(physics, scene, &heightMap);
+
+  std::mt19937 random(1337);
+  std::uniform_real_distribution<float> spread(-40.0f, 40.0f);
+  std::uniform_real_distribution<float> size(0.4f, 1.0f);
+  for (int x = 0; x < 1024; x++) {
+    const PxVec3 position(spread(random), 20.0f + (x / 256) * 3.0f, spread(random));
+    const float extent = size(random);
+    switch (x % 3) {
+      case 0:
+        AddDynamic(physics, scene, PxTransform(position), PxBoxGeometry(extent, extent, extent));
+        break;
+      case 1:
+        AddDynamic(physics, scene, PxTransform(position), PxSphereGeometry(extent));
+        break;
+      default:
+        AddDynamic(physics, scene, PxTransform(position), PxCapsuleGeometry(extent * 0.5f, extent));
+        break;
+    }
+  }
+}
+
+/* Capsule controllers walking over the terrain side by side, the sweeps of the controllers of a crowd */
+static void BuildControllers(PhysXHandle* physics, PhysXBenchmarkScene* scene)
+{
+  Math::Array2D<float> heightMap(YEAGER_PHYSX_SCENES_BENCHMARK_TERRAIN, YEAGER_PHYSX_SCENES_BENCHMARK_TERRAIN);
+  AddTerrain(physics, scene, &heightMap);
+
+  const Uint count = Benchmark::GetNumberOption("Controllers", YEAGER_PHYSX_SCENES_BENCHMARK_CONTROLLERS);
+  const Uint side = std::ceil(std::sqrt(static_cast<double>(count)));
+  const float spacing = 96.0f / std::max<Uint>(1, side);
+  PhysXCharacterController* controllers = physics->GetCharacterController();
+  for (Uint x = 0; x < count; x++) {
+    PxController* controller =
+        controllers->CreateController(PxControllerShapeType::eCAPSULE, 0.4f, 0.4f, std::min(spacing * 0.5f, 1.0f));
+    if (!controller) {
+      continue;
+    }
+    /* Vertices of the terrain under the controller, the grid is centered on the terrain */
+    const int cellX = static_cast<int>((x % side) * spacing) + (YEAGER_PHYSX_SCENES_BENCHMARK_TERRAIN - 96) / 2;
+    const int cellZ = static_cast<int>((x / side) * spacing) + (YEAGER_PHYSX_SCENES_BENCHMARK_TERRAIN - 96) / 2;
+    const float height = heightMap.At(cellX, cellZ) + 3.0f;
+    controllers->SetPosition(controller, PxExtendedVec3(cellX - YEAGER_PHYSX_SCENES_BENCHMARK_TERRAIN / 2, height,
+                                                        cellZ - YEAGER_PHYSX_SCENES_BENCHMARK_TERRAIN / 2));
+    scene->Controllers.push_back(controller);
+  }
+}
+
+struct PhysXBenchmarkSceneRun {
+  double Seconds = 0.0;
+  double MaxStepSeconds = 0.0;
+  double MoveSeconds = 0.0;
+  uint64_t ContactPairs = 0;
+  Uint MaxContactPairs = 0;
+  Uint ActiveBodies = 0;
+  PhysXAllocatorStats Memory;
+  bool Stable = true;
+};
+
+static bool RunScene(PhysXBenchmarkSceneBuilder build, Uint steps, PhysXBenchmarkSceneRun* run)
+{
+  PhysXHandle physics(YEAGER_NULLPTR);
+  physics.SetPxPvdEnabled(false);
+  if (!physics.InitPxEngine()) {
+    return false;
+  }
+  physics.GetCpuDispatcher()->SetMaxThreads(Benchmark::GetNumberOption("Threads", 0));
+
+  PhysXBenchmarkScene scene;
+  scene.SolverIterations =
+      Benchmark::GetNumberOption("SolverIterations", YEAGER_PHYSX_SCENES_BENCHMARK_SOLVER_ITERATIONS);
+  scene.Material = physics.GetMaterialCache()->Acquire(YEAGER_PHYSX_DEFAULT_MATERIAL);
+  build(&physics, &scene);
+
+  const float deltaTime = 1.0f / 60.0f;
+  const PxControllerFilters filters;
+  PxScene* pxScene = physics.GetPxScene();
+  for (Uint step = 0; step < steps; step++) {
+    const auto start = std::chrono::steady_clock::now();
+    /* The controllers walk forward and fall, they move between the steps as the application moves them */
+    for (PxController* controller : scene.Controllers) {
+      physics.GetCharacterController()->Move(controller, PxVec3(4.0f, -20.0f, 0.0f) * deltaTime, 0.001f, deltaTime,
+                                             filters);
+    }
+    const auto moved = std::chrono::steady_clock::now();
+    pxScene->simulate(deltaTime);
+    pxScene->fetchResults(true);
+    const auto end = std::chrono::steady_clock::now();
+
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    run->Seconds += seconds;
+    run->MaxStepSeconds = std::max(run->MaxStepSeconds, seconds);
+    run->MoveSeconds += std::chrono::duration<double>(moved - start).count();
+
+    PxSimulationStatistics statistics;
+    pxScene->getSimulationStatistics(statistics);
+    run->ContactPairs += statistics.nbDiscreteContactPairsTotal;
+    run->MaxContactPairs = std::max<Uint>(run->MaxContactPairs, statistics.nbDiscreteContactPairsTotal);
+    run->ActiveBodies = statistics.nbActiveDynamicBodies;
+  }
+  run->Memory = physics.GetPxAllocator()->GetStats();
+
+  /* A body below the ground or not finite means the scene blew up */
+  for (PxRigidActor* actor : scene.Actors) {
+    const PxTransform pose = actor->getGlobalPose();
+    if (!pose.isValid() || pose.p.y < scene.MinHeight) {
+      run->Stable = false;
+    }
+  }
+  for (PxController* controller : scene.Controllers) {
+    const PxExtendedVec3 position = controller->getPosition();
+    if (!std::isfinite(position.y) || position.y < scene.MinHeight) {
+      run->Stable = false;
+    }
+  }
+
+  for (PxJoint* joint : scene.Joints) {
+    joint->release();
+  }
+  for (PxRigidActor* actor : scene.Actors) {
+    pxScene->removeActor(*actor);
+    PX_RELEASE(actor);
+  }
+  physics.GetMaterialCache()->Release(scene.Material);
+  /* The controllers are purged with the controller manager */
+  physics.TerminateEngine();
+  return true;
+}
+
+static void PhysXScenesBenchmarkSuite(BenchmarkReport* report)
+{
+  const std::pair<String, PhysXBenchmarkSceneBuilder> scenes[] = {
+      {"BoxPyramids", BuildBoxPyramids},           {"SpherePile", BuildSpherePile},
+      {"CapsuleChains", BuildCapsuleChains},       {"TerrainDebris", BuildTerrainDebris},
+      {"CharacterControllers", BuildControllers},
+  };
+  const String only = Benchmark::GetOption("Scene", "All");
+  const Uint steps = std::max(1.0, Benchmark::GetNumberOption("Steps", YEAGER_PHYSX_SCENES_BENCHMARK_STEPS));
+  report->AddMetric("Steps", steps);
+  report->AddMetric("Solver Iterations",
+                    Benchmark::GetNumberOption("SolverIterations", YEAGER_PHYSX_SCENES_BENCHMARK_SOLVER_ITERATIONS));
+
+  bool found = false;
+  for (const auto& [name, build] : scenes) {
+    if (only != "All" && only != name) {
+      continue;
+    }
+    found = true;
+
+    PhysXBenchmarkSceneRun run;
+    if (!RunScene(build, steps, &run)) {
+      report->Fail("PhysX engine cannot be initialized!");
+      return;
+    }
+    BenchmarkMeasure measure;
+    measure.Name = "PhysX Scene " + name;
+    measure.ItemsUnit = "steps";
+    measure.Items = steps;
+    measure.Seconds = run.Seconds;
+    report->AddMeasure(measure);
+
+    report->AddMetric(name + " Step", run.Seconds * 1000.0 / steps, "ms");
+    report->AddMetric(name + " Max Step", run.MaxStepSeconds * 1000.0, "ms");
+    if (run.MoveSeconds > 0.0) {
+      report->AddMetric(name + " Controller Moves", run.MoveSeconds * 1000.0 / steps, "ms");
+    }
+    report->AddMetric(name + " Contact Pairs", static_cast<double>(run.ContactPairs) / steps, "pairs/step");
+    report->AddMetric(name + " Max Contact Pairs", run.MaxContactPairs, "pairs");
+    report->AddMetric(name + " Active Bodies", run.ActiveBodies);
+    report->AddMetric(name + " Peak Memory", run.Memory.PeakBytes / (1024.0 * 1024.0), "MB");
+    report->AddMetric(name + " Live Memory", run.Memory.LiveBytes / (1024.0 * 1024.0), "MB");
+    if (!run.Stable) {
+      report->Fail("PhysX scene " + name + " blew up, a body went through the ground or is not finite!");
+    }
+  }
+  if (!found) {
+    report->Fail("PhysX scene " + only + " not found!");
+  }
+}
+
+YEAGER_BENCHMARK_SUITE("PhysXScenes", PhysXScenesBenchmarkSuite);
@@ -0,0 +1,188 @@
+#include "Benchmark.h"
+#include "Components/Physics/PhysXHandle.h"
+#include "Components/TerrainGen/GradientNoise.h"
+#include "Components/TerrainGen/TerrainHeightField.h"
+
+#include <random>
+using namespace Yeager;
+using namespace physx;
+
+#define YEAGER_PHYSX_TERRAIN_BENCHMARK_SIZE 1025
+#define YEAGER_PHYSX_TERRAIN_BENCHMARK_HEIGHT 256.0f
+#define YEAGER_PHYSX_TERRAIN_BENCHMARK_RAYS 8192
+
+/* The full grid of the terrain as a triangle mesh, the way the terrain collision was built before the heightfields */
+static size_t CookTerrainTriangleMesh(Math::Array2D<float>* heightMap, int size)
+{
+  std::vector<PxVec3> vertices;
+  std::vector<PxU32> indices;
+  vertices.reserve(static_cast<size_t>(size) * size);
+  indices.reserve(static_cast<size_t>(size - 1) * (size - 1) * 6);
+  for (int z = 0; z < size; z++) {
+    for (int x = 0; x < size; x++) {
+      vertices.push_back(PxVec3(x, heightMap->At(x, z), z));
+    }
+  }
+  for (int z = 0; z < size - 1; z++) {
+    for (int x = 0; x < size - 1; x++) {
+      const PxU32 bottomLeft = z * size + x;
+      const PxU32 topLeft = (z + 1) * size + x;
+      indices.insert(indices.end(), {bottomLeft, topLeft, topLeft + 1, bottomLeft, topLeft + 1, bottomLeft + 1});
+    }
+  }
+
+  PxTriangleMeshDesc meshDesc;
+  meshDesc.points.count = vertices.size();
+  meshDesc.points.stride = sizeof(PxVec3);
+  meshDesc.points.data = vertices.data();
+  meshDesc.triangles.count = indices.size() / 3;
+  meshDesc.triangles.stride = 3 * sizeof(PxU32);
+  meshDesc.triangles.data = indices.data();
+
+  PxTolerancesScale scale;
+  PxCookingParams params(scale);
+  PxDefaultMemoryOutputStream buffer;
+  if (!PxCookTriangleMesh(params, meshDesc, buffer)) {
+    return 0;
+  }
+  return buffer.getSize();
+}
+
+/* Height of the triangles of the terrain under the point, the surface the heightfield quantizes */
+static float GetTriangleHeight(const TerrainHeightField& field, const PxVec3& point)
+{
+  const int cellX = std::clamp(static_cast<int>(std::floor(point.x)), 0, field.GetWidth() - 2);
+  const int cellZ = std::clamp(static_cast<int>(std::floor(point.z)), 0, field.GetHeight() - 2);
+  TerrainRay ray;
+  ray.Origin = Vector3(point.x, YEAGER_PHYSX_TERRAIN_BENCHMARK_HEIGHT * 4.0f, point.z);
+  TerrainRayHit hit;
+  return field.IntersectCell(ray, cellX, cellZ, ray.MaxDistance, &hit) ? hit.Position.y : point.y;
+}
+
+static void PhysXTerrainBenchmarkSuite(BenchmarkReport* report)
+{
+  PhysXHandle physics(YEAGER_NULLPTR);
+  physics.SetPxPvdEnabled(false);
+  if (!physics.InitPxEngine()) {
+    report->Fail("PhysX engine cannot be initialized!");
+    return;
+  }
+
+  const int size = YEAGER_PHYSX_TERRAIN_BENCHMARK_SIZE;
+  const float half = YEAGER_PHYSX_TERRAIN_BENCHMARK_HEIGHT * 0.5f;
+  Math::Array2D<float> heightMap(size, size);
+  NoiseFractalSettings noise;
+  noise.Octaves = 8;
+  noise.Frequency = 1.0f / 256.0f;
+  GradientNoise(1337).FillArray2D(&heightMap, 0, 0, size, size, noise, half, half);
+
+  PhysXHeightFieldInput input;
+  input.Heights = heightMap.GetAddress(0, 0);
+  input.Width = size;
+  input.Depth = size;
+  input.RowStride = heightMap.GetPitch() * sizeof(float);
+
+  const String name = std::to_string(size) + "x" + std::to_string(size);
+  PhysXHeightField heightField;
+  BenchmarkMeasure build;
+  build.Name = "PhysX Heightfield Build " + name;
+  build.ItemsUnit = "samples";
+  build.Items = static_cast<double>(size) * size;
+  build.Seconds = Benchmark::MeasureBestSeconds(3, [&]() {
+    PX_RELEASE(heightField.aHeightField);
+    heightField = PhysXGeometryHandle::CreateHeightField(physics.GetPxPhysics(), input);
+  });
+  report->AddMeasure(build);
+
+  size_t cookedBytes = 0;
+  BenchmarkMeasure cook;
+  cook.Name = "PhysX Triangle Mesh Cook " + name;
+  cook.ItemsUnit = "samples";
+  cook.Items = build.Items;
+  cook.Seconds = Benchmark::MeasureBestSeconds(1, [&]() { cookedBytes = CookTerrainTriangleMesh(&heightMap, size); });
+  report->AddMeasure(cook);
+
+  if (heightField.aHeightField == YEAGER_NULLPTR || cookedBytes == 0) {
+    report->Fail("PhysX terrain heightfield or triangle mesh cannot be created!");
+    physics.TerminateEngine();
+    return;
+  }
+
+  const double heightFieldBytes = build.Items * sizeof(PxHeightFieldSample);
+  report->AddMetric("Setup Speedup", cook.Seconds / std::max(build.Seconds, 1e-9), "x");
+  report->AddMetric("Heightfield Memory", heightFieldBytes / (1024.0 * 1024.0), "MB");
+  report->AddMetric("Triangle Mesh Memory", cookedBytes / (1024.0 * 1024.0), "MB");
+  report->AddMetric("Heightfield Height Step", heightField.aGeometry.heightScale);
+
+  /* Rays from above the terrain going down at random angles, most of them hit it */
+  TerrainHeightField field;
+  field.Build(&heightMap, size, size, 1.0f);
+  std::mt19937 random(1337);
+  std::uniform_real_distribution<float> position(0.0f, size - 1.0f);
+  std::uniform_real_distribution<float> slope(-1.0f, 1.0f);
+  std::vector<PxVec3> origins(YEAGER_PHYSX_TERRAIN_BENCHMARK_RAYS), directions(YEAGER_PHYSX_TERRAIN_BENCHMARK_RAYS);
+  for (size_t ray = 0; ray < origins.size(); ray++) {
+    origins[ray] = PxVec3(position(random), YEAGER_PHYSX_TERRAIN_BENCHMARK_HEIGHT * 1.5f, position(random));
+    directions[ray] = PxVec3(slope(random), -1.0f, slope(random)).getNormalized();
+  }
+
+  const float maxDistance = YEAGER_PHYSX_TERRAIN_BENCHMARK_HEIGHT * 8.0f;
+  std::vector<PxGeomRaycastHit> hits(origins.size());
+  std::vector<PxU32> hitCounts(origins.size());
+  BenchmarkMeasure physxRays;
+  physxRays.Name = "PhysX Heightfield Raycast";
+  physxRays.ItemsUnit = "rays";
+  physxRays.Items = origins.size();
+  physxRays.Seconds = Benchmark::MeasureBestSeconds(3, [&]() {
+    for (size_t ray = 0; ray < origins.size(); ray++) {
+      hitCounts[ray] = PxGeometryQuery::raycast(origins[ray], directions[ray], heightField.aGeometry,
+                                                heightField.aPose, maxDistance, PxHitFlag::eDEFAULT, 1, &hits[ray]);
+    }
+  });
+  report->AddMeasure(physxRays);
+
+  std::vector<TerrainRayHit> fieldHits(origins.size());
+  std::vector<uint8_t> fieldFound(origins.size());
+  BenchmarkMeasure fieldRays;
+  fieldRays.Name = "Terrain Height Field Raycast";
+  fieldRays.ItemsUnit = "rays";
+  fieldRays.Items = origins.size();
+  fieldRays.Seconds = Benchmark::MeasureBestSeconds(3, [&]() {
+    for (size_t ray = 0; ray < origins.size(); ray++) {
+      TerrainRay query;
+      query.Origin = PxVec3ToVector3(origins[ray]);
+      query.Direction = PxVec3ToVector3(directions[ray]);
+      query.MaxDistance = maxDistance;
+      fieldFound[ray] = field.Raycast(query, &fieldHits[ray]);
+    }
+  });
+  report->AddMeasure(fieldRays);
+
+  /* Every hit of PhysX must be on the triangles of the terrain within the quantization, and both must agree on what
+   * hits. Rays grazing the surface may hit or miss by the quantization alone, so a few disagreements are allowed */
+  const float tolerance = heightField.aGeometry.heightScale * 0.5f + YEAGER_PHYSX_TERRAIN_BENCHMARK_HEIGHT * 1e-5f;
+  float worstError = 0.0f;
+  Uint disagreements = 0;
+  for (size_t ray = 0; ray < origins.size(); ray++) {
+    if ((hitCounts[ray] > 0) != (fieldFound[ray] != 0)) {
+      disagreements++;
+      continue;
+    }
+    if (hitCounts[ray] > 0) {
+      worstError = std::max(worstError, std::abs(hits[ray].position.y - GetTriangleHeight(field, hits[ray].position)));
+    }
+  }
+  report->AddMetric("Heightfield Worst Height Error", worstError);
+  report->AddMetric("Hit Disagreements", disagreements);
+  if (worstError > tolerance) {
+    report->Fail("PhysX heightfield hits are off the terrain surface by more than the quantization!");
+  }
+  if (disagreements > origins.size() / 1000) {
+    report->Fail("PhysX heightfield and the terrain height field disagree on the rays that hit!");
+  }
+
+  PX_RELEASE(heightField.aHeightField);
+  physics.TerminateEngine();
+}
+
+YEAGER_BENCHMARK_SUITE("PhysXTerrain", PhysXTerrainBenchmarkSuite);
@@ -0,0 +1,158 @@
+#include "Benchmark.h"
+#include "Components/Renderer/AnimationEngine/Skinning.h"
+#include <random>
+using namespace Yeager;
+
+#define YEAGER_SKINNING_BENCHMARK_VERTICES 262144
+#define YEAGER_SKINNING_BENCHMARK_BONES 64
+#define YEAGER_SKINNING_BENCHMARK_REPETITIONS 5
+
+/* Synthetic skinned mesh, the bones are rigid transforms so the linear blend and the dual quaternion results can be
+ * compared against each other on vertices with a single influence */
+struct SkinningBenchmarkData {
+  std::vector<AnimatedVertexData> Vertices;
+  std::vector<Matrix4> Bones;
+  std::vector<DualQuaternion> DualQuaternions;
+};
+
+static SkinningBenchmarkData BuildSkinningBenchmarkData()
+{
+  SkinningBenchmarkData data;
+  std::mt19937 generator(1337);
+  std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+  std::uniform_int_distribution<int> bone(0, YEAGER_SKINNING_BENCHMARK_BONES - 1);
+  std::uniform_int_distribution<int> influences(1, MAX_BONE_INFLUENCE);
+
+  for (Uint x = 0; x < YEAGER_SKINNING_BENCHMARK_BONES; x++) {
+    Vector3 axis(unit(generator), unit(generator), unit(generator));
+    axis = glm::length(axis) > 0.0f ? glm::normalize(axis) : Vector3(0.0f, 1.0f, 0.0f);
+    const Vector3 translation(unit(generator) * 5.0f, unit(generator) * 5.0f, unit(generator) * 5.0f);
+    data.Bones.push_back(glm::rotate(glm::translate(Matrix4(1.0f), translation), unit(generator) * 3.14f, axis));
+  }
+  CpuSkinning::BuildDualQuaternions(data.Bones.data(), data.Bones.size(), &data.DualQuaternions);
+
+  data.Vertices.resize(YEAGER_SKINNING_BENCHMARK_VERTICES);
+  for (auto& vertex : data.Vertices) {
+    vertex.Position = Vector3(unit(generator), unit(generator), unit(generator));
+    vertex.Normals = glm::normalize(Vector3(unit(generator), unit(generator), 1.5f));
+
+    const int count = influences(generator);
+    float total = 0.0f;
+    for (int x = 0; x < MAX_BONE_INFLUENCE; x++) {
+      vertex.BonesIDs[x] = x < count ? bone(generator) : -1;
+      vertex.Weights[x] = x < count ? unit(generator) + 1.1f : 0.0f;
+      total += vertex.Weights[x];
+    }
+    for (int x = 0; x < count; x++) {
+      vertex.Weights[x] /= total;
+    }
+  }
+  return data;
+}
+
+using SkinningFunction = std::function<void(size_t begin, size_t end, Vector3* positions, Vector3* normals)>;
+
+/* Splits the vertices in equal ranges, one per thread */
+static void RunSkinningThreads(Uint threads, size_t count, const SkinningFunction& function, Vector3* positions,
+                               Vector3* normals)
+{
+  if (threads <= 1) {
+    function(0, count, positions, normals);
+    return;
+  }
+
+  std::vector<std::thread> workers;
+  const size_t range = (count + threads - 1) / threads;
+  for (Uint x = 0; x < threads; x++) {
+    const size_t begin = std::min(count, x * range);
+    const size_t end = std::min(count, begin + range);
+    workers.emplace_back(function, begin, end, positions, normals);
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+static float MaxDistance(const std::vector<Vector3>& a, const std::vector<Vector3>& b)
+{
+  float error = 0.0f;
+  for (size_t x = 0; x < a.size(); x++) {
+    error = std::max(error, glm::length(a[x] - b[x]));
+  }
+  return error;
+}
+
+static void SkinningBenchmarkSuite(BenchmarkReport* report)
+{
+  const SkinningBenchmarkData data = BuildSkinningBenchmarkData();
+  const size_t count = data.Vertices.size();
+  const AnimatedVertexData* vertices = data.Vertices.data();
+
+  const std::vector<std::pair<String, SkinningFunction>> variants = {
+      {"Linear Blend Scalar",
+       [&](size_t begin, size_t end, Vector3* positions, Vector3* normals) {
+         CpuSkinning::LinearBlendScalar(vertices + begin, end - begin, data.Bones.data(), data.Bones.size(),
+                                        positions + begin, normals + begin);
+       }},
+      {"Linear Blend SIMD",
+       [&](size_t begin, size_t end, Vector3* positions, Vector3* normals) {
+         CpuSkinning::LinearBlendSIMD(vertices + begin, end - begin, data.Bones.data(), data.Bones.size(),
+                                      positions + begin, normals + begin);
+       }},
+      {"Dual Quaternion Scalar",
+       [&](size_t begin, size_t end, Vector3* positions, Vector3* normals) {
+         CpuSkinning::DualQuaternionScalar(vertices + begin, end - begin, data.DualQuaternions.data(),
+                                           data.DualQuaternions.size(), positions + begin, normals + begin);
+       }},
+      {"Dual Quaternion SIMD",
+       [&](size_t begin, size_t end, Vector3* positions, Vector3* normals) {
+         CpuSkinning::DualQuaternionSIMD(vertices + begin, end - begin, data.DualQuaternions.data(),
+                                         data.DualQuaternions.size(), positions + begin, normals + begin);
+       }},
+  };
+
+  const Uint hardwareThreads = std::max<Uint>(1, std::thread::hardware_concurrency());
+  std::vector<std::vector<Vector3>> positions(variants.size(), std::vector<Vector3>(count));
+  std::vector<std::vector<Vector3>> normals(variants.size(), std::vector<Vector3>(count));
+
+  for (Uint variant = 0; variant < variants.size(); variant++) {
+    for (Uint threads : {1u, hardwareThreads}) {
+      BenchmarkMeasure measure;
+      measure.Name = variants[variant].first + (threads > 1 ? " MT" : "");
+      measure.ItemsUnit = "vertices";
+      measure.Items = count;
+      measure.Threads = threads;
+      measure.Seconds = Benchmark::MeasureBestSeconds(YEAGER_SKINNING_BENCHMARK_REPETITIONS, [&]() {
+        RunSkinningThreads(threads, count, variants[variant].second, positions[variant].data(),
+                           normals[variant].data());
+      });
+      report->AddMeasure(measure);
+      if (hardwareThreads == 1)
+        break;
+    }
+  }
+
+  /* Validation, the SIMD paths must match the scalar reference and both methods must agree on rigid vertices */
+  const float linearError = MaxDistance(positions[0], positions[1]);
+  const float dualError = MaxDistance(positions[2], positions[3]);
+  const float normalError = std::max(MaxDistance(normals[0], normals[1]), MaxDistance(normals[2], normals[3]));
+  float rigidError = 0.0f;
+  for (size_t x = 0; x < count; x++) {
+    if (data.Vertices[x].BonesIDs[1] == -1) {
+      rigidError = std::max(rigidError, glm::length(positions[0][x] - positions[2][x]));
+    }
+  }
+
+  report->AddMetric("SIMD max position error (linear blend)", linearError, "units");
+  report->AddMetric("SIMD max position error (dual quaternion)", dualError, "units");
+  report->AddMetric("SIMD max normal error", normalError);
+  report->AddMetric("Linear blend x dual quaternion rigid error", rigidError, "units");
+  report->AddMetric("SIMD available", CpuSkinning::IsSIMDAvailable() ? 1.0 : 0.0);
+
+  const float tolerance = 1e-4f;
+  if (linearError > tolerance || dualError > tolerance || normalError > tolerance || rigidError > tolerance) {
+    report->Fail("CPU skinning results diverged from the scalar reference!");
+  }
+}
+
+YEAGER_BENCHMARK_SUITE("Skinning", SkinningBenchmarkSuite);
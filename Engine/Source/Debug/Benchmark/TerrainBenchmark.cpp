@@ -0,0 +1,121 @@
+#include "Benchmark.h"
+#include "Components/TerrainGen/ProceduralTerrain.h"
+using namespace Yeager;
+
+#define YEAGER_TERRAIN_BENCHMARK_REPETITIONS 3
+
+/* The serial setup the terrain used before the worker pool, kept as the reference of the parallel output */
+static void BuildTerrainMeshSerial(const TerrainMeshBuildDesc& desc, std::vector<TerrainVertex>* vertices,
+                                   std::vector<GLuint>* indices)
+{
+  int v_index = 0;
+  vertices->assign(desc.Width * desc.Height, TerrainVertex());
+  indices->clear();
+  for (int x = 0; x < desc.Width; x++) {
+    for (int y = 0; y < desc.Height; y++) {
+      TerrainVertex& vertex = (*vertices)[v_index++];
+      vertex.Position = Vector3(x * desc.WorldScale, desc.HeightMap->At(x, y), y * desc.WorldScale);
+      vertex.TexCoords = Vector2(desc.TextureScale * (float)x / desc.Size, desc.TextureScale * (float)y / desc.Size);
+    }
+  }
+
+  for (int z = 0; z < desc.Height - 1; z++) {
+    for (int x = 0; x < desc.Width - 1; x++) {
+      Uint IndexBottomLeft = z * desc.Width + x;
+      Uint IndexTopLeft = (z + 1) * desc.Width + x;
+      Uint IndexTopRight = (z + 1) * desc.Width + x + 1;
+      Uint IndexBottomRight = z * desc.Width + x + 1;
+      indices->push_back(IndexBottomLeft);
+      indices->push_back(IndexTopLeft);
+      indices->push_back(IndexTopRight);
+      indices->push_back(IndexBottomLeft);
+      indices->push_back(IndexTopRight);
+      indices->push_back(IndexBottomRight);
+    }
+  }
+
+  for (Uint x = 0; x < indices->size(); x += 3) {
+    Uint Index0 = (*indices)[x];
+    Uint Index1 = (*indices)[x + 1];
+    Uint Index2 = (*indices)[x + 2];
+    Vector3 v1 = (*vertices)[Index1].Position - (*vertices)[Index0].Position;
+    Vector3 v2 = (*vertices)[Index2].Position - (*vertices)[Index0].Position;
+    Vector3 Normal = glm::normalize(glm::cross(v1, v2));
+    (*vertices)[Index0].Normals += Normal;
+    (*vertices)[Index1].Normals += Normal;
+    (*vertices)[Index2].Normals += Normal;
+  }
+
+  for (auto& vertex : *vertices) {
+    vertex.Normals = glm::normalize(vertex.Normals);
+  }
+}
+
+/* FNV-1a of the raw bytes, the outputs must match bit by bit */
+static uint64_t HashTerrainMesh(const std::vector<TerrainVertex>& vertices, const std::vector<GLuint>& indices)
+{
+  uint64_t hash = 14695981039346656037ULL;
+  auto feed = [&](const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t x = 0; x < size; x++) {
+      hash = (hash ^ bytes[x]) * 1099511628211ULL;
+    }
+  };
+  feed(vertices.data(), vertices.size() * sizeof(TerrainVertex));
+  feed(indices.data(), indices.size() * sizeof(GLuint));
+  return hash;
+}
+
+static void TerrainSetupBenchmarkSuite(BenchmarkReport* report)
+{
+  WorkerPool* pool = WorkerPool::GetGlobal();
+  for (int size : {256, 512, 1024, 2048, 4096}) {
+    Math::Array2D<float> heightMap(size, size);
+    for (int z = 0; z < size; z++) {
+      for (int x = 0; x < size; x++) {
+        const float height = 64.0f * std::sin(x * 0.05f) * std::cos(z * 0.031f) + 8.0f * std::sin(x * z * 0.001f);
+        heightMap.Set(x, z, 128.0f + height);
+      }
+    }
+
+    TerrainMeshBuildDesc desc;
+    desc.HeightMap = &heightMap;
+    desc.Width = size;
+    desc.Height = size;
+    desc.Size = size;
+
+    std::vector<TerrainVertex> vertices;
+    std::vector<GLuint> indices;
+    const String name = std::to_string(size) + "x" + std::to_string(size);
+
+    /* A single repetition for the biggest grids, the serial build of 4096 takes seconds */
+    const Uint repetitions = size >= 2048 ? 1 : YEAGER_TERRAIN_BENCHMARK_REPETITIONS;
+
+    BenchmarkMeasure serial;
+    serial.Name = "Terrain Setup Serial " + name;
+    serial.ItemsUnit = "vertices";
+    serial.Items = static_cast<double>(size) * size;
+    serial.Seconds =
+        Benchmark::MeasureBestSeconds(repetitions, [&]() { BuildTerrainMeshSerial(desc, &vertices, &indices); });
+    const uint64_t reference = HashTerrainMesh(vertices, indices);
+    report->AddMeasure(serial);
+
+    /* Frees the reference before building again, a 4096 grid takes almost 1 GB */
+    std::vector<TerrainVertex>().swap(vertices);
+    std::vector<GLuint>().swap(indices);
+
+    BenchmarkMeasure parallel = serial;
+    parallel.Name = "Terrain Setup Parallel " + name;
+    parallel.Threads = pool->GetConcurrency();
+    parallel.Seconds = Benchmark::MeasureBestSeconds(
+        repetitions, [&]() { TerrainMeshBuilder::Build(desc, &vertices, &indices, pool); });
+    report->AddMeasure(parallel);
+    report->AddMetric("Speedup " + name, serial.Seconds / std::max(parallel.Seconds, 1e-9), "x");
+
+    if (HashTerrainMesh(vertices, indices) != reference) {
+      report->Fail("Parallel terrain setup of " + name + " differs from the serial setup!");
+    }
+  }
+}
+
+YEAGER_BENCHMARK_SUITE("TerrainSetup", TerrainSetupBenchmarkSuite);
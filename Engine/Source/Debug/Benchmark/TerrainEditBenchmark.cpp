@@ -0,0 +1,104 @@
+#include "Benchmark.h"
+#include "Components/TerrainGen/GradientNoise.h"
+#include "Components/TerrainGen/ProceduralTerrain.h"
+using namespace Yeager;
+
+#define YEAGER_TERRAIN_EDIT_BENCHMARK_SIZE 2049
+#define YEAGER_TERRAIN_EDIT_BENCHMARK_HEIGHT 256.0f
+#define YEAGER_TERRAIN_EDIT_BENCHMARK_STROKES 400
+
+static void TerrainEditBenchmarkSuite(BenchmarkReport* report)
+{
+  const int size = YEAGER_TERRAIN_EDIT_BENCHMARK_SIZE;
+  const float half = YEAGER_TERRAIN_EDIT_BENCHMARK_HEIGHT * 0.5f;
+  WorkerPool* pool = WorkerPool::GetGlobal();
+
+  Math::Array2D<float> heightMap(size, size);
+  NoiseFractalSettings noise;
+  noise.Octaves = 8;
+  noise.Frequency = 1.0f / 512.0f;
+  GradientNoise(1337).FillArray2D(&heightMap, 0, 0, size, size, noise, half, half, pool);
+
+  TerrainMeshBuildDesc desc;
+  desc.HeightMap = &heightMap;
+  desc.Width = size;
+  desc.Height = size;
+  desc.Size = size;
+
+  std::vector<TerrainVertex> vertices;
+  std::vector<GLuint> indices;
+  BenchmarkMeasure full;
+  full.Name = "Terrain Full Remesh " + std::to_string(size) + "x" + std::to_string(size);
+  full.ItemsUnit = "vertices";
+  full.Items = static_cast<double>(size) * size;
+  full.Threads = pool->GetConcurrency();
+  full.Seconds =
+      Benchmark::MeasureBestSeconds(2, [&]() { TerrainMeshBuilder::Build(desc, &vertices, &indices, pool); });
+  report->AddMeasure(full);
+
+  TerrainQuadtree quadtree;
+  quadtree.Build(&heightMap, size, size, TerrainLODSettings(), pool);
+
+  /* Strokes along a spiral over the terrain, every brush in turn, remeshed right after like a frame while sculpting */
+  TerrainHeightEditor editor(&heightMap, size, size, 0.0f, YEAGER_TERRAIN_EDIT_BENCHMARK_HEIGHT);
+  const TerrainBrushType::Enum types[] = {TerrainBrushType::eRAISE, TerrainBrushType::eLOWER,
+                                          TerrainBrushType::eFLATTEN, TerrainBrushType::eSMOOTH};
+  double strokeSeconds = 0.0, slowestStroke = 0.0;
+  size_t verticesRemeshed = 0;
+  for (int stroke = 0; stroke < YEAGER_TERRAIN_EDIT_BENCHMARK_STROKES; stroke++) {
+    TerrainBrush brush;
+    brush.Type = types[(stroke / 25) % 4];
+    brush.Radius = 32.0f;
+    brush.Strength = brush.Type == TerrainBrushType::eRAISE || brush.Type == TerrainBrushType::eLOWER ? 4.0f : 0.5f;
+    brush.TargetHeight = half;
+    const float angle = stroke * 0.05f;
+    const float radius = size * (0.1f + 0.35f * stroke / YEAGER_TERRAIN_EDIT_BENCHMARK_STROKES);
+    const float centerX = size * 0.5f + std::cos(angle) * radius;
+    const float centerZ = size * 0.5f + std::sin(angle) * radius;
+
+    const double seconds = Benchmark::MeasureBestSeconds(1, [&]() {
+      editor.ApplyBrush(brush, centerX, centerZ);
+      for (const auto& rect : editor.TakeDirtyRects()) {
+        verticesRemeshed += TerrainMeshBuilder::UpdateRegion(desc, rect, &vertices, pool).GetArea();
+        quadtree.UpdateRegion(rect, pool);
+      }
+    });
+    strokeSeconds += seconds;
+    slowestStroke = std::max(slowestStroke, seconds);
+  }
+
+  BenchmarkMeasure strokes;
+  strokes.Name = "Terrain Brush Stroke";
+  strokes.ItemsUnit = "strokes";
+  strokes.Items = YEAGER_TERRAIN_EDIT_BENCHMARK_STROKES;
+  strokes.Threads = pool->GetConcurrency();
+  strokes.Seconds = strokeSeconds;
+  report->AddMeasure(strokes);
+  report->AddMetric("Slowest Stroke", slowestStroke * 1000.0, "ms");
+  report->AddMetric("Vertices Remeshed Per Stroke",
+                    static_cast<double>(verticesRemeshed) / YEAGER_TERRAIN_EDIT_BENCHMARK_STROKES);
+  report->AddMetric("Upload Per Stroke",
+                    sizeof(TerrainVertex) * static_cast<double>(verticesRemeshed) /
+                        YEAGER_TERRAIN_EDIT_BENCHMARK_STROKES / 1024.0,
+                    "KB");
+  report->AddMetric("Full Upload", sizeof(TerrainVertex) * static_cast<double>(vertices.size()) / 1024.0, "KB");
+
+  /* The edited mesh must be the same one a full remesh of the sculpted heightmap gives */
+  std::vector<TerrainVertex> reference;
+  TerrainMeshBuilder::Build(desc, &reference, &indices, pool);
+  if (std::memcmp(reference.data(), vertices.data(), sizeof(TerrainVertex) * vertices.size()) != 0) {
+    report->Fail("Terrain vertices remeshed by region differ from a full remesh!");
+  }
+
+  /* The errors of the updated quadtree may stay higher than a rebuild, never lower */
+  TerrainQuadtree rebuilt;
+  rebuilt.Build(&heightMap, size, size, TerrainLODSettings(), pool);
+  for (int level = 0; level < rebuilt.GetLevelCount(); level++) {
+    if (quadtree.GetLevelError(level) < rebuilt.GetLevelError(level)) {
+      report->Fail("Terrain quadtree updated by region has a lower error than a rebuild!");
+      break;
+    }
+  }
+}
+
+YEAGER_BENCHMARK_SUITE("TerrainEdit", TerrainEditBenchmarkSuite);
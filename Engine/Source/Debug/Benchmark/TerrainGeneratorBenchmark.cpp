@@ -0,0 +1,129 @@
+#include "Benchmark.h"
+#include "Components/TerrainGen/ProceduralTerrain.h"
+using namespace Yeager;
+
+#define YEAGER_TERRAIN_GENERATOR_BENCHMARK_SIZE 2048
+#define YEAGER_TERRAIN_GENERATOR_BENCHMARK_FAULTS 128
+#define YEAGER_TERRAIN_GENERATOR_BENCHMARK_SEED 1337
+#define YEAGER_TERRAIN_GENERATOR_BENCHMARK_REPETITIONS 3
+
+static void FillHeightMap(Math::Array2D<float>* heightMap, int size)
+{
+  GradientNoise(YEAGER_TERRAIN_GENERATOR_BENCHMARK_SEED)
+      .FillArray2D(heightMap, 0, 0, size, size, NoiseFractalSettings(), 32.0f, 0.0f);
+}
+
+static bool EqualHeightMaps(Math::Array2D<float>* a, Math::Array2D<float>* b, int size)
+{
+  for (int z = 0; z < size; z++) {
+    if (std::memcmp(a->GetAddress(0, z), b->GetAddress(0, z), sizeof(float) * size) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* The fault formation as it was before the bands, one fault at a time over the whole grid */
+static void ApplyFaultsReference(Math::Array2D<float>* heightMap, int size, const std::vector<TerrainFault>& faults)
+{
+  for (const auto& fault : faults) {
+    const int dirX = fault.X2 - fault.X1;
+    const int dirZ = fault.Z2 - fault.Z1;
+    for (int z = 0; z < size; z++) {
+      for (int x = 0; x < size; x++) {
+        const int crossProduct = (x - fault.X1) * dirZ - dirX * (z - fault.Z1);
+        if (crossProduct > 0) {
+          heightMap->At(x, z) += fault.Height;
+        }
+      }
+    }
+  }
+}
+
+static void FaultFormationBenchmark(BenchmarkReport* report)
+{
+  const int size = YEAGER_TERRAIN_GENERATOR_BENCHMARK_SIZE;
+  const std::vector<TerrainFault> faults = FaultFormationTerrain::GenerateFaults(
+      YEAGER_TERRAIN_GENERATOR_BENCHMARK_SEED, size, YEAGER_TERRAIN_GENERATOR_BENCHMARK_FAULTS, 0, 64);
+  const String name = std::to_string(size) + "x" + std::to_string(size);
+  const double items = static_cast<double>(size) * size * faults.size();
+
+  Math::Array2D<float> reference(size, size);
+  BenchmarkMeasure serial;
+  serial.Name = "Fault Formation Reference " + name;
+  serial.ItemsUnit = "samples x faults";
+  serial.Items = items;
+  serial.Seconds = Benchmark::MeasureBestSeconds(YEAGER_TERRAIN_GENERATOR_BENCHMARK_REPETITIONS, [&]() {
+    FillHeightMap(&reference, size);
+    ApplyFaultsReference(&reference, size, faults);
+  });
+  report->AddMeasure(serial);
+
+  Math::Array2D<float> heightMap(size, size);
+  WorkerPool single(0);
+  const NoiseSIMDPath::Enum best = GradientNoise::GetBestSIMDPath();
+  for (Uint path = NoiseSIMDPath::eSIMD_SCALAR; path <= best; path++) {
+    const NoiseSIMDPath::Enum simd = static_cast<NoiseSIMDPath::Enum>(path);
+    for (WorkerPool* pool : {&single, WorkerPool::GetGlobal()}) {
+      BenchmarkMeasure measure;
+      measure.Name = "Fault Formation " + NoiseSIMDPath::ToString(simd) + " " + name;
+      measure.ItemsUnit = "samples x faults";
+      measure.Items = items;
+      measure.Threads = pool->GetConcurrency();
+      measure.Seconds = Benchmark::MeasureBestSeconds(YEAGER_TERRAIN_GENERATOR_BENCHMARK_REPETITIONS, [&]() {
+        FillHeightMap(&heightMap, size);
+        FaultFormationTerrain::ApplyFaults(&heightMap, size, faults, simd, pool);
+      });
+      report->AddMeasure(measure);
+      report->AddMetric("Fault Formation Speedup " + NoiseSIMDPath::ToString(simd) + " " +
+                            std::to_string(measure.Threads) + " Threads",
+                        serial.Seconds / std::max(measure.Seconds, 1e-9), "x");
+
+      if (!EqualHeightMaps(&heightMap, &reference, size)) {
+        report->Fail("Fault formation path " + NoiseSIMDPath::ToString(simd) + " differs from the reference!");
+      }
+    }
+  }
+}
+
+static void MidPointDisplacementBenchmark(BenchmarkReport* report)
+{
+  /* A power of two and the size of a terrain with a sample more, the later wraps around the border */
+  for (int size : {YEAGER_TERRAIN_GENERATOR_BENCHMARK_SIZE, YEAGER_TERRAIN_GENERATOR_BENCHMARK_SIZE + 1}) {
+    const String name = std::to_string(size) + "x" + std::to_string(size);
+    Math::Array2D<float> reference(size, size);
+    Math::Array2D<float> heightMap(size, size);
+
+    WorkerPool single(0);
+    double seconds[2] = {0.0, 0.0};
+    for (WorkerPool* pool : {&single, WorkerPool::GetGlobal()}) {
+      Math::Array2D<float>* target = pool == &single ? &reference : &heightMap;
+      BenchmarkMeasure measure;
+      measure.Name = "Midpoint Displacement " + name;
+      measure.ItemsUnit = "samples";
+      measure.Items = static_cast<double>(size) * size;
+      measure.Threads = pool->GetConcurrency();
+      measure.Seconds = Benchmark::MeasureBestSeconds(YEAGER_TERRAIN_GENERATOR_BENCHMARK_REPETITIONS, [&]() {
+        FillHeightMap(target, size);
+        MidPointDisplacementTerrain::CreateMidPointDisplacementF32(target, size, 1.0f,
+                                                                   YEAGER_TERRAIN_GENERATOR_BENCHMARK_SEED, pool);
+      });
+      report->AddMeasure(measure);
+      seconds[pool == &single ? 0 : 1] = measure.Seconds;
+    }
+    report->AddMetric("Midpoint Displacement Speedup " + name, seconds[0] / std::max(seconds[1], 1e-9), "x");
+
+    /* The random values come from the seed and the position, never from the order the bands run */
+    if (!EqualHeightMaps(&heightMap, &reference, size)) {
+      report->Fail("Midpoint displacement " + name + " differs between the worker pool and a single thread!");
+    }
+  }
+}
+
+static void TerrainGeneratorBenchmarkSuite(BenchmarkReport* report)
+{
+  FaultFormationBenchmark(report);
+  MidPointDisplacementBenchmark(report);
+}
+
+YEAGER_BENCHMARK_SUITE("TerrainGenerators", TerrainGeneratorBenchmarkSuite);
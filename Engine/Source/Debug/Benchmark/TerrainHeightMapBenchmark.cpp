@@ -0,0 +1,140 @@
+#include "Benchmark.h"
+#include "Components/TerrainGen/GradientNoise.h"
+#include "Components/TerrainGen/TerrainHeightMap.h"
+using namespace Yeager;
+
+#define YEAGER_TERRAIN_HEIGHTMAP_BENCHMARK_SIZE 2049
+#define YEAGER_TERRAIN_HEIGHTMAP_BENCHMARK_HEIGHT 256.0f
+
+static float MaxDifference(Math::Array2D<float>* a, Math::Array2D<float>* b, int size)
+{
+  float difference = 0.0f;
+  for (int z = 0; z < size; z++) {
+    for (int x = 0; x < size; x++) {
+      difference = std::max(difference, std::abs(a->At(x, z) - b->At(x, z)));
+    }
+  }
+  return difference;
+}
+
+static void TerrainHeightMapBenchmarkSuite(BenchmarkReport* report)
+{
+  const int size = YEAGER_TERRAIN_HEIGHTMAP_BENCHMARK_SIZE;
+  const float half = YEAGER_TERRAIN_HEIGHTMAP_BENCHMARK_HEIGHT * 0.5f;
+  WorkerPool* pool = WorkerPool::GetGlobal();
+  const std::filesystem::path folder = std::filesystem::temp_directory_path();
+  const double samples = static_cast<double>(size) * size;
+
+  Math::Array2D<float> heightMap(size, size);
+  NoiseFractalSettings noise;
+  noise.Octaves = 8;
+  noise.Frequency = 1.0f / 512.0f;
+  GradientNoise(1337).FillArray2D(&heightMap, 0, 0, size, size, noise, half, half, pool);
+
+  TerrainHeightMapInfo info;
+  info.Width = size;
+  info.Height = size;
+  info.MaxHeight = YEAGER_TERRAIN_HEIGHTMAP_BENCHMARK_HEIGHT;
+  info.Seed = 1337;
+
+  /* The text dump the heightmaps used before, as the baseline of the binary files */
+  const String textPath = (folder / "YeagerTerrainHeightMap.txt").string();
+  BenchmarkMeasure textSave;
+  textSave.Name = "Terrain HeightMap Text Save";
+  textSave.ItemsUnit = "samples";
+  textSave.Items = samples;
+  textSave.Seconds = Benchmark::MeasureBestSeconds(1, [&]() {
+    std::ofstream output(textPath, std::ofstream::out | std::ofstream::binary);
+    for (int z = 0; z < size; z++) {
+      for (int x = 0; x < size; x++) {
+        output << heightMap.At(x, z) << ' ';
+      }
+    }
+  });
+  report->AddMeasure(textSave);
+  BenchmarkMeasure textLoad = textSave;
+  textLoad.Name = "Terrain HeightMap Text Load";
+  textLoad.Seconds = Benchmark::MeasureBestSeconds(1, [&]() {
+    Math::Array2D<float> loaded(size, size);
+    std::ifstream input(textPath);
+    for (int z = 0; z < size; z++) {
+      for (int x = 0; x < size; x++) {
+        input >> loaded.At(x, z);
+      }
+    }
+  });
+  report->AddMeasure(textLoad);
+  report->AddMetric("Text Size", std::filesystem::file_size(textPath) / 1024.0, "KB");
+  std::filesystem::remove(textPath);
+
+  const std::pair<TerrainHeightMapFormat::Enum, TerrainHeightMapCompression::Enum> variants[] = {
+      {TerrainHeightMapFormat::eUNORM16, TerrainHeightMapCompression::eNONE},
+      {TerrainHeightMapFormat::eUNORM16, TerrainHeightMapCompression::eDELTA_LZ},
+      {TerrainHeightMapFormat::eFLOAT32, TerrainHeightMapCompression::eNONE},
+      {TerrainHeightMapFormat::eFLOAT32, TerrainHeightMapCompression::eDELTA_LZ}};
+
+  for (const auto& [format, compression] : variants) {
+    const String name =
+        TerrainHeightMapFormat::ToString(format) + " " + TerrainHeightMapCompression::ToString(compression);
+    const String path = (folder / ("YeagerTerrainHeightMap" YEAGER_TERRAIN_HEIGHTMAP_EXT_STR)).string();
+    TerrainHeightMapWriteSettings settings;
+    settings.Format = format;
+    settings.Compression = compression;
+
+    size_t bytes = 0;
+    BenchmarkMeasure save;
+    save.Name = "Terrain HeightMap Save " + name;
+    save.ItemsUnit = "samples";
+    save.Items = samples;
+    save.Threads = pool->GetConcurrency();
+    save.Seconds = Benchmark::MeasureBestSeconds(
+        3, [&]() { TerrainHeightMapFile::Write(path, heightMap.GetAddress(0, 0), info, settings, &bytes); });
+    report->AddMeasure(save);
+
+    Math::Array2D<float> loaded(size, size);
+    bool valid = true;
+    BenchmarkMeasure load = save;
+    load.Name = "Terrain HeightMap Load " + name;
+    load.Seconds = Benchmark::MeasureBestSeconds(5, [&]() {
+      TerrainHeightMapFile file;
+      valid = file.Open(path) && file.Read(&loaded, pool) && file.GetInfo().Seed == info.Seed;
+    });
+    report->AddMeasure(load);
+    report->AddMetric("Size " + name, bytes / 1024.0, "KB");
+    report->AddMetric("Bits Per Sample " + name, bytes * 8.0 / samples);
+
+    /* Float files are lossless, 16 bits ones are off by at most half a step of the quantization */
+    const float error = MaxDifference(&heightMap, &loaded, size);
+    const float tolerance =
+        format == TerrainHeightMapFormat::eFLOAT32 ? 0.0f : YEAGER_TERRAIN_HEIGHTMAP_BENCHMARK_HEIGHT / 65535.0f;
+    report->AddMetric("Max Error " + name, error);
+    if (!valid || error > tolerance) {
+      report->Fail("Terrain heightmap " + name + " does not load back what was saved!");
+    }
+    /* The samples must not be written past an array smaller than the file */
+    TerrainHeightMapFile reopened;
+    Math::Array2D<float> smaller(size / 2, size / 2);
+    if (!reopened.Open(path) || reopened.Read(&smaller, pool)) {
+      report->Fail("Terrain heightmap " + name + " was read into an array of another size!");
+    }
+    reopened.Close();
+    std::filesystem::remove(path);
+  }
+
+  /* Raw R16 round trip, the size is taken from the file */
+  const String rawPath = (folder / "YeagerTerrainHeightMap.r16").string();
+  int width = 0, height = 0;
+  std::shared_ptr<Math::Array2D<float>> imported;
+  if (TerrainHeightMapFile::ExportRaw16(rawPath, heightMap.GetAddress(0, 0), size, size, 0.0f,
+                                        YEAGER_TERRAIN_HEIGHTMAP_BENCHMARK_HEIGHT)) {
+    imported = TerrainHeightMapFile::ImportRaw16(rawPath, 0.0f, YEAGER_TERRAIN_HEIGHTMAP_BENCHMARK_HEIGHT, &width,
+                                                 &height);
+  }
+  if (!imported || width != size || height != size ||
+      MaxDifference(&heightMap, imported.get(), size) > YEAGER_TERRAIN_HEIGHTMAP_BENCHMARK_HEIGHT / 65535.0f) {
+    report->Fail("Terrain heightmap raw R16 import does not match the export!");
+  }
+  std::filesystem::remove(rawPath);
+}
+
+YEAGER_BENCHMARK_SUITE("TerrainHeightMap", TerrainHeightMapBenchmarkSuite);
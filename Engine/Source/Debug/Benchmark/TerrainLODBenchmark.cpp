@@ -0,0 +1,164 @@
+#include "Benchmark.h"
+#include "Components/TerrainGen/GradientNoise.h"
+#include "Components/TerrainGen/TerrainLOD.h"
+using namespace Yeager;
+
+#define YEAGER_TERRAIN_LOD_BENCHMARK_SIZE 2049
+#define YEAGER_TERRAIN_LOD_BENCHMARK_HEIGHT 256.0f
+
+/* Area of the heightmap drawn by the node, in samples */
+static void GetNodeArea(const TerrainLODNode& node, int* x, int* z, int* size)
+{
+  *size = node.Quadrant < 0 ? node.Size : node.Size / 2;
+  *x = node.X + (node.Quadrant < 0 ? 0 : (node.Quadrant & 1) * *size);
+  *z = node.Z + (node.Quadrant < 0 ? 0 : (node.Quadrant >> 1) * *size);
+}
+
+/* Every quad of the heightmap must be drawn by exactly one node */
+static bool CheckCoverage(const TerrainQuadtree& quadtree, const std::vector<TerrainLODNode>& selection)
+{
+  const int quadsX = quadtree.GetWidth() - 1;
+  const int quadsZ = quadtree.GetHeight() - 1;
+  std::vector<uint8_t> covered(static_cast<size_t>(quadsX) * quadsZ, 0);
+  for (const auto& node : selection) {
+    int x, z, size;
+    GetNodeArea(node, &x, &z, &size);
+    for (int row = z; row < std::min(z + size, quadsZ); row++) {
+      for (int column = x; column < std::min(x + size, quadsX); column++) {
+        covered[static_cast<size_t>(row) * quadsX + column]++;
+      }
+    }
+  }
+  return std::all_of(covered.begin(), covered.end(), [](uint8_t count) { return count == 1; });
+}
+
+/**
+ * Evaluates the borders of every node with the same morph of the shader, and returns the biggest difference of height
+ * between the two sides of a border at each sample. Zero means no cracks
+ */
+static float MeasureCrackError(const TerrainQuadtree& quadtree, const std::vector<TerrainLODNode>& selection,
+                               const TerrainLODView& view, const TerrainLODRanges& ranges)
+{
+  /* Key is the direction of the border, the line of it and the sample along it */
+  std::map<std::tuple<int, int, int>, Vector2> borders;
+
+  for (const auto& node : selection) {
+    int x, z, size;
+    GetNodeArea(node, &x, &z, &size);
+    const int step = 1 << node.Level;
+    const int vertices = size / step + 1;
+    const int gridX = (x - node.X) / step;
+    const int gridZ = (z - node.Z) / step;
+
+    for (int direction = 0; direction < 2; direction++) {
+      for (int side = 0; side < 2; side++) {
+        /* Direction 0 are the borders along X (bottom and top), 1 along Z (left and right) */
+        std::vector<Vector2> polyline;
+        for (int vertex = 0; vertex < vertices; vertex++) {
+          const int vx = direction == 0 ? gridX + vertex : gridX + side * (vertices - 1);
+          const int vz = direction == 0 ? gridZ + side * (vertices - 1) : gridZ + vertex;
+          const Vector3 position = quadtree.EvaluateVertex(node, vx, vz, view, ranges, 1.0f);
+          polyline.push_back(Vector2(direction == 0 ? position.x : position.z, position.y));
+        }
+
+        const int line = direction == 0 ? std::min(z + side * size, quadtree.GetHeight() - 1)
+                                        : std::min(x + side * size, quadtree.GetWidth() - 1);
+        const int begin = direction == 0 ? x : z;
+        const int end = std::min(begin + size, (direction == 0 ? quadtree.GetWidth() : quadtree.GetHeight()) - 1);
+        for (int sample = begin; sample <= end; sample++) {
+          for (size_t segment = 0; segment + 1 < polyline.size(); segment++) {
+            const Vector2& a = polyline[segment];
+            const Vector2& b = polyline[segment + 1];
+            if (b.x <= a.x || sample < a.x || sample > b.x) {
+              continue;
+            }
+            const float height = a.y + (b.y - a.y) * (sample - a.x) / (b.x - a.x);
+            auto found = borders.find({direction, line, sample});
+            if (found == borders.end()) {
+              borders[{direction, line, sample}] = Vector2(height, height);
+            } else {
+              found->second.x = std::min(found->second.x, height);
+              found->second.y = std::max(found->second.y, height);
+            }
+            break;
+          }
+        }
+      }
+    }
+  }
+
+  float error = 0.0f;
+  for (const auto& [key, heights] : borders) {
+    error = std::max(error, heights.y - heights.x);
+  }
+  return error;
+}
+
+static void TerrainLODBenchmarkSuite(BenchmarkReport* report)
+{
+  const int size = YEAGER_TERRAIN_LOD_BENCHMARK_SIZE;
+  const float half = YEAGER_TERRAIN_LOD_BENCHMARK_HEIGHT * 0.5f;
+  WorkerPool* pool = WorkerPool::GetGlobal();
+
+  Math::Array2D<float> heightMap(size, size);
+  NoiseFractalSettings noise;
+  noise.Octaves = 8;
+  noise.Frequency = 1.0f / 512.0f;
+  GradientNoise(1337).FillArray2D(&heightMap, 0, 0, size, size, noise, half, half, pool);
+
+  TerrainQuadtree quadtree;
+  const String name = std::to_string(size) + "x" + std::to_string(size);
+  BenchmarkMeasure build;
+  build.Name = "Terrain Quadtree Build " + name;
+  build.ItemsUnit = "samples";
+  build.Items = static_cast<double>(size) * size;
+  build.Threads = pool->GetConcurrency();
+  build.Seconds = Benchmark::MeasureBestSeconds(
+      3, [&]() { quadtree.Build(&heightMap, size, size, TerrainLODSettings(), pool); });
+  report->AddMeasure(build);
+  report->AddMetric("Levels", quadtree.GetLevelCount());
+  report->AddMetric("Coarsest Level Error", quadtree.GetLevelError(quadtree.GetLevelCount() - 1));
+
+  const double fullTriangles = static_cast<double>(size - 1) * (size - 1) * 2;
+  const std::vector<std::pair<String, Vector3>> cameras = {
+      {"Center", Vector3(size * 0.5f, YEAGER_TERRAIN_LOD_BENCHMARK_HEIGHT + 20.0f, size * 0.5f)},
+      {"Corner", Vector3(0.0f, YEAGER_TERRAIN_LOD_BENCHMARK_HEIGHT, 0.0f)},
+      {"High", Vector3(size * 0.5f, 3000.0f, size * 0.5f)},
+      {"Outside", Vector3(-500.0f, 200.0f, size * 1.5f)}};
+
+  for (const auto& [camera, position] : cameras) {
+    TerrainLODView view;
+    view.CameraPosition = position;
+    const TerrainLODRanges ranges = quadtree.ComputeRanges(view, 1.0f);
+
+    std::vector<TerrainLODNode> selection;
+    BenchmarkMeasure select;
+    select.Name = "Terrain LOD Select " + camera;
+    select.ItemsUnit = "selections";
+    select.Items = 1;
+    select.Seconds = Benchmark::MeasureBestSeconds(20, [&]() {
+      selection.clear();
+      quadtree.Select(view, 1.0f, ranges, &selection);
+    });
+    report->AddMeasure(select);
+
+    Uint triangles = 0;
+    for (const auto& node : selection) {
+      triangles += quadtree.GetTriangleCount(node);
+    }
+    report->AddMetric("Nodes " + camera, selection.size());
+    report->AddMetric("Triangles " + camera, triangles);
+    report->AddMetric("Triangles Of Full Resolution " + camera, 100.0 * triangles / fullTriangles, "%");
+
+    if (!CheckCoverage(quadtree, selection)) {
+      report->Fail("Terrain LOD selection of " + camera + " does not cover every quad exactly once!");
+    }
+    const float crack = MeasureCrackError(quadtree, selection, view, ranges);
+    report->AddMetric("Crack Error " + camera, crack);
+    if (crack > YEAGER_TERRAIN_LOD_BENCHMARK_HEIGHT * 1e-4f) {
+      report->Fail("Terrain LOD selection of " + camera + " has cracks between the nodes!");
+    }
+  }
+}
+
+YEAGER_BENCHMARK_SUITE("TerrainLOD", TerrainLODBenchmarkSuite);
@@ -0,0 +1,186 @@
+#include "Benchmark.h"
+#include "Components/TerrainGen/TerrainHeightField.h"
+#include <random>
+using namespace Yeager;
+
+#define YEAGER_TERRAIN_QUERY_BENCHMARK_SIZE 2049
+#define YEAGER_TERRAIN_QUERY_BENCHMARK_HEIGHT 256.0f
+#define YEAGER_TERRAIN_QUERY_BENCHMARK_POINTS 1000000
+#define YEAGER_TERRAIN_QUERY_BENCHMARK_RAYS 100000
+#define YEAGER_TERRAIN_QUERY_BENCHMARK_CHECKED_RAYS 1000
+
+/**
+ * Reference raycast without the pyramid, marches along the ray half a cell at a time and tests the cells around every
+ * step, until the steps are past the nearest hit found
+ */
+static bool RaycastReference(const TerrainHeightField& field, const TerrainRay& ray, TerrainRayHit* hit)
+{
+  const float scale = field.GetWorldScale();
+  const float extentX = (field.GetWidth() - 1) * scale;
+  const float extentZ = (field.GetHeight() - 1) * scale;
+  const float horizontal = std::sqrt(ray.Direction.x * ray.Direction.x + ray.Direction.z * ray.Direction.z);
+  const float step = horizontal > 0.0f ? scale * 0.5f / horizontal : ray.MaxDistance;
+  const float end = std::min(ray.MaxDistance, horizontal > 0.0f ? (extentX + extentZ) * 2.0f / horizontal : 0.0f);
+
+  float nearest = ray.MaxDistance;
+  bool found = false;
+  int lastX = INT_MIN, lastZ = INT_MIN;
+  for (float t = 0.0f; t <= end && t <= nearest + step; t += step) {
+    const int cellX = static_cast<int>(std::floor((ray.Origin.x + ray.Direction.x * t) / scale));
+    const int cellZ = static_cast<int>(std::floor((ray.Origin.z + ray.Direction.z * t) / scale));
+    if (cellX == lastX && cellZ == lastZ) {
+      continue;
+    }
+    lastX = cellX, lastZ = cellZ;
+    for (int z = std::max(cellZ - 1, 0); z <= std::min(cellZ + 1, field.GetHeight() - 2); z++) {
+      for (int x = std::max(cellX - 1, 0); x <= std::min(cellX + 1, field.GetWidth() - 2); x++) {
+        if (field.IntersectCell(ray, x, z, nearest, hit)) {
+          nearest = hit->Distance;
+          found = true;
+        }
+      }
+    }
+  }
+  return found;
+}
+
+/* Mostly picking rays looking down from above the terrain, some grazing ones and some going up into the sky */
+static std::vector<TerrainRay> GenerateRays(size_t count, float extent)
+{
+  std::mt19937 random(1337);
+  std::uniform_real_distribution<float> position(-0.25f * extent, 1.25f * extent);
+  std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+  std::vector<TerrainRay> rays(count);
+  for (auto& ray : rays) {
+    const float kind = unit(random);
+    const float yaw = unit(random) * 6.2831853f;
+    const float pitch = kind < 0.1f ? unit(random) * 0.5f : -(0.05f + unit(random) * 1.5f);
+    ray.Origin = Vector3(position(random), YEAGER_TERRAIN_QUERY_BENCHMARK_HEIGHT + unit(random) * 200.0f,
+                         position(random));
+    ray.Direction = Vector3(std::cos(yaw) * std::cos(pitch), std::sin(pitch), std::sin(yaw) * std::cos(pitch));
+  }
+  return rays;
+}
+
+static void TerrainQueryBenchmarkSuite(BenchmarkReport* report)
+{
+  const int size = YEAGER_TERRAIN_QUERY_BENCHMARK_SIZE;
+  const float half = YEAGER_TERRAIN_QUERY_BENCHMARK_HEIGHT * 0.5f;
+  WorkerPool* pool = WorkerPool::GetGlobal();
+
+  Math::Array2D<float> heightMap(size, size);
+  NoiseFractalSettings noise;
+  noise.Octaves = 8;
+  noise.Frequency = 1.0f / 512.0f;
+  GradientNoise(1337).FillArray2D(&heightMap, 0, 0, size, size, noise, half, half, pool);
+
+  TerrainHeightField field;
+  BenchmarkMeasure build;
+  build.Name = "Terrain Height Field Build";
+  build.ItemsUnit = "samples";
+  build.Items = static_cast<double>(size) * size;
+  build.Threads = pool->GetConcurrency();
+  build.Seconds = Benchmark::MeasureBestSeconds(3, [&]() { field.Build(&heightMap, size, size, 1.0f, pool); });
+  report->AddMeasure(build);
+  report->AddMetric("Pyramid Levels", field.GetLevelCount());
+
+  const size_t points = YEAGER_TERRAIN_QUERY_BENCHMARK_POINTS;
+  std::mt19937 random(7);
+  std::uniform_real_distribution<float> position(0.0f, size - 1.0f);
+  std::vector<float> x(points), z(points);
+  for (size_t point = 0; point < points; point++) {
+    x[point] = position(random);
+    z[point] = position(random);
+  }
+
+  std::vector<float> heights(points), scalarHeights(points);
+  std::vector<Vector3> normals(points), scalarNormals(points);
+  const NoiseSIMDPath::Enum best = GradientNoise::GetBestSIMDPath();
+  for (const auto path : {NoiseSIMDPath::eSIMD_SCALAR, best}) {
+    if (path == NoiseSIMDPath::eSIMD_SSE41 || (path == best && best == NoiseSIMDPath::eSIMD_SCALAR)) {
+      continue;
+    }
+    field.SetSIMDPath(path);
+    const bool scalar = path == NoiseSIMDPath::eSIMD_SCALAR;
+    float* heightOutput = scalar ? scalarHeights.data() : heights.data();
+    Vector3* normalOutput = scalar ? scalarNormals.data() : normals.data();
+
+    BenchmarkMeasure height;
+    height.Name = "Terrain Height Queries " + NoiseSIMDPath::ToString(path);
+    height.ItemsUnit = "queries";
+    height.Items = points;
+    height.Seconds =
+        Benchmark::MeasureBestSeconds(5, [&]() { field.SampleHeights(x.data(), z.data(), heightOutput, points); });
+    report->AddMeasure(height);
+
+    BenchmarkMeasure normal;
+    normal.Name = "Terrain Normal Queries " + NoiseSIMDPath::ToString(path);
+    normal.ItemsUnit = "queries";
+    normal.Items = points;
+    normal.Seconds =
+        Benchmark::MeasureBestSeconds(5, [&]() { field.SampleNormals(x.data(), z.data(), normalOutput, points); });
+    report->AddMeasure(normal);
+  }
+
+  if (best == NoiseSIMDPath::eSIMD_AVX2) {
+    if (std::memcmp(heights.data(), scalarHeights.data(), sizeof(float) * points) != 0 ||
+        std::memcmp(normals.data(), scalarNormals.data(), sizeof(Vector3) * points) != 0) {
+      report->Fail("Terrain batch queries of the AVX2 path differ from the scalar path!");
+    }
+  }
+
+  const float extent = (size - 1) * field.GetWorldScale();
+  const std::vector<TerrainRay> rays = GenerateRays(YEAGER_TERRAIN_QUERY_BENCHMARK_RAYS, extent);
+  std::vector<TerrainRayHit> hits(rays.size());
+  std::vector<uint8_t> hitFound(rays.size());
+
+  BenchmarkMeasure raycast;
+  raycast.Name = "Terrain Raycast";
+  raycast.ItemsUnit = "rays";
+  raycast.Items = rays.size();
+  raycast.Seconds = Benchmark::MeasureBestSeconds(3, [&]() {
+    for (size_t ray = 0; ray < rays.size(); ray++) {
+      hitFound[ray] = field.Raycast(rays[ray], &hits[ray]);
+    }
+  });
+  report->AddMeasure(raycast);
+
+  BenchmarkMeasure parallel = raycast;
+  parallel.Name = "Terrain Raycast Parallel";
+  parallel.Threads = pool->GetConcurrency();
+  parallel.Seconds = Benchmark::MeasureBestSeconds(3, [&]() {
+    pool->ParallelFor(0, rays.size(), 1024, [&](size_t begin, size_t end) {
+      for (size_t ray = begin; ray < end; ray++) {
+        hitFound[ray] = field.Raycast(rays[ray], &hits[ray]);
+      }
+    });
+  });
+  report->AddMeasure(parallel);
+  report->AddMetric("Rays Hit", 100.0 * std::count(hitFound.begin(), hitFound.end(), 1) / rays.size(), "%");
+
+  /* The march visits every cell along the ray, the pyramid must find the same nearest hit */
+  const size_t checked = YEAGER_TERRAIN_QUERY_BENCHMARK_CHECKED_RAYS;
+  size_t mismatches = 0;
+  BenchmarkMeasure reference;
+  reference.Name = "Terrain Raycast Reference March";
+  reference.ItemsUnit = "rays";
+  reference.Items = checked;
+  reference.Seconds = Benchmark::MeasureBestSeconds(1, [&]() {
+    mismatches = 0;
+    for (size_t ray = 0; ray < checked; ray++) {
+      TerrainRayHit expected;
+      const bool found = RaycastReference(field, rays[ray], &expected);
+      if (found != static_cast<bool>(hitFound[ray]) ||
+          (found && std::fabs(expected.Distance - hits[ray].Distance) > 1e-3f * std::max(1.0f, expected.Distance))) {
+        mismatches++;
+      }
+    }
+  });
+  report->AddMeasure(reference);
+  report->AddMetric("Raycast Mismatches", mismatches);
+  if (mismatches > 0) {
+    report->Fail("Terrain raycast differs from the reference march in " + std::to_string(mismatches) + " rays!");
+  }
+}
+
+YEAGER_BENCHMARK_SUITE("TerrainQuery", TerrainQueryBenchmarkSuite);
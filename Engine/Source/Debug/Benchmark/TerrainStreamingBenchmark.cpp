@@ -0,0 +1,98 @@
+#include "Benchmark.h"
+#include "Components/TerrainGen/TerrainChunkManager.h"
+using namespace Yeager;
+
+#define YEAGER_TERRAIN_STREAMING_FRAMES 2000
+#define YEAGER_TERRAIN_STREAMING_BUILD_CHUNKS 64
+
+/* The border of a chunk must match its neighbours bit by bit, heights and normals */
+static bool CheckChunkEdges(const GradientNoise& noise, const TerrainStreamingSettings& settings)
+{
+  const int side = settings.ChunkQuads + 1;
+  const auto chunk = TerrainChunkBuilder::Build(noise, settings, TerrainChunkCoord{-3, 7});
+  const auto right = TerrainChunkBuilder::Build(noise, settings, TerrainChunkCoord{-2, 7});
+  const auto up = TerrainChunkBuilder::Build(noise, settings, TerrainChunkCoord{-3, 8});
+
+  auto equal = [](const TerrainVertex& a, const TerrainVertex& b) {
+    return a.Position.y == b.Position.y && std::memcmp(&a.Normals, &b.Normals, sizeof(Vector3)) == 0;
+  };
+  for (int x = 0; x < side; x++) {
+    if (!equal(chunk->Vertices[x * side + side - 1], right->Vertices[x * side]) ||
+        !equal(chunk->Vertices[(side - 1) * side + x], up->Vertices[x])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void TerrainStreamingBenchmarkSuite(BenchmarkReport* report)
+{
+  TerrainStreamingSettings settings;
+  settings.Seed = 1337;
+  settings.UploadToGPU = false;
+
+  GradientNoise noise(settings.Seed);
+  if (!CheckChunkEdges(noise, settings)) {
+    report->Fail("Terrain chunk borders differ from their neighbours!");
+  }
+
+  const int side = settings.ChunkQuads + 1;
+  BenchmarkMeasure build;
+  build.Name = "Terrain Chunk Build";
+  build.ItemsUnit = "vertices";
+  build.Items = static_cast<double>(side) * side * YEAGER_TERRAIN_STREAMING_BUILD_CHUNKS;
+  build.Seconds = Benchmark::MeasureBestSeconds(3, [&]() {
+    for (int x = 0; x < YEAGER_TERRAIN_STREAMING_BUILD_CHUNKS; x++) {
+      TerrainChunkBuilder::Build(noise, settings, TerrainChunkCoord{x, -x});
+    }
+  });
+  report->AddMeasure(build);
+
+  /* The camera flies away from the origin and back, the way back comes through the chunks cached in the LRU */
+  TerrainChunkManager manager(settings);
+  const float speed = settings.GetChunkWorldSize() / 16.0f;
+  double updateSeconds = 0.0, slowestUpdate = 0.0;
+  size_t peakMemory = 0;
+  Uint peakResident = 0;
+  for (int frame = 0; frame < YEAGER_TERRAIN_STREAMING_FRAMES; frame++) {
+    const int half = YEAGER_TERRAIN_STREAMING_FRAMES / 2;
+    const float distance = (frame < half ? frame : YEAGER_TERRAIN_STREAMING_FRAMES - frame) * speed;
+
+    const double seconds =
+        Benchmark::MeasureBestSeconds(1, [&]() { manager.Update(Vector3(distance, 0.0f, distance * 0.5f)); });
+    updateSeconds += seconds;
+    slowestUpdate = std::max(slowestUpdate, seconds);
+
+    const TerrainStreamingStats& stats = manager.GetStats();
+    peakMemory = std::max(peakMemory, stats.MemoryBytes);
+    peakResident = std::max(peakResident, stats.ResidentChunks);
+    if (stats.RequestedThisFrame > settings.GenerationBudget) {
+      report->Fail("Terrain streaming requested more chunks than the generation budget in a frame!");
+    }
+
+    /* Gives the workers the time of a frame */
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  manager.WaitForChunksInFlight();
+
+  BenchmarkMeasure update;
+  update.Name = "Terrain Streaming Update";
+  update.ItemsUnit = "frames";
+  update.Items = YEAGER_TERRAIN_STREAMING_FRAMES;
+  update.Seconds = updateSeconds;
+  report->AddMeasure(update);
+
+  const TerrainStreamingStats& stats = manager.GetStats();
+  report->AddMetric("Slowest Update", slowestUpdate * 1000.0, "ms");
+  report->AddMetric("Chunks Generated", stats.TotalGenerated);
+  report->AddMetric("Cache Hits", stats.CacheHits);
+  report->AddMetric("Peak Resident Chunks", peakResident);
+  report->AddMetric("Peak Memory", peakMemory / 1024.0, "KB");
+  report->AddMetric("Memory Bound", manager.GetMemoryBound() / 1024.0, "KB");
+
+  if (peakMemory > manager.GetMemoryBound()) {
+    report->Fail("Terrain streaming memory went over the bound of the settings!");
+  }
+}
+
+YEAGER_BENCHMARK_SUITE("TerrainStreaming", TerrainStreamingBenchmarkSuite);
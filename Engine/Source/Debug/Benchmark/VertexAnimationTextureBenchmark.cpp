@@ -0,0 +1,215 @@
+#include "Benchmark.h"
+#include "Components/Kernel/Caching/Cache.h"
+#include "Components/Renderer/AnimationEngine/AnimationEngine.h"
+#include "Components/Renderer/AnimationEngine/VertexAnimationTexture.h"
+using namespace Yeager;
+
+#define YEAGER_VAT_BENCHMARK_VERTICES 3000
+#define YEAGER_VAT_BENCHMARK_DURATION 2.0f
+/* Small on purpose, so every frame wraps in many rows like the meshes bigger than the real max width */
+#define YEAGER_VAT_BENCHMARK_WIDTH 64
+
+/* Bone 0 slides along X and bone 1 turns around Y, both are closed forms of the time */
+static float SlideOf(float seconds)
+{
+  return 2.0f * std::sin(seconds * 3.0f);
+}
+
+static float AngleOf(float seconds)
+{
+  return seconds * 1.5f;
+}
+
+static Vector3 TurnAroundY(const Vector3& value, float angle)
+{
+  return Vector3(value.x * std::cos(angle) + value.z * std::sin(angle), value.y,
+                 -value.x * std::sin(angle) + value.z * std::cos(angle));
+}
+
+/* Every third vertex follows bone 0, bone 1 or half of each */
+static std::vector<AnimatedVertexData> BuildVertices()
+{
+  std::vector<AnimatedVertexData> vertices(YEAGER_VAT_BENCHMARK_VERTICES);
+  for (Uint x = 0; x < vertices.size(); x++) {
+    AnimatedVertexData& vertex = vertices[x];
+    vertex.Position = Vector3(std::sin(x * 0.37f) * 3.0f, x * 0.001f, std::cos(x * 0.53f) * 3.0f);
+    vertex.Normals = glm::normalize(Vector3(std::cos(x * 0.11f), 0.5f, std::sin(x * 0.11f)));
+    for (Uint influence = 0; influence < MAX_BONE_INFLUENCE; influence++) {
+      vertex.BonesIDs[influence] = -1;
+      vertex.Weights[influence] = 0.0f;
+    }
+    if (x % 3 == 2) {
+      vertex.BonesIDs[0] = 0;
+      vertex.BonesIDs[1] = 1;
+      vertex.Weights[0] = 0.5f;
+      vertex.Weights[1] = 0.5f;
+    } else {
+      vertex.BonesIDs[0] = x % 3;
+      vertex.Weights[0] = 1.0f;
+    }
+  }
+  return vertices;
+}
+
+/* The pose of the vertex without the skinning, the weights of the vertices are known */
+static void ReferencePose(const AnimatedVertexData& vertex, Uint index, float seconds, Vector3* position,
+                          Vector3* normal)
+{
+  const Vector3 slid = vertex.Position + Vector3(SlideOf(seconds), 0.0f, 0.0f);
+  const Vector3 turned = TurnAroundY(vertex.Position, AngleOf(seconds));
+  const Vector3 turnedNormal = TurnAroundY(vertex.Normals, AngleOf(seconds));
+  switch (index % 3) {
+    case 0:
+      *position = slid;
+      *normal = vertex.Normals;
+      break;
+    case 1:
+      *position = turned;
+      *normal = turnedNormal;
+      break;
+    default:
+      *position = (slid + turned) * 0.5f;
+      *normal = glm::normalize(vertex.Normals + turnedNormal);
+      break;
+  }
+}
+
+static Vector3 ReadTexel(const std::vector<float>& texels, Uint width, Uint rowsPerFrame, Uint frame, Uint vertex)
+{
+  /* The texel fetched by TexelOf in SimpleInstancedVAT.vert */
+  const size_t column = vertex % width;
+  const size_t row = static_cast<size_t>(frame) * rowsPerFrame + vertex / width;
+  const size_t index = (row * width + column) * 3;
+  return Vector3(texels[index], texels[index + 1], texels[index + 2]);
+}
+
+/* A clip moving the root 10 units in 10 ticks, without ticks per second like the files of some exporters */
+static aiScene* BuildClipWithoutRate()
+{
+  aiScene* scene = new aiScene();
+  scene->mRootNode = new aiNode("Root");
+
+  aiNodeAnim* node = new aiNodeAnim();
+  node->mNodeName = aiString("Root");
+  node->mNumPositionKeys = 2;
+  node->mPositionKeys = new aiVectorKey[2];
+  node->mPositionKeys[0] = aiVectorKey(0.0, aiVector3D(0.0f));
+  node->mPositionKeys[1] = aiVectorKey(10.0, aiVector3D(10.0f, 0.0f, 0.0f));
+  node->mNumRotationKeys = 1;
+  node->mRotationKeys = new aiQuatKey[1]{aiQuatKey(0.0, aiQuaternion())};
+  node->mNumScalingKeys = 1;
+  node->mScalingKeys = new aiVectorKey[1]{aiVectorKey(0.0, aiVector3D(1.0f))};
+
+  aiAnimation* animation = new aiAnimation();
+  animation->mName = aiString("NoRate");
+  animation->mDuration = 10.0;
+  animation->mTicksPerSecond = 0.0;
+  animation->mNumChannels = 1;
+  animation->mChannels = new aiNodeAnim*[1]{node};
+
+  scene->mNumAnimations = 1;
+  scene->mAnimations = new aiAnimation*[1]{animation};
+  return scene;
+}
+
+/* The animator must play the clip at the default rate, a rate of 0 bakes every frame at the first tick */
+static bool BakesClipWithoutRate(const std::vector<AnimatedVertexData>& vertices)
+{
+  const std::filesystem::path folder = std::filesystem::temp_directory_path();
+  const String sourcePath = (folder / "YeagerVATNoRateSource.fbx").string();
+  const String path = (folder / ("YeagerVATNoRate" YEAGER_ANIMATION_CLIP_CACHE_EXT_STR)).string();
+
+  aiScene* scene = BuildClipWithoutRate();
+  const bool written = AnimationClipCompiler::Compile(scene, sourcePath, path);
+  delete scene;
+
+  auto file = BaseAllocator::MakeSharedPtr<AnimationClipFile>();
+  if (!written || !file->Load(path, CreateFileHash(sourcePath), AnimationClipFile::GetSourceTimestamp(sourcePath)))
+    return false;
+
+  auto set = BaseAllocator::MakeSharedPtr<AnimationClipSet>();
+  set->Skeleton = AnimationSkeleton::Build(*file);
+  set->Animations.push_back(Animation(file, 0));
+  set->Animations[0].BindSkeleton(set->Skeleton);
+  std::map<String, BoneInfo> boneInfoMap;
+  boneInfoMap["Root"].ID = 0;
+
+  AnimationEngine engine;
+  engine.LoadClipSet(set, boneInfoMap);
+  const std::vector<const std::vector<AnimatedVertexData>*> meshes = {&vertices};
+  const auto data = VertexAnimationTextureBaker::BakeClip(meshes, &engine, 0);
+
+  std::error_code error;
+  std::filesystem::remove(path, error);
+
+  /* Vertex 0 follows bone 0 only, the root */
+  const float expectedDuration = 10.0f / YEAGER_ANIMATION_DEFAULT_TICKS_PER_SECOND;
+  return data.has_value() && std::abs(data->Duration - expectedDuration) < 1e-5f && data->FrameCount > 1 &&
+         ReadTexel(data->Positions, data->Width, data->RowsPerFrame, 0, 0) !=
+             ReadTexel(data->Positions, data->Width, data->RowsPerFrame, 1, 0);
+}
+
+static void VertexAnimationTextureBenchmarkSuite(BenchmarkReport* report)
+{
+  /* Two meshes, the second starts at a vertex offset inside a row */
+  const std::vector<AnimatedVertexData> vertices = BuildVertices();
+  const std::vector<AnimatedVertexData> first(vertices.begin(), vertices.begin() + vertices.size() / 3 + 1);
+  const std::vector<AnimatedVertexData> second(vertices.begin() + first.size(), vertices.end());
+  const std::vector<const std::vector<AnimatedVertexData>*> meshes = {&first, &second};
+
+  const VertexAnimationPoseSampler sampler = [](float seconds, std::vector<Matrix4>* bones) {
+    bones->assign(2, Matrix4(1.0f));
+    (*bones)[0] = glm::translate(Matrix4(1.0f), Vector3(SlideOf(seconds), 0.0f, 0.0f));
+    (*bones)[1] = glm::rotate(Matrix4(1.0f), AngleOf(seconds), Vector3(0.0f, 1.0f, 0.0f));
+    return true;
+  };
+
+  VertexAnimationTextureBakeSettings settings;
+  settings.MaxWidth = YEAGER_VAT_BENCHMARK_WIDTH;
+  std::optional<VertexAnimationTextureData> data;
+  BenchmarkMeasure bake;
+  bake.Name = "Vertex Animation Texture Bake";
+  bake.ItemsUnit = "vertices";
+  bake.Seconds = Benchmark::MeasureBestSeconds(3, [&]() {
+    data = VertexAnimationTextureBaker::BakeMeshes(meshes, YEAGER_VAT_BENCHMARK_DURATION, sampler, settings);
+  });
+  if (!data.has_value()) {
+    report->Fail("Vertex animation texture cannot be baked!");
+    return;
+  }
+  bake.Items = static_cast<double>(data->VertexCount) * data->FrameCount;
+  report->AddMeasure(bake);
+  report->AddMetric("Frames", data->FrameCount);
+  report->AddMetric("Texture Size", data->GetMemorySize() / 1024.0, "KB");
+
+  if (data->Width != YEAGER_VAT_BENCHMARK_WIDTH || data->VertexCount != vertices.size() ||
+      data->MeshVertexOffsets != std::vector<Uint>{0, static_cast<Uint>(first.size())}) {
+    report->Fail("Vertex animation texture layout does not match the meshes!");
+    return;
+  }
+
+  float positionError = 0.0f;
+  float normalError = 0.0f;
+  for (Uint frame = 0; frame < data->FrameCount; frame++) {
+    const float seconds = frame / data->SampleRate;
+    for (Uint vertex = 0; vertex < vertices.size(); vertex++) {
+      Vector3 position, normal;
+      ReferencePose(vertices[vertex], vertex, seconds, &position, &normal);
+      const Vector3 baked = ReadTexel(data->Positions, data->Width, data->RowsPerFrame, frame, vertex);
+      const Vector3 bakedNormal = ReadTexel(data->Normals, data->Width, data->RowsPerFrame, frame, vertex);
+      positionError = std::max(positionError, glm::length(baked - position));
+      normalError = std::max(normalError, glm::length(bakedNormal - normal));
+    }
+  }
+  report->AddMetric("Max Position Error", positionError, "units");
+  report->AddMetric("Max Normal Error", normalError);
+  if (positionError > 1e-4f || normalError > 1e-4f) {
+    report->Fail("Vertex animation texture does not match the reference pose!");
+  }
+
+  if (!BakesClipWithoutRate(vertices)) {
+    report->Fail("Vertex animation texture of a clip without ticks per second does not move!");
+  }
+}
+
+YEAGER_BENCHMARK_SUITE("VertexAnimationTexture", VertexAnimationTextureBenchmarkSuite);
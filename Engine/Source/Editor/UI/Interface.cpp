@@ -2,6 +2,8 @@
 #include "Common/Math/Mathematics.h"
 #include "Common/Utils/Common.h"
 #include "Explorer.h"
+#include "Components/Renderer/AnimationEngine/AnimationEngine.h"
+#include "Components/TerrainGen/TerrainLOD.h"
 #include "Main/Core/Application.h"
 #include "Main/IO/InputHandle.h"
 #include "Main/IO/Serialization.h"
@@ -1043,6 +1045,32 @@ void Interface::RenderDebugger()
 
   Separator();
 
+  /* Animation level of detail, thresholds can be changed in runtime */
+  AnimationLODSettings* lod = AnimationEngine::GetLODSettings();
+  const AnimationLODFrameStats& lodStats = AnimationEngine::GetLODFrameStats();
+  Checkbox(locale.Translate("Debug.Dev.Anim.LOD.Enabled.Chk").c_str(), &lod->Enabled);
+  Checkbox(locale.Translate("Debug.Dev.Anim.LOD.Interpolate.Chk").c_str(), &lod->InterpolateBetweenUpdates);
+  DragFloat(locale.Translate("Debug.Dev.Anim.LOD.Near.Distance.Txt").c_str(), &lod->NearDistance, 1.0f, 0.0f, 10000.0f);
+  DragFloat(locale.Translate("Debug.Dev.Anim.LOD.Medium.Distance.Txt").c_str(), &lod->MediumDistance, 1.0f, 0.0f,
+            10000.0f);
+  DragFloat(locale.Translate("Debug.Dev.Anim.LOD.Far.Distance.Txt").c_str(), &lod->FarDistance, 1.0f, 0.0f, 10000.0f);
+  DragFloat(locale.Translate("Debug.Dev.Anim.LOD.Skip.Bones.Distance.Txt").c_str(),
+            &lod->SkipLowImportanceBonesDistance, 1.0f, 0.0f, 10000.0f);
+  Text("%s %u", locale.Translate("Debug.Dev.Anim.LOD.Bones.Evaluated.Txt").c_str(), lodStats.BonesEvaluated);
+  Text("%s %u (%u / %u)", locale.Translate("Debug.Dev.Anim.LOD.Bones.Saved.Txt").c_str(), lodStats.BonesSaved(),
+       lodStats.BonesSavedByRate, lodStats.BonesSavedByImportance);
+  Text("%s %u / %u", locale.Translate("Debug.Dev.Anim.LOD.Animators.Txt").c_str(), lodStats.AnimatorsEvaluated,
+       lodStats.AnimatorsInterpolated);
+  Text("%s %u (%zu KB)", locale.Translate("Debug.Dev.Anim.Clip.Sets.Txt").c_str(),
+       AnimationLibrary::GetLoadedClipSetsCount(), AnimationLibrary::GetLoadedClipSetsMemory() / 1024);
+
+  const TerrainLODFrameStats& terrainStats = TerrainLODRenderer::GetFrameStats();
+  Text("%s %u", locale.Translate("Debug.Dev.Terrain.LOD.Nodes.Txt").c_str(), terrainStats.NodesDrawn);
+  Text("%s %u / %u", locale.Translate("Debug.Dev.Terrain.LOD.Triangles.Txt").c_str(), terrainStats.TrianglesDrawn,
+       terrainStats.TrianglesFullResolution);
+
+  Separator();
+
   Text("%s %u", locale.Translate("Debug.Dev.Frames.Txt").c_str(), m_Frames);
   if (m_Application->GetMode() == ApplicationMode::eAPPLICATION_EDITOR) {
     /* Prevent the calculation of dividing itself by 0 */
@@ -1241,6 +1269,68 @@ void Interface::PhysXHandleControlWindow()
       handle->GetPxScene()->getNbActors(physx::PxActorTypeFlag::eRIGID_DYNAMIC | physx::PxActorTypeFlag::eRIGID_STATIC);
   Text("Count of actors in PhysX Scene %d", actorNum);
   Text("Count of actors loaded in Yeager Engine %d", handle->GetActorsHandle()->size());
+  Text("Time waiting for the step %.3f ms", handle->GetLastFetchWaitSeconds() * 1000.0f);
+  Text("Dynamic actors moved in the last step %d of %d", handle->GetActivePoseCount(), handle->GetDynamicPoseCount());
+
+  PhysXFixedStep* fixedStep = handle->GetFixedStep();
+  float stepRate = fixedStep->GetStepRate();
+  if (SliderFloat("Step rate (Hz)", &stepRate, YEAGER_PHYSX_MIN_STEP_RATE, 240.0f, "%.0f")) {
+    fixedStep->SetStepRate(stepRate);
+  }
+  int maxSubsteps = fixedStep->GetMaxSubsteps();
+  if (SliderInt("Max substeps", &maxSubsteps, 1, 16)) {
+    fixedStep->SetMaxSubsteps(maxSubsteps);
+  }
+  bool interpolation = handle->IsInterpolationEnabled();
+  if (Checkbox("Interpolate the rendered poses", &interpolation)) {
+    handle->SetInterpolationEnabled(interpolation);
+  }
+  Text("Steps in the last frame %d, alpha %.2f, time dropped %.2f s", handle->GetLastFrameSteps(),
+       handle->GetInterpolationAlpha(), fixedStep->GetDroppedSeconds());
+  PhysXCpuDispatcher* dispatcher = handle->GetCpuDispatcher();
+  int maxThreads = dispatcher->GetMaxThreads();
+  if (SliderInt("Step threads (0 is every worker)", &maxThreads, 0, dispatcher->GetWorkerPool()->GetWorkersCount())) {
+    dispatcher->SetMaxThreads(maxThreads);
+  }
+  const PhysXCpuDispatcherStats dispatcherStats = dispatcher->GetStats();
+  Text("Tasks run %llu, most at once %d", static_cast<unsigned long long>(dispatcherStats.Tasks),
+       dispatcherStats.PeakRunning);
+  const PhysXMaterialCacheStats materials = handle->GetMaterialCache()->GetStats();
+  Text("Count of materials in PhysX %d (%d shared by the cache, %d references)",
+       handle->GetPxPhysics()->getNbMaterials(), materials.Materials, materials.References);
+  Text("Count of named physics materials %d", materials.NamedMaterials);
+
+  const PhysXAllocatorStats memory = handle->GetPxAllocator()->GetStats();
+  if (TreeNode("Memory")) {
+    Text("Live %.2f MB, peak %.2f MB, %llu live allocations", memory.LiveBytes / (1024.0 * 1024.0),
+         memory.PeakBytes / (1024.0 * 1024.0), static_cast<unsigned long long>(memory.LiveAllocations));
+    Text("Pools %.2f MB (%.2f MB used), large blocks %.2f MB", memory.PooledBytes / (1024.0 * 1024.0),
+         memory.PooledBytesUsed / (1024.0 * 1024.0), memory.LargeBytes / (1024.0 * 1024.0));
+    const MemoryTagStats& tag = BaseAllocator::GetTagStats(MemoryTag::ePHYSX);
+    Text("Engine allocator, PhysX tag %.2f MB (peak %.2f MB)", tag.mLiveBytes.load() / (1024.0 * 1024.0),
+         tag.mPeakBytes.load() / (1024.0 * 1024.0));
+    if (BeginTable("PhysX Allocation Names", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_ScrollY,
+                   ImVec2(0.0f, 200.0f))) {
+      TableSetupColumn("Name");
+      TableSetupColumn("Live KB");
+      TableSetupColumn("Peak KB");
+      TableSetupColumn("Allocations");
+      TableHeadersRow();
+      for (const PhysXAllocationNameStats& name : handle->GetPxAllocator()->GetNameStats()) {
+        TableNextRow();
+        TableNextColumn();
+        TextUnformatted(name.Name.c_str());
+        TableNextColumn();
+        Text("%.1f", name.LiveBytes / 1024.0);
+        TableNextColumn();
+        Text("%.1f", name.PeakBytes / 1024.0);
+        TableNextColumn();
+        Text("%llu", static_cast<unsigned long long>(name.LiveAllocations));
+      }
+      EndTable();
+    }
+    TreePop();
+  }
 
   Separator();
 
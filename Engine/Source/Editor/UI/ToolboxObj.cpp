@@ -1,5 +1,6 @@
 #include "ToolboxObj.h"
 #include "Components/Renderer/AnimationEngine/AnimationEngine.h"
+#include "Components/Renderer/AnimationEngine/VertexAnimationTexture.h"
 #include "Components/Renderer/Objects/Object.h"
 #include "Components/Renderer/Skybox/Skybox.h"
 #include "Components/Renderer/Texture/TextureHandle.h"
@@ -215,12 +216,23 @@ void ToolboxHandle::DrawToolboxObjectAnimated()
   Yeager::AnimatedObject* obj = static_cast<Yeager::AnimatedObject*>(m_EntityPtr);
   if (obj->IsLoaded()) {
     for (auto& animation : *obj->GetAnimationEngine()->GetAnimations()) {
+      PushID(animation.GetIndex());
       Text("Name: %s", animation.GetName().c_str());
       Text("Duration: %f", animation.GetDuration());
       if (Button("Play")) {
         Uint index = animation.GetIndex();
         obj->GetAnimationEngine()->PlayAnimation(index);
       }
+      if (obj->IsInstanced()) {
+        SameLine();
+        if (Button("Bake Crowd")) {
+          obj->BuildVertexAnimationTexture(animation.GetIndex(), VertexAnimationTextureBakeSettings());
+        }
+      }
+      PopID();
+    }
+    if (obj->HasVertexAnimationTexture()) {
+      Text("Instances drawn from baked vertex animation texture");
     }
   }
 }
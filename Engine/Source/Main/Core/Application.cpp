@@ -400,7 +400,7 @@ void ApplicationCore::UpdateTheEngine()
   auto light = BaseAllocator::MakeSharedPtr<PhysicalLightHandle>(
       EntityBuilder(this, "main"),
       std::vector<Shader*>{ShaderFromVarName("Simple"), ShaderFromVarName("SimpleAnimated"),
-                           ShaderFromVarName("TerrainGeneration")},
+                           ShaderFromVarName("TerrainGeneration"), ShaderFromVarName("TerrainCDLOD")},
       ShaderFromVarName("Light"));
   light->SetCanBeSerialize(false);
   light->GetDirectionalLight()->Ambient = Vector3(1);
@@ -417,6 +417,10 @@ void ApplicationCore::UpdateTheEngine()
     OpenGLClear();
 
     mInterface->InitRenderFrame();
+
+    /* Fetches the step started in the last frame and publishes its poses, from here to StartSimulation the scene can
+     * be changed freely */
+    mPhysXHandle->EndSimulation();
     mScene->CheckThreadsAndTriggerActions();
 
     UpdateDeltaTime();
@@ -426,9 +430,11 @@ void ApplicationCore::UpdateTheEngine()
     UpdateCamera();
 
     mAudioEngine->Engine->update();
+    GetInput()->ProcessInputRender(GetWindow(), mDeltaTime);
 
+    /* Runs the fixed steps the frame time adds up to, the last one runs in the PhysX workers while the frame is drawn
+     * with the poses of the previous frame */
     mPhysXHandle->StartSimulation(mDeltaTime);
-    mPhysXHandle->EndSimulation();
 
     DrawObjects();
     BuildAndDrawLightSources();
@@ -437,7 +443,6 @@ void ApplicationCore::UpdateTheEngine()
 
     GetInterface()->RenderUI();
     GetScene()->CheckScheduleDeletions();
-    GetInput()->ProcessInputRender(GetWindow(), mDeltaTime);
     mRequest->HandleRequests();
 
     IntervalElapsedTimeManager::EndTimeInterval("Application Frame");
@@ -513,9 +518,19 @@ void ApplicationCore::DrawObjects()
     }
   }
 
+  AnimationEngine::ResetLODFrameStats();
+  TerrainLODRenderer::ResetFrameStats();
+  const Matrix4 viewProjection = mWorldMatrices.mProjection * mWorldMatrices.mView;
+
   for (const auto& obj : *GetScene()->GetAnimatedObject()) {
     Shader* shader = YEAGER_NULLPTR;
 
+    if (obj->IsInstanced() && obj->HasVertexAnimationTexture()) {
+      /* Baked crowds dont need any animation work in the CPU */
+      obj->DrawVertexAnimated(ShaderFromVarName("SimpleInstancedVAT"), mDeltaTime);
+      continue;
+    }
+
     if (obj->IsInstanced()) {
       shader = ShaderFromVarName("SimpleInstancedAnimated");
     } else {
@@ -523,7 +538,7 @@ void ApplicationCore::DrawObjects()
     }
 
     shader->UseShader();
-    obj->UpdateAnimation(mDeltaTime);
+    obj->UpdateAnimation(mDeltaTime, mWorldMatrices.mViewerPos, viewProjection);
     obj->BuildAnimationMatrices(shader);
     obj->Draw(shader);
   }
@@ -20,10 +20,18 @@
 #include "Common/Utils/Common.h"
 #include "Main/Core/Application.h"
 #include "Common/Utils/Utilities.h"
+#include "Debug/Benchmark/Benchmark.h"
 
 // clang-format on 
 int main(int argc, char* argv[])
 {
+  /* Benchmarks run headless, before any window or OpenGL context is created */
+  std::optional<String> benchmark = Yeager::Benchmark::SearchSuiteArgument(argc, argv);
+  if (benchmark.has_value()) {
+    Yeager::Benchmark::ParseOptions(argc, argv);
+    return Yeager::Benchmark::Run(benchmark.value());
+  }
+
   Yeager::ApplicationCore Application(argc, argv);
   if(Application.ShouldRender()) {
     Application.UpdateTheEngine();
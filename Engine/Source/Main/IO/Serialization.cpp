@@ -1,5 +1,6 @@
 #include "Serialization.h"
 #include "Components/Renderer/Skybox/Skybox.h"
+#include "Components/TerrainGen/ProceduralTerrain.h"
 #include "Main/Core/Application.h"
 #include "Main/Scene/Scene.h"
 using namespace Yeager;
@@ -138,6 +139,7 @@ void YEAGER_FORCE_INLINE Serialization::SerializeBasicObjectType(YAML::Emitter&
   SerializeObject(out, "Scale", obj->GetTransformation().scale);
   SerializeObject(out, "Path", obj->GetPath());
   SerializeObject(out, "Geometry", ObjectGeometryTypeToString(obj->GetGeometry()));
+  SerializeObject(out, "PhysicsMaterial", obj->GetPhysXActor()->GetMaterialName());
   SerializeBegin(out, "TexturesLoaded", YAML::BeginSeq);
 
   if (obj->GetGeometry() == ObjectGeometryType::eCUSTOM) {
@@ -229,6 +231,7 @@ void Serialization::SerializeScene(Yeager::Scene* scene, String path)
   SerializeObject(out, "SceneType", SceneTypeToString(scene->GetContext()->ProjectSceneType));
   SerializeObject(out, "Camera Position", m_Application->GetCamera()->GetPosition());
   SerializeObject(out, "Camera Direction", m_Application->GetCamera()->GetFront());
+  SerializePhysicsMaterials(out);
   SerializeBegin(out, "SceneEntities", YAML::BeginSeq);
 
   if (scene->GetSkybox()->CanBeSerialize() && scene->GetSkybox()->IsLoaded()) {
@@ -516,6 +519,46 @@ void Serialization::DeserializeTemplateAssetsIntoScene(Yeager::Scene* scene, con
   }
 }
 
+void Serialization::SerializePhysicsMaterials(YAML::Emitter& out)
+{
+  SerializeBegin(out, "PhysicsMaterials", YAML::BeginSeq);
+  for (const auto& [name, desc] : m_Application->GetPhysXHandle()->GetMaterialCache()->GetNamedMaterials()) {
+    out << YAML::BeginMap;
+    SerializeObject(out, "Name", name);
+    SerializeObject(out, "StaticFriction", desc.StaticFriction);
+    SerializeObject(out, "DynamicFriction", desc.DynamicFriction);
+    SerializeObject(out, "Restitution", desc.Restitution);
+    SerializeObject(out, "FrictionCombine", PhysXMaterialDesc::CombineModeToString(desc.FrictionCombine));
+    SerializeObject(out, "RestitutionCombine", PhysXMaterialDesc::CombineModeToString(desc.RestitutionCombine));
+    out << YAML::EndMap;
+  }
+  out << YAML::EndSeq;
+}
+
+void Serialization::DeserializePhysicsMaterials(const YAML::Node& node)
+{
+  PhysXMaterialCache* cache = m_Application->GetPhysXHandle()->GetMaterialCache();
+  cache->ResetNamedMaterials();
+  for (const auto& material : node) {
+    PhysXMaterialDesc desc;
+    String name, frictionCombine, restitutionCombine;
+    if (!DeserializeIfExistsIntoRef(material, "Name", name)) {
+      Yeager::Log(WARNING, "Physics material without a name in the scene file!");
+      continue;
+    }
+    DeserializeIfExistsIntoRef(material, "StaticFriction", desc.StaticFriction);
+    DeserializeIfExistsIntoRef(material, "DynamicFriction", desc.DynamicFriction);
+    DeserializeIfExistsIntoRef(material, "Restitution", desc.Restitution);
+    if (DeserializeIfExistsIntoRef(material, "FrictionCombine", frictionCombine)) {
+      desc.FrictionCombine = PhysXMaterialDesc::StringToCombineMode(frictionCombine);
+    }
+    if (DeserializeIfExistsIntoRef(material, "RestitutionCombine", restitutionCombine)) {
+      desc.RestitutionCombine = PhysXMaterialDesc::StringToCombineMode(restitutionCombine);
+    }
+    cache->SetNamedMaterial(name, desc);
+  }
+}
+
 void Serialization::DeserializeScene(Yeager::Scene* scene, String path)
 {
   YAML::Node node = YAML::LoadFile(path);
@@ -556,6 +599,10 @@ void YEAGER_FORCE_INLINE Serialization::DeserializeSceneInfo(Yeager::Scene* scen
     if (node["TimeOfCreation"]) {
       scene->GetContext()->TimeOfCreation = DeserializeProjectTimeOfCreation(node["TimeOfCreation"]);
     }
+    /* Before the entities, the objects acquire the materials by name */
+    if (node["PhysicsMaterials"]) {
+      DeserializePhysicsMaterials(node["PhysicsMaterials"]);
+    }
   }
 }
 ObjectGeometryType::Enum YEAGER_FORCE_INLINE Serialization::DeserializeBasicObject(Yeager::Object* BaseClassObj,
@@ -717,9 +764,12 @@ void Serialization::DeserializeObject(YAML::detail::iterator_value& entity, Yeag
 
   } else {
     // Generates geometry for object
-    if (!obj->GenerateObjectGeometry(geometry, ObjectPhysXCreationStatic(obj->GetTransformationPtr()->position,
-                                                                         obj->GetTransformationPtr()->rotation,
-                                                                         obj->GetTransformationPtr()->scale))) {
+    ObjectPhysXCreationStatic physics(obj->GetTransformationPtr()->position, obj->GetTransformationPtr()->rotation,
+                                      obj->GetTransformationPtr()->scale);
+    if (entity["PhysicsMaterial"]) {
+      physics.Material = entity["PhysicsMaterial"].as<String>();
+    }
+    if (!obj->GenerateObjectGeometry(geometry, physics)) {
       Yeager::Log(ERROR, "Error generating object geometry during deserialization!");
       succceded = false;
     }
@@ -757,9 +807,12 @@ void Serialization::DeserializeAnimatedObject(YAML::detail::iterator_value& enti
       return;
     }
   } else {
-    if (!obj->GenerateObjectGeometry(geometry, ObjectPhysXCreationStatic(obj->GetTransformationPtr()->position,
-                                                                         obj->GetTransformationPtr()->rotation,
-                                                                         obj->GetTransformationPtr()->scale))) {
+    ObjectPhysXCreationStatic physics(obj->GetTransformationPtr()->position, obj->GetTransformationPtr()->rotation,
+                                      obj->GetTransformationPtr()->scale);
+    if (entity["PhysicsMaterial"]) {
+      physics.Material = entity["PhysicsMaterial"].as<String>();
+    }
+    if (!obj->GenerateObjectGeometry(geometry, physics)) {
       Yeager::Log(ERROR, "Error generating animated object geometry during deserialization!");
       succceded = false;
     }
@@ -1000,3 +1053,28 @@ std::optional<Serialization::LocaleData> Serialization::DeserializeLocaleData(co
   }
   return data;
 }
+
+bool Serialization::SerializeTerrain(Yeager::ProceduralTerrain* terrain, const String& path,
+                                     const TerrainHeightMapWriteSettings& settings)
+{
+  if (!terrain->SaveHeightMap(path, settings)) {
+    Yeager::Log(ERROR, "Cannot serialize terrain to {}", path);
+    return false;
+  }
+  Yeager::Log(INFO, "Terrain serialized to {}, format {}, compression {}", path,
+              TerrainHeightMapFormat::ToString(settings.Format),
+              TerrainHeightMapCompression::ToString(settings.Compression));
+  return true;
+}
+
+bool Serialization::DeserializeTerrain(Yeager::ProceduralTerrain* terrain, const String& path)
+{
+  const auto start = std::chrono::steady_clock::now();
+  if (!terrain->LoadHeightMap(path)) {
+    Yeager::Log(ERROR, "Cannot deserialize terrain from {}", path);
+    return false;
+  }
+  const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+  Yeager::Log(INFO, "Terrain deserialized from {} in {} ms", path, elapsed.count() / 1000.0);
+  return true;
+}
@@ -25,6 +25,7 @@
 #include "Common/Utils/Utilities.h"
 
 #include "Components/Renderer/Objects/Entity.h"
+#include "Components/TerrainGen/TerrainHeightMap.h"
 #include "Editor/UI/Interface.h"
 #include "Main/Window/Window.h"
 
@@ -85,6 +86,7 @@ namespace Yeager {
 class Scene;
 class ApplicationCore;
 class Settings;
+class ProceduralTerrain;
 struct TemplateHandle;
 
 extern std::vector<OpenProjectsDisplay> ReadProjectsToDisplay(String dir, Yeager::ApplicationCore* app);
@@ -121,6 +123,14 @@ class Serialization {
   typedef std::map<String, String> LocaleData;
   std::optional<LocaleData> DeserializeLocaleData(const std::filesystem::path& path);
 
+  /**
+   * @brief Saves the terrain as a binary heightmap (YEAGER_TERRAIN_HEIGHTMAP_EXT_STR), deserializing it gives the same
+   * terrain back without generating the noise again
+   */
+  bool SerializeTerrain(Yeager::ProceduralTerrain* terrain, const String& path,
+                        const TerrainHeightMapWriteSettings& settings = TerrainHeightMapWriteSettings());
+  bool DeserializeTerrain(Yeager::ProceduralTerrain* terrain, const String& path);
+
  private:
   Yeager::ApplicationCore* m_Application = YEAGER_NULLPTR;
 
@@ -141,6 +151,9 @@ class Serialization {
   void YEAGER_FORCE_INLINE SerializeBasicObjectType(YAML::Emitter& out, Yeager::Object* obj);
   void YEAGER_FORCE_INLINE SerializeBegin(YAML::Emitter& out, const char* key, YAML::EMITTER_MANIP manip);
   void YEAGER_FORCE_INLINE SerializeSystemInfo(YAML::Emitter& out, Yeager::Scene* scene);
+  /** Named materials of the PhysXMaterialCache, the objects refer to them by name */
+  void SerializePhysicsMaterials(YAML::Emitter& out);
+  void DeserializePhysicsMaterials(const YAML::Node& node);
 
   template <typename Type>
   std::optional<Type> DeserializeObject(const YAML::Node& node, Cchar key);
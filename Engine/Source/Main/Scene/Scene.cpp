@@ -290,6 +290,12 @@ void Scene::VerifyCacheSubFolders()
   if (!Yeager::ValidatesPath(cacheFolder + YG_PS + "Object")) {
     Yeager::CreateDirectoryAndValidate(cacheFolder + YG_PS + "Object");
   }
+  if (!Yeager::ValidatesPath(cacheFolder + YG_PS + "Animation")) {
+    Yeager::CreateDirectoryAndValidate(cacheFolder + YG_PS + "Animation");
+  }
+  if (!Yeager::ValidatesPath(cacheFolder + YG_PS + "Physics")) {
+    Yeager::CreateDirectoryAndValidate(cacheFolder + YG_PS + "Physics");
+  }
 }
 
 String Scene::GetTextureCacheFolderPath() const
@@ -297,6 +303,16 @@ String Scene::GetTextureCacheFolderPath() const
   return String(m_Context.ProjectFolderPath + YG_PS + "Cache" + YG_PS + "Texture");
 }
 
+String Scene::GetAnimationCacheFolderPath() const
+{
+  return String(m_Context.ProjectFolderPath + YG_PS + "Cache" + YG_PS + "Animation");
+}
+
+String Scene::GetPhysicsCacheFolderPath() const
+{
+  return String(m_Context.ProjectFolderPath + YG_PS + "Cache" + YG_PS + "Physics");
+}
+
 Scene::~Scene()
 {
   if (!m_SceneWasTerminated) {
@@ -168,6 +168,8 @@ class Scene {
   }
 
   String GetTextureCacheFolderPath() const;
+  String GetAnimationCacheFolderPath() const;
+  String GetPhysicsCacheFolderPath() const;
 
   void BuildSceneFromTemplate(const TemplateHandle& handle);
 